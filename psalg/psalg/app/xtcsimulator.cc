@@ -0,0 +1,141 @@
+// Writes a synthetic run of area detector, hsd and bld data with
+// detector::XtcSimulator to an xtc2 file or a TCP socket, or runs it
+// through a buffer pool with consumer threads, and prints the rate.
+//
+// Examples:
+// xtcsimulator -f sim.xtc2 -n 10000 -r 120
+// xtcsimulator -s localhost:12345 -a jungfrau:jungfrau:32x512x1024 -H hsd:4:6000 -b ebeam
+// xtcsimulator -p 64:4 -n 100000
+
+#include <stdio.h>
+#include <stdlib.h>    // atoi, atof, strtoul
+#include <string.h>    // strchr
+#include <getopt.h>
+#include <time.h>      // clock_gettime
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "psalg/detector/XtcSimulator.hh"
+
+using namespace detector;
+
+//-------------------
+
+static void usage(const char* name) {
+  printf("Usage: %s [-f <file> | -s <host:port> | -p <nbuffers:nthreads>]\n"
+         "          [-n <events>] [-r <rate Hz>] [-d <damaged fraction>] [-e <expt>] [-R <run>]\n"
+         "          [-a <name:type:shape>]... [-H <name:channels:samples>]... [-b <name>]...\n"
+         "  shape as 8x512x1024; without detectors: -a jungfrau:jungfrau:8x512x1024 -H hsd:4:6000 -b ebeam\n",
+         name);
+}
+
+static double time_sec() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1e-9*t.tv_nsec;
+}
+
+/// Splits "a:b:c" on ':'
+static std::vector<std::string> split(const char* s, const char sep=':') {
+  std::vector<std::string> v(1);
+  for(; *s; s++) {
+    if(*s == sep) v.push_back(std::string());
+    else v.back() += *s;
+  }
+  return v;
+}
+
+//-------------------
+
+int main(int argc, char **argv) {
+  const char* fname = 0;
+  const char* hostport = 0;
+  const char* poolpars = 0;
+  const char* expt = "tstx00117";
+  unsigned runnum = 1;
+  uint64_t nevents = 1000;
+  double rate = 0, damage = 0;
+  std::vector<std::string> areas, hsds, blds;
+
+  int c;
+  while((c = getopt(argc, argv, "hf:s:p:n:r:d:e:R:a:H:b:")) != -1) {
+    switch(c) {
+    case 'f': fname = optarg; break;
+    case 's': hostport = optarg; break;
+    case 'p': poolpars = optarg; break;
+    case 'n': nevents = strtoull(optarg, NULL, 10); break;
+    case 'r': rate = atof(optarg); break;
+    case 'd': damage = atof(optarg); break;
+    case 'e': expt = optarg; break;
+    case 'R': runnum = atoi(optarg); break;
+    case 'a': areas.push_back(optarg); break;
+    case 'H': hsds.push_back(optarg); break;
+    case 'b': blds.push_back(optarg); break;
+    default : usage(argv[0]); return (c == 'h') ? 0 : 1;
+    }
+  }
+  if((fname != 0) + (hostport != 0) + (poolpars != 0) != 1) {usage(argv[0]); return 1;}
+
+  XtcSimulator sim(expt, runnum);
+  if(areas.empty() && hsds.empty() && blds.empty()) {
+    areas.push_back("jungfrau:jungfrau:8x512x1024");
+    hsds.push_back("hsd:4:6000");
+    blds.push_back("ebeam");
+  }
+  for(size_t i=0; i<areas.size(); i++) {
+    std::vector<std::string> f = split(areas[i].c_str());
+    if(f.size() != 3) {usage(argv[0]); return 1;}
+    std::vector<std::string> s = split(f[2].c_str(), 'x');
+    unsigned shape[XtcData::MaxRank];
+    for(size_t k=0; k<s.size() && k<XtcData::MaxRank; k++) shape[k] = atoi(s[k].c_str());
+    sim.add_area_detector(f[0].c_str(), f[1].c_str(), shape, s.size());
+  }
+  for(size_t i=0; i<hsds.size(); i++) {
+    std::vector<std::string> f = split(hsds[i].c_str());
+    if(f.size() != 3) {usage(argv[0]); return 1;}
+    sim.add_hsd(f[0].c_str(), atoi(f[1].c_str()), atoi(f[2].c_str()));
+  }
+  for(size_t i=0; i<blds.size(); i++) sim.add_bld(blds[i].c_str());
+  sim.set_rate(rate);
+  sim.set_damage(damage);
+
+  uint64_t ndgrams = 0;
+  double t0 = time_sec();
+  if(fname) {
+    SimFileSink sink(fname);
+    if(!sink.ok()) return 1;
+    ndgrams = sim.run(sink, nevents);
+  }
+  else if(hostport) {
+    std::vector<std::string> f = split(hostport);
+    if(f.size() != 2) {usage(argv[0]); return 1;}
+    SimSocketSink sink(f[0].c_str(), atoi(f[1].c_str()));
+    if(!sink.ok()) return 1;
+    ndgrams = sim.run(sink, nevents);
+  }
+  else {
+    std::vector<std::string> f = split(poolpars);
+    const unsigned nbuffers = atoi(f[0].c_str());
+    const unsigned nthreads = (f.size() > 1) ? atoi(f[1].c_str()) : 1;
+    SimBufferPool pool(nbuffers ? nbuffers : 1, sim.max_dgram_size());
+    std::vector<std::thread> workers;
+    for(unsigned t=0; t<nthreads; t++) {
+      workers.emplace_back([&pool]() {
+        unsigned index;
+        while(pool.pop(index)) pool.release(index);
+      });
+    }
+    ndgrams = sim.run(pool, nevents);
+    pool.close();
+    for(unsigned t=0; t<workers.size(); t++) workers[t].join();
+  }
+  double dt = time_sec() - t0;
+
+  printf("%llu datagrams, %llu L1Accepts in %.3f s: %.0f events/s, %llu contributions dropped\n",
+         (unsigned long long)ndgrams, (unsigned long long)sim.nevents(), dt, sim.nevents()/dt,
+         (unsigned long long)sim.ndamaged());
+  return (ndgrams == nevents+7) ? 0 : 1;
+}
+
+//-------------------
@@ -11,6 +11,9 @@
  *
  * NDArray<float>& arr = aio.ndarray();
  * std::cout << "ndarray: " << arr);
+ *
+ * Files *.npy and *.npy.gz are loaded in binary with NpyArray (psalg/calib/NpyIO.hh);
+ * without buf the array points to the mapped file.
  */
 
 #include <string>
@@ -20,6 +23,7 @@
 
 #include "psalg/calib/Types.hh" // shape_t, size_t
 #include "psalg/calib/NDArray.hh" // NDArray
+#include "psalg/calib/NpyIO.hh" // NpyArray
 #include "psalg/utils/Logger.hh" // for MSG
 
 using namespace std;
@@ -73,12 +77,16 @@ private:
   std::string _dtype_name;
 
   NDArray<T>  _nda;
+  NpyArray<T> _npy;
 
   void _init();
 
   /// loads metadata and data from file
   void _load_array();
 
+  /// loads binary array from *.npy or *.npy.gz file
+  void _load_npy();
+
   /// parser for comment lines and metadata from file with array
   void _parse_str_of_comment(const std::string& str);
 
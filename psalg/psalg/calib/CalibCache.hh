@@ -0,0 +1,157 @@
+#ifndef PSALG_CALIBCACHE_H
+#define PSALG_CALIBCACHE_H
+//-----------------------------
+
+/** Process-wide cache of calibration constants from the calibration web service.
+ *
+ * Constants are kept once per process, keyed on the query (detector, experiment,
+ * ctype, run, time_sec, version), and shared, reference counted, by all of the
+ * CalibParsDBWeb objects, e.g. those of several AreaDetector instances.
+ * Each new query asks the web service for its document, and queries which
+ * resolve to the same data (id_data of the document) share one copy.
+ * Empty or failed downloads are not cached.
+ *
+ * If a cache directory is set (set_directory or the environment variable
+ * PSALG_CALIB_CACHE_DIR) the data and metadata are also stored in it as
+ *
+ *   <dir>/<dbname>/<id_data>.data - raw bytes, as in GridFS, or an uncompressed npy
+ *   <dir>/<dbname>/<id_data>.json - metadata document
+ *
+ * and are mapped from there (read-only shared mappings, whose pages are shared by
+ * all of the processes of a node) by the following jobs, which then only ask the
+ * web service for the document.  Files are written to a temporary name and renamed,
+ * so that many processes can fill the same directory.
+ *
+ * The data of the constants are read-only pages: all of the consumers see the same
+ * bytes, a consumer which writes to them gets a SIGSEGV.  Copy the array to change it.
+ *
+ * Usage::
+ *
+ * #include "psalg/calib/CalibCache.hh"
+ *
+ * calib::CalibCache& cache = calib::CalibCache::instance();
+ * cache.set_directory("/scratch/calib-cache");
+ * cache.prefetch("cspad_0001", NULL, calib::CalibCache::area_detector_ctypes(), 10);
+ * calib::CalibConstantsPtr p = cache.get("cspad_0001", NULL, "pedestals", 10);
+ * if(p) {p->data(); p->size(); p->data_shape();}
+ */
+
+#include <map>
+#include <memory>  // shared_ptr
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "psalg/calib/MDBWebUtils.hh" // URLWS
+
+namespace calib {
+
+//-----------------------------
+
+/// Immutable data and metadata of a calibration document
+class CalibConstants {
+public:
+
+  /// Copies the data received from the web service to read-only pages, inflates
+  /// gzip-compressed data; check valid()
+  CalibConstants(const std::string& metadata, std::string& data);
+
+  /// Maps the data file of the cache directory read-only, check valid()
+  CalibConstants(const std::string& metadata, const std::string& fname);
+
+  ~CalibConstants();
+
+  /// false for empty data, data which could not be inflated or a file which could not be mapped
+  bool               valid()      const {return _data != 0 && _size != 0;}
+  const char*        data()       const {return _data;}
+  size_t             size()       const {return _size;}
+  /// mapped from a file of the cache directory
+  bool               mapped()     const {return _file && _map != 0;}
+  const std::string& metadata()   const {return _metadata;}
+  const std::string& id_data()    const {return _id_data;}
+  const std::string& data_shape() const {return _data_shape;}
+  const std::string& data_dtype() const {return _data_dtype;}
+  unsigned           run()        const {return _run;}
+  /// last run of validity, 0 if open ("end")
+  unsigned           run_end()    const {return _run_end;}
+
+  CalibConstants(const CalibConstants&) = delete;
+  CalibConstants& operator = (const CalibConstants&) = delete;
+
+private:
+
+  void _parse_metadata();
+
+  std::string _metadata;
+  const char* _data;
+  size_t      _size;
+  void*       _map;
+  size_t      _map_size;
+  bool        _file;
+  std::string _id_data;
+  std::string _data_shape;
+  std::string _data_dtype;
+  unsigned    _run;
+  unsigned    _run_end;
+};
+
+typedef std::shared_ptr<const CalibConstants> CalibConstantsPtr;
+
+//-----------------------------
+
+class CalibCache {
+public:
+
+  static CalibCache& instance();
+
+  /// Returns constants for the query, or an empty pointer if the document is not found;
+  /// thread safe
+  CalibConstantsPtr get(const char* det, const char* exp=NULL, const char* ctype=NULL,
+                        const unsigned run=0, const unsigned time_sec=0, const char* vers=NULL,
+                        const char* urlws=psalg::URLWS);
+
+  /// Gets the constants of all ctypes, each in its own thread; returns the number found
+  unsigned prefetch(const char* det, const char* exp, const std::vector<std::string>& ctypes,
+                    const unsigned run=0, const unsigned time_sec=0, const char* vers=NULL,
+                    const char* urlws=psalg::URLWS);
+
+  /// ctypes used by AreaDetector
+  static const std::vector<std::string>& area_detector_ctypes();
+
+  /// Empty string disables the on-disk cache
+  void set_directory(const std::string& dir);
+  std::string directory();
+
+  /// Releases the constants of the cache; those in use stay valid
+  void clear();
+
+  /// Number of queries and of distinct constants held
+  size_t nqueries();
+  size_t nconstants();
+
+  /// Maps the data of id_data of dbname from the cache directory, or returns an empty
+  /// pointer if it is not there
+  CalibConstantsPtr load(const std::string& dbname, const std::string& metadata, const std::string& id_data);
+
+  /// Writes the data and metadata of c to the cache directory, if it is set
+  void store(const std::string& dbname, const CalibConstants& c);
+
+  CalibCache(const CalibCache&) = delete;
+  CalibCache& operator = (const CalibCache&) = delete;
+
+private:
+
+  CalibCache();
+  ~CalibCache() {}
+
+  std::mutex _mutex;
+  std::string _dir;
+  std::map<std::string, CalibConstantsPtr> _queries;     // full query -> constants
+  std::map<std::string, CalibConstantsPtr> _constants;   // dbname/id_data -> constants
+};
+
+//-----------------------------
+
+} // namespace calib
+
+#endif // PSALG_CALIBCACHE_H
@@ -4,6 +4,7 @@
 
 #include "psalg/calib/CalibParsDB.hh" // #include "psalg/calib/Query.hh"
 #include "psalg/calib/MDBWebUtils.hh"
+#include "psalg/calib/CalibCache.hh"
 
 using namespace psalg; // for NDArray
 
@@ -32,6 +33,12 @@ private:
 
   void _default_msg(const std::string& msg=std::string()) const;
 
+  // constants of the CalibCache referenced by the _ndarray_* members
+  CalibConstantsPtr _constants_float;
+  CalibConstantsPtr _constants_double;
+  CalibConstantsPtr _constants_uint16;
+  CalibConstantsPtr _constants_uint32;
+
 }; // class
 
 //-----------------------------
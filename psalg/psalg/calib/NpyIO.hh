@@ -0,0 +1,112 @@
+#ifndef PSALG_NPYIO_H
+#define PSALG_NPYIO_H
+
+//-------------------
+
+/** Binary calibration arrays in the numpy .npy format
+ *
+ *  The .npy format is a short text header with dtype and shape
+ *  followed by the raw data, the format numpy writes with np.save and
+ *  which MDBUtils.save_doc writes next to the text files of the constants.
+ *  Files and buffers may be compressed with gzip (.npy.gz).
+ *
+ *  Uncompressed files are mapped, not read: the array points to the pages of
+ *  the file (a private, copy-on-write mapping) and loading costs no more
+ *  than opening the file.  Compressed files and buffers are inflated.
+ *
+ *  Usage
+ *
+ *  #include "psalg/calib/NpyIO.hh"
+ *
+ *  NpyArray<float> a;
+ *  if(a.load("pedestals.npy")) {   // or .npy.gz
+ *    NDArray<float>& nda = a.ndarray();
+ *  }
+ *  save_npy("pedestals.npy.gz", nda, true);
+ *
+ *  // response of the calibration web service
+ *  if(is_npy(s.data(), s.size()) || is_gzip(s.data(), s.size())) a.set_buffer(s.data(), s.size());
+ */
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "psalg/calib/NDArray.hh"
+
+namespace psalg {
+
+//-------------------
+
+struct NpyHeader {
+  std::string           descr;         // e.g. "<f4"
+  bool                  fortran_order;
+  std::vector<uint32_t> shape;
+  size_t                data_offset;   // from the start of the buffer
+  size_t                itemsize;
+  size_t                size() const {size_t s=1; for(size_t i=0; i<shape.size(); i++) s*=shape[i]; return s;}
+};
+
+/// npy dtype descr of T, e.g. "<f4" for float
+template<typename T> const char* npy_descr();
+
+bool is_npy (const char* buf, const size_t size);
+bool is_gzip(const char* buf, const size_t size);
+
+/// Parses the header of the npy buffer, false if it is not valid
+bool parse_npy_header(const char* buf, const size_t size, NpyHeader& h);
+
+/// Header (version 1.0, padded to 64 bytes) for an array of descr and shape
+std::string npy_header(const std::string& descr, const uint32_t* shape, const size_t ndim);
+
+bool gunzip(const char* buf, const size_t size, std::string& out);
+bool gzip  (const char* buf, const size_t size, std::string& out, const int level=1);
+
+//-------------------
+
+template<typename T>
+class NpyArray {
+public:
+
+  NpyArray();
+  ~NpyArray();
+
+  /// Maps a .npy file or inflates a gzip-compressed one
+  bool load(const std::string& fname);
+
+  /// Copies (or inflates) an npy buffer
+  bool set_buffer(const char* buf, const size_t size);
+
+  NDArray<T>& ndarray() {return _nda;}
+  bool mapped() const {return _map != 0;}
+
+  NpyArray(const NpyArray&) = delete;
+  NpyArray& operator = (const NpyArray&) = delete;
+
+private:
+
+  void _release();
+  bool _set_data(const char* buf, const size_t size, const std::string& name);
+
+  void*       _map;
+  size_t      _map_size;
+  std::string _buffer;
+  NDArray<T>  _nda;
+};
+
+//-------------------
+
+/// Points nda to the data of an uncompressed npy buffer, which must outlive nda;
+/// nda must not be written to if buf is read-only, as the data of CalibConstants
+template<typename T>
+bool set_ndarray_npy(NDArray<T>& nda, const char* buf, const size_t size);
+
+/// Saves nda in fname, compressed with gzip if compress
+template<typename T>
+bool save_npy(const std::string& fname, const NDArray<T>& nda, const bool compress=false);
+
+//-------------------
+
+} // namespace psalg
+
+#endif // PSALG_NPYIO_H
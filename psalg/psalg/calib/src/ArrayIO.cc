@@ -51,6 +51,12 @@ void ArrayIO<T>::_load_array()
 {
     MSG(TRACE, "Load file " << _fname);
 
+    if(_fname.size()>4 && (_fname.compare(_fname.size()-4, 4, ".npy")==0
+    || (_fname.size()>7 && _fname.compare(_fname.size()-7, 7, ".npy.gz")==0))) {
+      _load_npy();
+      return;
+    }
+
     _count_1st_line = 0;
     _count_str_data = 0;
     _count_str_comt = 0;
@@ -89,6 +95,36 @@ void ArrayIO<T>::_load_array()
 
 //-----------------------------
 
+template <typename T>
+void ArrayIO<T>::_load_npy()
+{
+    if(!_npy.load(_fname)) {
+      MSG(WARNING, "Failed to load npy file: \"" << _fname << "\"");
+      _status = ArrayIO<T>::UNREADABLE;
+      return;
+    }
+
+    NDArray<T>& a = _npy.ndarray();
+    _ndim = a.ndim();
+    for(size_t i=0; i<_ndim; i++) _shape[i] = a.shape()[i];
+    _size = a.size();
+    _count_data = _size;
+    _dtype_name = npy_descr<T>();
+
+    _nda.set_shape(_shape, _ndim);
+    if(_buf) {
+      _nda.set_data_buffer(_buf);
+      std::memcpy(_nda.data(), a.data(), _size*sizeof(T));
+    }
+    else _nda.set_data_buffer(a.data()); // zero-copy, valid while this object exists
+
+    _status = ArrayIO<T>::LOADED;
+    MSG(TRACE, "Loaded data from file: \"" << _fname << "\""
+         << (_npy.mapped() ? " mapped" : "") << " Input array " << _nda << " of type " << _dtype_name);
+}
+
+//-----------------------------
+
 template <typename T>
 void ArrayIO<T>::_parse_str_of_comment(const std::string& s)
 {
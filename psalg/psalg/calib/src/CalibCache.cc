@@ -0,0 +1,279 @@
+//-------------------
+
+#include "psalg/calib/CalibCache.hh"
+#include "psalg/calib/NpyIO.hh" // is_gzip, gunzip, parse_npy_header
+#include "psalg/utils/Logger.hh" // for MSG
+
+#include <stdio.h>     // rename, remove
+#include <stdlib.h>    // getenv, strtoul
+#include <string.h>    // strerror, memcpy
+#include <unistd.h>    // close, getpid
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap, mprotect
+#include <sys/stat.h>  // fstat, mkdir
+#include <errno.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <curl/curl.h> // curl_global_init
+#include <rapidjson/document.h>
+
+using namespace psalg;
+
+//-------------------
+
+namespace calib {
+
+//-------------------
+//  CalibConstants
+//-------------------
+
+CalibConstants::CalibConstants(const std::string& metadata, std::string& data)
+  : _metadata(metadata), _data(0), _size(0), _map(0), _map_size(0), _file(false), _run(0), _run_end(0) {
+  // compressed (npy.gz) data are inflated once here, the cache and its directory keep them uncompressed;
+  // data which do not inflate to npy are raw data of data_shape which happen to start as gzip does
+  std::string s;
+  NpyHeader h;
+  _parse_metadata();
+  if(is_gzip(data.data(), data.size())) {
+    if(gunzip(data.data(), data.size(), s) && parse_npy_header(s.data(), s.size(), h)) data.swap(s);
+    else MSG(DEBUG, "CalibConstants: " << data.size() << " bytes of data do not inflate to npy, kept as raw data");
+  }
+  if(data.empty()) return;
+  // read-only pages, shared by all of the consumers of the cache
+  void* p = mmap(0, data.size(), PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+  if(p == MAP_FAILED) {
+    MSG(WARNING, "CalibConstants: can not map " << data.size() << " bytes: " << strerror(errno));
+    return;
+  }
+  memcpy(p, data.data(), data.size());
+  mprotect(p, data.size(), PROT_READ);
+  _map = p;
+  _map_size = data.size();
+  _data = (const char*)p;
+  _size = data.size();
+}
+
+CalibConstants::CalibConstants(const std::string& metadata, const std::string& fname)
+  : _metadata(metadata), _data(0), _size(0), _map(0), _map_size(0), _file(true), _run(0), _run_end(0) {
+  _parse_metadata();
+  int fd = open(fname.c_str(), O_RDONLY);
+  if(fd < 0) return;
+  struct stat st;
+  if(fstat(fd, &st) == 0 && st.st_size > 0) {
+    // read-only, the pages are shared by all of the consumers and processes of the node
+    void* p = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if(p != MAP_FAILED) {
+      madvise(p, st.st_size, MADV_WILLNEED);
+      _map = p;
+      _map_size = st.st_size;
+      _data = (const char*)p;
+      _size = st.st_size;
+    }
+    else MSG(WARNING, "CalibConstants: can not map " << fname << ": " << strerror(errno));
+  }
+  close(fd);
+}
+
+CalibConstants::~CalibConstants() {
+  if(_map) munmap(_map, _map_size);
+}
+
+void CalibConstants::_parse_metadata() {
+  rapidjson::Document doc;
+  doc.Parse(_metadata.c_str());
+  if(doc.HasParseError() || !doc.IsObject()) return;
+  const rapidjson::Value& id    = value_from_json_doc(doc, "id_data");
+  const rapidjson::Value& shape = value_from_json_doc(doc, "data_shape");
+  const rapidjson::Value& dtype = value_from_json_doc(doc, "data_dtype");
+  const rapidjson::Value& run   = value_from_json_doc(doc, "run");
+  const rapidjson::Value& end   = value_from_json_doc(doc, "run_end");
+  if(id.IsString())    _id_data    = id.GetString();
+  if(shape.IsString()) _data_shape = shape.GetString();
+  if(dtype.IsString()) _data_dtype = dtype.GetString();
+  if(run.IsUint())     _run        = run.GetUint();
+  if(end.IsUint())     _run_end    = end.GetUint();
+  else if(end.IsString()) _run_end = strtoul(end.GetString(), NULL, 10); // "end" -> 0
+}
+
+//-------------------
+//  CalibCache
+//-------------------
+
+CalibCache& CalibCache::instance() {
+  static CalibCache cache;
+  return cache;
+}
+
+CalibCache::CalibCache() {
+  const char* dir = getenv("PSALG_CALIB_CACHE_DIR");
+  if(dir) _dir = dir;
+}
+
+const std::vector<std::string>& CalibCache::area_detector_ctypes() {
+  static const std::vector<std::string> ctypes = {"pedestals", "pixel_rms", "pixel_status", "pixel_gain",
+                                                  "pixel_offset", "pixel_mask", "pixel_bkgd", "common_mode",
+                                                  "geometry"};
+  return ctypes;
+}
+
+void CalibCache::set_directory(const std::string& dir) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _dir = dir;
+}
+
+std::string CalibCache::directory() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _dir;
+}
+
+void CalibCache::clear() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _queries.clear();
+  _constants.clear();
+}
+
+size_t CalibCache::nqueries() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _queries.size();
+}
+
+size_t CalibCache::nconstants() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _constants.size();
+}
+
+//-------------------
+
+CalibConstantsPtr CalibCache::get(const char* det, const char* exp, const char* ctype,
+                                  const unsigned run, const unsigned time_sec, const char* vers,
+                                  const char* urlws) {
+  if(!det || !ctype) {
+    MSG(WARNING, "CalibCache::get: detector or ctype is not defined");
+    return CalibConstantsPtr();
+  }
+
+  std::stringstream ss;
+  ss << det << '/' << (exp ? exp : "") << '/' << ctype << '/' << (vers ? vers : "") << '/' << run << '/' << time_sec;
+  const std::string key = ss.str();
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _queries.find(key);
+    if(it != _queries.end()) return it->second;
+  }
+
+  // the document, a short request for each new query: the data base picks the newest of
+  // the documents which cover the run, which may not be one of those in the cache
+  std::map<std::string, std::string> omap;
+  dbnames_collection_query(omap, det, exp, ctype, run, time_sec, vers);
+  const std::string dbname = (exp) ? omap["db_exp"] : omap["db_det"];
+
+  rapidjson::Document outdocs;
+  const rapidjson::Value& jdoc = find_doc(outdocs, dbname.c_str(), omap["colname"].c_str(), omap["query"].c_str(), urlws);
+  if(jdoc.IsNull()) {
+    MSG(WARNING, "CalibCache: DOCUMENT IS NOT FOUND FOR QUERY = " << omap["query"]);
+    return CalibConstantsPtr();
+  }
+  const rapidjson::Value& vid = value_from_json_doc(jdoc, "id_data");
+  if(!vid.IsString()) {
+    MSG(WARNING, "CalibCache: document without id_data for query " << omap["query"]);
+    return CalibConstantsPtr();
+  }
+  const std::string id_data(vid.GetString());
+  const std::string metadata = json_doc_to_string(jdoc);
+  const std::string key_data = dbname + '/' + id_data;
+
+  // the data, from memory, the cache directory or the web service
+  CalibConstantsPtr p;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _constants.find(key_data);
+    if(it != _constants.end()) p = it->second;
+  }
+  if(!p) p = load(dbname, metadata, id_data);
+  if(!p) {
+    std::string data;
+    get_data_for_id(data, dbname.c_str(), id_data.c_str(), urlws);
+    std::shared_ptr<CalibConstants> c = std::make_shared<CalibConstants>(metadata, data);
+    if(!c->valid()) { // a failed download is not cached, neither in memory nor on disk
+      MSG(WARNING, "CalibCache: NO DATA FOR id_data " << id_data << " OF QUERY = " << omap["query"]);
+      return CalibConstantsPtr();
+    }
+    store(dbname, *c);
+    p = c;
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto ins = _constants.insert(std::make_pair(key_data, p));
+  p = ins.first->second; // the first of concurrent requests wins
+  _queries[key] = p;
+  MSG(DEBUG, "CalibCache: " << key << " -> " << key_data << " size " << p->size() << (p->mapped() ? " mapped" : ""));
+  return p;
+}
+
+//-------------------
+
+unsigned CalibCache::prefetch(const char* det, const char* exp, const std::vector<std::string>& ctypes,
+                              const unsigned run, const unsigned time_sec, const char* vers,
+                              const char* urlws) {
+  // curl_global_init is not thread safe, curl_easy_init would call it in each thread
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+
+  std::vector<char> found(ctypes.size(), 0);
+  std::vector<std::thread> threads;
+  for(size_t i=0; i<ctypes.size(); i++) {
+    threads.emplace_back([&, i]() {
+      found[i] = get(det, exp, ctypes[i].c_str(), run, time_sec, vers, urlws) ? 1 : 0;
+    });
+  }
+  unsigned n = 0;
+  for(size_t i=0; i<threads.size(); i++) {threads[i].join(); n += found[i];}
+  MSG(DEBUG, "CalibCache::prefetch: " << n << " of " << ctypes.size() << " ctypes for " << det << " run " << run);
+  return n;
+}
+
+//-------------------
+
+CalibConstantsPtr CalibCache::load(const std::string& dbname, const std::string& metadata, const std::string& id_data) {
+  const std::string dir = directory();
+  if(dir.empty()) return CalibConstantsPtr();
+  const std::string fname = dir + '/' + dbname + '/' + id_data + ".data";
+  struct stat st;
+  if(stat(fname.c_str(), &st) != 0 || st.st_size == 0) return CalibConstantsPtr();
+  CalibConstantsPtr p = std::make_shared<CalibConstants>(metadata, fname);
+  return p->valid() ? p : CalibConstantsPtr();
+}
+
+//-------------------
+
+static bool write_file(const std::string& fname, const char* data, const size_t size) {
+  std::stringstream ss;
+  ss << fname << ".tmp." << getpid() << '.' << std::this_thread::get_id();
+  const std::string tmpname = ss.str();
+  {
+    std::ofstream f(tmpname.c_str(), std::ios::binary);
+    if(!f.write(data, size)) {remove(tmpname.c_str()); return false;}
+  }
+  if(rename(tmpname.c_str(), fname.c_str()) != 0) {remove(tmpname.c_str()); return false;}
+  return true;
+}
+
+void CalibCache::store(const std::string& dbname, const CalibConstants& c) {
+  const std::string dir = directory();
+  if(dir.empty()) return;
+  const std::string dbdir = dir + '/' + dbname;
+  mkdir(dir.c_str(), 0777);
+  mkdir(dbdir.c_str(), 0777);
+  const std::string fname = dbdir + '/' + c.id_data();
+  if(!write_file(fname + ".json", c.metadata().data(), c.metadata().size())
+  || !write_file(fname + ".data", c.data(), c.size()))
+    MSG(WARNING, "CalibCache: can not write " << fname << ".data in the cache directory");
+}
+
+//-------------------
+
+} // namespace calib
+
+//-------------------
@@ -1,4 +1,5 @@
 #include "psalg/calib/CalibParsDBWeb.hh"
+#include "psalg/calib/NpyIO.hh" // parse_npy_header, set_ndarray_npy
 
 //using namespace std;
 using namespace psalg; // for NDArray
@@ -67,12 +68,40 @@ const NDArray<float>& CalibParsDBWeb::get_ndarray_float(Query& q) {
 
 //-------------------
 
+/// Sets nda to the data of the constants, without copy; c must live as long as nda is used.
+/// The data are the read-only pages of the cache, shared by all of the detectors, and nda
+/// is only handed out as a const NDArray.
+
+template<typename T>
+static void set_ndarray_constants(NDArray<T>& nda, const CalibConstants* c) {
+  NpyHeader h;
+  if(c && parse_npy_header(c->data(), c->size(), h)) {
+    if(!set_ndarray_npy(nda, c->data(), c->size())) nda.set_shape();
+    return;
+  }
+  if(!c || c->data_shape().empty()) {
+    MSG(WARNING, "CalibParsDBWeb: no array constants for the query");
+    nda.set_shape();
+    return;
+  }
+  nda.set_shape_string(c->data_shape());
+  if(c->size() < nda.size()*sizeof(T)) {
+    MSG(WARNING, "CalibParsDBWeb: " << c->size() << " bytes of " << c->data_dtype()
+        << " data do not fill shape " << c->data_shape() << " of " << sizeof(T) << "-byte values");
+    nda.set_shape();
+    return;
+  }
+  nda.set_data_buffer(const_cast<char*>(c->data()));
+}
+
+//-------------------
+
 //_default_msg(std::string("get_ndarray_"#N"(Query&)"));
 #define GET_NDARRAY(T,N)\
 const NDArray<T>& CalibParsDBWeb::get_ndarray_##N(Query& q) {\
-  rapidjson::Document doc;\
   Query::map_t& qmap = q.qmap();\
-  calib_constants_nda<T>(_ndarray_##N, doc, QUERY_PARAMETERS(qmap));\
+  _constants_##N = CalibCache::instance().get(QUERY_PARAMETERS(qmap));\
+  set_ndarray_constants<T>(_ndarray_##N, _constants_##N.get());\
   return _ndarray_##N;\
 }
 
@@ -88,7 +117,12 @@ GET_NDARRAY(uint32_t, uint32)
 const std::string& CalibParsDBWeb::get_string(Query& q) {
   //_default_msg(std::string("get_string(Query&)"));
   Query::map_t& qmap = q.qmap();
-  calib_constants(_string, _metadata, QUERY_PARAMETERS(qmap));
+  CalibConstantsPtr c = CalibCache::instance().get(QUERY_PARAMETERS(qmap));
+  if(c) {
+    _string.assign(c->data(), c->size());
+    _metadata.Parse(c->metadata().c_str());
+  }
+  else _string.clear();
   return _string;
 }
 
@@ -10,6 +10,7 @@
 
 #include "psalg/utils/Logger.hh" // MSG, LOGGER
 #include "psalg/calib/MDBWebUtils.hh"
+#include "psalg/calib/NpyIO.hh" // parse_npy_header, set_ndarray_npy, is_gzip, gunzip
 
 // psdaq/pydaq/README.JSON
 // psdaq/drp/drp_eval.cc
@@ -514,8 +515,34 @@ void calib_constants_nda(NDArray<T>& nda, rapidjson::Document& doc, const char*
   calib_constants(sresp, doc, det, exp, ctype, run, time_sec, vers, urlws);
   MSG(DEBUG, "doc: " << json_doc_to_string(doc));
 
+  // binary npy data (optionally gzip-compressed) carry their own shape and dtype; data without
+  // a valid npy header, also once inflated, are raw bytes of data_shape
+  std::string inflated;
+  const std::string* npy = 0;
+  NpyHeader h;
+  if(parse_npy_header(sresp.data(), sresp.size(), h)) npy = &sresp;
+  else if(is_gzip(sresp.data(), sresp.size()) && gunzip(sresp.data(), sresp.size(), inflated)
+          && parse_npy_header(inflated.data(), inflated.size(), h)) npy = &inflated;
+  if(npy) {
+    NDArray<T> a; // points to the data of npy, which are copied once to nda
+    if(!set_ndarray_npy(a, npy->data(), npy->size())) {
+      MSG(WARNING, "calib_constants_nda: can not decode " << npy->size() << " bytes of npy data for ctype " << ctype);
+      nda.set_shape();
+      return;
+    }
+    nda.set_shape(a.shape(), a.ndim());
+    nda.set_data_copy(a.const_data());
+    MSG(DEBUG, "nda: " << nda);
+    return;
+  }
+
   const std::string sshape = doc["data_shape"].GetString();
   nda.set_shape_string(sshape);
+  if(sresp.size() < nda.size()*sizeof(T)) {
+    MSG(WARNING, "calib_constants_nda: " << sresp.size() << " bytes of data do not fill shape " << sshape << " for ctype " << ctype);
+    nda.set_shape();
+    return;
+  }
   nda.set_data_copy(sresp.data()); // deep copy string/byte array to nda data buffer
 
   MSG(DEBUG, "nda: " << nda);
@@ -0,0 +1,287 @@
+//-------------------
+
+#include "psalg/calib/NpyIO.hh"
+#include "psalg/utils/Logger.hh" // for MSG
+
+#include <stdlib.h>    // strtoul
+#include <string.h>    // memcmp, strerror
+#include <unistd.h>    // close
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap
+#include <sys/stat.h>  // fstat
+#include <errno.h>
+#include <fstream>
+#include <sstream>
+
+#include <zlib.h>
+
+namespace psalg {
+
+//-------------------
+
+static const char NPY_MAGIC[] = "\x93NUMPY";
+
+template<> const char* npy_descr<float>   () {return "<f4";}
+template<> const char* npy_descr<double>  () {return "<f8";}
+template<> const char* npy_descr<int8_t>  () {return "|i1";}
+template<> const char* npy_descr<uint8_t> () {return "|u1";}
+template<> const char* npy_descr<int16_t> () {return "<i2";}
+template<> const char* npy_descr<uint16_t>() {return "<u2";}
+template<> const char* npy_descr<int32_t> () {return "<i4";}
+template<> const char* npy_descr<uint32_t>() {return "<u4";}
+template<> const char* npy_descr<int64_t> () {return "<i8";}
+template<> const char* npy_descr<uint64_t>() {return "<u8";}
+
+//-------------------
+
+bool is_npy(const char* buf, const size_t size) {
+  return size >= 10 && memcmp(buf, NPY_MAGIC, 6) == 0;
+}
+
+bool is_gzip(const char* buf, const size_t size) {
+  return size >= 2 && (uint8_t)buf[0] == 0x1f && (uint8_t)buf[1] == 0x8b;
+}
+
+//-------------------
+/// Value of key in the header dict, e.g. "'<f4'" for 'descr' or "(3, 4)" for 'shape'
+
+static std::string header_value(const std::string& dict, const char* key) {
+  std::string k("'"); k += key; k += "'";
+  size_t p = dict.find(k);
+  if(p == std::string::npos) return std::string();
+  p = dict.find(':', p+k.size());
+  if(p == std::string::npos) return std::string();
+  p = dict.find_first_not_of(' ', p+1);
+  if(p == std::string::npos) return std::string();
+  size_t e = (dict[p] == '(') ? dict.find(')', p)+1 : dict.find_first_of(",}", p);
+  if(e == std::string::npos || e == 0) return std::string();
+  return dict.substr(p, e-p);
+}
+
+bool parse_npy_header(const char* buf, const size_t size, NpyHeader& h) {
+  if(!is_npy(buf, size)) return false;
+  const uint8_t major = buf[6];
+  size_t hlen, hstart;
+  if(major == 1) {hlen = (uint8_t)buf[8] | ((uint8_t)buf[9]<<8); hstart = 10;}
+  else if(major == 2 || major == 3) {
+    if(size < 12) return false;
+    hlen = (uint8_t)buf[8] | ((uint8_t)buf[9]<<8) | ((uint32_t)(uint8_t)buf[10]<<16) | ((uint32_t)(uint8_t)buf[11]<<24);
+    hstart = 12;
+  }
+  else return false;
+  if(hstart + hlen > size) return false;
+
+  const std::string dict(buf+hstart, hlen);
+  std::string descr = header_value(dict, "descr");
+  std::string order = header_value(dict, "fortran_order");
+  std::string shape = header_value(dict, "shape");
+  if(descr.size() < 3 || shape.size() < 2) return false;
+
+  h.descr = descr.substr(1, descr.size()-2); // remove quotes
+  h.fortran_order = (order == "True");
+  h.shape.clear();
+  const char* p = shape.c_str()+1;
+  while(true) {
+    char* e;
+    unsigned long v = strtoul(p, &e, 10);
+    if(e == p) break;
+    h.shape.push_back(v);
+    p = e;
+    while(*p == ',' || *p == ' ') p++;
+  }
+  h.itemsize = strtoul(h.descr.c_str()+2, NULL, 10);
+  h.data_offset = hstart + hlen;
+  return h.itemsize > 0;
+}
+
+//-------------------
+
+std::string npy_header(const std::string& descr, const uint32_t* shape, const size_t ndim) {
+  std::stringstream ss;
+  ss << "{'descr': '" << descr << "', 'fortran_order': False, 'shape': (";
+  for(size_t i=0; i<ndim; i++) ss << shape[i] << ((ndim == 1 || i+1 < ndim) ? "," : "") << ((i+1 < ndim) ? " " : "");
+  ss << "), }";
+  std::string dict = ss.str();
+  // the data start is aligned to 64 bytes, the header ends with '\n'
+  const size_t total = (10 + dict.size() + 1 + 63)/64*64;
+  dict.append(total - 10 - dict.size() - 1, ' ');
+  dict += '\n';
+  std::string h(NPY_MAGIC, 6);
+  h += '\x01'; h += '\x00';
+  h += (char)(dict.size() & 0xff);
+  h += (char)(dict.size() >> 8);
+  return h + dict;
+}
+
+//-------------------
+
+bool gunzip(const char* buf, const size_t size, std::string& out) {
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  if(inflateInit2(&zs, 16+MAX_WBITS) != Z_OK) return false;
+  zs.next_in  = (Bytef*)buf;
+  zs.avail_in = size;
+  // the uncompressed size of a gzip member is in its last 4 bytes (modulo 4GB)
+  // and is only trusted up to the 1032:1 limit of deflate, a corrupt or foreign trailer can not claim gigabytes
+  size_t guess = (size >= 4) ? ((uint8_t)buf[size-4] | ((uint8_t)buf[size-3]<<8) | ((uint8_t)buf[size-2]<<16) | ((size_t)(uint8_t)buf[size-1]<<24)) : 0;
+  if(guess > 1032*size + 1024) guess = 1032*size + 1024;
+  out.resize(guess > size ? guess : 4*size + 1024);
+  size_t done = 0;
+  int ret;
+  do {
+    if(done == out.size()) out.resize(2*out.size());
+    zs.next_out  = (Bytef*)&out[done];
+    zs.avail_out = out.size() - done;
+    ret = inflate(&zs, Z_NO_FLUSH);
+    done = out.size() - zs.avail_out;
+  } while(ret == Z_OK);
+  inflateEnd(&zs);
+  out.resize(done);
+  return ret == Z_STREAM_END;
+}
+
+bool gzip(const char* buf, const size_t size, std::string& out, const int level) {
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  if(deflateInit2(&zs, level, Z_DEFLATED, 16+MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+  out.resize(deflateBound(&zs, size) + 32);
+  zs.next_in   = (Bytef*)buf;
+  zs.avail_in  = size;
+  zs.next_out  = (Bytef*)&out[0];
+  zs.avail_out = out.size();
+  int ret = deflate(&zs, Z_FINISH);
+  out.resize(out.size() - zs.avail_out);
+  deflateEnd(&zs);
+  return ret == Z_STREAM_END;
+}
+
+//-------------------
+
+template<typename T>
+bool set_ndarray_npy(NDArray<T>& nda, const char* buf, const size_t size) {
+  NpyHeader h;
+  if(!parse_npy_header(buf, size, h)) {
+    MSG(WARNING, "set_ndarray_npy: not a valid npy buffer");
+    return false;
+  }
+  if(h.descr != npy_descr<T>() || h.fortran_order) {
+    MSG(WARNING, "set_ndarray_npy: data of dtype " << h.descr << (h.fortran_order ? " in fortran order" : "")
+        << " do not match the array of " << npy_descr<T>());
+    return false;
+  }
+  if(h.shape.size() >= (size_t)NDArray<T>::MAXNDIM || h.data_offset + h.size()*sizeof(T) > size) {
+    MSG(WARNING, "set_ndarray_npy: shape does not match the size of the buffer");
+    return false;
+  }
+  nda.set_shape(h.shape.empty() ? 0 : &h.shape[0], h.shape.size());
+  nda.set_data_buffer(const_cast<char*>(buf + h.data_offset));
+  return true;
+}
+
+//-------------------
+
+template<typename T>
+NpyArray<T>::NpyArray() : _map(0), _map_size(0) {}
+
+template<typename T>
+NpyArray<T>::~NpyArray() {_release();}
+
+template<typename T>
+void NpyArray<T>::_release() {
+  if(_map) {munmap(_map, _map_size); _map = 0; _map_size = 0;}
+  std::string().swap(_buffer);
+}
+
+template<typename T>
+bool NpyArray<T>::_set_data(const char* buf, const size_t size, const std::string& name) {
+  if(is_gzip(buf, size)) {
+    std::string s;
+    if(!gunzip(buf, size, s)) {
+      MSG(WARNING, "NpyArray: can not inflate " << name);
+      _release();
+      return false;
+    }
+    _release();
+    _buffer.swap(s);
+  }
+  else if(buf != _map) _buffer.assign(buf, size);
+  const char* p = _map ? (const char*)_map : _buffer.data();
+  const size_t n = _map ? _map_size : _buffer.size();
+  if(!set_ndarray_npy(_nda, p, n)) {
+    MSG(WARNING, "NpyArray: can not load " << name);
+    _release();
+    return false;
+  }
+  return true;
+}
+
+template<typename T>
+bool NpyArray<T>::load(const std::string& fname) {
+  _release();
+  int fd = open(fname.c_str(), O_RDONLY);
+  if(fd < 0) {
+    MSG(WARNING, "NpyArray: can not open " << fname << ": " << strerror(errno));
+    return false;
+  }
+  struct stat st;
+  void* p = MAP_FAILED;
+  if(fstat(fd, &st) == 0 && st.st_size > 0)
+    p = mmap(0, st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(p == MAP_FAILED) {
+    MSG(WARNING, "NpyArray: can not map " << fname);
+    return false;
+  }
+  _map = p;
+  _map_size = st.st_size;
+  return _set_data((const char*)_map, _map_size, fname); // a compressed file is inflated and unmapped
+}
+
+template<typename T>
+bool NpyArray<T>::set_buffer(const char* buf, const size_t size) {
+  _release();
+  return _set_data(buf, size, "buffer");
+}
+
+//-------------------
+
+template<typename T>
+bool save_npy(const std::string& fname, const NDArray<T>& nda, const bool compress) {
+  std::string s = npy_header(npy_descr<T>(), nda.shape(), nda.ndim());
+  s.append((const char*)nda.const_data(), nda.size()*sizeof(T));
+  if(compress) {
+    std::string z;
+    if(!gzip(s.data(), s.size(), z)) return false;
+    s.swap(z);
+  }
+  std::ofstream f(fname.c_str(), std::ios::binary);
+  if(!f.write(s.data(), s.size())) {
+    MSG(WARNING, "save_npy: can not write " << fname);
+    return false;
+  }
+  return true;
+}
+
+//-------------------
+
+#define INST_NPYIO(T)\
+  template class NpyArray<T>;\
+  template bool set_ndarray_npy<T>(NDArray<T>&, const char*, const size_t);\
+  template bool save_npy<T>(const std::string&, const NDArray<T>&, const bool);
+
+INST_NPYIO(float)
+INST_NPYIO(double)
+INST_NPYIO(int8_t)
+INST_NPYIO(uint8_t)
+INST_NPYIO(int16_t)
+INST_NPYIO(uint16_t)
+INST_NPYIO(int32_t)
+INST_NPYIO(uint32_t)
+INST_NPYIO(int64_t)
+INST_NPYIO(uint64_t)
+
+//-------------------
+
+} // namespace psalg
+
+//-------------------
@@ -170,6 +170,10 @@ public:
   calib::CalibPars* calib_pars();
   calib::CalibPars* calib_pars_updated();
 
+  /// Gets all of the constants of the run into the process-wide CalibCache, in parallel;
+  /// returns the number of ctypes found
+  unsigned prefetch_calib_pars();
+
   const std::string& expname()   {return _expname;}
   const std::string& calibtype() {return _calibtype;}
   const unsigned     runnum()    {return _runnum;}
@@ -4,6 +4,7 @@
 
 #include <stdint.h>  // uint8_t, uint32_t, etc.
 #include "psalg/detector/AreaDetector.hh"
+#include "psalg/detector/CalibEngine.hh"
 
 //using namespace std;
 using namespace psalg;
@@ -156,7 +157,7 @@ private:
 
   NDArray<pnccd_raw_t>   _raw;
   NDArray<pnccd_calib_t> _calib;
-  const NDArray<pnccd_pedestals_t>* _peds;
+  CalibEngine _engine;
 
   void _panel_id(std::ostream& os, const int ind);
 
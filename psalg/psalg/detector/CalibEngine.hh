@@ -0,0 +1,124 @@
+#ifndef PSALG_CALIBENGINE_H
+#define PSALG_CALIBENGINE_H
+//-----------------------------
+
+/** Usage
+ *
+ * #include "psalg/detector/CalibEngine.hh"
+ *
+ * CalibEngine engine(CalibLayout::jungfrau(nmods));
+ * engine.set_pedestals(peds);    // [ngains][nsegs][rows][cols]
+ * engine.set_gain(gain);         // [ngains][nsegs][rows][cols]
+ * engine.set_status(status);     // [nsegs][rows][cols]
+ * engine.set_common_mode(cmpars);
+ * engine.calib(raw, calib);
+ *
+ * Computes, for every pixel,
+ *
+ *   calib = (raw - pedestal - common mode) * gain,  or 0 if the status is bad
+ *
+ * in a single pass over the raw data.  The rows of all segments are shared
+ * between the OpenMP threads, and each row is finished, common mode
+ * included, while it is in the L1 cache.  The per-pixel loops are written
+ * for the compiler to vectorize (omp simd).
+ *
+ * The common mode of a pixel is the median of the pedestal subtracted
+ * values of the good pixels, below a threshold, in the same row of its
+ * ASIC (or bank) - CalibLayout::cm_cols consecutive pixels.
+ * The common mode parameters are
+ *   [0] - mode, 0 to turn the correction off
+ *   [1] - threshold on |raw - pedestal| of the pixels in the median
+ *   [2] - the largest correction applied
+ *   [3] - the least number of pixels for a median (optional, default cm_cols/4)
+ *
+ * For the detectors with gain ranges (Jungfrau), the range of a pixel is
+ * in the raw value bits above data_mask, and selects its pedestal and gain.
+ * Range code 2 is invalid and gives 0.  Only the pixels in the highest gain
+ * range contribute to or get a common mode correction.
+ */
+
+#include <stdint.h>  // uint16_t
+#include <algorithm> // fill
+#include <vector>
+
+#include "psalg/calib/NDArray.hh"
+#include "psalg/calib/CalibParsTypes.hh"
+
+using namespace psalg;
+using namespace calib;
+
+namespace detector {
+
+//-----------------------------
+
+struct CalibLayout {
+  size_t   nsegs;      // panels, modules, 2x1s
+  size_t   rows;       // per segment
+  size_t   cols;       // per segment
+  size_t   cm_cols;    // pixels in an ASIC (or bank) row, which share a common mode
+  unsigned ngains;     // gain ranges, each with its own pedestals and gains
+  uint16_t data_mask;  // bits of the raw value which are data
+  unsigned gain_shift; // of the gain range bits, 0 if none
+
+  size_t size() const {return nsegs*rows*cols;}
+
+  static CalibLayout epix100a();
+  static CalibLayout jungfrau(const size_t nmods);
+  static CalibLayout cspad(const size_t nsegs=32);
+  static CalibLayout pnccd();
+};
+
+//-----------------------------
+
+class CalibEngine {
+public:
+  typedef uint16_t raw_t;
+  typedef float    calib_t;
+
+  CalibEngine(const CalibLayout& layout);
+  ~CalibEngine() {}
+
+  const CalibLayout& layout() const {return _layout;}
+
+  /// An empty array, or one of other than the expected size (with a warning),
+  /// sets the defaults: 0 pedestals, unit gain, good status, no common mode
+  template<typename T> void set_pedestals(const NDArray<T>& a) {
+    _set(_peds, _check(a.const_data(), a.size(), _peds.size(), "pedestals") ? a.const_data() : (const T*)0, 0);
+  }
+  template<typename T> void set_gain(const NDArray<T>& a) {
+    _set(_gain, _check(a.const_data(), a.size(), _gain.size(), "gain") ? a.const_data() : (const T*)0, 1);
+    _update_scale();
+  }
+  void set_status(const NDArray<pixel_status_t>& a);
+  void set_common_mode(const NDArray<common_mode_t>& a);
+
+  /// out has the size of raw, layout().size()
+  void calib(const raw_t* raw, calib_t* out) const;
+  bool calib(const NDArray<raw_t>& raw, NDArray<calib_t>& out) const;
+
+private:
+  bool _check(const void* data, const size_t size, const size_t expected, const char* what) const;
+  template<typename T> void _set(std::vector<float>& v, const T* p, float dflt) {
+    if(p) for(size_t i=0; i<v.size(); i++) v[i] = (float)p[i];
+    else  std::fill(v.begin(), v.end(), dflt);
+  }
+  void _update_scale();
+
+  template<bool GAINBITS>
+  void _row(const raw_t* raw, calib_t* out, const size_t pix, float* scratch) const;
+
+  CalibLayout         _layout;
+  std::vector<float>  _peds;   // [ngains][size]
+  std::vector<float>  _gain;   // [ngains][size]
+  std::vector<bool>   _good;   // [size]
+  std::vector<float>  _scale;  // gain, 0 for bad status
+  unsigned            _cm_mode;
+  float               _cm_thr;
+  float               _cm_max;
+  size_t              _cm_min;
+}; // class
+
+} // namespace detector
+
+#endif // PSALG_CALIBENGINE_H
+//-----------------------------
@@ -1,6 +1,7 @@
 #ifndef PSALG_DATASOURCESIMULATOR_H
 #define PSALG_DATASOURCESIMULATOR_H
 //-----------------------------
+// Events of ndarrays from text files; for synthetic xtc2 streams see XtcSimulator.hh
 
 #include <string>
 //#include "psalg/calib/NDArray.hh" // NDArray
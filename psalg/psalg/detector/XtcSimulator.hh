@@ -0,0 +1,196 @@
+#ifndef PSALG_XTCSIMULATOR_H
+#define PSALG_XTCSIMULATOR_H
+//-----------------------------
+
+/** Synthetic xtc2 streams for throughput tests of the DAQ and psana without hardware.
+ *
+ * Usage
+ *
+ * #include "psalg/detector/XtcSimulator.hh"
+ *
+ * XtcSimulator sim;
+ * unsigned sh[] = {8, 512, 1024};
+ * sim.add_area_detector("jungfrau", "jungfrau", sh, 3);   // uint16 raw [8][512][1024]
+ * sim.add_hsd("hsd", 4, 6000);                            // 4 channels of 6000 samples
+ * sim.add_bld("ebeam");                                   // ebeam-like scalars
+ * sim.set_damage(0.01);                                   // 1% of the contributions dropped
+ * sim.set_rate(1000.);                                    // L1Accepts per second, 0 - unpaced
+ *
+ * SimFileSink   file("sim.xtc2");               sim.run(file, 10000);
+ * SimSocketSink sock("127.0.0.1", 12345);       sim.run(sock, 10000);
+ * SimBufferPool pool(64, sim.max_dgram_size()); // workers: pool.pop(i) ... pool.release(i)
+ *                                               sim.run(pool, 10000);
+ *
+ * run() writes Configure, BeginRun, BeginStep, Enable, the L1Accepts,
+ * Disable, EndStep and EndRun; transition() and l1accept() build single
+ * datagrams into the caller's buffer.
+ *
+ * Each detector is a node (nodeId 1, 2, ...) with one segment, and its
+ * Names are in Configure:
+ *   area - "raw" uint16 array of the given shape: pedestal, noise and a few photons
+ *   hsd  - "eventHeader" and "chanNN" raw streams of Pds::HSD::StreamHeader and
+ *          uint16 samples: a baseline with noise and one pulse per channel
+ *   bld  - "damageMask" and ebeam-like doubles
+ * BeginRun has the "runinfo" of experiment and run number.
+ *
+ * A damaged contribution has no data in the event, and the DroppedContribution
+ * bit is set in the damage of the datagram.
+ */
+
+#include <stdint.h>
+#include <stdio.h>   // FILE
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "xtcdata/xtc/Dgram.hh"
+#include "xtcdata/xtc/NamesLookup.hh"
+#include "xtcdata/xtc/TransitionId.hh"
+
+namespace detector {
+
+//-----------------------------
+
+/// Destination of the datagrams of XtcSimulator::run
+class SimSink {
+public:
+  virtual ~SimSink() {}
+  /// Returns false to stop the run
+  virtual bool put(const XtcData::Dgram& dg) = 0;
+  /// Buffer for the next datagram, 0 to use the buffer of the simulator
+  virtual void* buffer(size_t& size) {return 0;}
+};
+
+/// Appends the datagrams to an xtc2 file
+class SimFileSink : public SimSink {
+public:
+  SimFileSink(const char* fname);
+  virtual ~SimFileSink();
+  bool ok() const {return _file != 0;}
+  virtual bool put(const XtcData::Dgram& dg);
+private:
+  FILE* _file;
+};
+
+/// Sends the datagrams over a TCP connection, back to back as in a file
+class SimSocketSink : public SimSink {
+public:
+  SimSocketSink(const char* host, unsigned port);
+  virtual ~SimSocketSink();
+  bool ok() const {return _fd >= 0;}
+  virtual bool put(const XtcData::Dgram& dg);
+private:
+  int _fd;
+};
+
+/// Fixed number of fixed size buffers, filled in place by the simulator
+/// and handed to consumer threads in order, like the pebble of the DRP MemPool
+class SimBufferPool : public SimSink {
+public:
+  SimBufferPool(unsigned nbuffers, size_t bufsize);
+  virtual ~SimBufferPool();
+
+  /// Next datagram and its buffer index, 0 after close() once all are taken
+  XtcData::Dgram* pop(unsigned& index);
+  /// Returns the buffer to the pool
+  void release(unsigned index);
+  /// Wakes up the consumers waiting in pop()
+  void close();
+
+  unsigned nbuffers() const {return _nbuffers;}
+  size_t   bufsize()  const {return _bufsize;}
+
+  virtual void* buffer(size_t& size);
+  virtual bool put(const XtcData::Dgram& dg);
+
+  SimBufferPool(const SimBufferPool&) = delete;
+  SimBufferPool& operator = (const SimBufferPool&) = delete;
+
+private:
+  unsigned _nbuffers;
+  size_t   _bufsize;
+  char*    _buffers;
+  unsigned _current;             // buffer being filled by the producer
+  std::deque<unsigned> _free;
+  std::deque<unsigned> _full;
+  bool     _closed;
+  std::mutex _mutex;
+  std::condition_variable _cv_free;
+  std::condition_variable _cv_full;
+};
+
+//-----------------------------
+
+class XtcSimulator {
+public:
+
+  enum Kind {AREA, HSD, BLD};
+
+  struct Det {
+    Kind        kind;
+    std::string name;
+    std::string type;
+    unsigned    nodeId;
+    unsigned    shape[XtcData::MaxRank];
+    unsigned    rank;
+    uint64_t    ndamaged;
+  };
+
+  XtcSimulator(const char* expt="tstx00117", unsigned runnum=1, unsigned seed=1);
+  ~XtcSimulator() {}
+
+  void add_area_detector(const char* name, const char* type, const unsigned* shape, unsigned rank);
+  void add_hsd(const char* name, unsigned nchannels, unsigned nsamples);
+  void add_bld(const char* name);
+
+  /// Probability for each contribution of an L1Accept to be dropped
+  void set_damage(double fraction) {_damage = fraction;}
+  /// L1Accepts per second in run(), 0 for as fast as possible
+  void set_rate(double hz) {_rate = hz;}
+
+  /// Transition datagram, Configure with the Names of all detectors, in buf
+  XtcData::Dgram& transition(XtcData::TransitionId::Value tid, void* buf, size_t size);
+  /// Next L1Accept datagram in buf
+  XtcData::Dgram& l1accept(void* buf, size_t size);
+
+  /// Writes a run of nevents L1Accepts to sink, returns the number of datagrams written
+  uint64_t run(SimSink& sink, uint64_t nevents);
+
+  /// Largest datagram l1accept can build
+  size_t max_dgram_size() const;
+
+  const std::vector<Det>& detectors() const {return _dets;}
+  uint64_t nevents()  const {return _nevents;}
+  uint64_t ndamaged() const {return _ndamaged;}
+
+  XtcSimulator(const XtcSimulator&) = delete;
+  XtcSimulator& operator = (const XtcSimulator&) = delete;
+
+private:
+
+  uint32_t _random() {_seed ^= _seed << 13; _seed ^= _seed >> 17; _seed ^= _seed << 5; return _seed;}
+  XtcData::TimeStamp _next_time();
+  void _add_names(XtcData::Xtc& xtc, const void* bufEnd, Det& det);
+  void _add_runinfo_names(XtcData::Xtc& xtc, const void* bufEnd);
+  void _add_data(XtcData::Xtc& xtc, const void* bufEnd, const Det& det);
+
+  std::string _expt;
+  unsigned    _runnum;
+  uint32_t    _seed;
+  double      _damage;
+  double      _rate;
+  uint64_t    _time_ns;     // of the last datagram
+  uint64_t    _nevents;
+  uint64_t    _ndamaged;
+  std::vector<Det>      _dets;
+  std::vector<uint16_t> _noise; // table of noise values, read from random offsets
+  XtcData::NamesLookup  _namesLookup;
+};
+
+//-----------------------------
+
+} // namespace detector
+
+#endif // PSALG_XTCSIMULATOR_H
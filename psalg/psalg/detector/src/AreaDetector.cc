@@ -4,6 +4,7 @@
 
 #include "psalg/detector/AreaDetector.hh"
 #include "psalg/utils/Logger.hh" // for MSG
+#include "psalg/calib/CalibCache.hh"
 
 using namespace std;
 using namespace psalg;
@@ -467,6 +468,12 @@ calib::CalibPars* AreaDetector::calib_pars_updated() {
   return calib_pars();
 }
 
+unsigned AreaDetector::prefetch_calib_pars() {
+  // the same parameters as query(), so that the constants are found by calib_pars()
+  return calib::CalibCache::instance().prefetch(detname().c_str(), expname().c_str(),
+           calib::CalibCache::area_detector_ctypes(), runnum());
+}
+
 //-------------------
 
 } // namespace detector
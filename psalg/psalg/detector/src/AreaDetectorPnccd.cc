@@ -16,18 +16,18 @@ namespace detector {
 //-----------------------------
 
 AreaDetectorPnccd::AreaDetectorPnccd(const std::string& detname, XtcData::ConfigIter& configo)
-  : AreaDetector(detname, configo) {
+  : AreaDetector(detname, configo), _engine(CalibLayout::pnccd()) {
   MSG(DEBUG, "In c-tor AreaDetectorPnccd(detname, configo) for " << detname);
   //process_config();
 }
 
 AreaDetectorPnccd::AreaDetectorPnccd(const std::string& detname)
-  : AreaDetector(detname) {
+  : AreaDetector(detname), _engine(CalibLayout::pnccd()) {
   MSG(DEBUG, "In c-tor AreaDetectorPnccd(detname) for " << detname);
 }
 
 AreaDetectorPnccd::AreaDetectorPnccd()
-  : AreaDetector() {
+  : AreaDetector(), _engine(CalibLayout::pnccd()) {
   MSG(DEBUG, "In default c-tor AreaDetectorPnccd()");
 }
 
@@ -323,15 +323,7 @@ NDArray<pnccd_raw_t>& AreaDetectorPnccd::raw(XtcData::DescData& dd) {
 
 NDArray<pnccd_calib_t>& AreaDetectorPnccd::calib(XtcData::DescData& dd) {
   _make_raw(dd);
-  unsigned n = size();
-  _calib.reserve_data_buffer(n);
-  _calib.set_shape(shape(), ndim());
-
-  pnccd_raw_t*   pr = _raw.data();
-  pnccd_raw_t*   pr_last = &pr[n];
-  pnccd_calib_t* pc = _calib.data();
-  const pnccd_pedestals_t* pp = (*_peds).const_data();
-  for(; pr<pr_last; pr++, pc++, pp++) *pc = (pnccd_calib_t)*pr - (pnccd_calib_t)*pp;
+  _engine.calib(_raw, _calib);
   return _calib;
 }
 
@@ -341,7 +333,7 @@ void AreaDetectorPnccd::load_calib_constants() {
   set_calibtype("pedestals");
   const NDArray<pnccd_pedestals_t>& a = pedestals_d();
   std::cout << "== det.pedestals_d : " << a << '\n';
-  _peds = &a;
+  _engine.set_pedestals(a);
 }
 
 //-------------------
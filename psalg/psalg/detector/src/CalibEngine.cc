@@ -0,0 +1,188 @@
+//-----------------------------
+
+#include <cmath>      // fabs
+#include <omp.h>
+
+#include "psalg/detector/CalibEngine.hh"
+#include "psalg/utils/Logger.hh" // for MSG
+
+using namespace std;
+using namespace psalg;
+
+namespace detector {
+
+//-----------------------------
+
+CalibLayout CalibLayout::epix100a() {
+  // 2x2 ASICs of 352x384, read out in banks of 96 columns
+  CalibLayout l = {1, 704, 768, 96, 1, 0xffff, 0};
+  return l;
+}
+
+CalibLayout CalibLayout::jungfrau(const size_t nmods) {
+  // 2x4 ASICs of 256x256 per module, gain range in bits 14-15
+  CalibLayout l = {nmods, 512, 1024, 256, 3, 0x3fff, 14};
+  return l;
+}
+
+CalibLayout CalibLayout::cspad(const size_t nsegs) {
+  // 2x1 sensors of two 185x194 ASICs
+  CalibLayout l = {nsegs, 185, 388, 194, 1, 0x3fff, 0};
+  return l;
+}
+
+CalibLayout CalibLayout::pnccd() {
+  // 512x512 quadrants read out by CAMEX chips of 128 channels
+  CalibLayout l = {4, 512, 512, 128, 1, 0xffff, 0};
+  return l;
+}
+
+//-----------------------------
+
+CalibEngine::CalibEngine(const CalibLayout& layout)
+  : _layout(layout)
+  , _peds (layout.ngains*layout.size(), 0)
+  , _gain (layout.ngains*layout.size(), 1)
+  , _good (layout.size(), true)
+  , _scale(layout.ngains*layout.size(), 1)
+  , _cm_mode(0)
+  , _cm_thr(0)
+  , _cm_max(0)
+  , _cm_min(0) {
+  MSG(DEBUG, "In c-tor CalibEngine for " << layout.nsegs << " x " << layout.rows << " x " << layout.cols);
+}
+
+//-------------------
+
+bool CalibEngine::_check(const void* data, const size_t size, const size_t expected, const char* what) const {
+  if(!data) return false; // empty array
+  if(size == expected) return true;
+  MSG(WARNING, "CalibEngine " << what << " size " << size << " != " << expected << ", use defaults");
+  return false;
+}
+
+//-------------------
+
+void CalibEngine::set_status(const NDArray<pixel_status_t>& a) {
+  const pixel_status_t* p = _check(a.const_data(), a.size(), _good.size(), "status") ? a.const_data() : 0;
+  for(size_t i=0; i<_good.size(); i++) _good[i] = p ? p[i]==0 : true;
+  _update_scale();
+}
+
+//-------------------
+
+void CalibEngine::set_common_mode(const NDArray<common_mode_t>& a) {
+  const common_mode_t* p = a.const_data();
+  const size_t n = p ? a.size() : 0;
+  _cm_mode = (n>2) ? (unsigned)p[0] : 0;
+  _cm_thr  = (n>2) ? (float)p[1] : 0;
+  _cm_max  = (n>2) ? (float)p[2] : 0;
+  _cm_min  = (n>3) ? (size_t)p[3] : _layout.cm_cols/4;
+  if(_cm_min < 1) _cm_min = 1;
+  if(n && n<3) MSG(WARNING, "CalibEngine common mode needs at least 3 parameters, got " << n);
+}
+
+//-------------------
+
+void CalibEngine::_update_scale() {
+  const size_t size = _layout.size();
+  for(size_t g=0; g<_layout.ngains; g++)
+    for(size_t i=0; i<size; i++)
+      _scale[g*size+i] = _good[i] ? _gain[g*size+i] : 0;
+}
+
+//-------------------
+
+/// Gain range, 0/1/2, of Jungfrau range codes 0/1/3; code 2 is invalid
+static inline unsigned _range(const uint16_t code) {return code - (code>>1);}
+
+template<bool GAINBITS>
+void CalibEngine::_row(const raw_t* raw, calib_t* out, const size_t pix, float* scratch) const {
+  const size_t   cols  = _layout.cols;
+  const size_t   size  = _layout.size();
+  const unsigned shift = _layout.gain_shift;
+  const raw_t    dmask = _layout.data_mask;
+  const float*   ped   = &_peds [pix];
+  const float*   scale = &_scale[pix];
+
+  if(!_cm_mode) {
+    #pragma omp simd
+    for(size_t c=0; c<cols; c++) {
+      const unsigned code = GAINBITS ? (raw[c]>>shift)&3 : 0;
+      const size_t   i    = GAINBITS ? _range(code)*size+c : c;
+      const float    v    = ((float)(raw[c]&dmask) - ped[i]) * scale[i];
+      out[c] = GAINBITS ? v * (float)(code!=2) : v;
+    }
+    return;
+  }
+
+  #pragma omp simd
+  for(size_t c=0; c<cols; c++) {
+    const size_t i = GAINBITS ? _range((raw[c]>>shift)&3)*size+c : c;
+    out[c] = (float)(raw[c]&dmask) - ped[i];
+  }
+
+  for(size_t c0=0; c0<cols; c0+=_layout.cm_cols) {
+    const size_t c1 = std::min(c0+_layout.cm_cols, cols);
+
+    size_t n = 0;
+    for(size_t c=c0; c<c1; c++) {
+      if(GAINBITS && (raw[c]>>shift)) continue;
+      if(scale[c]!=0 && fabs(out[c])<_cm_thr) scratch[n++] = out[c];
+    }
+
+    float cm = 0;
+    if(n >= _cm_min) {
+      std::nth_element(scratch, scratch+n/2, scratch+n);
+      cm = scratch[n/2];
+      if(fabs(cm) > _cm_max) cm = 0;
+    }
+
+    #pragma omp simd
+    for(size_t c=c0; c<c1; c++) {
+      const unsigned code = GAINBITS ? (raw[c]>>shift)&3 : 0;
+      const size_t   i    = GAINBITS ? _range(code)*size+c : c;
+      const float    v    = (out[c] - (code ? 0 : cm)) * scale[i];
+      out[c] = GAINBITS ? v * (float)(code!=2) : v;
+    }
+  }
+}
+
+//-------------------
+
+void CalibEngine::calib(const raw_t* raw, calib_t* out) const {
+  const size_t cols  = _layout.cols;
+  const long   nrows = (long)(_layout.nsegs*_layout.rows);
+  const bool   gainbits = _layout.gain_shift != 0;
+
+  #pragma omp parallel if(_layout.size() > (1<<16))
+  {
+    std::vector<float> scratch(_layout.cm_cols);
+
+    #pragma omp for schedule(static)
+    for(long r=0; r<nrows; r++) {
+      const size_t pix = r*cols;
+      if(gainbits) _row<true> (&raw[pix], &out[pix], pix, scratch.data());
+      else         _row<false>(&raw[pix], &out[pix], pix, scratch.data());
+    }
+  }
+}
+
+//-------------------
+
+bool CalibEngine::calib(const NDArray<raw_t>& raw, NDArray<calib_t>& out) const {
+  if(raw.size() != _layout.size()) {
+    MSG(ERROR, "CalibEngine raw size " << raw.size() << " != " << _layout.size());
+    return false;
+  }
+  out.reserve_data_buffer(raw.size());
+  out.set_shape(raw.shape(), raw.ndim());
+  calib(raw.const_data(), out.data());
+  return true;
+}
+
+//-------------------
+
+} // namespace detector
+
+//-----------------------------
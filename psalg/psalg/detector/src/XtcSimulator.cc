@@ -0,0 +1,442 @@
+//-------------------
+
+#include "psalg/detector/XtcSimulator.hh"
+#include "psalg/utils/Logger.hh" // for MSG
+
+#include <string.h>      // memcpy, strerror
+#include <errno.h>
+#include <time.h>        // clock_gettime
+#include <unistd.h>      // close
+#include <netdb.h>       // getaddrinfo
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h> // TCP_NODELAY
+#include <algorithm>     // min
+#include <chrono>
+#include <new>           // placement new
+#include <thread>        // sleep_until
+
+#include "xtcdata/xtc/DescData.hh"
+#include "xtcdata/xtc/ShapesData.hh"
+#include "xtcdata/xtc/VarDef.hh"
+
+#ifndef POSIX_TIME_AT_EPICS_EPOCH
+#define POSIX_TIME_AT_EPICS_EPOCH 631152000u
+#endif
+
+using namespace XtcData;
+
+namespace detector {
+
+//-------------------
+//  Sinks
+//-------------------
+
+SimFileSink::SimFileSink(const char* fname) : _file(fopen(fname, "w")) {
+  if(!_file) MSG(ERROR, "SimFileSink: can not open " << fname << ": " << strerror(errno));
+}
+
+SimFileSink::~SimFileSink() {
+  if(_file) fclose(_file);
+}
+
+bool SimFileSink::put(const Dgram& dg) {
+  return _file && fwrite(&dg, sizeof(dg) + dg.xtc.sizeofPayload(), 1, _file) == 1;
+}
+
+//-------------------
+
+SimSocketSink::SimSocketSink(const char* host, unsigned port) : _fd(-1) {
+  struct addrinfo hints, *res;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family   = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  const std::string sport = std::to_string(port);
+  if(getaddrinfo(host, sport.c_str(), &hints, &res) != 0) {
+    MSG(ERROR, "SimSocketSink: unknown host " << host);
+    return;
+  }
+  _fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if(_fd >= 0 && connect(_fd, res->ai_addr, res->ai_addrlen) != 0) {
+    MSG(ERROR, "SimSocketSink: can not connect to " << host << ':' << port << ": " << strerror(errno));
+    close(_fd);
+    _fd = -1;
+  }
+  freeaddrinfo(res);
+  int one = 1;
+  if(_fd >= 0) setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+SimSocketSink::~SimSocketSink() {
+  if(_fd >= 0) close(_fd);
+}
+
+bool SimSocketSink::put(const Dgram& dg) {
+  const char* p = (const char*)&dg;
+  size_t size = sizeof(dg) + dg.xtc.sizeofPayload();
+  while(_fd >= 0 && size) {
+    ssize_t n = send(_fd, p, size, MSG_NOSIGNAL);
+    if(n < 0) {
+      if(errno == EINTR) continue;
+      MSG(WARNING, "SimSocketSink: " << strerror(errno));
+      return false;
+    }
+    p += n;
+    size -= n;
+  }
+  return _fd >= 0;
+}
+
+//-------------------
+
+SimBufferPool::SimBufferPool(unsigned nbuffers, size_t bufsize)
+  : _nbuffers(nbuffers), _bufsize(bufsize), _buffers(new char[nbuffers*bufsize]), _current(0), _closed(false) {
+  for(unsigned i=0; i<nbuffers; i++) _free.push_back(i);
+}
+
+SimBufferPool::~SimBufferPool() {
+  delete[] _buffers;
+}
+
+void* SimBufferPool::buffer(size_t& size) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _cv_free.wait(lock, [this]{return !_free.empty();});
+  _current = _free.front();
+  _free.pop_front();
+  size = _bufsize;
+  return _buffers + _current*_bufsize;
+}
+
+bool SimBufferPool::put(const Dgram& dg) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _full.push_back(_current);
+  }
+  _cv_full.notify_one();
+  return true;
+}
+
+Dgram* SimBufferPool::pop(unsigned& index) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _cv_full.wait(lock, [this]{return !_full.empty() || _closed;});
+  if(_full.empty()) return 0;
+  index = _full.front();
+  _full.pop_front();
+  return (Dgram*)(_buffers + index*_bufsize);
+}
+
+void SimBufferPool::release(unsigned index) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _free.push_back(index);
+  }
+  _cv_free.notify_one();
+}
+
+void SimBufferPool::close() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _closed = true;
+  }
+  _cv_full.notify_all();
+}
+
+//-------------------
+//  Names of the detectors
+//-------------------
+
+class SimAreaDef : public VarDef {
+public:
+  SimAreaDef(unsigned rank) {
+    NameVec.push_back({"raw", Name::UINT16, (int)rank});
+  }
+};
+
+class SimHsdDef : public VarDef {
+public:
+  SimHsdDef(unsigned nchannels) {
+    Alg alg("fpga", 1, 2, 3);
+    char chanName[8];
+    NameVec.push_back({"eventHeader", Name::UINT32, 1});
+    for(unsigned i=0; i<nchannels; i++) {
+      snprintf(chanName, sizeof(chanName), "chan%2.2d", i);
+      NameVec.push_back({chanName, alg});
+    }
+  }
+};
+
+class SimBldDef : public VarDef {
+public:
+  enum index {damageMask, ebeamCharge, ebeamL3Energy, ebeamLTUPosX, ebeamLTUPosY, ebeamPhotonEnergy};
+  SimBldDef() {
+    NameVec.push_back({"damageMask",        Name::UINT32});
+    NameVec.push_back({"ebeamCharge",       Name::DOUBLE});
+    NameVec.push_back({"ebeamL3Energy",     Name::DOUBLE});
+    NameVec.push_back({"ebeamLTUPosX",      Name::DOUBLE});
+    NameVec.push_back({"ebeamLTUPosY",      Name::DOUBLE});
+    NameVec.push_back({"ebeamPhotonEnergy", Name::DOUBLE});
+  }
+};
+
+class SimRunInfoDef : public VarDef {
+public:
+  enum index {expt, runnum};
+  SimRunInfoDef() {
+    NameVec.push_back({"expt",   Name::CHARSTR, 1});
+    NameVec.push_back({"runnum", Name::UINT32});
+  }
+};
+
+static const unsigned RUNINFO_NODEID = 0;
+static const unsigned NOISE_SIZE     = 1<<16;
+static const unsigned HSD_PULSE_SIZE = 32;
+
+//-------------------
+//  XtcSimulator
+//-------------------
+
+XtcSimulator::XtcSimulator(const char* expt, unsigned runnum, unsigned seed)
+  : _expt(expt), _runnum(runnum), _seed(seed ? seed : 1), _damage(0), _rate(0),
+    _nevents(0), _ndamaged(0), _noise(NOISE_SIZE) {
+  struct timespec t;
+  clock_gettime(CLOCK_REALTIME, &t);
+  // TimeStamps count from the EPICS epoch, as those of the DAQ
+  _time_ns = (t.tv_sec - POSIX_TIME_AT_EPICS_EPOCH)*1000000000ULL + t.tv_nsec;
+  // pedestal 1000, approximately gaussian noise of rms 9 from a sum of four bytes
+  for(unsigned i=0; i<NOISE_SIZE; i++) {
+    uint32_t r = _random();
+    _noise[i] = 1000 + ((r&0xff) + ((r>>8)&0xff) + ((r>>16)&0xff) + (r>>24))/16 - 32;
+  }
+}
+
+//-------------------
+
+void XtcSimulator::add_area_detector(const char* name, const char* type, const unsigned* shape, unsigned rank) {
+  // Name of xtcdata aborts on arrays of rank MaxRank or more
+  if(rank >= MaxRank) {
+    MSG(ERROR, "XtcSimulator: rank " << rank << " of " << name << " is not below " << MaxRank << ", not added");
+    return;
+  }
+  Det d;
+  d.kind = AREA; d.name = name; d.type = type; d.nodeId = _dets.size()+1;
+  d.rank = rank;
+  for(unsigned i=0; i<d.rank; i++) d.shape[i] = shape[i];
+  d.ndamaged = 0;
+  _dets.push_back(d);
+}
+
+void XtcSimulator::add_hsd(const char* name, unsigned nchannels, unsigned nsamples) {
+  Det d;
+  d.kind = HSD; d.name = name; d.type = "hsd"; d.nodeId = _dets.size()+1;
+  // an even number of samples keeps the streams 4-byte aligned
+  d.rank = 2; d.shape[0] = nchannels; d.shape[1] = (nsamples < HSD_PULSE_SIZE) ? HSD_PULSE_SIZE : (nsamples+1)&~1u;
+  d.ndamaged = 0;
+  _dets.push_back(d);
+}
+
+void XtcSimulator::add_bld(const char* name) {
+  Det d;
+  d.kind = BLD; d.name = name; d.type = name; d.nodeId = _dets.size()+1;
+  d.rank = 0;
+  d.ndamaged = 0;
+  _dets.push_back(d);
+}
+
+//-------------------
+
+size_t XtcSimulator::max_dgram_size() const {
+  size_t size = sizeof(Dgram) + 0x10000; // headers and shapes, Configure
+  for(size_t i=0; i<_dets.size(); i++) {
+    const Det& d = _dets[i];
+    if(d.kind == AREA) {
+      size_t n = 1; for(unsigned k=0; k<d.rank; k++) n *= d.shape[k];
+      size += n*sizeof(uint16_t);
+    }
+    else if(d.kind == HSD) size += d.shape[0]*(16 + d.shape[1]*sizeof(uint16_t) + 4);
+  }
+  return size;
+}
+
+//-------------------
+
+TimeStamp XtcSimulator::_next_time() {
+  // beam period of the rate, or of 1 MHz when unpaced
+  _time_ns += (_rate > 0) ? uint64_t(1e9/_rate) : 1000;
+  return TimeStamp(unsigned(_time_ns/1000000000), unsigned(_time_ns%1000000000));
+}
+
+//-------------------
+
+void XtcSimulator::_add_runinfo_names(Xtc& xtc, const void* bufEnd) {
+  Alg alg("runinfo", 0, 0, 1);
+  NamesId namesId(RUNINFO_NODEID, 0);
+  Names& names = *new(xtc, bufEnd) Names(bufEnd, "runinfo", alg, "runinfo", "", namesId);
+  SimRunInfoDef def;
+  names.add(xtc, bufEnd, def);
+  _namesLookup[namesId] = NameIndex(names);
+}
+
+void XtcSimulator::_add_names(Xtc& xtc, const void* bufEnd, Det& det) {
+  Alg alg("raw", 2, 0, 0);
+  NamesId namesId(det.nodeId, 0);
+  const std::string detId = "sim" + std::to_string(det.nodeId);
+  Names& names = *new(xtc, bufEnd) Names(bufEnd, det.name.c_str(), alg, det.type.c_str(), detId.c_str(), namesId);
+  if(det.kind == AREA)     {SimAreaDef def(det.rank);    names.add(xtc, bufEnd, def);}
+  else if(det.kind == HSD) {SimHsdDef def(det.shape[0]); names.add(xtc, bufEnd, def);}
+  else                     {SimBldDef def;               names.add(xtc, bufEnd, def);}
+  _namesLookup[namesId] = NameIndex(names);
+}
+
+//-------------------
+
+void XtcSimulator::_add_data(Xtc& xtc, const void* bufEnd, const Det& det) {
+  NamesId namesId(det.nodeId, 0);
+  CreateData cd(xtc, bufEnd, _namesLookup, namesId);
+  unsigned shape[MaxRank];
+
+  if(det.kind == AREA) {
+    for(unsigned k=0; k<det.rank; k++) shape[k] = det.shape[k];
+    Array<uint16_t> a = cd.allocate<uint16_t>(0, shape);
+    uint16_t* p = a.data();
+    size_t n = a.num_elem();
+    // noise from a random offset of the table, and a photon in ~1e-4 of the pixels
+    for(size_t i=0; i<n;) {
+      size_t off = _random()%NOISE_SIZE;
+      size_t len = std::min(n-i, size_t(NOISE_SIZE-off));
+      memcpy(p+i, &_noise[off], len*sizeof(uint16_t));
+      i += len;
+    }
+    for(size_t i=n/10000+1; i; i--) p[_random()%n] += 150 + _random()%100;
+  }
+
+  else if(det.kind == HSD) {
+    shape[0] = 2;
+    Array<uint32_t> h = cd.allocate<uint32_t>(0, shape);
+    h(0) = 1<<20; // raw stream only
+    h(1) = 1u<<31; // JESD status ok
+    const unsigned nsamples = det.shape[1];
+    for(unsigned ch=0; ch<det.shape[0]; ch++) {
+      shape[0] = 4*sizeof(uint32_t) + nsamples*sizeof(uint16_t);
+      Array<uint8_t> a = cd.allocate<uint8_t>(1+ch, shape);
+      uint32_t* sh = (uint32_t*)a.data(); // Pds::HSD::StreamHeader
+      sh[0] = nsamples; sh[1] = 0; sh[2] = 0; sh[3] = 0;
+      uint16_t* s = (uint16_t*)(sh+4);
+      for(unsigned i=0; i<nsamples;) {
+        unsigned off = _random()%NOISE_SIZE;
+        unsigned len = std::min(nsamples-i, NOISE_SIZE-off);
+        memcpy(s+i, &_noise[off], len*sizeof(uint16_t));
+        i += len;
+      }
+      // one pulse of a triangular shape and random height
+      const unsigned t0 = _random()%(nsamples-HSD_PULSE_SIZE+1);
+      const unsigned amp = 200 + _random()%800;
+      for(unsigned i=0; i<HSD_PULSE_SIZE; i++) {
+        unsigned w = (i < HSD_PULSE_SIZE/4) ? 4*i : (HSD_PULSE_SIZE-i)*4/3;
+        s[t0+i] += amp*w/HSD_PULSE_SIZE;
+      }
+    }
+  }
+
+  else {
+    const double r = (_random()%1000)*1e-3 - 0.5;
+    cd.set_value(SimBldDef::damageMask,        (uint32_t)0);
+    cd.set_value(SimBldDef::ebeamCharge,       0.25 + 0.01*r);
+    cd.set_value(SimBldDef::ebeamL3Energy,     10000. + 20.*r);
+    cd.set_value(SimBldDef::ebeamLTUPosX,      0.1*r);
+    cd.set_value(SimBldDef::ebeamLTUPosY,     -0.1*r);
+    cd.set_value(SimBldDef::ebeamPhotonEnergy, 9500. + 20.*r);
+  }
+}
+
+//-------------------
+
+Dgram& XtcSimulator::transition(TransitionId::Value tid, void* buf, size_t size) {
+  const void* bufEnd = (char*)buf + size;
+  Transition tr(Dgram::Event, tid, _next_time(), 1);
+  Dgram& dg = *new(buf) Dgram(tr, Xtc(TypeId(TypeId::Parent, 0)));
+
+  if(tid == TransitionId::Configure) {
+    _namesLookup.clear();
+    _add_runinfo_names(dg.xtc, bufEnd);
+    for(size_t i=0; i<_dets.size(); i++) _add_names(dg.xtc, bufEnd, _dets[i]);
+  }
+  else if(tid == TransitionId::BeginRun) {
+    NamesId namesId(RUNINFO_NODEID, 0);
+    CreateData runinfo(dg.xtc, bufEnd, _namesLookup, namesId);
+    runinfo.set_string(SimRunInfoDef::expt, _expt.c_str());
+    runinfo.set_value(SimRunInfoDef::runnum, (uint32_t)_runnum);
+  }
+  return dg;
+}
+
+Dgram& XtcSimulator::l1accept(void* buf, size_t size) {
+  const void* bufEnd = (char*)buf + size;
+  Transition tr(Dgram::Event, TransitionId::L1Accept, _next_time(), 1);
+  Dgram& dg = *new(buf) Dgram(tr, Xtc(TypeId(TypeId::Parent, 0)));
+
+  const uint32_t threshold = uint32_t(_damage*4294967295.);
+  for(size_t i=0; i<_dets.size(); i++) {
+    if(_damage > 0 && _random() <= threshold) {
+      dg.xtc.damage.increase(Damage::DroppedContribution);
+      _dets[i].ndamaged++;
+      _ndamaged++;
+      continue;
+    }
+    _add_data(dg.xtc, bufEnd, _dets[i]);
+  }
+  _nevents++;
+  return dg;
+}
+
+//-------------------
+
+uint64_t XtcSimulator::run(SimSink& sink, uint64_t nevents) {
+  std::vector<char> own;
+  uint64_t ndgrams = 0;
+
+  auto next_buffer = [&](size_t& size) -> void* {
+    void* p = sink.buffer(size);
+    if(p) return p;
+    if(own.empty()) own.resize(max_dgram_size());
+    size = own.size();
+    return &own[0];
+  };
+  auto put_transition = [&](TransitionId::Value tid) -> bool {
+    size_t size;
+    void* p = next_buffer(size);
+    if(!sink.put(transition(tid, p, size))) return false;
+    ndgrams++;
+    return true;
+  };
+
+  static const TransitionId::Value begin[] = {TransitionId::Configure, TransitionId::BeginRun,
+                                              TransitionId::BeginStep, TransitionId::Enable};
+  static const TransitionId::Value end[]   = {TransitionId::Disable, TransitionId::EndStep,
+                                              TransitionId::EndRun};
+  for(unsigned i=0; i<sizeof(begin)/sizeof(begin[0]); i++)
+    if(!put_transition(begin[i])) return ndgrams;
+
+  typedef std::chrono::steady_clock clock;
+  const clock::time_point t0 = clock::now();
+  const double period = (_rate > 0) ? 1./_rate : 0;
+  for(uint64_t i=0; i<nevents; i++) {
+    if(period > 0)
+      std::this_thread::sleep_until(t0 + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(i*period)));
+    size_t size;
+    void* p = next_buffer(size);
+    if(!sink.put(l1accept(p, size))) return ndgrams;
+    ndgrams++;
+  }
+
+  for(unsigned i=0; i<sizeof(end)/sizeof(end[0]); i++)
+    if(!put_transition(end[i])) return ndgrams;
+
+  MSG(DEBUG, "XtcSimulator::run: " << ndgrams << " datagrams, " << _ndamaged << " dropped contributions");
+  return ndgrams;
+}
+
+//-------------------
+
+} // namespace detector
+
+//-------------------
@@ -5,6 +5,7 @@
  * This file was an early attempt to have C code that could use both
  * malloc (for psana) and a non-malloc "stack" (for the DAQ).  in the
  * end this code felt too complex, so it has been removed from the DAQ.
+ * The DAQ peak lists are made by the allocation-free HsdFex.hh instead.
  */
 
 /*
@@ -0,0 +1,71 @@
+#ifndef HSD_FEX_HH
+#define HSD_FEX_HH
+
+/*
+ * Peak lists from the hsd channel data (see Hsd.hh for the layout of
+ * the event header and of the streams).
+ *
+ * The peaks are taken from the firmware sparsified (fex) stream when it
+ * is present.  Otherwise they are found in the raw waveform as runs of
+ * samples outside of the [ymin,ymax] band, which is the criterion the
+ * firmware uses to sparsify.  Each peak is summarized by
+ *
+ *   start    - index of its first sample in the raw waveform
+ *   width    - number of samples
+ *   integral - sum of (sample - baseline), with baseline = (ymin+ymax)/2
+ *   time     - constant fraction time [samples]: where the excursion from
+ *              the baseline first reaches fraction of its maximum,
+ *              interpolated linearly between samples
+ *
+ * The caller provides the array of peaks and the extractor has no state
+ * that changes per event, so that one extractor can be shared by the
+ * drp worker threads without locks or malloc.
+ */
+
+#include <stdint.h>
+
+#include "Stream.hh"
+
+namespace Pds {
+  namespace HSD {
+
+    struct Peak {
+        uint32_t start;
+        uint32_t width;
+        float    integral;
+        float    time;
+    };
+
+    class PeakExtractor {
+    public:
+        PeakExtractor(int ymin, int ymax, float fraction=0.5);
+
+        ~PeakExtractor(){}
+
+        // All of the functions fill at most maxPeaks peaks and return
+        // the number of peaks found, which is larger if some were dropped.
+
+        // Channel data of size bytes, as it follows the TimingHeader
+        unsigned extract(const uint32_t* evtheader, const uint8_t* data, unsigned size,
+                         Peak* peaks, unsigned maxPeaks) const;
+
+        // Firmware sparsified stream
+        unsigned parse_fex(const StreamHeader& s, Peak* peaks, unsigned maxPeaks) const;
+
+        // Raw waveform of numsamples samples
+        unsigned find_raw(const uint16_t* wf, unsigned numsamples, Peak* peaks, unsigned maxPeaks) const;
+
+        float baseline() const { return _baseline; }
+
+    private:
+        void _summarize(const uint16_t* q, unsigned start, unsigned width, Peak& peak) const;
+
+        int   _ymin;
+        int   _ymax;
+        float _baseline;
+        float _fraction;
+    };
+  } // HSD
+} // Pds
+
+#endif
@@ -0,0 +1,126 @@
+#include "psalg/digitizer/HsdFex.hh"
+
+using namespace Pds::HSD;
+
+PeakExtractor::PeakExtractor(int ymin, int ymax, float fraction)
+: _ymin(ymin)
+, _ymax(ymax)
+, _baseline(0.5f*(ymin+ymax))
+, _fraction(fraction)
+{
+}
+
+unsigned PeakExtractor::extract(const uint32_t* evtheader, const uint8_t* data, unsigned size,
+                                Peak* peaks, unsigned maxPeaks) const
+{
+    // find out if we have raw/fex or both
+    unsigned streams((evtheader[0]>>20)&0x3);
+    const StreamHeader* sh_raw = 0;
+    const StreamHeader* sh_fex = 0;
+    const uint8_t* p = data;
+    const uint8_t* const p_end = data + size;
+    while(streams && p + sizeof(StreamHeader) <= p_end) {
+        const StreamHeader& s = *reinterpret_cast<const StreamHeader*>(p);
+        const uint8_t* next = p + sizeof(StreamHeader) + s.num_samples()*2;
+        if (next > p_end) break;
+        if (s.stream_id() == 0) sh_raw = &s;
+        if (s.stream_id() == 1) sh_fex = &s;
+        p = next;
+        streams &= ~(1<<s.stream_id());
+    }
+
+    if (sh_fex)
+        return parse_fex(*sh_fex, peaks, maxPeaks);
+    if (sh_raw)
+        return find_raw(reinterpret_cast<const uint16_t*>(sh_raw+1), sh_raw->num_samples(), peaks, maxPeaks);
+    return 0;
+}
+
+unsigned PeakExtractor::parse_fex(const StreamHeader& s, Peak* peaks, unsigned maxPeaks) const
+{
+    // Samples come in groups of 4.  A group with the top bit set holds the
+    // numbers of skipped samples, otherwise it holds 4 samples of a peak.
+    // The position of a peak in the raw waveform is the number of skipped
+    // samples plus the width of all of the previous peaks (see HsdPython.hh).
+    const uint16_t* q = reinterpret_cast<const uint16_t*>(&s+1);
+    const unsigned n = s.num_samples();
+
+    unsigned npeaks = 0;
+    unsigned ns = 0;
+    unsigned totWidth = 0;
+    unsigned first = 0;     // first sample of the current peak in q
+    unsigned width = 0;
+    bool in = false;
+    for(unsigned i=0; i<n;) {
+        if (q[i]&0x8000) {
+            if (in) { // this completes the previous peak
+                if (npeaks < maxPeaks) _summarize(q+first, ns+totWidth, width, peaks[npeaks]);
+                npeaks++;
+                totWidth += width;
+                in = false;
+            }
+            for (unsigned j=0; j<4 && i<n; j++, i++) {
+                ns += (q[i]&0x7fff);
+            }
+        } else {
+            if (!in) {
+                first = i;
+                width = 0;
+                in = true;
+            }
+            const unsigned w = (n-i < 4) ? n-i : 4;
+            i += w;
+            width += w;
+        }
+    }
+    if (in) { // the last peak ends with the stream
+        if (npeaks < maxPeaks) _summarize(q+first, ns+totWidth, width, peaks[npeaks]);
+        npeaks++;
+    }
+    return npeaks;
+}
+
+unsigned PeakExtractor::find_raw(const uint16_t* wf, unsigned numsamples, Peak* peaks, unsigned maxPeaks) const
+{
+    unsigned npeaks = 0;
+    for(unsigned i=0; i<numsamples;) {
+        if (wf[i] >= _ymin && wf[i] <= _ymax) { i++; continue; }
+        const unsigned first = i;
+        while (i<numsamples && (wf[i] < _ymin || wf[i] > _ymax)) i++;
+        if (npeaks < maxPeaks) _summarize(wf+first, first, i-first, peaks[npeaks]);
+        npeaks++;
+    }
+    return npeaks;
+}
+
+void PeakExtractor::_summarize(const uint16_t* q, unsigned start, unsigned width, Peak& peak) const
+{
+    // The excursion from the baseline with the largest magnitude sets the polarity
+    float integral = 0;
+    float amax = 0;
+    for(unsigned i=0; i<width; i++) {
+        const float d = float(q[i]) - _baseline;
+        integral += d;
+        if ((d < 0 ? -d : d) > (amax < 0 ? -amax : amax)) amax = d;
+    }
+
+    const float level = _fraction*amax;
+    const float sign  = amax < 0 ? -1.f : 1.f;
+    float time = start;
+    for(unsigned i=0; i<width; i++) {
+        const float d = float(q[i]) - _baseline;
+        if (sign*d < sign*level) continue;
+        if (i > 0) {
+            const float d0 = float(q[i-1]) - _baseline;
+            time = start + (i-1) + (level-d0)/(d-d0);
+        }
+        else
+            time = start;
+        break;
+    }
+
+    peak.start    = start;
+    peak.width    = width;
+    peak.integral = integral;
+    peak.time     = time;
+}
@@ -0,0 +1,129 @@
+#ifndef PSALG_ANGULARINTEGRATOR_H
+#define PSALG_ANGULARINTEGRATOR_H
+
+//------------------
+
+#include <vector>
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint32_t
+
+#include "psalg/geometry/GeometryTypes.hh"
+
+//------------------
+
+namespace geometry {
+
+class GeometryAccess;
+
+/// @addtogroup geometry
+
+/**
+ *  @ingroup geometry
+ *
+ *  @brief Radial and azimuthal integration of detector data.
+ *
+ *  The pixels of the detector are binned once, from the geometry, beam
+ *  center, detector distance and mask, into a sparse matrix (CSR) with a
+ *  row per (phi, radial) bin, holding the pixels of the bin and their
+ *  weights.  Integrating an event is then a weighted sum per row; the rows
+ *  are shared between the OpenMP threads and each sum is vectorized.
+ *
+ *  With pixel splitting each pixel is divided into split x split subpixels
+ *  which are binned separately, so that a pixel on a bin boundary
+ *  contributes to both bins in proportion.
+ *
+ *  @anchor interface
+ *  @par<interface> Interface Description
+ *
+ *  @code
+ *  #include "psalg/geometry/AngularIntegrator.hh"
+ *
+ *  geometry::AngularIntegrator::Pars pars;
+ *  pars.x0 = 0; pars.y0 = 0;     // beam center [um]
+ *  pars.distance = 100000;       // [um]
+ *  pars.radial = geometry::AngularIntegrator::TWO_THETA;
+ *  pars.rmin = 0; pars.rmax = 30; pars.nr = 300;
+ *  pars.nphi = 8;
+ *  pars.split = 2;
+ *
+ *  geometry::AngularIntegrator integ(geo, pars, mask);
+ *  std::vector<double> profile(integ.nbins());
+ *  integ.integrate(calib.const_data(), &profile[0]);  // for each event
+ *  @endcode
+ */
+
+class AngularIntegrator {
+public:
+
+  /// Radial coordinate of the bins
+  enum RADIAL {RADIUS=0,  // distance [um] from the beam center in the detector plane
+               TWO_THETA, // scattering angle [deg]
+               Q};        // momentum transfer 4*pi*sin(theta)/wavelength [1/Angstrom]
+
+  struct Pars {
+    pixel_coord_t x0;         // beam center [um]
+    pixel_coord_t y0;
+    pixel_coord_t distance;   // from the sample to z=0 of the detector [um]
+    RADIAL        radial;
+    double        rmin;       // radial range and number of bins
+    double        rmax;
+    unsigned      nr;
+    double        phimin;     // azimuthal range [deg] and number of bins
+    double        phimax;
+    unsigned      nphi;
+    double        wavelength; // [Angstrom], for Q
+    unsigned      split;      // subpixels per pixel along x and y
+
+    Pars() : x0(0), y0(0), distance(0), radial(RADIUS), rmin(0), rmax(1), nr(1),
+             phimin(-180), phimax(180), nphi(1), wavelength(1), split(1) {}
+  };
+
+  /// Bins the pixels of coordinate arrays X, Y, Z [um] of size, with pixel size [um];
+  /// pixels with mask 0 are excluded
+  AngularIntegrator(const pixel_coord_t* X, const pixel_coord_t* Y, const pixel_coord_t* Z,
+                    const gsize_t& size, const pixel_coord_t& pix_size,
+                    const Pars& pars, const pixel_mask_t* mask=0);
+
+  /// Bins the pixels of the top object of the geometry
+  AngularIntegrator(GeometryAccess& geo, const Pars& pars, const pixel_mask_t* mask=0);
+
+  ~AngularIntegrator() {}
+
+  const Pars& pars () const {return _pars;}
+  gsize_t  size    () const {return _size;}
+  /// Bins are ordered [nphi][nr]
+  unsigned nbins   () const {return _pars.nphi*_pars.nr;}
+  /// Sum of the pixel weights of each bin, the number of pixels without splitting
+  const std::vector<double>& norm() const {return _norm;}
+  /// Bin centers
+  std::vector<double> radial_centers () const;
+  std::vector<double> phi_centers    () const;
+
+  /**
+   *  @brief Integrates data, of size() pixels, into result, of nbins() values
+   *  @param[in]  data - per pixel values, e.g. calibrated
+   *  @param[out] result - the (weighted) mean of each bin, 0 for empty bins,
+   *              or the sum if average is false
+   */
+  template<typename T> void integrate(const T* data, double* result, const bool average=true) const;
+
+private:
+
+  void _build(const pixel_coord_t* X, const pixel_coord_t* Y, const pixel_coord_t* Z,
+              const pixel_coord_t& pix_size, const pixel_mask_t* mask);
+
+  /// Bin of a position, or -1 if outside of the ranges
+  int _bin(const double& x, const double& y, const double& z) const;
+
+  Pars     _pars;
+  gsize_t  _size;
+
+  std::vector<size_t>   _row;   // first entry of each bin, and the end
+  std::vector<uint32_t> _pix;
+  std::vector<float>    _w;
+  std::vector<double>   _norm;
+};
+
+} // namespace geometry
+
+#endif // PSALG_ANGULARINTEGRATOR_H
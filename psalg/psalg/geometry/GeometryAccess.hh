@@ -10,6 +10,7 @@
 #include <stdint.h>  // uint8_t, uint16_t, uint32_t, etc.
 
 #include "psalg/geometry/GeometryObject.hh"
+#include "psalg/geometry/ImageMapping.hh"
 
 #include "psalg/calib/NDArray.hh"
 
@@ -107,6 +108,11 @@ namespace geometry {
  *    // Make image from index, iX, iY, and intensity, W, arrays
  *        ndarray<geometry::GeometryAccess::image_t> img = 
  *                geometry::GeometryAccess::img_from_pixel_arrays(iX, iY, 0, isize);
+ *
+ *    // or, for every event, with the pixel to image mapping kept by the geometry
+ *        NDArray<geometry::GeometryAccess::image_t>& img = geometry.ref_img(W);
+ *        // binned 2x2
+ *        geometry.image_mapping(2).image(W, img);
  *    
  *    // Access and print comments from the calibration "geometry" file:
  *        std::map<int, std::string>& dict = geometry.get_dict_of_comments ();
@@ -345,6 +351,19 @@ public:
                             const double* W = 0,
                             const gsize_t& size = 0);
 
+  /// Returns the mapping of the pixels of the top object to an image, built on first use
+ /**
+   *  The mapping is kept until the geometry is loaded or changed, through this object
+   *  or through its GeometryObjects, see GeometryObject::version().
+   *  @param[in] binning - image pixels are binning x binning blocks of detector pixels
+   *  @param[in] interpolate - share the pixels between image pixels with bilinear weights
+   */
+  const ImageMapping& image_mapping(const unsigned& binning = 1, const bool& interpolate = false);
+
+  /// Returns reference to data member image of the top object for intensity array W
+  /// using image_mapping(binning), interpolating if the current mapping does
+  NDArray<image_t>& ref_img(const double* W, const unsigned& binning = 1);
+
   /// Loads calibration file
  /**
    *  @param[in] path - path to the file with calibration parameters of type "geometry"
@@ -419,6 +438,15 @@ private:
   /// Pointer to image, which is created as a member data of GeometryAccess object
   NDArray<image_t>* p_image;
 
+  /// Cached image mapping and the parameters it was built with
+  ImageMapping* p_mapping;
+  unsigned m_mapping_binning;
+  bool     m_mapping_interpolate;
+  unsigned m_mapping_version;
+
+  /// Drops the cached image mapping when the geometry changes
+  void reset_image_mapping();
+
   /// pointer to array of x pixel coordinates centrally projected to specified z plane
   pixel_coord_t* p_XatZ;
 
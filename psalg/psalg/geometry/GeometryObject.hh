@@ -119,6 +119,21 @@ public:
   typedef geometry::SegGeometry SG;
   typedef GeometryObject* pGO;
 
+  /// Affine transformation of pixel coordinates, p' = R*p + T
+  struct Transform {
+    double r[3][3];
+    double t[3];
+
+    static Transform identity();
+
+    /// Returns the transformation applying o first, then this
+    Transform operator*(const Transform& o) const;
+
+    /// Xt = R*X + T for arrays of size coordinates
+    void apply(const pixel_coord_t* X, const pixel_coord_t* Y, const pixel_coord_t* Z, const gsize_t size,
+               pixel_coord_t* Xt, pixel_coord_t* Yt, pixel_coord_t* Zt) const;
+  };
+
   /**
    *  @brief Class constructor accepts path to the calibration "geometry" file and verbosity control bit-word 
    *  
@@ -188,6 +203,12 @@ public:
   /// Returns parent object index
   segindex_t get_parent_index() {return m_pindex;}
 
+  /// Returns the transformation of self object coordinates to the parent frame
+  Transform transform(const bool do_tilt=true) const;
+
+  /// Returns a number which changes when the parameters of self object or of its children change
+  unsigned version() const;
+
   /**
    *  @brief Re-evaluate pixel coordinates (useful if geo is changed)
    *  @param[in]  do_tilt - on/off tilt angle correction
@@ -196,7 +217,7 @@ public:
   void evaluate_pixel_coords(const bool do_tilt=true, const bool do_eval=false);
 
   /**
-   *  @brief Returns pointers to pixel coordinate arrays
+   *  @brief Returns pointers to pixel coordinate arrays, re-evaluated if the geometry has changed
    *  @param[out] X - pointer to x pixel coordinate array
    *  @param[out] Y - pointer to y pixel coordinate array
    *  @param[out] Z - pointer to z pixel coordinate array
@@ -297,6 +318,9 @@ private:
   bool          m_do_tilt;
   bitword_t     m_mbits; // mask control bits
 
+  unsigned      m_version;      // counts changes of the parameters
+  unsigned      m_eval_version; // version() when the arrays were evaluated
+
   SG* m_seggeom;
 
   pGO m_parent;
@@ -309,22 +333,12 @@ private:
   pixel_area_t*  p_aarr; // pixel area array
   pixel_mask_t*  p_marr; // pixel mask array
 
-  void transform_geo_coord_arrays(const pixel_coord_t* X,
-				  const pixel_coord_t* Y,
-				  const pixel_coord_t* Z,
-				  const gsize_t size,
-				  pixel_coord_t* Xt,
-				  pixel_coord_t* Yt,
-				  pixel_coord_t* Zt,
-				  const bool do_tilt=true
-				  );
-
-  static void rotation(const pixel_coord_t* X, const pixel_coord_t* Y, const gsize_t size,
-                       const double C, const double S,
-		       pixel_coord_t* Xrot, pixel_coord_t* Yrot);
-
-  static void rotation(const pixel_coord_t* X, const pixel_coord_t* Y, const gsize_t size, const angle_t angle_deg,
-                       pixel_coord_t* Xrot, pixel_coord_t* Yrot);
+  /// Fills the arrays of the top object being evaluated, from index ibase, with the pixels
+  /// of self object transformed by parent * transform(), in one pass per segment
+  void fill_geo_arrays(const Transform& parent, gsize_t& ibase,
+                       pixel_coord_t* X, pixel_coord_t* Y, pixel_coord_t* Z,
+                       pixel_area_t* A, pixel_mask_t* M,
+                       const bool do_tilt, const bitword_t mbits);
 
   /// Delete arrays with allocated memory, reset pointers to 0
   void _deallocate_memory();
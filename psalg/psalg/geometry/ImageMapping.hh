@@ -0,0 +1,110 @@
+#ifndef PSALG_IMAGEMAPPING_H
+#define PSALG_IMAGEMAPPING_H
+
+//------------------
+
+#include <vector>
+#include <stdint.h>  // uint32_t
+
+#include "psalg/geometry/GeometryTypes.hh"
+#include "psalg/calib/NDArray.hh"
+
+//------------------
+
+namespace geometry {
+
+/// @addtogroup geometry
+
+/**
+ *  @ingroup geometry
+ *
+ *  @brief Precomputed scatter of detector pixels to image pixels.
+ *
+ *  The mapping is built once per geometry, from the pixel index (or
+ *  coordinate) arrays of GeometryAccess, and then makes an image from the
+ *  per-pixel data of each event without recomputing anything.
+ *
+ *  The scatter entries are sorted by image pixel, so that the image is
+ *  written sequentially, and split into blocks of consecutive image pixels
+ *  which the OpenMP threads fill independently.
+ *
+ *  @li Modes
+ *  \n  binning=1 - each image pixel takes the value of the (last) detector
+ *                  pixel with its indexes, as GeometryAccess::img_from_pixel_arrays
+ *  \n  binning>1 - image pixels are the sums of binning x binning blocks of pixels
+ *  \n  interpolation - from pixel coordinates, each detector pixel is shared
+ *                  between the four nearest image pixels with bilinear weights
+ *
+ *  @anchor interface
+ *  @par<interface> Interface Description
+ *
+ *  @code
+ *  #include "psalg/geometry/ImageMapping.hh"
+ *
+ *  const pixel_idx_t* iX;
+ *  const pixel_idx_t* iY;
+ *  gsize_t size;
+ *  geometry.get_pixel_coord_indexes(iX, iY, size);
+ *  geometry::ImageMapping map(iX, iY, size, 2); // 2x2 binning
+ *
+ *  NDArray<ImageMapping::image_t> img;
+ *  map.image(calib.const_data(), img);          // for each event
+ *  @endcode
+ *
+ *  @see GeometryAccess::image_mapping
+ */
+
+class ImageMapping {
+public:
+
+  typedef double image_t;
+  typedef psalg::types::shape_t shape_t;
+
+  /// Mapping from pixel index arrays, as returned by GeometryAccess::get_pixel_coord_indexes
+  ImageMapping(const pixel_idx_t* iX, const pixel_idx_t* iY, const gsize_t& size, const unsigned& binning=1);
+
+  /// Interpolating mapping from pixel coordinate arrays [um] and the image pixel size [um]
+  ImageMapping(const pixel_coord_t* X, const pixel_coord_t* Y, const gsize_t& size,
+               const pixel_coord_t& pix_size, const unsigned& binning=1);
+
+  ~ImageMapping() {}
+
+  /// Number of detector pixels the mapping takes
+  gsize_t  size    () const {return _size;}
+  unsigned binning () const {return _binning;}
+  bool     weighted() const {return !_w.empty();}
+  /// Image shape, {rows, cols}
+  const shape_t* shape() const {return _shape;}
+
+  /// Fills img, of rows*cols values, from data, of size() values
+  template<typename T> void image(const T* data, image_t* img) const;
+
+  /// Sets the shape of img and fills it. If the buffer of img, owned or external,
+  /// does not hold rows*cols values, img gets an own buffer of that size.
+  template<typename T> void image(const T* data, psalg::NDArray<image_t>& img) const;
+
+private:
+
+  struct Entry {
+    uint32_t dst; // image pixel
+    uint32_t src; // detector pixel
+    float    w;
+  };
+
+  void _build(std::vector<Entry>& entries, const bool accumulate);
+
+  gsize_t  _size;
+  unsigned _binning;
+  shape_t  _shape[2];
+  bool     _accumulate; // sum into image pixels, otherwise assign
+
+  std::vector<uint32_t> _dst;
+  std::vector<uint32_t> _src;
+  std::vector<float>    _w;     // empty if all weights are 1
+  std::vector<size_t>   _block; // first entry of each block, and the end
+  std::vector<uint32_t> _first; // first image pixel of each block, and the end
+};
+
+} // namespace geometry
+
+#endif // PSALG_IMAGEMAPPING_H
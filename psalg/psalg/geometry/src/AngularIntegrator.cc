@@ -0,0 +1,175 @@
+//-------------------
+
+#include "psalg/geometry/AngularIntegrator.hh"
+#include "psalg/geometry/GeometryAccess.hh"
+
+#include <algorithm> // sort
+#include <cmath>     // sqrt, atan2, floor, sin
+#include <utility>   // pair
+
+#include <omp.h>
+
+#include "psalg/utils/Logger.hh" // MSG
+
+//-------------------
+
+namespace geometry {
+
+//-------------------
+
+AngularIntegrator::AngularIntegrator(const pixel_coord_t* X, const pixel_coord_t* Y, const pixel_coord_t* Z,
+                                     const gsize_t& size, const pixel_coord_t& pix_size,
+                                     const Pars& pars, const pixel_mask_t* mask)
+  : _pars(pars)
+  , _size(size)
+{
+  _build(X, Y, Z, pix_size, mask);
+}
+
+//-------------------
+
+AngularIntegrator::AngularIntegrator(GeometryAccess& geo, const Pars& pars, const pixel_mask_t* mask)
+  : _pars(pars)
+  , _size(0)
+{
+  const pixel_coord_t* X;
+  const pixel_coord_t* Y;
+  const pixel_coord_t* Z;
+  geo.get_pixel_coords(X, Y, Z, _size);
+  _build(X, Y, Z, geo.get_pixel_scale_size(), mask);
+}
+
+//-------------------
+
+int AngularIntegrator::_bin(const double& x, const double& y, const double& z) const
+{
+  const double dx = x - _pars.x0;
+  const double dy = y - _pars.y0;
+  const double r  = sqrt(dx*dx + dy*dy);
+
+  double v = r;
+  if (_pars.radial != RADIUS) {
+    const double twotheta = atan2(r, z + _pars.distance);
+    v = (_pars.radial == TWO_THETA) ? twotheta / DEG_TO_RAD
+                                    : 4*M_PI*sin(twotheta/2) / _pars.wavelength;
+  }
+  const double phi = atan2(dy, dx) / DEG_TO_RAD;
+
+  const double fr = (v   - _pars.rmin)   / (_pars.rmax   - _pars.rmin)   * _pars.nr;
+  const double fp = (phi - _pars.phimin) / (_pars.phimax - _pars.phimin) * _pars.nphi;
+  if (!(fr >= 0 && fr < _pars.nr && fp >= 0 && fp < _pars.nphi)) return -1;
+  return int(fp)*_pars.nr + int(fr);
+}
+
+//-------------------
+
+void AngularIntegrator::_build(const pixel_coord_t* X, const pixel_coord_t* Y, const pixel_coord_t* Z,
+                               const pixel_coord_t& pix_size, const pixel_mask_t* mask)
+{
+  if (!_pars.split) _pars.split = 1;
+  const unsigned nb    = nbins();
+  const unsigned split = _pars.split;
+  const float    wsub  = 1./(split*split);
+
+  _row .assign(nb+1, 0);
+  _norm.assign(nb, 0);
+
+  // Bins of the subpixels of a pixel, with the weights of the same bin merged
+  std::vector<std::pair<int,float> > sub(split*split);
+  auto pixel_bins = [&](const gsize_t i) -> unsigned {
+    unsigned n = 0;
+    for(unsigned sx=0; sx<split; ++sx)
+      for(unsigned sy=0; sy<split; ++sy) {
+        const double dx = ((sx+0.5)/split - 0.5) * pix_size;
+        const double dy = ((sy+0.5)/split - 0.5) * pix_size;
+        const int b = _bin(X[i]+dx, Y[i]+dy, Z[i]);
+        if (b >= 0) sub[n++] = std::make_pair(b, wsub);
+      }
+    if (n > 1) {
+      std::sort(sub.begin(), sub.begin()+n);
+      unsigned m = 0;
+      for(unsigned k=1; k<n; ++k) {
+        if (sub[k].first == sub[m].first) sub[m].second += sub[k].second;
+        else sub[++m] = sub[k];
+      }
+      n = m+1;
+    }
+    return n;
+  };
+
+  // Count the entries of each bin, then place them
+  for(gsize_t i=0; i<_size; ++i) {
+    if (mask && !mask[i]) continue;
+    const unsigned n = pixel_bins(i);
+    for(unsigned k=0; k<n; ++k) _row[sub[k].first+1]++;
+  }
+  for(unsigned b=0; b<nb; ++b) _row[b+1] += _row[b];
+
+  _pix.resize(_row[nb]);
+  _w  .resize(_row[nb]);
+  std::vector<size_t> pos(_row.begin(), _row.end()-1);
+  for(gsize_t i=0; i<_size; ++i) {
+    if (mask && !mask[i]) continue;
+    const unsigned n = pixel_bins(i);
+    for(unsigned k=0; k<n; ++k) {
+      const int b = sub[k].first;
+      const size_t e = pos[b]++;
+      _pix[e] = i;
+      _w  [e] = sub[k].second;
+      _norm[b] += sub[k].second;
+    }
+  }
+
+  MSG(DEBUG, "AngularIntegrator of " << _size << " pixels into " << _pars.nphi << 'x' << _pars.nr
+      << " bins with " << _pix.size() << " entries");
+}
+
+//-------------------
+
+std::vector<double> AngularIntegrator::radial_centers() const
+{
+  std::vector<double> v(_pars.nr);
+  for(unsigned i=0; i<_pars.nr; ++i) v[i] = _pars.rmin + (i+0.5)*(_pars.rmax-_pars.rmin)/_pars.nr;
+  return v;
+}
+
+//-------------------
+
+std::vector<double> AngularIntegrator::phi_centers() const
+{
+  std::vector<double> v(_pars.nphi);
+  for(unsigned i=0; i<_pars.nphi; ++i) v[i] = _pars.phimin + (i+0.5)*(_pars.phimax-_pars.phimin)/_pars.nphi;
+  return v;
+}
+
+//-------------------
+
+template<typename T>
+void AngularIntegrator::integrate(const T* data, double* result, const bool average) const
+{
+  const long      nb  = nbins();
+  const size_t*   row = _row.data();
+  const uint32_t* pix = _pix.data();
+  const float*    w   = _w.data();
+
+  #pragma omp parallel for schedule(dynamic,16) if(_pix.size() > 65536)
+  for(long b=0; b<nb; ++b) {
+    double s = 0;
+    #pragma omp simd reduction(+:s)
+    for(size_t k=row[b]; k<row[b+1]; ++k) s += w[k]*(double)data[pix[k]];
+    result[b] = (!average) ? s : (_norm[b] > 0) ? s/_norm[b] : 0;
+  }
+}
+
+//-------------------
+
+template void AngularIntegrator::integrate<double>  (const double*,   double*, const bool) const;
+template void AngularIntegrator::integrate<float>   (const float*,    double*, const bool) const;
+template void AngularIntegrator::integrate<uint16_t>(const uint16_t*, double*, const bool) const;
+template void AngularIntegrator::integrate<int32_t> (const int32_t*,  double*, const bool) const;
+
+//-------------------
+
+} // namespace geometry
+
+//-------------------
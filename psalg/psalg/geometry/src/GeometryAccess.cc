@@ -20,6 +20,10 @@ GeometryAccess::GeometryAccess(const std::string& path)
   , p_iX(0)
   , p_iY(0)
   , p_image(0)
+  , p_mapping(0)
+  , m_mapping_binning(0)
+  , m_mapping_interpolate(false)
+  , m_mapping_version(0)
   , p_XatZ(0)
   , p_YatZ(0)
 {
@@ -35,6 +39,10 @@ GeometryAccess::GeometryAccess(std::stringstream& ss)
   , p_iX(0)
   , p_iY(0)
   , p_image(0)
+  , p_mapping(0)
+  , m_mapping_binning(0)
+  , m_mapping_interpolate(false)
+  , m_mapping_version(0)
   , p_XatZ(0)
   , p_YatZ(0)
 {
@@ -49,7 +57,8 @@ GeometryAccess::~GeometryAccess()
   MSG(DEBUG, "In d-tor ~GeometryAccess");
   if(p_iX)    delete [] p_iX;
   if(p_iY)    delete [] p_iY;
-  if(p_image) delete [] p_image;
+  if(p_image) delete p_image;
+  reset_image_mapping();
   if(p_XatZ)  delete [] p_XatZ;
   if(p_YatZ)  delete [] p_YatZ;
 }
@@ -58,6 +67,7 @@ GeometryAccess::~GeometryAccess()
 
 void GeometryAccess::load_pars_from_stringstream(std::stringstream& ss)
 {
+  reset_image_mapping();
   m_dict_of_comments.clear();
   v_list_of_geos.clear();
   v_list_of_geos.reserve(100);
@@ -461,6 +471,7 @@ GeometryAccess::set_geo_pars(const std::string& oname,
 {
   GeometryAccess::pGO geo = (oname.empty()) ? get_top_geo() : get_geo(oname, oindex);
   geo -> set_geo_pars(x0, y0, z0, rot_z, rot_y, rot_x, tilt_z, tilt_y, tilt_x);
+  reset_image_mapping();
 }
 
 //-------------------
@@ -475,6 +486,7 @@ GeometryAccess::move_geo(const std::string& oname,
 {
   GeometryAccess::pGO geo = (oname.empty()) ? get_top_geo() : get_geo(oname, oindex);
   geo -> move_geo(dx, dy, dz);
+  reset_image_mapping();
 }
 
 //-------------------
@@ -489,6 +501,7 @@ GeometryAccess::tilt_geo(const std::string& oname,
 {
   GeometryAccess::pGO geo = (oname.empty()) ? get_top_geo() : get_geo(oname, oindex);
   geo -> tilt_geo(dt_x, dt_y, dt_z);
+  reset_image_mapping();
 }
 
 //-------------------
@@ -686,7 +699,7 @@ GeometryAccess::ref_img_from_pixel_arrays(const pixel_idx_t*& iX,
 
     shape_t sh[2] = {ix_max, iy_max};
 
-    if(p_image) delete [] p_image;
+    if(p_image) delete p_image;
     p_image = new NDArray<image_t>(sh, 2);
     NDArray<image_t>& img = *p_image;
 
@@ -697,6 +710,55 @@ GeometryAccess::ref_img_from_pixel_arrays(const pixel_idx_t*& iX,
     return *p_image;
 }
 
+void GeometryAccess::reset_image_mapping()
+{
+  if(p_mapping) delete p_mapping;
+  p_mapping = 0;
+}
+
+//-------------------
+
+const ImageMapping&
+GeometryAccess::image_mapping(const unsigned& binning, const bool& interpolate)
+{
+  const unsigned version = get_top_geo()->version();
+  if(p_mapping && m_mapping_binning == binning && m_mapping_interpolate == interpolate
+               && m_mapping_version == version)
+    return *p_mapping;
+
+  reset_image_mapping();
+
+  gsize_t size;
+  if(interpolate) {
+    const pixel_coord_t* X;
+    const pixel_coord_t* Y;
+    const pixel_coord_t* Z;
+    get_pixel_coords(X,Y,Z,size);
+    p_mapping = new ImageMapping(X, Y, size, get_pixel_scale_size(), binning);
+  }
+  else {
+    const pixel_idx_t* iX;
+    const pixel_idx_t* iY;
+    get_pixel_coord_indexes(iX, iY, size);
+    p_mapping = new ImageMapping(iX, iY, size, binning);
+  }
+  m_mapping_binning     = binning;
+  m_mapping_interpolate = interpolate;
+  m_mapping_version     = version;
+  return *p_mapping;
+}
+
+//-------------------
+
+NDArray<image_t>&
+GeometryAccess::ref_img(const double* W, const unsigned& binning)
+{
+  const ImageMapping& map = image_mapping(binning, m_mapping_interpolate);
+  if(!p_image) p_image = new NDArray<image_t>();
+  map.image(W, *p_image);
+  return *p_image;
+}
+
 //-------------------
 //-------------------
 //-- Static Methods--
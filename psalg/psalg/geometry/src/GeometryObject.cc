@@ -49,6 +49,8 @@ GeometryObject::GeometryObject(std::string   pname,
     , m_tilt_x (tilt_x)
     , m_do_tilt(true)
     , m_mbits(0377)
+    , m_version(0)
+    , m_eval_version(0)
     , m_size(0)
     , p_xarr(0)
     , p_yarr(0)
@@ -158,41 +160,72 @@ void GeometryObject::print_geo_children()
 
 //-------------------
 
-void GeometryObject::transform_geo_coord_arrays(const pixel_coord_t* X,
-                                                const pixel_coord_t* Y,
-                                                const pixel_coord_t* Z,
-                                                const gsize_t size,
-                                                pixel_coord_t* Xt,
-                                                pixel_coord_t* Yt,
-                                                pixel_coord_t* Zt,
-                                                const bool do_tilt)
+GeometryObject::Transform GeometryObject::Transform::identity()
 {
-  // take rotation ( +tilt ) angles in degrees
-  angle_t angle_x = (do_tilt) ? m_rot_x + m_tilt_x : m_rot_x;
-  angle_t angle_y = (do_tilt) ? m_rot_y + m_tilt_y : m_rot_y;
-  angle_t angle_z = (do_tilt) ? m_rot_z + m_tilt_z : m_rot_z;
+  Transform o = {{{1,0,0},{0,1,0},{0,0,1}}, {0,0,0}};
+  return o;
+}
+
+//-------------------
 
-  // allocate memory for intermediate transformation
-  pixel_coord_t* X1 = new pixel_coord_t[size];
-  pixel_coord_t* Y1 = new pixel_coord_t[size];
-  pixel_coord_t* Z2 = new pixel_coord_t[size];
+GeometryObject::Transform GeometryObject::Transform::operator*(const Transform& o) const
+{
+  Transform p;
+  for(int i=0; i<3; ++i) {
+    for(int j=0; j<3; ++j)
+      p.r[i][j] = r[i][0]*o.r[0][j] + r[i][1]*o.r[1][j] + r[i][2]*o.r[2][j];
+    p.t[i] = r[i][0]*o.t[0] + r[i][1]*o.t[1] + r[i][2]*o.t[2] + t[i];
+  }
+  return p;
+}
 
-  // apply three rotations around Z, Y, and X axes
-  rotation(X,  Y,  size, angle_z, X1, Y1);
-  rotation(Z,  X1, size, angle_y, Z2, Xt);
-  rotation(Y1, Z2, size, angle_x, Yt, Zt);
+//-------------------
 
-  // apply translation
+void GeometryObject::Transform::apply(const pixel_coord_t* X, const pixel_coord_t* Y, const pixel_coord_t* Z, const gsize_t size,
+                                      pixel_coord_t* Xt, pixel_coord_t* Yt, pixel_coord_t* Zt) const
+{
+  const double r00=r[0][0], r01=r[0][1], r02=r[0][2], t0=t[0];
+  const double r10=r[1][0], r11=r[1][1], r12=r[1][2], t1=t[1];
+  const double r20=r[2][0], r21=r[2][1], r22=r[2][2], t2=t[2];
+
+  #pragma omp parallel for simd schedule(static) if(size > 65536)
   for(gsize_t i=0; i<size; ++i) {
-    Xt[i] += m_x0;
-    Yt[i] += m_y0;
-    Zt[i] += m_z0;
+    const pixel_coord_t x=X[i], y=Y[i], z=Z[i];
+    Xt[i] = r00*x + r01*y + r02*z + t0;
+    Yt[i] = r10*x + r11*y + r12*z + t1;
+    Zt[i] = r20*x + r21*y + r22*z + t2;
   }
+}
 
-  // release allocated memory
-  delete [] X1;
-  delete [] Y1;
-  delete [] Z2;
+//-------------------
+
+GeometryObject::Transform GeometryObject::transform(const bool do_tilt) const
+{
+  // take rotation ( +tilt ) angles in degrees
+  const angle_t angle_x = ((do_tilt) ? m_rot_x + m_tilt_x : m_rot_x) * DEG_TO_RAD;
+  const angle_t angle_y = ((do_tilt) ? m_rot_y + m_tilt_y : m_rot_y) * DEG_TO_RAD;
+  const angle_t angle_z = ((do_tilt) ? m_rot_z + m_tilt_z : m_rot_z) * DEG_TO_RAD;
+
+  const double cx = cos(angle_x), sx = sin(angle_x);
+  const double cy = cos(angle_y), sy = sin(angle_y);
+  const double cz = cos(angle_z), sz = sin(angle_z);
+
+  // three rotations around Z, Y, and X axes, then translation
+  const Transform rz = {{{cz,-sz, 0},{sz, cz, 0},{  0,  0, 1}}, {0,0,0}};
+  const Transform ry = {{{cy,  0,sy},{ 0,  1, 0},{-sy,  0,cy}}, {0,0,0}};
+  const Transform rx = {{{ 1,  0, 0},{ 0, cx,-sx},{  0, sx,cx}}, {m_x0,m_y0,m_z0}};
+  return rx * (ry * rz);
+}
+
+//-------------------
+
+unsigned GeometryObject::version() const
+{
+  unsigned v = m_version;
+  for(std::vector<pGO>::const_iterator it  = v_list_of_children.begin();
+                                       it != v_list_of_children.end(); ++it)
+    v += (*it)->version();
+  return v;
 }
 
 //-------------------
@@ -231,7 +264,7 @@ void GeometryObject::get_pixel_coords(const pixel_coord_t*& X, const pixel_coord
                                       const bool do_tilt, const bool do_eval)
 {
   // std::cout << "  ============ do_tilt : " << do_tilt << '\n';
-  if(p_xarr==0 || do_tilt != m_do_tilt || do_eval) evaluate_pixel_coords(do_tilt, do_eval);
+  if(p_xarr==0 || do_tilt != m_do_tilt || do_eval || version() != m_eval_version) evaluate_pixel_coords(do_tilt, do_eval);
   X    = p_xarr;
   Y    = p_yarr;
   Z    = p_zarr;
@@ -277,21 +310,38 @@ void GeometryObject::evaluate_pixel_coords(const bool do_tilt, const bool do_eva
     p_marr = new pixel_mask_t [m_size];
   }
 
+  // the transformations of all levels are composed, so each pixel is transformed once
+  gsize_t ibase=0;
+  fill_geo_arrays(Transform::identity(), ibase, p_xarr, p_yarr, p_zarr, p_aarr, p_marr, do_tilt, m_mbits);
+  m_eval_version = version();
+}
+
+//-------------------
+
+void GeometryObject::fill_geo_arrays(const Transform& parent, gsize_t& ibase,
+                                     pixel_coord_t* X, pixel_coord_t* Y, pixel_coord_t* Z,
+                                     pixel_area_t* A, pixel_mask_t* M,
+                                     const bool do_tilt, const bitword_t mbits)
+{
+  const Transform t = parent * transform(do_tilt);
+
   if(m_seggeom) {
 
+       const gsize_t size = m_seggeom -> size();
        const pixel_coord_t* x_arr = m_seggeom -> pixel_coord_array(AXIS_X);
        const pixel_coord_t* y_arr = m_seggeom -> pixel_coord_array(AXIS_Y);
        const pixel_coord_t* z_arr = m_seggeom -> pixel_coord_array(AXIS_Z);
        const pixel_area_t*  a_arr = m_seggeom -> pixel_area_array();
-       const pixel_mask_t*  m_arr = m_seggeom -> pixel_mask_array(m_mbits);
+       const pixel_mask_t*  m_arr = m_seggeom -> pixel_mask_array(mbits);
 
-       transform_geo_coord_arrays(x_arr, y_arr, z_arr, m_size, p_xarr, p_yarr, p_zarr, do_tilt);
-       std::memcpy(&p_aarr[0], a_arr, m_size*sizeof(pixel_area_t));
-       std::memcpy(&p_marr[0], m_arr, m_size*sizeof(pixel_mask_t));
+       t.apply(x_arr, y_arr, z_arr, size, &X[ibase], &Y[ibase], &Z[ibase]);
+       std::memcpy(&A[ibase], a_arr, size*sizeof(pixel_area_t));
+       std::memcpy(&M[ibase], m_arr, size*sizeof(pixel_mask_t));
+       ibase += size;
        return;
   }
 
-  segindex_t ibase=0;
+  const gsize_t ibase0 = ibase;
   segindex_t ind=0;
   for(std::vector<pGO>::iterator it  = v_list_of_children.begin(); 
                                  it != v_list_of_children.end(); ++it, ++ind) {
@@ -304,36 +354,18 @@ void GeometryObject::evaluate_pixel_coords(const bool do_tilt, const bool do_eva
       MSG(WARNING, ss.str());
     }
 
-    const pixel_coord_t* pXch; 
-    const pixel_coord_t* pYch;
-    const pixel_coord_t* pZch; 
-    const pixel_area_t* pAch; 
-    const pixel_mask_t* pMch; 
-    gsize_t      sizech;
-
-    (*it)->get_pixel_coords(pXch, pYch, pZch, sizech, do_tilt, do_eval);       
-    transform_geo_coord_arrays(pXch, pYch, pZch, sizech, &p_xarr[ibase], &p_yarr[ibase], &p_zarr[ibase], do_tilt);
-
-    (*it)->get_pixel_areas(pAch, sizech);
-    std::memcpy(&p_aarr[ibase], pAch, sizech*sizeof(pixel_area_t));
-
-    (*it)->get_pixel_mask(pMch, sizech, m_mbits);
-    std::memcpy(&p_marr[ibase], pMch, sizech*sizeof(pixel_mask_t));
-
-    ibase += sizech;
-
-    (*it)->_deallocate_memory();
+    (*it)->fill_geo_arrays(t, ibase, X, Y, Z, A, M, do_tilt, mbits);
   }
 
-  if(ibase == geometry::SIZE2X2 && m_oname == "CSPAD2X2:V1") {
+  if(ibase-ibase0 == geometry::SIZE2X2 && m_oname == "CSPAD2X2:V1") {
     // shuffle pixels for cspad2x2, geometry::SIZE2X2 = 2*185*388 = 143560 
     // shuffle pixels only once for "CSPAD2X2:V1" only!
 
-    two2x1ToData2x2<pixel_coord_t>(p_xarr);
-    two2x1ToData2x2<pixel_coord_t>(p_yarr);
-    two2x1ToData2x2<pixel_coord_t>(p_zarr);
-    two2x1ToData2x2<pixel_area_t>(p_aarr);
-    two2x1ToData2x2<pixel_mask_t>(p_marr);
+    two2x1ToData2x2<pixel_coord_t>(&X[ibase0]);
+    two2x1ToData2x2<pixel_coord_t>(&Y[ibase0]);
+    two2x1ToData2x2<pixel_coord_t>(&Z[ibase0]);
+    two2x1ToData2x2<pixel_area_t>(&A[ibase0]);
+    two2x1ToData2x2<pixel_mask_t>(&M[ibase0]);
   }
 }
 
@@ -383,6 +415,7 @@ void GeometryObject::set_geo_pars(const pixel_coord_t& x0,
   m_tilt_z = tilt_z;
   m_tilt_y = tilt_y;
   m_tilt_x = tilt_x; 
+  ++m_version;
 }
 
 //-------------------
@@ -395,6 +428,7 @@ void GeometryObject::move_geo(const pixel_coord_t& dx,
   m_x0 += dx;    
   m_y0 += dy;    
   m_z0 += dz;  
+  ++m_version;
 }
 
 //-------------------
@@ -407,85 +441,9 @@ void GeometryObject::tilt_geo(const pixel_coord_t& dt_x,
   m_tilt_z += dt_z;
   m_tilt_y += dt_y;
   m_tilt_x += dt_x; 
+  ++m_version;
 }
 
-//-------------------
-//-------------------
-//-------------------
-//-------------------
-
-void GeometryObject::rotation(const pixel_coord_t* X, const pixel_coord_t* Y, const gsize_t size,
-                              const double C, const double S, pixel_coord_t* Xrot, pixel_coord_t* Yrot)
-  {
-    // takes 0.48 sec for cspad size=2296960
-    /*
-    const pixel_coord_t* Xend = &X[size];
-    const pixel_coord_t* x=X; // &X[0];
-    const pixel_coord_t* y=Y;
-    for(; x!=Xend; x++, y++) {
-      *Xrot++ = *x*C - *y*S;
-      *Yrot++ = *y*C + *x*S;
-    }
-    */
-
-    // takes 0.55 sec for cspad size=2296960
-    // and   0.29 sec with pragma
-
-    omp_set_num_threads(6); // or use env# OMP_NUM_THREADS //num_threads(6); ??
-
-    #pragma omp parallel for
-    for(gsize_t i=0; i<size; ++i) {
-      Xrot[i] = X[i]*C - Y[i]*S; 
-      Yrot[i] = Y[i]*C + X[i]*S; 
-    }
-  }
-
-//-------------------
-
-/*
-void GeometryObject::rotation(const pixel_coord_t* X, const pixel_coord_t* Y, const gsize_t size,
-               const double C, const double S, 
-               pixel_coord_t* Xrot, pixel_coord_t* Yrot)
-  {
-    //std::fill_n(Carr, int(size), double(C));
-    //std::fill_n(Sarr, int(size), double(S));
-
-    // takes 2 sec
-
-    pixel_coord_t* xc = new pixel_coord_t [size];
-    pixel_coord_t* xs = new pixel_coord_t [size];
-    pixel_coord_t* yc = new pixel_coord_t [size];
-    pixel_coord_t* ys = new pixel_coord_t [size];
-
-    auto vS = std::bind1st(std::multiplies<double>(), S);
-    auto vC = std::bind1st(std::multiplies<double>(), C);
-
-    std::transform(X, &X[size], &xs[0], vS);
-    std::transform(X, &X[size], &xc[0], vC);
-    std::transform(Y, &Y[size], &ys[0], vS);
-    std::transform(Y, &Y[size], &yc[0], vC);
-
-    std::transform(&xc[0], &xc[size], &ys[0], Xrot, std::minus<pixel_coord_t>());
-    std::transform(&yc[0], &yc[size], &xs[0], Yrot, std::plus<pixel_coord_t>());
-
-    delete [] xc; 
-    delete [] xs; 
-    delete [] yc; 
-    delete [] ys; 
-  }
-*/
-
-//-------------------
-
-void GeometryObject::rotation(const pixel_coord_t* X, const pixel_coord_t* Y, const gsize_t size,
-                              const angle_t angle_deg, pixel_coord_t* Xrot, pixel_coord_t* Yrot)
-  {
-    const angle_t angle_rad = angle_deg * DEG_TO_RAD;
-    const double C = cos(angle_rad);
-    const double S = sin(angle_rad);
-    rotation(X, Y, size, C, S, Xrot, Yrot);
-  }
-
 //-------------------
 
 } // namespace geometry
@@ -0,0 +1,189 @@
+//-------------------
+
+#include "psalg/geometry/ImageMapping.hh"
+
+#include <algorithm> // stable_sort, fill
+#include <cmath>     // floor
+
+#include <omp.h>
+
+#include "psalg/utils/Logger.hh" // MSG
+
+//-------------------
+
+namespace geometry {
+
+typedef ImageMapping::image_t image_t;
+
+/// Entries per block of the image, enough to amortize the thread scheduling
+static const size_t BLOCK_ENTRIES = 16384;
+
+//-------------------
+
+ImageMapping::ImageMapping(const pixel_idx_t* iX, const pixel_idx_t* iY, const gsize_t& size, const unsigned& binning)
+  : _size(size)
+  , _binning(binning ? binning : 1)
+{
+  const unsigned b = _binning;
+  pixel_idx_t ix_max=0; for(gsize_t i=0; i<size; ++i) {if (iX[i] > ix_max) ix_max = iX[i];}
+  pixel_idx_t iy_max=0; for(gsize_t i=0; i<size; ++i) {if (iY[i] > iy_max) iy_max = iY[i];}
+  _shape[0] = size ? ix_max/b + 1 : 0;
+  _shape[1] = size ? iy_max/b + 1 : 0;
+
+  std::vector<Entry> entries(size);
+  for(gsize_t i=0; i<size; ++i) {
+    Entry& e = entries[i];
+    e.dst = (iX[i]/b)*_shape[1] + iY[i]/b;
+    e.src = i;
+    e.w   = 1;
+  }
+  _build(entries, b>1);
+}
+
+//-------------------
+
+ImageMapping::ImageMapping(const pixel_coord_t* X, const pixel_coord_t* Y, const gsize_t& size,
+                           const pixel_coord_t& pix_size, const unsigned& binning)
+  : _size(size)
+  , _binning(binning ? binning : 1)
+{
+  const unsigned b = _binning;
+  // Pixel centers are at (index+0.5)*pix_size from the image corner, as in GeometryAccess::get_pixel_coord_indexes
+  pixel_coord_t x_min=size ? X[0] : 0; for(gsize_t i=0; i<size; ++i) {if (X[i] < x_min) x_min = X[i];}
+  pixel_coord_t y_min=size ? Y[0] : 0; for(gsize_t i=0; i<size; ++i) {if (Y[i] < y_min) y_min = Y[i];}
+
+  std::vector<Entry> entries;
+  entries.reserve(4*size);
+  std::vector<pixel_idx_t> i0(size), j0(size);
+  std::vector<float> fx(size), fy(size);
+  pixel_idx_t ix_max=0, iy_max=0;
+  for(gsize_t i=0; i<size; ++i) {
+    pixel_coord_t u = (X[i] - x_min) / pix_size;
+    pixel_coord_t v = (Y[i] - y_min) / pix_size;
+    i0[i] = (pixel_idx_t)floor(u); fx[i] = u - i0[i];
+    j0[i] = (pixel_idx_t)floor(v); fy[i] = v - j0[i];
+    if (i0[i] > ix_max) ix_max = i0[i];
+    if (j0[i] > iy_max) iy_max = j0[i];
+  }
+  _shape[0] = size ? (ix_max+1)/b + 1 : 0;
+  _shape[1] = size ? (iy_max+1)/b + 1 : 0;
+
+  for(gsize_t i=0; i<size; ++i) {
+    const float w[4] = {(1-fx[i])*(1-fy[i]), (1-fx[i])*fy[i], fx[i]*(1-fy[i]), fx[i]*fy[i]};
+    for(unsigned n=0; n<4; n++) {
+      if (w[n] < 1e-6) continue;
+      Entry e;
+      e.dst = ((i0[i]+(n>>1))/b)*_shape[1] + (j0[i]+(n&1))/b;
+      e.src = i;
+      e.w   = w[n];
+      entries.push_back(e);
+    }
+  }
+  _build(entries, true);
+}
+
+//-------------------
+
+void ImageMapping::_build(std::vector<Entry>& entries, const bool accumulate)
+{
+  _accumulate = accumulate;
+
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const Entry& a, const Entry& b) {return a.dst < b.dst;});
+
+  // Without accumulation the last pixel at an image pixel wins, so only its entry is kept
+  if (!accumulate) {
+    size_t n = 0;
+    for(size_t k=0; k<entries.size(); ++k) {
+      if (k+1 < entries.size() && entries[k+1].dst == entries[k].dst) continue;
+      entries[n++] = entries[k];
+    }
+    entries.resize(n);
+  }
+
+  bool weighted = false;
+  for(size_t k=0; k<entries.size(); ++k) if (entries[k].w != 1) {weighted = true; break;}
+
+  _dst.resize(entries.size());
+  _src.resize(entries.size());
+  _w  .resize(weighted ? entries.size() : 0);
+  for(size_t k=0; k<entries.size(); ++k) {
+    _dst[k] = entries[k].dst;
+    _src[k] = entries[k].src;
+    if (weighted) _w[k] = entries[k].w;
+  }
+
+  // Blocks start where the image pixel changes, so that no two blocks write the same one
+  _block.assign(1, 0);
+  _first.assign(1, 0);
+  for(size_t k=BLOCK_ENTRIES; k<_dst.size(); k+=BLOCK_ENTRIES) {
+    while (k<_dst.size() && _dst[k]==_dst[k-1]) ++k;
+    if (k==_dst.size()) break;
+    _block.push_back(k);
+    _first.push_back(_dst[k]);
+  }
+  _block.push_back(_dst.size());
+  _first.push_back(_shape[0]*_shape[1]);
+
+  MSG(DEBUG, "ImageMapping of " << _size << " pixels to image " << _shape[0] << 'x' << _shape[1]
+      << " with " << _dst.size() << " entries in " << _block.size()-1 << " blocks");
+}
+
+//-------------------
+
+template<typename T>
+void ImageMapping::image(const T* data, image_t* img) const
+{
+  const long      nblocks = _block.size()-1;
+  const uint32_t* dst = _dst.data();
+  const uint32_t* src = _src.data();
+  const float*    w   = _w.data();
+
+  #pragma omp parallel for schedule(static) if(nblocks > 1)
+  for(long b=0; b<nblocks; ++b) {
+    const size_t k0 = _block[b];
+    const size_t k1 = _block[b+1];
+    std::fill(img+_first[b], img+_first[b+1], image_t(0));
+    if (!_accumulate) {
+      // image pixels are unique
+      #pragma omp simd
+      for(size_t k=k0; k<k1; ++k) img[dst[k]] = (image_t)data[src[k]];
+    }
+    else if (w) {
+      for(size_t k=k0; k<k1; ++k) img[dst[k]] += w[k]*(image_t)data[src[k]];
+    }
+    else {
+      for(size_t k=k0; k<k1; ++k) img[dst[k]] += (image_t)data[src[k]];
+    }
+  }
+}
+
+//-------------------
+
+template<typename T>
+void ImageMapping::image(const T* data, psalg::NDArray<image_t>& img) const
+{
+  const size_t n = size_t(_shape[0])*_shape[1];
+  const bool alloc = !img.data() || img.size() != n;
+  img.set_shape(_shape, 2);
+  // a buffer of an other size, owned or external, is replaced by an owned one
+  if (alloc) img.set_data_buffer(0);
+  image(data, img.data());
+}
+
+//-------------------
+
+#define INSTANTIATE_IMAGE(T)\
+  template void ImageMapping::image<T>(const T*, image_t*) const;\
+  template void ImageMapping::image<T>(const T*, psalg::NDArray<image_t>&) const;
+
+INSTANTIATE_IMAGE(double)
+INSTANTIATE_IMAGE(float)
+INSTANTIATE_IMAGE(uint16_t)
+INSTANTIATE_IMAGE(int32_t)
+
+//-------------------
+
+} // namespace geometry
+
+//-------------------
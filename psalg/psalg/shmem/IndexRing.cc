@@ -0,0 +1,208 @@
+#include "IndexRing.hh"
+
+#include <new>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+using namespace psalg::shmem;
+
+//
+//  The words are in memory shared between processes, so the futexes
+//  can't be process private
+//
+static long _futex(std::atomic<uint32_t>* addr, int op, uint32_t val,
+                   const timespec* tmo)
+{
+  return syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), op, val, tmo, NULL, 0);
+}
+
+void Doorbell::init()
+{
+  _seq    .store(0);
+  _waiters.store(0);
+}
+
+void Doorbell::ring()
+{
+  _seq.fetch_add(1);
+  if (_waiters.load())
+    _futex(&_seq, FUTEX_WAKE, INT_MAX, NULL);
+}
+
+bool Doorbell::wait(uint32_t seq, unsigned ms)
+{
+  timespec tmo;
+  tmo.tv_sec  = ms/1000;
+  tmo.tv_nsec = (ms%1000)*1000000;
+  _waiters.fetch_add(1);
+  long rc = _futex(&_seq, FUTEX_WAIT, seq, &tmo);
+  int  err = errno;
+  _waiters.fetch_sub(1);
+  return !(rc < 0 && err == ETIMEDOUT);
+}
+
+static uint32_t _capacity(unsigned depth)
+{
+  uint32_t n = 1;
+  while(n < depth)  n <<= 1;
+  return n;
+}
+
+size_t IndexRing::size(unsigned depth)
+{
+  size_t sz = sizeof(IndexRing) + _capacity(depth)*sizeof(Cell);
+  return (sz + 63) & ~size_t(63);
+}
+
+void IndexRing::init(unsigned depth)
+{
+  uint32_t n = _capacity(depth);
+  _head.store(0);
+  _tail.store(0);
+  _mask  = n-1;
+  _depth = depth;
+  Cell* cells = _cells();
+  for(uint32_t i=0; i<n; i++) {
+    new(&cells[i].seq) std::atomic<uint32_t>(i);
+    cells[i].index = 0;
+  }
+}
+
+//
+//  Bounded MPMC queue after D. Vyukov: each cell's sequence number tells
+//  whether it is free for the push at a position or full for the pop
+//
+bool IndexRing::push(uint32_t index)
+{
+  Cell*    cells = _cells();
+  uint32_t pos   = _head.load(std::memory_order_relaxed);
+  while(1) {
+    Cell&   cell = cells[pos & _mask];
+    int32_t dif  = int32_t(cell.seq.load(std::memory_order_acquire) - pos);
+    if (dif == 0) {
+      if (pos - _tail.load(std::memory_order_relaxed) >= _depth)
+        return false;
+      if (_head.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed)) {
+        cell.index = index;
+        cell.seq.store(pos+1, std::memory_order_release);
+        return true;
+      }
+    }
+    else if (dif < 0)
+      return false;
+    else
+      pos = _head.load(std::memory_order_relaxed);
+  }
+}
+
+bool IndexRing::pop(uint32_t& index)
+{
+  Cell*    cells = _cells();
+  uint32_t pos   = _tail.load(std::memory_order_relaxed);
+  while(1) {
+    Cell&   cell = cells[pos & _mask];
+    int32_t dif  = int32_t(cell.seq.load(std::memory_order_acquire) - (pos+1));
+    if (dif == 0) {
+      if (_tail.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed)) {
+        index = cell.index;
+        cell.seq.store(pos+_mask+1, std::memory_order_release);
+        return true;
+      }
+    }
+    else if (dif < 0)
+      return false;
+    else
+      pos = _tail.load(std::memory_order_relaxed);
+  }
+}
+
+void IndexRing::depth(unsigned depth)
+{
+  _depth = depth < _mask+1 ? depth : _mask+1;
+}
+
+unsigned IndexRing::count() const
+{
+  return _head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_relaxed);
+}
+
+size_t MonitorRings::size(unsigned nqueues, unsigned nbuffers)
+{
+  return sizeof(Client)*(nqueues+2) + IndexRing::size(nbuffers)*(nqueues+3) +
+    sizeof(std::atomic<uint64_t>)*nbuffers;
+}
+
+MonitorRings* MonitorRings::create(void* p, unsigned nqueues, unsigned nbuffers)
+{
+  MonitorRings* r = reinterpret_cast<MonitorRings*>(p);
+  r->_magic    = 0;
+  r->_nqueues  = nqueues;
+  r->_ringSize = IndexRing::size(nbuffers);
+  r->_nbuffers = nbuffers;
+  for(unsigned i=0; i<=nqueues; i++) {
+    Client& c = r->_clients()[i];
+    c.bell.init();
+    new(&c.transitions) std::atomic<uint32_t>(0);
+  }
+  //  The client event queues hold a share of the buffers, like the
+  //  message queues they replace
+  for(unsigned q=0; q<nqueues+3; q++)
+    r->_ring(q).init(nbuffers);
+  for(unsigned q=0; q<nqueues; q++)
+    r->depth(q, nbuffers/nqueues);
+  for(unsigned i=0; i<nbuffers; i++)
+    new(&r->_holders()[i]) std::atomic<uint64_t>(0);
+  std::atomic_thread_fence(std::memory_order_release);
+  r->_magic    = Magic;
+  return r;
+}
+
+MonitorRings* MonitorRings::attach(void* p)
+{
+  MonitorRings* r = reinterpret_cast<MonitorRings*>(p);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return r->_magic == Magic ? r : 0;
+}
+
+bool MonitorRings::post(unsigned q, uint32_t index)
+{
+  if (!_ring(q).push(index))
+    return false;
+  if (q < _nqueues)
+    bell(q).ring();
+  else if (q != request())              // Never waited on
+    bell(_nqueues).ring();
+  return true;
+}
+
+Doorbell& MonitorRings::bell(unsigned client)
+{
+  return _clients()[client].bell;
+}
+
+std::atomic<uint32_t>& MonitorRings::transitions(unsigned client)
+{
+  return _clients()[client].transitions;
+}
+
+bool MonitorRings::release(uint32_t index, unsigned holder)
+{
+  uint64_t bit = 1ULL<<holder;
+  return _holders()[index].fetch_and(~bit) == bit;
+}
+
+IndexRing& MonitorRings::_ring(unsigned q)
+{
+  char* p = reinterpret_cast<char*>(this) + sizeof(Client)*(_nqueues+2) + size_t(_ringSize)*q;
+  return *reinterpret_cast<IndexRing*>(p);
+}
+
+std::atomic<uint64_t>* MonitorRings::_holders()
+{
+  char* p = reinterpret_cast<char*>(this) + sizeof(Client)*(_nqueues+2) + size_t(_ringSize)*(_nqueues+3);
+  return reinterpret_cast<std::atomic<uint64_t>*>(p);
+}
@@ -0,0 +1,114 @@
+#ifndef PsAlg_ShMem_IndexRing_hh
+#define PsAlg_ShMem_IndexRing_hh
+
+//--------------------------------------
+//
+//  Shared memory buffer index queues for the XtcMonitorServer and its
+//  clients, as an alternative to the POSIX message queues.
+//
+//  The queues are bounded multi-producer/multi-consumer rings of
+//  buffer indices that live in the server's shared memory segment, so
+//  that passing an event between the server and a client is a few
+//  atomic operations rather than a system call per hop.  A consumer
+//  that finds its ring empty sleeps on a futex (Doorbell), which the
+//  producers only wake, with a system call, when someone is sleeping.
+//
+//-----------------------------------
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace psalg {
+  namespace shmem {
+
+    class Doorbell {
+    public:
+      void     init    ();
+      uint32_t sequence() const { return _seq.load(); }
+      //  Wake the waiters, if any
+      void     ring    ();
+      //  Sleep until rung, unless it has been since sequence() returned
+      //  seq; false on timeout
+      bool     wait    (uint32_t seq, unsigned ms);
+    private:
+      std::atomic<uint32_t> _seq;
+      std::atomic<uint32_t> _waiters;
+    };
+
+    class IndexRing {
+    public:
+      static size_t size(unsigned depth);
+      void     init (unsigned depth);
+    public:
+      bool     push (uint32_t index);  // false when full
+      bool     pop  (uint32_t& index); // false when empty
+      unsigned count() const;
+      void     depth(unsigned depth);  // at most the depth it was initialized with
+    private:
+      struct Cell {
+        std::atomic<uint32_t> seq;
+        uint32_t              index;
+      };
+      Cell* _cells() { return reinterpret_cast<Cell*>(this+1); }
+    private:
+      alignas(64) std::atomic<uint32_t> _head;  // next position to push
+      alignas(64) std::atomic<uint32_t> _tail;  // next position to pop
+      alignas(64) uint32_t              _mask;
+      uint32_t                          _depth; // may be less than the capacity
+    };
+
+    //
+    //  The set of rings of an XtcMonitorServer.  Rings [0,nqueues) are those
+    //  of the event queues of the clients, ring nqueues (input()) returns
+    //  buffers to the server, and the request() and shuffle() rings are
+    //  internal to the server.
+    //
+    //  In broadcast mode, an event buffer is queued to every client and
+    //  each buffer has the set of clients still holding it, so that the
+    //  last one to release it returns it to the server.
+    //
+    class MonitorRings {
+    public:
+      enum { Magic = 0x474e4952 };
+      static size_t        size  (unsigned nqueues, unsigned nbuffers);
+      static MonitorRings* create(void* p, unsigned nqueues, unsigned nbuffers);
+      static MonitorRings* attach(void* p);
+    public:
+      unsigned input  () const { return _nqueues; }
+      unsigned request() const { return _nqueues+1; }
+      unsigned shuffle() const { return _nqueues+2; }
+      //  Queue an index and wake the consumer of ring q
+      bool     post   (unsigned q, uint32_t index);
+      bool     take   (unsigned q, uint32_t& index) { return _ring(q).pop(index); }
+      unsigned count  (unsigned q) const { return const_cast<MonitorRings*>(this)->_ring(q).count(); }
+      //  The doorbell of a client or, for input(), of the server
+      Doorbell& bell  (unsigned client);
+      //  Number of transitions sent to a client over its socket
+      std::atomic<uint32_t>& transitions(unsigned client);
+      //  Limit the number of buffers queued to a client
+      void     depth  (unsigned client, unsigned depth) { _ring(client).depth(depth); }
+    public:
+      enum { MaxHolders = 63, Server = 63 }; // the server holds a buffer while broadcasting it
+      void     hold   (uint32_t index, uint64_t holders) { _holders()[index].store(holders); }
+      bool     holds  (uint32_t index, unsigned holder) { return _holders()[index].load() & (1ULL<<holder); }
+      //  True when this was the last holder of the buffer
+      bool     release(uint32_t index, unsigned holder);
+    private:
+      struct Client {
+        alignas(64) Doorbell  bell;
+        std::atomic<uint32_t> transitions;
+      };
+      Client*    _clients() { return reinterpret_cast<Client*>(reinterpret_cast<char*>(this)+sizeof(Client)); }
+      IndexRing& _ring(unsigned q);
+      std::atomic<uint64_t>* _holders();
+    private:
+      uint32_t _magic;
+      uint32_t _nqueues;
+      uint32_t _ringSize;   // bytes per ring
+      uint32_t _nbuffers;
+    };
+  };
+};
+
+#endif
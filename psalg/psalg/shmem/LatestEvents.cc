@@ -0,0 +1,115 @@
+#include "LatestEvents.hh"
+
+#include "xtcdata/xtc/Dgram.hh"
+
+#include <new>
+#include <string.h>
+#include <unistd.h>
+
+using namespace psalg::shmem;
+
+size_t LatestEvents::size()
+{
+  size_t pageSize = sysconf(_SC_PAGESIZE);
+  return (sizeof(LatestEvents) + pageSize - 1) / pageSize * pageSize;
+}
+
+LatestEvents* LatestEvents::create(void* p, size_t sizeOfBuffers, unsigned nbuffers)
+{
+  if (nbuffers > MaxBuffers)
+    return nullptr;
+
+  LatestEvents* r = new(p) LatestEvents;
+  r->_nbuffers      = nbuffers;
+  r->_sizeOfBuffers = sizeOfBuffers;
+  r->_publishing.store(0);
+  r->_head     .store(0);
+  r->_configure.store(uint64_t(1)<<32); // an odd sequence number is never current
+  for(unsigned i=0; i<Depth; i++)
+    r->_slots[i].store(uint64_t(1)<<32);
+  for(unsigned i=0; i<MaxBuffers; i++)
+    r->_sequence[i].store(0);
+  r->_magic = Magic;
+  r->_running.store(1, std::memory_order_release);
+  return r;
+}
+
+LatestEvents* LatestEvents::attach(const void* p)
+{
+  const LatestEvents* r = reinterpret_cast<const LatestEvents*>(p);
+  return r->_magic == Magic ? const_cast<LatestEvents*>(r) : nullptr;
+}
+
+void LatestEvents::modify(unsigned index)
+{
+  uint32_t seq = _sequence[index].load(std::memory_order_relaxed);
+  if (!(seq&1)) {
+    _sequence[index].store(seq+1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+}
+
+void LatestEvents::publish(unsigned index, bool configure)
+{
+  uint32_t seq  = (_sequence[index].load(std::memory_order_relaxed) | 1) + 1;
+  _sequence[index].store(seq, std::memory_order_release);
+
+  //  Events and transitions are published by different threads
+  while (_publishing.exchange(1, std::memory_order_acquire))
+    ;
+
+  uint64_t slot = uint64_t(seq)<<32 | index;
+  uint64_t head = _head.load(std::memory_order_relaxed);
+  _slots[head % Depth].store(slot, std::memory_order_relaxed);
+  if (configure)
+    _configure.store(slot, std::memory_order_relaxed);
+  _head.store(head+1, std::memory_order_release);
+
+  _publishing.store(0, std::memory_order_release);
+}
+
+void LatestEvents::shutdown()
+{
+  _running.store(0, std::memory_order_release);
+}
+
+size_t LatestEvents::read(uint64_t seq, const char* buffers, void* dst, size_t maxsize) const
+{
+  if (seq >= head())
+    return 0;
+  uint64_t slot = _slots[seq % Depth].load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (_head.load(std::memory_order_relaxed) - seq >= Depth)
+    return 0;                           // the slot may have been reused
+  return _copy(slot, buffers, dst, maxsize);
+}
+
+size_t LatestEvents::readConfigure(const char* buffers, void* dst, size_t maxsize, uint64_t& slot) const
+{
+  slot = _configure.load(std::memory_order_acquire);
+  return _copy(slot, buffers, dst, maxsize);
+}
+
+size_t LatestEvents::_copy(uint64_t slot, const char* buffers, void* dst, size_t maxsize) const
+{
+  unsigned index = slot & 0xffffffff;
+  uint32_t seq   = slot >> 32;
+  if ((seq&1) || index >= _nbuffers)
+    return 0;
+  if (_sequence[index].load(std::memory_order_acquire) != seq)
+    return 0;
+
+  //  The size may be garbage if the buffer is being rewritten, which the
+  //  second check of the sequence number catches
+  const char* src = buffers + _sizeOfBuffers*index;
+  const XtcData::Dgram* dg = reinterpret_cast<const XtcData::Dgram*>(src);
+  size_t sz = sizeof(XtcData::Dgram) + dg->xtc.sizeofPayload();
+  if (sz > _sizeOfBuffers)  sz = _sizeOfBuffers;
+  if (sz > maxsize)         sz = maxsize;
+  memcpy(dst, src, sz);
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (_sequence[index].load(std::memory_order_relaxed) != seq)
+    return 0;
+  return sz;
+}
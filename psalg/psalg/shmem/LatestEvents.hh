@@ -0,0 +1,64 @@
+#ifndef PsAlg_ShMem_LatestEvents_hh
+#define PsAlg_ShMem_LatestEvents_hh
+
+//--------------------------------------
+//
+//  A record of the datagrams most recently published by an XtcMonitorServer,
+//  at the end of its shared memory segment, for readers that only want to
+//  sample the live data.
+//
+//  Each buffer has a sequence number which is odd while the server writes
+//  the buffer and even once the datagram in it is complete (a seqlock).
+//  A reader copies a published datagram out of the buffer and keeps the
+//  copy if the sequence number didn't change meanwhile.  The readers only
+//  read the shared memory, so there may be any number of them and the
+//  server neither knows of them nor waits for them.
+//
+//-----------------------------------
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace psalg {
+  namespace shmem {
+
+    class LatestEvents {
+    public:
+      enum { Magic = 0x5453414c, MaxBuffers = 512, Depth = 16 };
+      //  Fixed, so that a reader finds the record from the size of the segment
+      static size_t        size  ();
+      static LatestEvents* create(void* p, size_t sizeOfBuffers, unsigned nbuffers);
+      static LatestEvents* attach(const void* p);
+    public:  // server
+      void     modify  (unsigned index);  // the buffer is about to be written
+      void     publish (unsigned index, bool configure);
+      void     shutdown();
+    public:  // readers
+      bool     running      () const { return _running.load(std::memory_order_acquire); }
+      size_t   sizeOfBuffers() const { return _sizeOfBuffers; }
+      //  Number of datagrams published
+      uint64_t head         () const { return _head.load(std::memory_order_acquire); }
+      //  Copy the datagram published as number seq, or the last Configure,
+      //  out of the buffers.  Returns its size, or 0 if it is no longer
+      //  available.  The position of the Configure is returned in slot, to
+      //  tell when it changes.
+      size_t   read         (uint64_t seq, const char* buffers, void* dst, size_t maxsize) const;
+      size_t   readConfigure(const char* buffers, void* dst, size_t maxsize, uint64_t& slot) const;
+    private:
+      size_t   _copy        (uint64_t slot, const char* buffers, void* dst, size_t maxsize) const;
+    private:
+      uint32_t              _magic;
+      uint32_t              _nbuffers;
+      uint64_t              _sizeOfBuffers;
+      std::atomic<uint32_t> _running;
+      std::atomic<uint32_t> _publishing;
+      std::atomic<uint64_t> _head;
+      std::atomic<uint64_t> _configure;          // sequence number << 32 | index
+      std::atomic<uint64_t> _slots[Depth];       // of the latest datagrams
+      std::atomic<uint32_t> _sequence[MaxBuffers];
+    };
+  };
+};
+
+#endif
@@ -17,7 +17,10 @@
 #include "xtcdata/xtc/Dgram.hh"
 #include "ShmemClient.hh"
 #include "XtcMonitorMsg.hh"
+#include "IndexRing.hh"
+#include "LatestEvents.hh"
 
+#include <errno.h>
 #include <poll.h>
 
 //#define DBUG
@@ -28,6 +31,12 @@ enum {PERMS_IN  = S_IRUSR|S_IRGRP|S_IROTH};
 enum {PERMS_OUT  = S_IWUSR|S_IWGRP|S_IWOTH};
 enum {OFLAGS = O_RDONLY};
 
+//  Time between checks that the server is still there when using rings
+static const unsigned RING_TMO_MS = 1000;
+
+//  Interval at which a snapshot client looks for a newer datagram
+static const unsigned SAMPLE_POLL_US = 1000;
+
 /*
 ** ++
 **
@@ -79,6 +88,7 @@ namespace psalg {
       int                          _trfd;
       mqd_t                        _evqin;
       mqd_t*                       _evqout;
+      MonitorRings*                _rings;
       unsigned                     _ev_index;
       const char*                  _tag;
       char*                        _shm;
@@ -95,10 +105,10 @@ namespace psalg {
       */
 
       DgramHandler(ShmemClient& client, XtcMonitorMsg myMsg,
-                   int trfd, mqd_t evqin, mqd_t* evqout, unsigned ev_index,
-                   const char* tag, char* myShm) :
+                   int trfd, mqd_t evqin, mqd_t* evqout, MonitorRings* rings,
+                   unsigned ev_index, const char* tag, char* myShm) :
         _client(client), _myMsg(myMsg),
-        _trfd(trfd), _evqin(evqin), _evqout(evqout), _ev_index(ev_index),
+        _trfd(trfd), _evqin(evqin), _evqout(evqout), _rings(rings), _ev_index(ev_index),
         _tag(tag), _shm(myShm)
       {
         _tmo.tv_sec = _tmo.tv_nsec = 0;
@@ -124,7 +134,18 @@ namespace psalg {
 #ifdef DBUG
               printf("ShmemClient DgramHandler free dgram index %d size %d\n",index,size);
 #endif
-              mq_timedsend(oq[ioq], (const char *)&myMsg, sizeof(myMsg), priority, &_tmo);
+              if (_rings) {
+                  //  Pass the event to the next client in the chain
+                  //  or back to the server.  A broadcast event is
+                  //  returned by the last of the clients to release it.
+                  if (_myMsg.broadcast() && !_rings->release(index, _ev_index))
+                      return;
+                  unsigned q = _myMsg.serial() ? _ev_index+1 : _myMsg.return_queue();
+                  if (!_rings->post(q, index))
+                      fprintf(stderr, "ShmemClient: ring %u is full for buffer %d\n", q, index);
+              }
+              else
+                  mq_timedsend(oq[ioq], (const char *)&myMsg, sizeof(myMsg), priority, &_tmo);
           } else {
               if(::send(_trfd,(char*)&myMsg,sizeof(myMsg),MSG_NOSIGNAL)<0) {
                   // cpo: we can get an error if the server exits
@@ -132,6 +153,8 @@ namespace psalg {
                   // the server alive? print a warning?
                   perror("ShmemClient.cc: transition send error (can happen if server exits)");
               }
+              else if (_rings)
+                  _rings->bell(_myMsg.numberOfQueues()).ring();
           }
       }
 
@@ -188,6 +211,19 @@ namespace psalg {
       */
 
       XtcData::Dgram* event(int &index, size_t &size) {
+        if (_rings) {
+          uint32_t i;
+          if (!_rings->take(_ev_index, i))
+            return NULL;
+          if (int(i) < _myMsg.numberOfBuffers()) {
+            index = i;
+            size = _myMsg.sizeOfBuffers();
+            return (XtcData::Dgram*) (_shm + (size * (size_t)i));
+          }
+          fprintf(stderr, "ILLEGAL EV BUFFER INDEX %d numBuffers %d\n", i,_myMsg.numberOfBuffers());
+          return NULL;
+        }
+
         mqd_t  iq = _evqin;
 
         XtcMonitorMsg myMsg;
@@ -241,7 +277,16 @@ ShmemClient::ShmemClient() :
   _handler          (0),
   _numberOfEvQueues (0),
   _myInputEvQueue   ((mqd_t)-1),
-  _myOutputEvQueue  (nullptr)
+  _myOutputEvQueue  (nullptr),
+  _rings            (nullptr),
+  _evIndex          (0),
+  _transitions      (0),
+  _latest           (nullptr),
+  _myShm            (nullptr),
+  _sizeOfShm        (0),
+  _sample_buffer    (nullptr),
+  _next             (0),
+  _configure        (0)
 {
 }
 
@@ -263,6 +308,11 @@ void ShmemClient::_shutdown()
 
   if (_handler)          { delete    _handler;          _handler = 0; }
   if (_myOutputEvQueue)  { delete [] _myOutputEvQueue;  _myOutputEvQueue = nullptr; }
+  _rings = nullptr;
+
+  if (_myShm)            { munmap(_myShm, _sizeOfShm);  _myShm = nullptr; }
+  if (_sample_buffer)    { delete [] _sample_buffer;    _sample_buffer = nullptr; }
+  _latest = nullptr;
 
   if (!(_myTrFd < 0))    { ::close(_myTrFd);            _myTrFd = -1; }
 }
@@ -276,6 +326,8 @@ void ShmemClient::_shutdown()
 
 void ShmemClient::free(int index, size_t size)
 {
+  if (_latest)  return;                 // get() returned a copy, which the client owns
+
   _handler->free(index,size);
 }
 
@@ -291,6 +343,34 @@ void* ShmemClient::get(int& index, size_t& size)
   index = -1;
   size = 0;
 
+  if (_latest)
+    return _sample(index,size);
+
+  if (_rings) {
+    //
+    //  The server counts the transitions it sends and rings our doorbell,
+    //  so the socket is only read when there is one
+    //
+    Doorbell& bell = _rings->bell(_evIndex);
+    while (1) {
+      uint32_t seq = bell.sequence();
+      if (_rings->transitions(_evIndex).load() != _transitions) {
+        ++_transitions;
+        return _handler->transition(index,size);
+      }
+      XtcData::Dgram* dg = _handler->event(index,size);
+      if (dg)
+        return dg;
+      if (!bell.wait(seq, RING_TMO_MS)) {
+        //  Return NULL if the server has disconnected
+        char c;
+        ssize_t r = ::recv(_myTrFd, &c, sizeof(c), MSG_PEEK|MSG_DONTWAIT);
+        if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+          return NULL;
+      }
+    }
+  }
+
   while (1) {
     if (::poll(_pfd, _nfd, -1) > 0) {
       if (_pfd[0].revents & POLLIN) { // Transition
@@ -311,6 +391,41 @@ void* ShmemClient::get(int& index, size_t& size)
 ** --
 */
 
+void* ShmemClient::_sample(int& index, size_t& size)
+{
+  size_t maxsize = _latest->sizeOfBuffers();
+  while (_latest->running()) {
+    uint64_t slot;
+    size_t sz = _latest->readConfigure(_myShm, _sample_buffer, maxsize, slot);
+    if (sz && slot != _configure) {
+      _configure = slot;
+      size = sz;
+      return _sample_buffer;
+    }
+
+    uint64_t head = _latest->head();
+    if (head > _next) {
+      _next = head;
+      sz = _latest->read(head-1, _myShm, _sample_buffer, maxsize);
+      if (sz && reinterpret_cast<Dgram*>(_sample_buffer)->service() != TransitionId::Configure) {
+        size = sz;
+        return _sample_buffer;
+      }
+      continue;
+    }
+
+    usleep(SAMPLE_POLL_US);
+  }
+  return NULL;                          // the server has exited
+}
+
+/*
+** ++
+**
+**
+** --
+*/
+
 int ShmemClient::connect(const char* tag, int tr_index) {
   int error = 0;
   char* qname = new char[128];
@@ -390,36 +505,55 @@ int ShmemClient::connect(const char* tag, int tr_index) {
   printf("Opening shared memory %s of size 0x%zx (0x%x * 0x%zx)\n",
 	 qname,sizeOfShm,myMsg.numberOfBuffers(),myMsg.sizeOfBuffers());
 
-  int shm = shm_open(qname, OFLAGS, PERMS_IN);
+  //  The rings following the buffers are written by the clients too
+  size_t sizeOfRings = myMsg.sizeOfRings();
+  int shm = shm_open(qname, sizeOfRings ? O_RDWR : OFLAGS, PERMS_IN);
   if (shm < 0) perror("shm_open");
   char* myShm = (char*)mmap(NULL, sizeOfShm, PROT_READ, MAP_SHARED, shm, 0);
   if (myShm == MAP_FAILED) perror("mmap");
   else printf("Shared memory at %p\n", (void*)myShm);
 
+  if (sizeOfRings) {
+    void* p = mmap(NULL, sizeOfRings, PROT_READ|PROT_WRITE, MAP_SHARED, shm, sizeOfShm);
+    if (p == MAP_FAILED) perror("mmap rings");
+    else if (!(_rings = MonitorRings::attach(p))) {
+      fprintf(stderr, "No event rings found in shared memory\n");
+      error++;
+    }
+  }
+
   close(shm);  // Done with the file descriptor
 
   int ev_index = myMsg.bufferIndex();
-  XtcMonitorMsg::eventInputQueue(tag,ev_index,qname);
-  _myInputEvQueue = _openQueue(qname, O_RDONLY, PERMS_IN);
-  if (_myInputEvQueue == (mqd_t)-1)
-    error++;
+  _evIndex     = ev_index;
+  _transitions = 0;
 
   _numberOfEvQueues = myMsg.numberOfQueues()+1;
   _myOutputEvQueue = new mqd_t[_numberOfEvQueues];
   for(int i=0; i<=myMsg.numberOfQueues(); i++)
     _myOutputEvQueue[i]=-1;
 
-  if (myMsg.serial()) {
-    XtcMonitorMsg::eventOutputQueue(tag,ev_index,qname);
-    _myOutputEvQueue[ev_index] = _openQueue(qname, O_WRONLY, PERMS_OUT);
-    if (_myOutputEvQueue[ev_index] == (mqd_t)-1)
-      error++;
+  if (_rings) {
+    printf("Using shared memory rings for the event queues\n");
   }
   else {
-    XtcMonitorMsg::eventInputQueue(tag,myMsg.return_queue(),qname);
-    _myOutputEvQueue[ev_index] = _openQueue(qname, O_WRONLY, PERMS_OUT);
-    if (_myOutputEvQueue[ev_index] == (mqd_t)-1)
+    XtcMonitorMsg::eventInputQueue(tag,ev_index,qname);
+    _myInputEvQueue = _openQueue(qname, O_RDONLY, PERMS_IN);
+    if (_myInputEvQueue == (mqd_t)-1)
       error++;
+
+    if (myMsg.serial()) {
+      XtcMonitorMsg::eventOutputQueue(tag,ev_index,qname);
+      _myOutputEvQueue[ev_index] = _openQueue(qname, O_WRONLY, PERMS_OUT);
+      if (_myOutputEvQueue[ev_index] == (mqd_t)-1)
+        error++;
+    }
+    else {
+      XtcMonitorMsg::eventInputQueue(tag,myMsg.return_queue(),qname);
+      _myOutputEvQueue[ev_index] = _openQueue(qname, O_WRONLY, PERMS_OUT);
+      if (_myOutputEvQueue[ev_index] == (mqd_t)-1)
+        error++;
+    }
   }
   delete[] qname;
 
@@ -445,8 +579,56 @@ int ShmemClient::connect(const char* tag, int tr_index) {
   _handler = new DgramHandler(*this,
                               myMsg,
                               _myTrFd,
-                              _myInputEvQueue, _myOutputEvQueue, ev_index,
+                              _myInputEvQueue, _myOutputEvQueue, _rings, ev_index,
                               tag,myShm);
 
   return 0;
 }
+
+/*
+** ++
+**
+**
+** --
+*/
+
+int ShmemClient::snapshot(const char* tag) {
+  _shutdown();
+
+  char shmName[128];
+  XtcMonitorMsg::sharedMemoryName(tag, shmName);
+  int shm = shm_open(shmName, OFLAGS, PERMS_IN);
+  if (shm < 0) {
+    perror("shm_open");
+    return 1;
+  }
+
+  //  The record of the latest datagrams ends the segment
+  struct stat st;
+  if (fstat(shm, &st) < 0 || size_t(st.st_size) < LatestEvents::size()) {
+    fprintf(stderr, "No record of the latest events in shared memory %s\n", shmName);
+    close(shm);
+    return 1;
+  }
+  void* p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, shm, 0);
+  close(shm);  // Done with the file descriptor
+  if (p == MAP_FAILED) {
+    perror("mmap");
+    return 1;
+  }
+  _myShm     = (char*)p;
+  _sizeOfShm = st.st_size;
+
+  if (!(_latest = LatestEvents::attach(_myShm + _sizeOfShm - LatestEvents::size()))) {
+    fprintf(stderr, "No record of the latest events in shared memory %s\n", shmName);
+    _shutdown();
+    return 1;
+  }
+
+  _sample_buffer = new char[_latest->sizeOfBuffers()];
+  _next          = _latest->head();
+  _configure     = 0;
+
+  printf("Sampling the latest events in shared memory %s\n", shmName);
+  return 0;
+}
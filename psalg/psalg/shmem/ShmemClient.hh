@@ -4,6 +4,7 @@
 #include <poll.h>
 #include <stddef.h>
 #include <mqueue.h>
+#include <stdint.h>
 
 namespace XtcData {
 
@@ -15,6 +16,8 @@ namespace psalg {
   namespace shmem {
 
     class DgramHandler;
+    class MonitorRings;
+    class LatestEvents;
 
     class ShmemClient {
     public:
@@ -27,12 +30,26 @@ namespace psalg {
       //  unique values of ev_index produce a serial chain of clients sharing events
       //  common values of ev_index produce a set of clients competing for events
       //
+      //  When the server passes events through shared memory rings rather
+      //  than message queues, get() and free() don't need system calls
+      //
       int connect(const char* tag, int tr_index=0);
       void* get(int& index, size_t& size);
       void free(int index, size_t size);
+      //
+      //  Alternatively, sample the datagrams the server most recently
+      //  distributed without connecting to it: get() then returns a copy of
+      //  the latest datagram published since the previous call, preceded by
+      //  the Configure whenever that changes, with the size of the datagram.
+      //  The copy is in a buffer of the client, which the next get()
+      //  overwrites, so free() does nothing.  Any number of clients may do
+      //  so without costing the server anything.
+      //
+      int snapshot(const char* tag);
 
     private:
       void _shutdown();
+      void* _sample(int& index, size_t& size);
 
     private:
       int           _myTrFd;
@@ -42,6 +59,15 @@ namespace psalg {
       unsigned      _numberOfEvQueues;  // number of message queues for events
       mqd_t         _myInputEvQueue;    // message queue for returned events
       mqd_t*        _myOutputEvQueue;   // message queues[nclients] for distributing events
+      MonitorRings* _rings;             // or the rings in place of the queues
+      unsigned      _evIndex;
+      uint32_t      _transitions;       // number of transitions received
+      LatestEvents* _latest;            // in snapshot mode
+      char*         _myShm;
+      size_t        _sizeOfShm;
+      char*         _sample_buffer;     // copy of the datagram returned by get()
+      uint64_t      _next;              // number of the next datagram published
+      uint64_t      _configure;         // position of the last Configure returned
     };
   };
 };
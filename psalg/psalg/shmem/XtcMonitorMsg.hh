@@ -26,12 +26,19 @@ namespace psalg {
       size_t sizeOfBuffers() const { return (size_t)_sizeOfBuffers&SizeMask; }
       bool serial         () const { return return_queue()==0; }
       int return_queue    () const { return (_numberOfBuffers>>16)&0xff; }
+      //  Every event is queued to all clients (with rings only)
+      bool broadcast      () const { return (_numberOfBuffers>>24)&1; }
+      //  Size of the MonitorRings following the buffers in shared memory;
+      //  0 when the event queues are POSIX message queues
+      size_t sizeOfRings  () const { return _reserved; }
     public:
       XtcMonitorMsg* bufferIndex(int b) {_bufferIndex=b; return this;}
       void numberOfBuffers      (int n) {_numberOfBuffers &= ~0xff; _numberOfBuffers |= ((n&0xff)<<0); }
       void numberOfQueues       (int n) {_numberOfBuffers &= ~0xff00; _numberOfBuffers |= ((n&0xff)<<8); }
       void sizeOfBuffers        (int s) {_sizeOfBuffers = (_sizeOfBuffers&~SizeMask) | (s&SizeMask);}
       void return_queue         (int q) {_numberOfBuffers &= ~0xff0000; _numberOfBuffers |= ((q&0xff)<<16); }
+      void broadcast           (bool b) {_numberOfBuffers &= ~(1<<24); _numberOfBuffers |= (int(b)<<24); }
+      void sizeOfRings          (size_t s) {_reserved = s;}
     public:
       static void sharedMemoryName     (const char* tag, char* buffer);
       static void eventInputQueue      (const char* tag, unsigned client, char* buffer);
@@ -43,7 +50,7 @@ namespace psalg {
       int32_t  _bufferIndex;
       int32_t  _numberOfBuffers;
       uint32_t _sizeOfBuffers; // hoping we don't get larger than 4GB and SizeMask matters
-      uint32_t _reserved;
+      uint32_t _reserved;      // size of the MonitorRings
     };
   };
 };
@@ -1,5 +1,7 @@
 #include "XtcMonitorServer.hh"
 #include "TransitionCache.hh"
+#include "IndexRing.hh"
+#include "LatestEvents.hh"
 
 #include "xtcdata/xtc/Dgram.hh"
 
@@ -38,6 +40,12 @@ static const unsigned numberofTrBuffers=18;
 //
 static const unsigned TMO_SEC = 10;
 
+//
+//  With rings, the sockets are checked when the server's doorbell has not
+//  been rung for this long
+//
+static const unsigned RING_TMO_MS = 100;
+
 #define PERMS (S_IRUSR|S_IRGRP|S_IROTH|S_IWUSR|S_IWGRP|S_IWOTH)
 #define PERMS_IN (S_IRUSR|S_IRGRP|S_IROTH)
 #define OFLAGS (O_CREAT|O_RDWR)
@@ -90,7 +98,8 @@ void sigfunc(int sig_no) {
 XtcMonitorServer::XtcMonitorServer(const char* tag,
                                    unsigned sizeofBuffers,
                                    unsigned numberofEvBuffers,
-                                   unsigned numberofEvQueues) :
+                                   unsigned numberofEvQueues,
+                                   bool     rings) :
   _tag              (tag),
   _sizeOfBuffers    (sizeofBuffers),
   _numberOfEvBuffers(numberofEvBuffers),
@@ -105,12 +114,19 @@ XtcMonitorServer::XtcMonitorServer(const char* tag,
   _nfd              (3),
   _shuffleQueue     (-1),
   _requestQueue     (-1),
+  _rings            (0),
+  _sizeOfRings      (rings ? MonitorRings::size(numberofEvQueues, numberofEvBuffers) : 0),
+  _latest           (0),
   _ievt             (0)
 {
   _myMsg.numberOfBuffers(numberofEvBuffers+numberofTrBuffers);
   _myMsg.numberOfQueues (numberofEvQueues);
   _myMsg.sizeOfBuffers  (sizeofBuffers);
   _myMsg.return_queue   (0);
+  _myMsg.sizeOfRings    (_sizeOfRings);
+
+  for(unsigned i=0; i<numberofEvQueues; i++)
+    _myOutputEvQueue[i] = (mqd_t)-1;
 
   _tmo.tv_sec  = 0;
   _tmo.tv_nsec = 0;
@@ -159,43 +175,139 @@ void XtcMonitorServer::distribute(bool l)
   unsigned rq = l ? _numberOfEvQueues : 0;
   _myMsg.return_queue( rq );
 
-  _replQueue(_requestQueue  , rq);
-  _replQueue(_myInputEvQueue, rq);
+  _replQueue(_numberOfEvQueues+1, rq);  // request queue
+  _replQueue(_numberOfEvQueues  , rq);  // input queue
 }
 
-bool XtcMonitorServer::_send(Dgram* dg)
+void XtcMonitorServer::broadcast()
+{
+  if (!_rings) {
+    printf("Broadcasting events requires the shared memory rings; distributing them serially\n");
+    distribute(false);
+    return;
+  }
+  if (_numberOfEvQueues > MonitorRings::MaxHolders) {
+    printf("Broadcasting events to at most %u clients; distributing them serially\n",
+           unsigned(MonitorRings::MaxHolders));
+    distribute(false);
+    return;
+  }
+
+  distribute(true);                     // the last client returns buffers to the server
+  _myMsg.broadcast(true);
+
+  //  Any client may have all of the events queued
+  for(unsigned i=0; i<_numberOfEvQueues; i++)
+    _rings->depth(i, _numberOfEvBuffers);
+}
+
+mqd_t XtcMonitorServer::_queue(unsigned q) const
+{
+  if (q <  _numberOfEvQueues)    return _myOutputEvQueue[q];
+  if (q == _numberOfEvQueues)    return _myInputEvQueue;
+  if (q == _numberOfEvQueues+1)  return _requestQueue;
+  return _shuffleQueue;
+}
+
+//
+//  Non-blocking queue operations
+//
+bool XtcMonitorServer::_post(unsigned q, const XtcMonitorMsg& msg)
 {
+  if (_rings)
+    return _rings->post(q, msg.bufferIndex());
+  return mq_timedsend(_queue(q), (const char*)&msg, sizeof(msg), 0, &_tmo) == 0;
+}
+
+bool XtcMonitorServer::_take(unsigned q, XtcMonitorMsg& msg)
+{
+  if (_rings) {
+    uint32_t index;
+    if (!_rings->take(q, index))
+      return false;
+    msg = _myMsg;                       // Only indices are queued
+    msg.bufferIndex(index);
+    return true;
+  }
   //
   //  For reasons I don't yet understand, sometimes the message queues
   //  are opened in blocking mode.  So, I use mq_timedreceive
   //  with a 0 timeout to avoid blocking.
   //
-  XtcMonitorMsg msg;
   const timespec no_wait={0,0};
-  int r = mq_timedreceive(_requestQueue, (char*)&msg, sizeof(msg), NULL,
-                          &no_wait);
+  return mq_timedreceive(_queue(q), (char*)&msg, sizeof(msg), NULL, &no_wait) > 0;
+}
+
+unsigned XtcMonitorServer::_count(unsigned q)
+{
+  if (_rings)
+    return _rings->count(q);
+  struct mq_attr attr;
+  mq_getattr(_queue(q), &attr);
+  return attr.mq_curmsgs;
+}
+
+bool XtcMonitorServer::_shuffle(const ShMsg& m)
+{
+  if (_rings) {
+    _shuffled[m.msg().bufferIndex()] = m.dg();
+    return _rings->post(_rings->shuffle(), m.msg().bufferIndex());
+  }
+  return mq_timedsend(_shuffleQueue, (const char*)&m, sizeof(m), 0, &_tmo) == 0;
+}
+
+bool XtcMonitorServer::_unshuffle(ShMsg& m)
+{
+  if (_rings) {
+    XtcMonitorMsg msg;
+    if (!_take(_rings->shuffle(), msg))
+      return false;
+    m = ShMsg(msg, _shuffled[msg.bufferIndex()]);
+    return true;
+  }
+  if (mq_receive(_shuffleQueue, (char*)&m, sizeof(m), NULL) < 0) {
+    perror("mq_receive");
+    return false;
+  }
+  return true;
+}
+
+//
+//  Take a free event buffer, if there is one
+//
+bool XtcMonitorServer::_acquire(XtcMonitorMsg& msg)
+{
+  bool r = _take(_numberOfEvQueues+1, msg); // request queue
 
 #ifndef NO_STEAL
   static unsigned _nsteals=0;
-  if (r>0)
-    ;
-  else {
-    if (r<0) ; // perror("Error reading input event queue");
-    for(unsigned i=0; i<_numberOfEvQueues; i++) {
+  if (!r) {
+    for(unsigned i=0; i<_numberOfEvQueues && !r; i++) {
       unsigned iq = (i+_nsteals)%_numberOfEvQueues; // fairness
-      r=mq_timedreceive(_myOutputEvQueue[iq], (char*)&msg, sizeof(msg), NULL,
-                        &no_wait);
-      if (r>0) break;
-      if (r<0) ; // perror("Error reading output event queue");
+      while((r=_take(iq, msg))) {
+        //  A broadcast event is only free once no other client holds it
+        if (!_myMsg.broadcast() || _rings->release(msg.bufferIndex(), iq))
+          break;
+      }
     }
     _nsteals++;
   }
 #endif
 
-  if (r>0) {
+  if (r) {
     _msgDest[msg.bufferIndex()]=-1;
+    if (_latest)
+      _latest->modify(msg.bufferIndex());
+  }
+  return r;
+}
+
+bool XtcMonitorServer::_send(Dgram* dg)
+{
+  XtcMonitorMsg msg;
+  if (_acquire(msg)) {
     ShMsg m(msg, dg);
-    if (mq_timedsend(_shuffleQueue, (const char*)&m, sizeof(m), 0, &_tmo)) {
+    if (!_shuffle(m)) {
       printf("ShuffleQ timed out\n");
       _deleteDatagram(dg);
     }
@@ -207,6 +319,73 @@ bool XtcMonitorServer::_send(Dgram* dg)
   return true;
 }
 
+int XtcMonitorServer::reserve(TransitionId::Value trid)
+{
+  if (trid == TransitionId::L1Accept) {
+    XtcMonitorMsg msg;
+    return _acquire(msg) ? msg.bufferIndex() : -1;
+  }
+
+  int itr = _transitionCache->allocate(trid);
+  if (itr < 0)
+    return -1;
+  if (_latest)
+    _latest->modify(itr + _numberOfEvBuffers);
+  return itr + _numberOfEvBuffers;
+}
+
+void XtcMonitorServer::commit(int ibuffer)
+{
+  if (ibuffer < int(_numberOfEvBuffers)) {
+    //
+    //  The event is distributed by routine(); there is nothing to copy
+    //
+    XtcMonitorMsg msg(_myMsg);
+    msg.bufferIndex(ibuffer);
+    ShMsg m(msg, 0);
+    if (!_shuffle(m)) {
+      printf("ShuffleQ timed out\n");
+      if (!_post(_numberOfEvQueues, msg))
+        printf("Unable to reclaim event buffer %d\n", ibuffer);
+    }
+    return;
+  }
+
+  int itr = ibuffer - _numberOfEvBuffers;
+  TransitionId::Value trid = reinterpret_cast<const Dgram*>(buffer(ibuffer))->service();
+
+  _myMsg.bufferIndex(ibuffer);
+
+  if (_latest)
+    _latest->publish(ibuffer, trid == TransitionId::Configure);
+
+  if (trid == TransitionId::Enable) {
+    //
+    //  Steal all event buffers from the clients
+    //
+    for(unsigned i=0; i<_numberOfEvQueues; i++)
+      _moveQueue(i, _numberOfEvQueues);
+  }
+
+  //
+  //  Broadcast the transition to all ready clients
+  //
+  for(unsigned i=0; i<_myTrFd.size(); i++) {
+    int oq = _myTrFd[i];
+    if (oq == -1 || !_transitionCache->allocate(itr,i))
+      continue;
+    if (::send(oq, (const char*)&_myMsg, sizeof(_myMsg), 0) < 0) {
+      perror("Error sending transition");
+      _transitionCache->deallocate(itr,i);
+    }
+    else
+      _sentTransition(i);
+#ifdef DBUG2
+    printf("*** outputTr   sent idx %d to client %d\n", _myMsg.bufferIndex(), i);
+#endif
+  }
+}
+
 XtcMonitorServer::Result XtcMonitorServer::events(Dgram* dg)
 {
   Dgram& dgrm = *dg;
@@ -225,47 +404,12 @@ XtcMonitorServer::Result XtcMonitorServer::events(Dgram* dg)
     return Deferred;
   }
   else {
-
-    int itr = _transitionCache->allocate(trid);
-
-    if (itr < 0) {
+    int ibuffer = reserve(trid);
+    if (ibuffer < 0)                    // This is no longer an error
       return Handled;
-      /**  This is no longer an error
-      printf("No buffers available for transition!\n");
-      _transitionCache->dump();
-      abort();
-      **/
-    }
-
-    int ibuffer = itr + _numberOfEvBuffers;
-
-    _myMsg.bufferIndex(ibuffer);
-    _copyDatagram(dg, _myShm + _sizeOfBuffers*ibuffer, _sizeOfBuffers);
-
-    if (trid == TransitionId::Enable) {
-      //
-      //  Steal all event buffers from the clients
-      //
-      for(unsigned i=0; i<_numberOfEvQueues; i++)
-        _moveQueue(_myOutputEvQueue[i], _myInputEvQueue);
-    }
-
-    //
-    //  Broadcast the transition to all ready clients
-    //
-    for(unsigned i=0; i<_myTrFd.size(); i++) {
-      int oq = _myTrFd[i];
-      if (oq == -1 || !_transitionCache->allocate(itr,i))
-        continue;
-      if (::send(oq, (const char*)&_myMsg, sizeof(_myMsg), 0) < 0) {
-        perror("Error sending transition");
-        _transitionCache->deallocate(itr,i);
-      }
-#ifdef DBUG2
-      printf("*** outputTr   sent idx %d to client %d\n", _myMsg.bufferIndex(), i);
-#endif
-    }
 
+    _copyDatagram(dg, buffer(ibuffer), _sizeOfBuffers);
+    commit(ibuffer);
   }
   return Handled;
 }
@@ -363,6 +507,8 @@ void XtcMonitorServer::discover()
 
             //  Post connection request to taskThread
             ::write(_initFd,&s,sizeof(s));
+            if (_rings)
+              _rings->bell(_numberOfEvQueues).ring();
 
             // Advertise the discovery port again
             break;
@@ -380,8 +526,30 @@ void XtcMonitorServer::routine()
   while(!_terminate.load(std::memory_order_relaxed)) {
 
     int tmo = 1000;                     // ms
-    if ((::poll(_pfd,_nfd,tmo)) > 0) {
-      if (_terminate.load(std::memory_order_relaxed))  break;
+    if (_rings) {
+      //
+      //  The rings are waited on here rather than in poll(), which then
+      //  only checks the sockets
+      //
+      Doorbell& bell = _rings->bell(_numberOfEvQueues);
+      uint32_t  seq  = bell.sequence();
+      if (!_rings->count(_rings->input()) && !_rings->count(_rings->shuffle()))
+        bell.wait(seq, RING_TMO_MS);
+      tmo = 0;
+    }
+
+    int nfd = ::poll(_pfd,_nfd,tmo);
+    if (_terminate.load(std::memory_order_relaxed))  break;
+
+    if (_rings) {
+      _returnBuffers();
+
+      ShMsg m;
+      while(_unshuffle(m))
+        _distribute(m);
+    }
+
+    if (nfd > 0) {
 
       if (_pfd[0].revents & POLLIN)
         _initialize_client();
@@ -389,77 +557,16 @@ void XtcMonitorServer::routine()
       //
       //  Handle buffers returned from client
       //
-      if (_pfd[1].revents & POLLIN) {
-        XtcMonitorMsg msg;
-        const timespec no_wait={0,0};
-        while(mq_timedreceive(_myInputEvQueue, (char*)&msg, sizeof(msg), NULL, &no_wait) > 0) {
-          if (mq_timedsend(_requestQueue, (const char*)&msg, sizeof(msg), 0, &_tmo))
-            perror("Writing to requestQ");
-          else {
-            _requestDatagram();
-#ifdef DBUG2
-            printf("*** receiveEv  got  idx %d\n", msg.bufferIndex());
-#endif
-          }
-        }
-      }
+      if (_pfd[1].revents & POLLIN)
+        _returnBuffers();
 
       //
       //  Handle events ready for distribution
       //
       if (_pfd[2].revents & POLLIN) {
-#ifdef DBUG2
-        static uint64_t nevt = 0;
-#endif
         ShMsg m;
-        if (mq_receive(_shuffleQueue, (char*)&m, sizeof(m), NULL) < 0)
-          perror("mq_receive");
-
-        _copyDatagram(m.dg(),_myShm+_sizeOfBuffers*m.msg().bufferIndex(), _sizeOfBuffers);
-        _deleteDatagram(m.dg());
-
-        if (m.msg().serial()) {
-          //
-          //  Send this event to the first available client
-          //
-          for(unsigned i=0; i<=_numberOfEvQueues; i++)
-            if (mq_timedsend(_myOutputEvQueue[i], (const char*)&m.msg(), sizeof(m.msg()), 0, &_tmo))
-              ; //          printf("outputEv timed out to client %d\n",i);
-            else {
-#ifdef DBUG2
-              printf("*** outputEv 1 sent idx %d to client %d, %u.%09u, nL1A %lu\n", m.msg().bufferIndex(), i, m.dg()->time.seconds(), m.dg()->time.nanoseconds(), nevt);
-#endif
-              _msgDest[m.msg().bufferIndex()]=i;
-              break;
-            }
-        }
-        else {
-          //
-          //  Send this event to the next client around (round-robin)
-          //
-          bool lsent=false;
-          for(unsigned i=0; i<_numberOfEvQueues; i++) {
-            int oc = _ievt++%_numberOfEvQueues;
-            int oq = _myOutputEvQueue[oc];
-            if (mq_timedsend(oq, (const char*)&m.msg(), sizeof(m.msg()), 0, &_tmo))
-              ;
-            else {
-#ifdef DBUG2
-              printf("*** outputEv 2 sent idx %d to client %d, %u.%09u, nL1A %lu\n", m.msg().bufferIndex(), oc, m.dg()->time.seconds(), m.dg()->time.nanoseconds(), nevt);
-#endif
-              _msgDest[m.msg().bufferIndex()]=oc;
-              lsent=true;
-              break;
-            }
-          }
-          if (!lsent) {
-            if (mq_timedsend(_myInputEvQueue, (const char*)&m.msg(), sizeof(m.msg()), 0, &_tmo))
-              perror("Unable to distribute or reclaim event");
-          }
-        }
-#ifdef DBUG2
-        ++nevt;
-#endif
+        if (_unshuffle(m))
+          _distribute(m);
       }
 
       //
@@ -486,11 +593,23 @@ void XtcMonitorServer::routine()
                   //  Recover buffers last sent to this client
 
                   //  First, account for the ones waiting in our input queue
-                  _clearDest(_myInputEvQueue);
-                  _clearDest(_requestQueue);
+                  _clearDest(_numberOfEvQueues);
+                  _clearDest(_numberOfEvQueues+1);
 
                   //  Recover the buffers still queued to the retired client
-                  _moveQueue(_myOutputEvQueue[q], _myInputEvQueue);
+                  _moveQueue(q, _numberOfEvQueues);
+
+                  //  Release those it holds of the broadcast events
+                  if (_myMsg.broadcast()) {
+                    for(unsigned j=0; j<_numberOfEvBuffers; j++) {
+                      if (!_rings->holds(j,q) || !_rings->release(j,q))
+                        continue;
+                      msg = _myMsg;
+                      msg.bufferIndex(j);
+                      if (!_post(_numberOfEvQueues, msg))
+                        printf("Failed to recover buffer %d held by retired client\n",j);
+                    }
+                  }
 
                   //  Force recovery of those still outstanding to the retired client
                   for(int j=0; j<int(_msgDest.size()); j++)
@@ -498,8 +617,8 @@ void XtcMonitorServer::routine()
                       printf("Recovering buffer %d\n",j);
                       msg = _myMsg;
                       msg.bufferIndex(j);
-                      if (mq_timedsend(_myInputEvQueue, (const char*)&msg, sizeof(msg), 0, &_tmo)<0)
-                        perror("Failed to recover buffer queued to retired client");
+                      if (!_post(_numberOfEvQueues, msg))
+                        printf("Failed to recover buffer %d queued to retired client\n",j);
                       else
                         _msgDest[j]=-1;
                     }
@@ -527,20 +646,131 @@ void XtcMonitorServer::routine()
   ::close(_pfd[0].fd);
 }
 
-void XtcMonitorServer::_clearDest(mqd_t queue)
+//
+//  Make the buffers returned by the clients available to be requested
+//
+void XtcMonitorServer::_returnBuffers()
+{
+  XtcMonitorMsg msg;
+  while(_take(_numberOfEvQueues, msg)) {
+    if (!_post(_numberOfEvQueues+1, msg))
+      perror("Writing to requestQ");
+    else {
+      _requestDatagram();
+#ifdef DBUG2
+      printf("*** receiveEv  got  idx %d\n", msg.bufferIndex());
+#endif
+    }
+  }
+}
+
+void XtcMonitorServer::_distribute(const ShMsg& m)
+{
+#ifdef DBUG2
+  static uint64_t nevt = 0;
+#endif
+  if (m.dg()) {                         // Not yet copied if not built in place
+    _copyDatagram(m.dg(),_myShm+_sizeOfBuffers*m.msg().bufferIndex(), _sizeOfBuffers);
+    _deleteDatagram(m.dg());
+  }
+
+  if (_latest)
+    _latest->publish(m.msg().bufferIndex(), false);
+
+  if (m.msg().broadcast()) {
+    _broadcast(m.msg());
+  }
+  else if (m.msg().serial()) {
+    //
+    //  Send this event to the first available client
+    //  (or back to the input queue)
+    //
+    for(unsigned i=0; i<=_numberOfEvQueues; i++)
+      if (!_post(i, m.msg()))
+        ; //          printf("outputEv timed out to client %d\n",i);
+      else {
+#ifdef DBUG2
+        printf("*** outputEv 1 sent idx %d to client %d, nL1A %lu\n", m.msg().bufferIndex(), i, nevt);
+#endif
+        _msgDest[m.msg().bufferIndex()]=i;
+        break;
+      }
+  }
+  else {
+    //
+    //  Send this event to the next client around (round-robin)
+    //
+    bool lsent=false;
+    for(unsigned i=0; i<_numberOfEvQueues; i++) {
+      int oc = _ievt++%_numberOfEvQueues;
+      if (!_post(oc, m.msg()))
+        ;
+      else {
+#ifdef DBUG2
+        printf("*** outputEv 2 sent idx %d to client %d, nL1A %lu\n", m.msg().bufferIndex(), oc, nevt);
+#endif
+        _msgDest[m.msg().bufferIndex()]=oc;
+        lsent=true;
+        break;
+      }
+    }
+    if (!lsent) {
+      if (!_post(_numberOfEvQueues, m.msg()))
+        perror("Unable to distribute or reclaim event");
+    }
+  }
+#ifdef DBUG2
+  ++nevt;
+#endif
+}
+
+//
+//  Queue the event to all clients.  The server holds the buffer too until
+//  it's done, so that no client can return it early.  A client whose ring
+//  is full misses the event.
+//
+void XtcMonitorServer::_broadcast(const XtcMonitorMsg& msg)
+{
+  unsigned idx = msg.bufferIndex();
+  uint64_t holders = 1ULL<<MonitorRings::Server;
+  for(unsigned i=0; i<_myTrFd.size(); i++)
+    if (_myTrFd[i] != -1)
+      holders |= 1ULL<<i;
+  _rings->hold(idx, holders);
+  _msgDest[idx]=-1;
+
+  for(unsigned i=0; i<_myTrFd.size(); i++)
+    if ((holders & (1ULL<<i)) && !_post(i, msg))
+      _rings->release(idx, i);
+
+  if (_rings->release(idx, MonitorRings::Server))   // no client took it
+    if (!_post(_numberOfEvQueues, msg))
+      perror("Unable to reclaim event");
+}
+
+//
+//  Tell a client using rings to read the transition sent on its socket
+//
+void XtcMonitorServer::_sentTransition(unsigned client)
+{
+  if (_rings) {
+    _rings->transitions(client)++;
+    _rings->bell(client).ring();
+  }
+}
+
+void XtcMonitorServer::_clearDest(unsigned queue)
 {
   XtcMonitorMsg msg;
-  const timespec no_wait={0,0};
   std::list<int> indices;
-  while(mq_timedreceive(queue, (char*)&msg,
-                        sizeof(msg), NULL, &no_wait)>0)
+  while(_take(queue, msg))
     indices.push_back(msg.bufferIndex());
 
   for(std::list<int>::iterator it=indices.begin();
       it!=indices.end(); it++) {
     _msgDest[*it]=-1;
     msg.bufferIndex(*it);
-    if (mq_timedsend(queue, (char*)&msg,sizeof(msg),0,&no_wait)<0) {
+    if (!_post(queue, msg)) {
       perror("Accounting input queue buffers");
       printf("May have lost buffer %d\n",*it);
     }
@@ -562,6 +792,9 @@ int XtcMonitorServer::_init()
   size_t sizeOfShm = size_t(_numberOfEvBuffers + numberofTrBuffers) * _sizeOfBuffers;
   unsigned remainder = sizeOfShm%pageSize;
   if (remainder) sizeOfShm += pageSize - remainder;
+  size_t sizeOfBufs = sizeOfShm;        // The rings follow the buffers
+  sizeOfShm += _sizeOfRings;
+  sizeOfShm += LatestEvents::size();    // and the record of the latest events ends the segment
 
   umask(1);  // try to enable world members to open these devices.
 
@@ -575,33 +808,39 @@ int XtcMonitorServer::_init()
 
   close(shm);  // Done with the file descriptor
 
+  if (_sizeOfRings) {
+    _rings = MonitorRings::create(_myShm + sizeOfBufs, _numberOfEvQueues, _numberOfEvBuffers);
+    _shuffled.resize(_numberOfEvBuffers);
+    printf("Using shared memory rings for the event queues\n");
+  }
+
+  _latest = LatestEvents::create(_myShm + sizeOfShm - LatestEvents::size(),
+                                 _sizeOfBuffers, _numberOfEvBuffers + numberofTrBuffers);
+  if (!_latest)
+    printf("Too many buffers to record the latest events\n");
+
   _transitionCache = new TransitionCache(_myShm+_numberOfEvBuffers*_sizeOfBuffers,
                                          _sizeOfBuffers,
                                          numberofTrBuffers);
 
   mq_attr q_attr;
 
-  q_attr.mq_maxmsg  = _numberOfEvBuffers;
-  q_attr.mq_msgsize = (long int)sizeof(XtcMonitorMsg);
-  q_attr.mq_flags   = O_NONBLOCK;
-
-  XtcMonitorMsg::eventOutputQueue(p,_numberOfEvQueues-1,toQname);
-  _flushQueue(_myInputEvQueue  = _openQueue(toQname,q_attr));
+  if (!_rings) {
+    q_attr.mq_maxmsg  = _numberOfEvBuffers;
+    q_attr.mq_msgsize = (long int)sizeof(XtcMonitorMsg);
+    q_attr.mq_flags   = O_NONBLOCK;
 
-  for(unsigned i=0; i<_numberOfEvBuffers; i++) {
-    _myMsg.bufferIndex(i);
-    _msgDest[i]=-1;
-    if (mq_timedsend(_myInputEvQueue, (const char*)&_myMsg, sizeof(_myMsg), 0, &_tmo)<0)
-      perror("Failed to queue buffer to input queue (initialize)");
-  }
+    XtcMonitorMsg::eventOutputQueue(p,_numberOfEvQueues-1,toQname);
+    _flushQueue(_myInputEvQueue  = _openQueue(toQname,q_attr));
 
-  q_attr.mq_maxmsg  = _numberOfEvBuffers / _numberOfEvQueues;
-  q_attr.mq_msgsize = (long int)sizeof(XtcMonitorMsg);
-  q_attr.mq_flags   = O_NONBLOCK;
+    q_attr.mq_maxmsg  = _numberOfEvBuffers / _numberOfEvQueues;
+    q_attr.mq_msgsize = (long int)sizeof(XtcMonitorMsg);
+    q_attr.mq_flags   = O_NONBLOCK;
 
-  for(unsigned i=0; i<_numberOfEvQueues; i++) {
-    XtcMonitorMsg::eventInputQueue(p,i,toQname);
-    _flushQueue(_myOutputEvQueue[i] = _openQueue(toQname,q_attr));
+    for(unsigned i=0; i<_numberOfEvQueues; i++) {
+      XtcMonitorMsg::eventInputQueue(p,i,toQname);
+      _flushQueue(_myOutputEvQueue[i] = _openQueue(toQname,q_attr));
+    }
   }
 
   { int pfd[2];
@@ -614,30 +853,40 @@ int XtcMonitorServer::_init()
     _pfd[0].revents = 0;
   }
 
-  q_attr.mq_maxmsg  = _numberOfEvBuffers;
-  q_attr.mq_msgsize = (long int)sizeof(XtcMonitorMsg);
-  q_attr.mq_flags   = O_NONBLOCK;
+  if (!_rings) {
+    q_attr.mq_maxmsg  = _numberOfEvBuffers;
+    q_attr.mq_msgsize = (long int)sizeof(XtcMonitorMsg);
+    q_attr.mq_flags   = O_NONBLOCK;
 
-  sprintf(toQname, "/PdsRequestQueue_%s",p);
-  _requestQueue = _openQueue(toQname, q_attr);
-  _flushQueue(_requestQueue);
+    sprintf(toQname, "/PdsRequestQueue_%s",p);
+    _requestQueue = _openQueue(toQname, q_attr);
+    _flushQueue(_requestQueue);
 
-  _pfd[1].fd = _myInputEvQueue;
-  _pfd[1].events  = POLLIN;
-  _pfd[1].revents = 0;
+    q_attr.mq_maxmsg  = _numberOfEvBuffers;
+    q_attr.mq_msgsize = (long int)sizeof(ShMsg);
+    q_attr.mq_flags   = O_NONBLOCK;
 
-  q_attr.mq_maxmsg  = _numberOfEvBuffers;
-  q_attr.mq_msgsize = (long int)sizeof(ShMsg);
-  q_attr.mq_flags   = O_NONBLOCK;
+    sprintf(toQname, "/PdsShuffleQueue_%s",p);
+    _shuffleQueue = _openQueue(toQname, q_attr);
+    { ShMsg m; _flushQueue(_shuffleQueue,(char*)&m, sizeof(m)); }
+  }
 
-  sprintf(toQname, "/PdsShuffleQueue_%s",p);
-  _shuffleQueue = _openQueue(toQname, q_attr);
-  { ShMsg m; _flushQueue(_shuffleQueue,(char*)&m, sizeof(m)); }
+  //  Rings aren't polled: a negative descriptor is ignored
+  _pfd[1].fd = _rings ? -1 : _myInputEvQueue;
+  _pfd[1].events  = POLLIN;
+  _pfd[1].revents = 0;
 
-  _pfd[2].fd = _shuffleQueue;
+  _pfd[2].fd = _rings ? -1 : _shuffleQueue;
   _pfd[2].events  = POLLIN;
   _pfd[2].revents = 0;
 
+  for(unsigned i=0; i<_numberOfEvBuffers; i++) {
+    _myMsg.bufferIndex(i);
+    _msgDest[i]=-1;
+    if (!_post(_numberOfEvQueues, _myMsg))
+      perror("Failed to queue buffer to input queue (initialize)");
+  }
+
   // create the listening threads
   _terminate.store(false, std::memory_order_release);
   _taskThread = std::thread(&XtcMonitorServer::routine,  std::ref(*this));
@@ -694,6 +943,9 @@ void XtcMonitorServer::_initialize_client()
 
   _myMsg.bufferIndex(iclient);
 
+  if (_rings)
+    _rings->transitions(iclient).store(0);
+
   if (::send(_myTrFd[iclient], (const char*)&_myMsg, sizeof(_myMsg), 0)<0) {
     perror("first send to client");
     abort();
@@ -717,11 +969,14 @@ void XtcMonitorServer::_update(int iclient,
     if (reinterpret_cast<const Dgram*>(_myShm+_sizeOfBuffers*ib)->service()>=next) {
       _myMsg.bufferIndex(ib);
 
-      if (_transitionCache->allocate(itr,iclient))
+      if (_transitionCache->allocate(itr,iclient)) {
         if (::send(_myTrFd[iclient], (const char*)&_myMsg, sizeof(_myMsg), 0)<0) {
           perror("Error sending current");
           _transitionCache->deallocate(itr,iclient);
         }
+        else
+          _sentTransition(iclient);
+      }
     }
   }
 }
@@ -793,39 +1048,32 @@ void XtcMonitorServer::_flushQueue(mqd_t q, char* m, unsigned sz)
   } while (attr.mq_curmsgs);
 }
 
-void XtcMonitorServer::_moveQueue(mqd_t iq, mqd_t oq)
+void XtcMonitorServer::_moveQueue(unsigned iq, unsigned oq)
 {
   XtcMonitorMsg m;
-  struct mq_attr attr;
-  do {
-    mq_getattr(iq, &attr);
-    if (attr.mq_curmsgs) {
-      if (mq_timedreceive(iq, (char*)&m, sizeof(m), NULL, &_tmo) == -1) {
-        perror("moveQueue: mq_timedreceive");
-        break;
-      }
-      else if (mq_timedsend   (oq, (char*)&m, sizeof(m), 0, &_tmo) == -1) {
-        printf("Failed to reclaim buffer %i : %s\n",
-               m.bufferIndex(), strerror(errno));
-      }
-      else
-        _msgDest[m.bufferIndex()]=-1;
+  while(_take(iq, m)) {
+    if (_myMsg.broadcast() && !_rings->release(m.bufferIndex(), iq))
+      continue;                         // other clients still hold it
+    if (!_post(oq, m)) {
+      printf("Failed to reclaim buffer %i : %s\n",
+             m.bufferIndex(), strerror(errno));
     }
-  } while (attr.mq_curmsgs);
+    else
+      _msgDest[m.bufferIndex()]=-1;
+  }
 }
 
-void XtcMonitorServer::_replQueue(mqd_t q, unsigned rq)
+void XtcMonitorServer::_replQueue(unsigned q, unsigned rq)
 {
-  timespec tmo; tmo.tv_sec = 0; tmo.tv_nsec = 0;
-  struct mq_attr attr;
-  mq_getattr(q,&attr);
-  printf("Replacing %lu entries\n",attr.mq_curmsgs);
-  while(attr.mq_curmsgs--) {
+  unsigned n = _count(q);
+  printf("Replacing %u entries\n",n);
+  while(n--) {
     XtcMonitorMsg m;
-    mq_timedreceive(q, reinterpret_cast<char*>(&m), sizeof(m), NULL, &tmo);
+    if (!_take(q, m))
+      break;
     m.return_queue(rq);
     _msgDest[m.bufferIndex()] = -1;
-    mq_timedsend   (q, reinterpret_cast<const char*>(&m), sizeof(m), 0, &tmo);
+    _post(q, m);
   }
 }
 
@@ -833,6 +1081,8 @@ void XtcMonitorServer::unlink()
 {
   _terminate.store(true, std::memory_order_release);
 
+  if (_latest)  _latest->shutdown();
+
   //printf("Unlinking Message Queues... \n");
   if (_myInputEvQueue != (mqd_t)-1)        mq_close(_myInputEvQueue);
 
@@ -41,6 +41,22 @@
 //  transitions are not reused until all clients have returned
 //  the buffer.
 //
+//  Optionally, the buffer indices are passed through lock-free rings
+//  in the shared memory segment (see IndexRing.hh) instead of the
+//  event message queues, which saves the system calls per event.
+//  Clients discover this from the first message they receive.
+//
+//  The datagrams most recently distributed are recorded at the end of the
+//  shared memory segment (see LatestEvents.hh), so that readers which
+//  only sample the data can copy them out without any messages.
+//
+//  With the rings, events may also be broadcast: each event is queued
+//  to every client at once, rather than passed from one to the next,
+//  and its buffer returns to the server when the last client releases
+//  it.  A client that falls behind doesn't hold up the others; when
+//  the server runs out of buffers, it takes back the oldest events
+//  still queued to such a client, which thus skips ahead.
+//
 //-----------------------------------
 
 #include "XtcMonitorMsg.hh"
@@ -65,13 +81,17 @@ namespace psalg {
   namespace shmem {
 
     class TransitionCache;
+    class MonitorRings;
+    class LatestEvents;
+    class ShMsg;
 
     class XtcMonitorServer {
     public:
       XtcMonitorServer(const char* tag,
                        unsigned sizeofBuffers,
                        unsigned numberofEvBuffers,
-                       unsigned numberofEvQueues);
+                       unsigned numberofEvQueues,
+                       bool     rings=false);
       virtual ~XtcMonitorServer();
     public:
       enum Result { Handled, Deferred };
@@ -80,8 +100,19 @@ namespace psalg {
       void discover   ();
       void routine    ();
       void unlink     ();
+    public:
+      //  Datagrams may also be built in place, avoiding the copy done by
+      //  events(): reserve() returns the index of the shared memory buffer
+      //  to construct a datagram of type trid in, or -1 if none is available
+      //  and the datagram is to be dropped.  commit() hands the datagram
+      //  constructed at buffer(index) to the clients.
+      int    reserve       (XtcData::TransitionId::Value trid);
+      void   commit        (int index);
+      char*  buffer        (int index) const { return _myShm + _sizeOfBuffers*index; }
+      size_t sizeOfBuffers () const { return _sizeOfBuffers; }
     public:
       void distribute (bool);
+      void broadcast  ();
     protected:
       int  _init             ();
     private:
@@ -89,11 +120,25 @@ namespace psalg {
       mqd_t _openQueue       (const char* name, mq_attr&);
       void _flushQueue       (mqd_t q);
       void _flushQueue       (mqd_t q, char* m, unsigned sz);
-      void _moveQueue        (mqd_t iq, mqd_t oq);
-      void _replQueue        (mqd_t q, unsigned rq);
+      //  Event queues by number: [0,numberOfEvQueues] are those of the
+      //  clients and the input queue, followed by the request and shuffle
+      //  queues.  These are message queues or rings.
+      mqd_t    _queue        (unsigned q) const;
+      bool     _post         (unsigned q, const XtcMonitorMsg&);
+      bool     _take         (unsigned q, XtcMonitorMsg&);
+      unsigned _count        (unsigned q);
+      bool     _shuffle      (const ShMsg&);
+      bool     _unshuffle    (ShMsg&);
+      void _moveQueue        (unsigned iq, unsigned oq);
+      void _replQueue        (unsigned q, unsigned rq);
+      bool _acquire          (XtcMonitorMsg&);
       bool _send             (XtcData::Dgram*);
+      void _returnBuffers    ();
+      void _distribute       (const ShMsg&);
+      void _broadcast        (const XtcMonitorMsg&);
+      void _sentTransition   (unsigned client);
       void _update           (int, XtcData::TransitionId::Value);
-      void _clearDest        (mqd_t);
+      void _clearDest        (unsigned q);
     private:
       virtual void _copyDatagram   (XtcData::Dgram* dg, char*, size_t);
       virtual void _deleteDatagram (XtcData::Dgram* dg);
@@ -122,6 +167,10 @@ namespace psalg {
       int               _nfd;
       mqd_t             _shuffleQueue;      // message queue for pre-distribution event processing
       mqd_t             _requestQueue;      // message queue for buffers awaiting request completion
+      MonitorRings*     _rings;             // event queues in shared memory, if used
+      size_t            _sizeOfRings;
+      std::vector<XtcData::Dgram*> _shuffled; // datagrams awaiting copy, with rings
+      LatestEvents*     _latest;            // the datagrams most recently distributed
       timespec          _tmo;
       std::atomic<bool> _terminate;         // Flag for causing subthreads to exit
       std::thread       _discThread;        // thread for receiving new client connections
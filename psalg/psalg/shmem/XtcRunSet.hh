@@ -36,7 +36,8 @@ public:
   void addPathsFromRunPrefix(std::string runPrefix);
   void addPathsFromListFile(std::string listFile);
   void connect(char* partitionTag, unsigned sizeOfBuffers, int numberOfBuffers, unsigned nclients, int rate,
-               bool verbose = false, bool veryverbose = false, bool interactive = false);
+               bool verbose = false, bool veryverbose = false, bool interactive = false,
+               bool rings = false);
   void run();
   void wait();
   void exit();
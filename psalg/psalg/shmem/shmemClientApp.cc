@@ -46,6 +46,7 @@ void usage(char* progname) {
           "[-r <rate>] "
           "[-t] dgram timing"
           "[-R] make reconnect attempts"
+          "[-S] sample the latest events"
           "[-v] "
           "[-V] "
           "[-h]\n", progname);
@@ -95,9 +96,10 @@ int main(int argc, char* argv[]) {
   bool veryverbose = false;
   bool accept = false;
   bool reconnect = false;
+  bool sample = false;
   timespec ptv,tv;
 
-  while ((c = getopt(argc, argv, "?hvVti:p:r:R")) != -1) {
+  while ((c = getopt(argc, argv, "?hvVti:p:r:RS")) != -1) {
     switch (c) {
     case '?':
     case 'h':
@@ -118,6 +120,9 @@ int main(int argc, char* argv[]) {
     case 'R':
       reconnect = true;
       break;
+    case 'S':
+      sample = true;
+      break;
     case 'V':
       veryverbose = true;
     case 'v':
@@ -132,7 +137,7 @@ int main(int argc, char* argv[]) {
     {
     MyShmemClient myClient(rate,verbose);
     int rc;
-    if ((rc = myClient.connect(partitionTag,index)))
+    if ((rc = sample ? myClient.snapshot(partitionTag) : myClient.connect(partitionTag,index)))
       break;
     events = 0;
     bytes = 0;
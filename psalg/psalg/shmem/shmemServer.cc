@@ -19,6 +19,7 @@ void usage(char* progname) {
   cerr << " [-r <ratePerSec>] [-c <# clients>]" << endl 
        << " [-L <numberOfLoops] " << endl
        << " [-i]                 : interactive" << endl
+       << " [-R]                 : pass events through shared memory rings" << endl
        << "[-v] [-V]" << endl;
 }
 
@@ -43,12 +44,13 @@ int main(int argc, char* argv[]) {
   bool verbose = false;
   bool veryverbose = false;
   bool interactive = false;
+  bool rings = false;
 
   //  (void) signal(SIGINT, sigfunc);
   //  (void) signal(SIGSEGV, sigfunc);
 
   int c;
-  while ((c = getopt(argc, argv, "f:l:x:d:p:n:s:r:c:L:vVih?")) != -1) {
+  while ((c = getopt(argc, argv, "f:l:x:d:p:n:s:r:c:L:vViRh?")) != -1) {
     switch (c) {
       case 'f':
         xtcFile = optarg;
@@ -90,6 +92,9 @@ int main(int argc, char* argv[]) {
       case 'i':
         interactive = true;
         break;
+      case 'R':
+        rings = true;
+        break;
       case 'h':
       case '?':
         usage(argv[0]);
@@ -122,7 +127,7 @@ int main(int argc, char* argv[]) {
   }
 
   XtcRunSet runSet;
-  runSet.connect(partitionTag, sizeOfBuffers, numberOfBuffers, nclients, rate, verbose, veryverbose, interactive);
+  runSet.connect(partitionTag, sizeOfBuffers, numberOfBuffers, nclients, rate, verbose, veryverbose, interactive, rings);
   runSet.wait();
   do {
     if (xtcFile) {
@@ -0,0 +1,239 @@
+// Logs through psalg::AsyncLog into a sink in memory and checks the
+// deferred formatting against snprintf, messages longer than a record,
+// the order and the counts of the messages of several threads, the drop
+// counter of full rings and the rate limit of SysLog, and prints the time
+// of a call.
+
+#include <stdio.h>
+#include <stdlib.h>    // EXIT_SUCCESS
+#include <string.h>    // strcmp, memcpy
+#include <errno.h>
+#include <time.h>      // clock_gettime
+#include <unistd.h>    // sysconf
+#include <sys/mman.h>  // mmap, mprotect
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "psalg/utils/AsyncLog.hh"
+#include "psalg/utils/SysLog.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check, ctest_time_sec
+
+using namespace psalg;
+using logging = psalg::SysLog;
+
+//-------------------
+
+/// CPU time of the calling thread, without the background thread on a shared core
+static double thread_time_sec() {
+  struct timespec t;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+  return t.tv_sec + 1e-9*t.tv_nsec;
+}
+
+/// Messages written by the background thread
+static std::vector<std::string> sink_messages;
+static std::mutex sink_mutex;
+
+static void memory_sink(int, const char* msg) {
+  std::lock_guard<std::mutex> lock(sink_mutex);
+  sink_messages.push_back(msg);
+}
+
+static void slow_sink(int priority, const char* msg) {
+  struct timespec t = {0, 100000};
+  nanosleep(&t, 0);
+  memory_sink(priority, msg);
+}
+
+static void null_sink(int, const char*) {}
+
+/// Logs fmt with args asynchronously and compares the message with snprintf
+template<typename... Args>
+static bool same(const char* fmt, Args... args) {
+  char expected[256];
+  snprintf(expected, sizeof(expected), fmt, args...);
+  sink_messages.clear();
+  AsyncLog::instance().log(memory_sink, LOG_INFO, "", fmt, args...);
+  AsyncLog::instance().flush();
+  const bool ok = sink_messages.size() == 1 && sink_messages[0] == expected;
+  if(!ok) printf("  '%s' != '%s'\n", sink_messages.empty() ? "" : sink_messages[0].c_str(), expected);
+  return ok;
+}
+
+//-------------------
+
+void test_format() {
+  printf("test_format\n");
+  AsyncLog& alog = AsyncLog::instance();
+  alog.start();
+  char name[] = "jungfrau";
+  enum {THREE=3};
+  ctest_check(same("plain text"), "no arguments");
+  ctest_check(same("%d %i %5d|%-5d|%05d %+d", -1, 2, 3, 4, 5, 6), "int");
+  ctest_check(same("%u %x %#X %o %hhu %hd", 4000000000u, 255u, 255u, 8u, 300, 70000), "unsigned, hh, h");
+  ctest_check(same("%ld %lu %lld %llx %zu %zd %jd", -1L, 1UL<<40, -(1LL<<50), 1ULL<<63, sizeof(name), (ssize_t)-2, (intmax_t)7),
+              "l, ll, z, j");
+  ctest_check(same("%f %.3e %10.2g %a %Lf", 3.5, 1e-7, 12345.678, 1.0, (long double)2.25), "floating point");
+  ctest_check(same("%.2f %g", 2.5f, 1.5f), "float is promoted");
+  ctest_check(same("%s|%10s|%-10s|%.3s", "a", name, (const char*)name, name), "strings");
+  ctest_check(same("%c%c %d %%", 'o', 'k', THREE), "char, enum, %%");
+  ctest_check(same("%*d|%-*.*f", 6, 42, 10, 2, 3.14159), "* width and precision");
+  ctest_check(same("%p %p", (void*)name, (const int*)0), "pointers");
+
+  sink_messages.clear();
+  errno = ENOENT;
+  alog.log(memory_sink, LOG_ERR, "<E> ", "open: %m");
+  errno = 0;
+  alog.flush();
+  ctest_check(sink_messages.size() == 1 && sink_messages[0] == std::string("<E> open: ") + strerror(ENOENT), "%m with the errno of the call");
+
+  sink_messages.clear();
+  alog.log(memory_sink, LOG_INFO, "", "%s|%5s", (const char*)0, (char*)0);
+  alog.log(memory_sink, LOG_INFO, "", "%d %s", 1);
+  alog.log(memory_sink, LOG_INFO, "", "%s", 1);
+  alog.flush();
+  ctest_check(sink_messages.size() == 3 && sink_messages[0] == "(null)|(null)", "null string");
+  ctest_check(sink_messages.size() == 3 && sink_messages[1] == "1 <?>" && sink_messages[2] == "<?>", "missing and mismatched arguments");
+
+  // messages longer than a record, as the json of the collection, arrive whole
+  std::string big(10000, 'x');
+  for(size_t i=0; i<big.size(); i+=37) big[i] = 'a' + i%26;
+  sink_messages.clear();
+  alog.log(memory_sink, LOG_INFO, "<I> ", "json %s %d", big.c_str(), 1);
+  alog.log(memory_sink, LOG_INFO, "<I> ", big.c_str());
+  alog.log_text(memory_sink, LOG_INFO, big.c_str());
+  alog.flush();
+  ctest_check(sink_messages.size() == 3 && sink_messages[0] == "<I> json " + big + " 1", "long message arrives whole");
+  ctest_check(sink_messages.size() == 3 && sink_messages[1] == "<I> " + big, "long format arrives whole");
+  ctest_check(sink_messages.size() == 3 && sink_messages[2] == big, "long text arrives whole");
+
+  // %.*s of a buffer without a 0, which ends at an inaccessible page
+  const long page = sysconf(_SC_PAGESIZE);
+  char* pages = (char*)mmap(0, 2*page, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+  mprotect(pages + page, page, PROT_NONE);
+  char* end = pages + page - 4;
+  memcpy(end, "lane", 4);
+  ctest_check(same("%.*s %d|%.4s|%-6.2s|", 4, end, 7, end, end), "precision of strings without a 0");
+  munmap(pages, 2*page);
+  alog.stop();
+}
+
+//-------------------
+
+void test_threads() {
+  printf("test_threads\n");
+  const unsigned nthreads = 4, nmsgs = 20000;
+  AsyncLog& alog = AsyncLog::instance();
+  alog.start(4096, 1);
+  const AsyncLog::Stats s0 = alog.stats();
+  sink_messages.clear();
+  std::vector<std::thread> threads;
+  for(unsigned t=0; t<nthreads; t++) {
+    threads.emplace_back([t, nmsgs, &alog]() {
+      for(unsigned i=0; i<nmsgs; i++) alog.log(memory_sink, LOG_DEBUG, "<D> ", "thread %u message %u", t, i);
+    });
+  }
+  for(unsigned t=0; t<nthreads; t++) threads[t].join();
+  alog.stop();
+  const AsyncLog::Stats s1 = alog.stats();
+
+  // the messages of each thread are in order, with gaps for the dropped ones
+  std::vector<int> last(nthreads, -1);
+  bool ordered = true;
+  for(size_t i=0; i<sink_messages.size(); i++) {
+    unsigned t, m;
+    if(sscanf(sink_messages[i].c_str(), "<D> thread %u message %u", &t, &m) != 2 || t >= nthreads || int(m) <= last[t]) {
+      ordered = false;
+      break;
+    }
+    last[t] = m;
+  }
+  ctest_check(ordered, "messages of each thread in order");
+  ctest_check(s1.logged - s0.logged == sink_messages.size()
+           && sink_messages.size() + (s1.dropped - s0.dropped) == nthreads*nmsgs, "logged + dropped == sent");
+  printf("  %llu logged, %llu dropped\n", (unsigned long long)(s1.logged - s0.logged),
+         (unsigned long long)(s1.dropped - s0.dropped));
+}
+
+//-------------------
+
+void test_drop() {
+  printf("test_drop\n");
+  const unsigned nmsgs = 2000;
+  AsyncLog& alog = AsyncLog::instance();
+  alog.start(16);
+  const AsyncLog::Stats s0 = alog.stats();
+  sink_messages.clear();
+  double dt = 0;
+  std::thread producer([&]() { // a new thread has a ring of the new size
+    double t0 = ctest_time_sec();
+    for(unsigned i=0; i<nmsgs; i++) alog.log(slow_sink, LOG_ERR, "<E> ", "fault %u", i);
+    dt = ctest_time_sec() - t0;
+  });
+  producer.join();
+  alog.stop();
+  const AsyncLog::Stats s1 = alog.stats();
+  ctest_check(s1.dropped > s0.dropped, "full ring drops");
+  ctest_check(sink_messages.size() + (s1.dropped - s0.dropped) == nmsgs, "logged + dropped == sent");
+  ctest_check(dt < nmsgs*100e-6, "caller is not slowed down by the sink");
+  printf("  %llu of %u dropped in %.3f ms\n", (unsigned long long)(s1.dropped - s0.dropped), nmsgs, 1e3*dt);
+}
+
+//-------------------
+
+void test_rate_limit() {
+  printf("test_rate_limit\n");
+  AsyncLog& alog = AsyncLog::instance();
+  const uint64_t n0 = alog.stats().suppressed;
+  logging::init("tst", LOG_ERR, true);
+  logging::rate_limit(5);
+  for(unsigned i=0; i<1000; i++) logging::error("test_AsyncLog burst %u", i);
+  logging::debug("test_AsyncLog filtered out %d", 1);
+  logging::flush();
+  const uint64_t n = alog.stats().suppressed - n0;
+  ctest_check(n >= 1000-10 && n <= 1000-5, "at most 5 messages per second of a call site");
+  logging::rate_limit(0);
+  alog.stop();
+}
+
+//-------------------
+
+void test_time() {
+  printf("test_time\n");
+  const unsigned nmsgs = 100000;
+  AsyncLog& alog = AsyncLog::instance();
+  char buf[256];
+  double t0 = thread_time_sec();
+  for(unsigned i=0; i<nmsgs; i++) snprintf(buf, sizeof(buf), "<D> pgp lane %u event %lu size %u %s", i%4, i*3UL, i, "ok");
+  double t1 = thread_time_sec();
+  alog.start(1<<17);
+  const AsyncLog::Stats s0 = alog.stats();
+  double t2 = 0, t3 = 0;
+  std::thread producer([&]() { // a new thread has a ring of the new size
+    alog.log(null_sink, LOG_DEBUG, "", "allocates the ring");
+    t2 = thread_time_sec();
+    for(unsigned i=0; i<nmsgs; i++) alog.log(null_sink, LOG_DEBUG, "<D> ", "pgp lane %u event %lu size %u %s", i%4, i*3UL, i, "ok");
+    t3 = thread_time_sec();
+  });
+  producer.join();
+  alog.stop();
+  const AsyncLog::Stats s1 = alog.stats();
+  ctest_check(s1.logged - s0.logged == nmsgs+1, "all logged");
+  printf("  snprintf %.0f ns, AsyncLog::log %.0f ns of CPU per message\n", 1e9*(t1-t0)/nmsgs, 1e9*(t3-t2)/nmsgs);
+}
+
+//-------------------
+
+int main(int argc, char **argv) {
+  test_format();
+  test_threads();
+  test_drop();
+  test_rate_limit();
+  test_time();
+
+  return ctest_status();
+}
+
+//-------------------
@@ -0,0 +1,168 @@
+// Checks the calibration constants of the CalibCache without the web
+// service: constants made from data and from a file of the cache directory,
+// plain, gzip-compressed and raw, their metadata, that their data are read-only,
+// and that constants stored in the cache directory load back the same.
+//
+// The cache directory is a new directory in the directory of the
+// argument, /tmp by default.
+
+#include <stdio.h>
+#include <stdlib.h>    // EXIT_SUCCESS, system
+#include <string.h>    // memcmp
+#include <signal.h>    // SIGSEGV
+#include <unistd.h>    // fork, getpid
+#include <sys/stat.h>  // mkdir
+#include <sys/wait.h>  // waitpid
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "psalg/calib/CalibCache.hh"
+#include "psalg/calib/NpyIO.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check
+
+using namespace psalg;
+using namespace calib;
+
+typedef psalg::types::shape_t shape_t;
+
+static const char* DBNAME = "cdb_test_det";
+
+//-------------------
+
+/// Metadata of a document, as the web service returns it
+static std::string metadata(const std::string& id_data) {
+  return "{\"id_data\": \"" + id_data + "\", \"data_shape\": \"(2, 3)\", \"data_dtype\": \"float32\","
+         " \"run\": 10, \"run_end\": \"end\"}";
+}
+
+/// npy buffer of a 2x3 float array
+static std::string npy_data() {
+  shape_t sh[] = {2,3};
+  std::string s = npy_header("<f4", sh, 2);
+  for(int i=0; i<6; i++) {float v = 1.5f*i; s.append((const char*)&v, sizeof(v));}
+  return s;
+}
+
+static bool same(const CalibConstants& c, const std::string& data) {
+  return c.valid() && c.size() == data.size() && !memcmp(c.data(), data.data(), data.size());
+}
+
+/// true if a write to the data of c kills the process which does it
+static bool read_only(const CalibConstants& c) {
+  pid_t pid = fork();
+  if(pid == 0) {
+    const_cast<char*>(c.data())[0] ^= 1;
+    _exit(0);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return WIFSIGNALED(status) && (WTERMSIG(status) == SIGSEGV || WTERMSIG(status) == SIGBUS);
+}
+
+static void write_file(const std::string& fname, const std::string& s) {
+  std::ofstream f(fname.c_str(), std::ios::binary);
+  f.write(s.data(), s.size());
+}
+
+//-------------------
+
+void test_data() {
+  printf("test_data\n");
+  const std::string npy = npy_data();
+  std::string data(npy);
+  CalibConstants c(metadata("5f0000000000000000000001"), data);
+  ctest_check(same(c, npy) && !c.mapped(), "constants from data");
+  ctest_check(c.id_data() == "5f0000000000000000000001" && c.data_shape() == "(2, 3)" && c.data_dtype() == "float32",
+              "id_data, shape and dtype of the metadata");
+  ctest_check(c.run() == 10 && c.run_end() == 0, "runs of the metadata");
+  ctest_check(read_only(c), "data are read-only");
+
+  std::string z;
+  gzip(npy.data(), npy.size(), z);
+  CalibConstants cz(metadata("5f0000000000000000000002"), z);
+  ctest_check(same(cz, npy), "compressed data are inflated");
+
+  // raw data of data_shape whose first bytes are those of gzip
+  std::string raw(npy_data().substr(0, 24));
+  raw[0] = '\x1f'; raw[1] = '\x8b';
+  const std::string raw0(raw);
+  CalibConstants cr(metadata("5f0000000000000000000009"), raw);
+  ctest_check(same(cr, raw0), "raw data which start as gzip are kept");
+
+  std::string empty;
+  CalibConstants ce(metadata("5f0000000000000000000003"), empty);
+  ctest_check(!ce.valid(), "empty data are not valid");
+}
+
+//-------------------
+
+void test_file(const std::string& dir) {
+  printf("test_file\n");
+  const std::string npy = npy_data();
+  const std::string fname = dir + "/test_CalibCache.data";
+  write_file(fname, npy);
+  CalibConstants c(metadata("5f0000000000000000000004"), fname);
+  ctest_check(same(c, npy) && c.mapped(), "constants from a file");
+  ctest_check(c.data_shape() == "(2, 3)" && c.run() == 10, "metadata");
+  ctest_check(read_only(c), "mapped data are read-only");
+  remove(fname.c_str());
+
+  CalibConstants cm(metadata("5f0000000000000000000005"), dir + "/missing.data");
+  ctest_check(!cm.valid(), "missing file is not valid");
+  write_file(fname, "");
+  CalibConstants ce(metadata("5f0000000000000000000006"), fname);
+  ctest_check(!ce.valid(), "empty file is not valid");
+  remove(fname.c_str());
+}
+
+//-------------------
+
+void test_store_load(const std::string& dir) {
+  printf("test_store_load\n");
+  CalibCache& cache = CalibCache::instance();
+  const std::string npy = npy_data();
+  const std::string id("5f0000000000000000000007");
+  std::string data(npy);
+  CalibConstants c(metadata(id), data);
+
+  cache.set_directory("");
+  cache.store(DBNAME, c);
+  ctest_check(!cache.load(DBNAME, metadata(id), id), "nothing stored without a directory");
+
+  const std::string cdir = dir + "/cache";
+  cache.set_directory(cdir);
+  ctest_check(!cache.load(DBNAME, metadata(id), id), "not in the directory before store");
+  cache.store(DBNAME, c);
+  CalibConstantsPtr p = cache.load(DBNAME, metadata(id), id);
+  ctest_check(p && same(*p, npy) && p->mapped(), "load after store");
+  ctest_check(p && p->id_data() == id && p->data_shape() == c.data_shape() && p->run() == c.run(), "metadata after load");
+
+  std::ifstream f((cdir + '/' + DBNAME + '/' + id + ".json").c_str());
+  std::stringstream ss; ss << f.rdbuf();
+  ctest_check(ss.str() == metadata(id), "metadata stored");
+  ctest_check(!cache.load(DBNAME, metadata("5f0000000000000000000008"), "5f0000000000000000000008"),
+              "other id_data is not loaded");
+
+  cache.set_directory("");
+  ctest_check(!cache.load(DBNAME, metadata(id), id), "nothing loaded without a directory");
+  system(("rm -rf " + cdir).c_str());
+}
+
+//-------------------
+
+int main(int argc, char **argv) {
+  std::stringstream ss;
+  ss << ((argc>1) ? argv[1] : "/tmp") << "/test_CalibCache-" << getpid();
+  const std::string dir = ss.str();
+  if(mkdir(dir.c_str(), 0777) != 0) {printf("can not create %s\n", dir.c_str()); return EXIT_FAILURE;}
+
+  test_data();
+  test_file(dir);
+  test_store_load(dir);
+
+  rmdir(dir.c_str());
+  return ctest_status();
+}
+
+//-------------------
@@ -0,0 +1,113 @@
+// Compares detector::CalibEngine with a direct per-pixel calibration
+// and prints the time per event.
+
+#include <stdio.h>
+#include <stdlib.h>    // rand
+#include <cmath>       // fabs
+#include <vector>
+#include <algorithm>   // nth_element
+
+#include "psalg/detector/CalibEngine.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check, ctest_time_sec
+
+using namespace detector;
+using psalg::ctest_check;
+using psalg::ctest_time_sec;
+
+typedef psalg::types::shape_t shape_t;
+
+//-------------------
+
+/// One pixel at a time, as in the documentation of CalibEngine
+static void calib_reference(const CalibLayout& l, const uint16_t* raw,
+                            const float* peds, const float* gain, const uint16_t* status,
+                            const double* cmpars, float* out) {
+  const size_t size = l.size();
+  std::vector<float> v;
+  for(size_t pix=0; pix<size; pix+=l.cm_cols) {
+    float cm = 0;
+    v.clear();
+    for(size_t i=pix; i<pix+l.cm_cols; i++) {
+      float d = float(raw[i]&l.data_mask) - peds[i];
+      if((!l.gain_shift || (raw[i]>>l.gain_shift)==0) && status[i]==0 && fabs(d)<cmpars[1]) v.push_back(d);
+    }
+    if(v.size() >= l.cm_cols/4) {
+      std::nth_element(v.begin(), v.begin()+v.size()/2, v.end());
+      cm = v[v.size()/2];
+      if(fabs(cm) > cmpars[2]) cm = 0;
+    }
+    for(size_t i=pix; i<pix+l.cm_cols; i++) {
+      unsigned code = l.gain_shift ? raw[i]>>l.gain_shift : 0;
+      unsigned g = (code==3) ? 2 : code;
+      float d = float(raw[i]&l.data_mask) - peds[g*size+i] - (code ? 0 : cm);
+      out[i] = (status[i] || code==2) ? 0 : d*gain[g*size+i];
+    }
+  }
+}
+
+//-------------------
+
+static void test_layout(const char* name, const CalibLayout& l) {
+  const size_t size = l.size();
+  shape_t sh1[] = {(shape_t)size};
+  shape_t shg[] = {(shape_t)(l.ngains*size)};
+  shape_t shc[] = {3};
+
+  NDArray<uint16_t> raw(sh1, 1);
+  NDArray<float>    peds(shg, 1), gain(shg, 1);
+  NDArray<uint16_t> status(sh1, 1);
+  double cmp[] = {1, 50, 20};
+  NDArray<double>   cmpars(shc, 1, cmp);
+
+  srand(1);
+  for(size_t i=0; i<l.ngains*size; i++) {
+    peds.data()[i] = 1000 + rand()%100 + 200*(i/size);
+    gain.data()[i] = 0.5 + 0.001*(rand()%1000);
+  }
+  for(size_t i=0; i<size; i++) {
+    status.data()[i] = (rand()%100==0) ? 1 : 0;
+    uint16_t v = 1000 + rand()%150 + 10*((i/l.cm_cols)%5); // pedestal + noise + common mode
+    if(rand()%50==0) v += 2000;                            // signal
+    if(l.gain_shift) v |= (rand()%20==0 ? rand()%4 : 0) << l.gain_shift;
+    raw.data()[i] = v;
+  }
+
+  CalibEngine engine(l);
+  engine.set_pedestals(peds);
+  engine.set_gain(gain);
+  engine.set_status(status);
+  engine.set_common_mode(cmpars);
+
+  NDArray<float> out;
+  std::vector<float> ref(size);
+  engine.calib(raw, out);
+  calib_reference(l, raw.const_data(), peds.const_data(), gain.const_data(), status.const_data(), cmp, &ref[0]);
+
+  size_t nbad = 0;
+  for(size_t i=0; i<size; i++)
+    if(fabs(out.data()[i]-ref[i]) > 1e-3*(1+fabs(ref[i]))) nbad++;
+
+  const unsigned nevts = 20;
+  double t0 = ctest_time_sec();
+  for(unsigned e=0; e<nevts; e++) engine.calib(raw, out);
+  double t1 = ctest_time_sec();
+  for(unsigned e=0; e<nevts; e++)
+    calib_reference(l, raw.const_data(), peds.const_data(), gain.const_data(), status.const_data(), cmp, &ref[0]);
+  double t2 = ctest_time_sec();
+
+  printf("%-10s %8zu pixels  %zu differ  engine %7.3f ms  reference %7.3f ms per event\n",
+         name, size, nbad, 1e3*(t1-t0)/nevts, 1e3*(t2-t1)/nevts);
+  ctest_check(nbad == 0, name);
+}
+
+//-------------------
+
+int main(int argc, char* argv[]) {
+  test_layout("epix100a", CalibLayout::epix100a());
+  test_layout("jungfrau", CalibLayout::jungfrau(2));
+  test_layout("cspad",    CalibLayout::cspad());
+  test_layout("pnccd",    CalibLayout::pnccd());
+  return psalg::ctest_status();
+}
+
+//-------------------
@@ -7,10 +7,13 @@
 
 //#include "psalg/geometry/GeometryObject.hh"
 #include "psalg/geometry/GeometryAccess.hh"
+#include "psalg/geometry/AngularIntegrator.hh"
 #include "psalg/calib/NDArray.hh"
 #include "psalg/utils/MacTimeFix.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check
 
 using namespace std;
+using namespace psalg;
 //using namespace geometry;
 
 //typedef geometry::GeometryObject::SG SG;
@@ -32,6 +35,9 @@ string fname_cspad2x2("/reg/g/psdm/detector/alignment/cspad2x2/calib-cspad2x2-01
 string fname_cspad("/reg/g/psdm/detector/alignment/cspad/calib-mec-2017-10-20/calib/"
 	           "CsPad::CalibV1/MecTargetChamber.0:Cspad.0/geometry/0-end.data");
 
+// committed with the test, relative to the working directory of add_test
+string fname_fixture("tests/data/geometry-cspad2x2.data");
+
 //-------------------
 
 double time_sec_nsec(const timespec& t){return t.tv_sec + 1e-9*(t.tv_nsec);}
@@ -159,6 +165,134 @@ void test_geo_get_misc()
 
 //-------------------
 
+void test_image_mapping(const string& fname)
+{
+  LOGGER.setLogger(LL::INFO, "%H:%M:%S");
+  cout << "\n==test_image_mapping fname: " << fname << " \n";
+
+  geometry::GeometryAccess geo(fname);
+
+  const pixel_idx_t* iX;
+  const pixel_idx_t* iY;
+  gsize_t size;
+  geo.get_pixel_coord_indexes(iX, iY, size);
+
+  std::vector<double> W(size);
+  double sum = 0;
+  for(gsize_t i=0; i<size; ++i) {W[i] = i%1000; sum += W[i];}
+
+  status = clock_gettime(CLOCK_REALTIME, &start);
+  psalg::NDArray<double> ref = geometry::GeometryAccess::img_from_pixel_arrays(iX, iY, &W[0], size);
+  status = clock_gettime(CLOCK_REALTIME, &stop);
+  cout << "  img_from_pixel_arrays time = " << dtime(start, stop) << " sec\n";
+
+  status = clock_gettime(CLOCK_REALTIME, &start);
+  const geometry::ImageMapping& map = geo.image_mapping();
+  status = clock_gettime(CLOCK_REALTIME, &stop);
+  cout << "  image_mapping build time   = " << dtime(start, stop) << " sec\n";
+
+  psalg::NDArray<double> img;
+  status = clock_gettime(CLOCK_REALTIME, &start);
+  for(unsigned n=0; n<10; n++) map.image(&W[0], img);
+  status = clock_gettime(CLOCK_REALTIME, &stop);
+  cout << "  image_mapping image time   = " << dtime(start, stop)/10 << " sec\n";
+
+  size_t ndiff = (img.size() == ref.size()) ? 0 : img.size();
+  for(size_t i=0; i<img.size() && !ndiff; ++i) if(img.data()[i] != ref.data()[i]) ndiff++;
+  cout << "  image shape " << img.shape()[0] << 'x' << img.shape()[1] << " differences: " << ndiff << '\n';
+  ctest_check(ndiff == 0, "mapped image equals img_from_pixel_arrays");
+
+  // an external buffer of an other size is not written
+  std::vector<double> small(16, -1);
+  const geometry::ImageMapping::shape_t sh[2] = {4, 4};
+  psalg::NDArray<double> ext(sh, 2, &small[0]);
+  map.image(&W[0], ext);
+  ctest_check(ext.data() != &small[0] && ext.size() == img.size() && small.back() == -1,
+              "external buffer of an other size replaced");
+
+  psalg::NDArray<double> bin;
+  geo.image_mapping(4).image(&W[0], bin);
+  double sbin = 0; for(size_t i=0; i<bin.size(); ++i) sbin += bin.data()[i];
+  cout << "  4x4 binned shape " << bin.shape()[0] << 'x' << bin.shape()[1] << " sum/total: " << sbin/sum << '\n';
+  ctest_check(bin.shape()[0] == (img.shape()[0]+3)/4 && fabs(sbin/sum - 1) < 1e-6, "4x4 binned image keeps the sum");
+
+  psalg::NDArray<double> itp;
+  geo.image_mapping(1, true).image(&W[0], itp);
+  double sitp = 0; for(size_t i=0; i<itp.size(); ++i) sitp += itp.data()[i];
+  cout << "  interpolated shape " << itp.shape()[0] << 'x' << itp.shape()[1] << " sum/total: " << sitp/sum << '\n';
+  ctest_check(fabs(sitp/sum - 1) < 1e-6, "interpolated image keeps the sum");
+
+  // the mapping follows a change of the geometry
+  geo.image_mapping();
+  geo.get_geo("SENS2X1:V1", 1)->move_geo(2000, 0, 0);
+  geo.get_pixel_coord_indexes(iX, iY, size);
+  psalg::NDArray<double> moved = geometry::GeometryAccess::img_from_pixel_arrays(iX, iY, &W[0], size);
+  geo.image_mapping().image(&W[0], img);
+  ndiff = (img.size() == moved.size()) ? 0 : img.size();
+  for(size_t i=0; i<img.size() && !ndiff; ++i) if(img.data()[i] != moved.data()[i]) ndiff++;
+  ctest_check(ndiff == 0, "mapping rebuilt after a segment moved");
+}
+
+//-------------------
+
+void test_angular_integrator(const string& fname)
+{
+  LOGGER.setLogger(LL::INFO, "%H:%M:%S");
+  cout << "\n==test_angular_integrator fname: " << fname << " \n";
+
+  geometry::GeometryAccess geo(fname);
+
+  const pixel_coord_t* X;
+  const pixel_coord_t* Y;
+  const pixel_coord_t* Z;
+  gsize_t size;
+  geo.get_pixel_coords(X, Y, Z, size);
+
+  geometry::AngularIntegrator::Pars pars;
+  pars.rmax  = 70000;
+  pars.nr    = 100;
+  pars.nphi  = 4;
+  pars.split = 2;
+
+  status = clock_gettime(CLOCK_REALTIME, &start);
+  geometry::AngularIntegrator integ(geo, pars);
+  status = clock_gettime(CLOCK_REALTIME, &stop);
+  cout << "  build time     = " << dtime(start, stop) << " sec\n";
+
+  // the mean radius of the pixels in a bin is close to its center
+  std::vector<float> R(size);
+  for(gsize_t i=0; i<size; ++i) R[i] = sqrt(X[i]*X[i] + Y[i]*Y[i]);
+
+  std::vector<double> prof(integ.nbins());
+  status = clock_gettime(CLOCK_REALTIME, &start);
+  for(unsigned n=0; n<10; n++) integ.integrate(&R[0], &prof[0]);
+  status = clock_gettime(CLOCK_REALTIME, &stop);
+  cout << "  integrate time = " << dtime(start, stop)/10 << " sec\n";
+
+  std::vector<double> rc = integ.radial_centers();
+  double maxdev = 0, npix = 0;
+  for(unsigned b=0; b<integ.nbins(); ++b) {
+    npix += integ.norm()[b];
+    if(integ.norm()[b] < 10) continue;
+    double dev = fabs(prof[b] - rc[b%pars.nr]);
+    if(dev > maxdev) maxdev = dev;
+  }
+  cout << "  pixels binned " << npix << " of " << size
+       << ", largest deviation of mean radius from bin center " << maxdev
+       << " um, bin width " << (pars.rmax-pars.rmin)/pars.nr << " um\n";
+  ctest_check(fabs(npix - size) < 1e-6*size, "every pixel binned");
+  ctest_check(maxdev < 0.5*(pars.rmax-pars.rmin)/pars.nr, "mean radius within half a bin of its center");
+
+  // summed, not averaged, the bins hold the total of the data
+  integ.integrate(&R[0], &prof[0], false);
+  double sprof = 0, sR = 0;
+  for(unsigned b=0; b<integ.nbins(); ++b) sprof += prof[b];
+  for(gsize_t i=0; i<size; ++i) sR += R[i];
+  ctest_check(fabs(sprof/sR - 1) < 1e-6, "sum of the bins is the total");
+}
+
+//-------------------
+
 void print_hline(const unsigned nchars, const char c) {printf("%s\n", std::string(nchars,c).c_str());}
 
 //-------------------
@@ -172,6 +306,8 @@ std::string usage(const std::string& tname="")
   if (tname == "" || tname=="2"	) ss << "\n   2  - test_geo_get_pixel_coords_as_pointer()";
   if (tname == "" || tname=="3"	) ss << "\n   3  - test_geo_get_pixel_coords_as_ndarray()";
   if (tname == "" || tname=="4"	) ss << "\n   4  - test_geo_get_misc()";
+  if (tname == "" || tname=="5"	) ss << "\n   5  - test_image_mapping([geometry-file])";
+  if (tname == "" || tname=="6"	) ss << "\n   6  - test_angular_integrator([geometry-file])";
   ss << '\n';
   return ss.str();
 }
@@ -195,11 +331,13 @@ int main(int argc, char* argv[])
   else if (tname=="2")  test_geo_get_pixel_coords_as_pointer();
   else if (tname=="3")  test_geo_get_pixel_coords_as_ndarray();
   else if (tname=="4")  test_geo_get_misc();
+  else if (tname=="5")  test_image_mapping(argc>2 ? argv[2] : fname_fixture);
+  else if (tname=="6")  test_angular_integrator(argc>2 ? argv[2] : fname_fixture);
 
   else MSG(WARNING, "Undefined test name: " << tname);
 
   print_hline(80,'_');
-  return EXIT_SUCCESS;
+  return ctest_status();
 }
 
 //-----------------
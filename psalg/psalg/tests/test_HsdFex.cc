@@ -0,0 +1,108 @@
+// Checks the peak lists of Pds::HSD::PeakExtractor on a simulated channel:
+// a raw waveform with pulses and the sparsified stream the firmware would
+// make of it.  The peaks of both streams must agree.
+
+#include <stdio.h>
+#include <stdlib.h>    // rand
+#include <string.h>    // memcpy
+#include <cmath>       // fabs
+#include <vector>
+
+#include "psalg/digitizer/HsdFex.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check
+
+using namespace Pds::HSD;
+using psalg::ctest_check;
+
+static const int ymin = 2040;
+static const int ymax = 2056;
+
+//-------------------
+
+/// Stream header words with the number of samples and the stream id
+static void add_stream(std::vector<uint8_t>& buf, unsigned id, const std::vector<uint16_t>& q) {
+  uint32_t word[4] = {(uint32_t)q.size(), id<<24, 0, 0};
+  const size_t n = buf.size();
+  buf.resize(n + sizeof(word) + 2*q.size());
+  memcpy(&buf[n], word, sizeof(word));
+  memcpy(&buf[n+sizeof(word)], &q[0], 2*q.size());
+}
+
+//-------------------
+
+/// Groups of 4 samples inside of [ymin,ymax] are replaced by skip counts, as in the firmware
+static std::vector<uint16_t> sparsify(const std::vector<uint16_t>& wf) {
+  std::vector<uint16_t> q;
+  unsigned skip = 0;
+  for(size_t g=0; g<wf.size(); g+=4) {
+    bool keep = false;
+    for(size_t i=g; i<g+4; i++) keep |= (wf[i] < ymin || wf[i] > ymax);
+    if (!keep) {skip += 4; continue;}
+    if (skip) {
+      q.push_back(0x8000|skip); q.push_back(0x8000); q.push_back(0x8000); q.push_back(0x8000);
+      skip = 0;
+    }
+    for(size_t i=g; i<g+4; i++) q.push_back(wf[i]);
+  }
+  if (skip) {q.push_back(0x8000|skip); q.push_back(0x8000); q.push_back(0x8000); q.push_back(0x8000);}
+  return q;
+}
+
+//-------------------
+
+int main(int argc, char* argv[]) {
+  srand(1);
+  const float baseline = 0.5*(ymin+ymax);
+
+  // Negative triangular pulses of depth 400 and half width 6 on a noisy baseline
+  const unsigned nsamples = 4000;
+  std::vector<uint16_t> wf(nsamples);
+  for(unsigned i=0; i<nsamples; i++) wf[i] = uint16_t(baseline + rand()%9 - 4);
+  std::vector<unsigned> centers;
+  for(unsigned c=100; c+20<nsamples; c+=97+rand()%200) {
+    centers.push_back(c);
+    for(int k=-6; k<=6; k++) wf[c+k] = uint16_t(baseline - 400*(6-abs(k))/6.);
+  }
+
+  std::vector<uint8_t> data;
+  add_stream(data, 0, wf);
+  add_stream(data, 1, sparsify(wf));
+  uint32_t evtheader[2] = {0x3u<<20, 0};
+
+  PeakExtractor fex(ymin, ymax, 0.5);
+  const unsigned maxPeaks = 64;
+  Peak pfex[maxPeaks], praw[maxPeaks];
+
+  // fex stream is used when present
+  const unsigned nfex = fex.extract(evtheader, &data[0], data.size(), pfex, maxPeaks);
+  const StreamHeader& sh = *reinterpret_cast<const StreamHeader*>(&data[0]);
+  const unsigned nraw = fex.find_raw(reinterpret_cast<const uint16_t*>(&sh+1), nsamples, praw, maxPeaks);
+
+  if (!ctest_check(nfex == centers.size() && nraw == centers.size(), "all peaks of both streams")) {
+    printf("found %u fex and %u raw peaks of %zu\n", nfex, nraw, centers.size());
+    return psalg::ctest_status();
+  }
+  int nbad = 0;
+  for(unsigned k=0; k<nfex; k++) {
+    // The half depth is crossed 3 samples before the center
+    const float t = centers[k] - 3;
+    const Peak& a = pfex[k];
+    const Peak& b = praw[k];
+    const bool ok = a.start <= b.start && a.start+a.width >= b.start+b.width && a.start%4 == 0
+                 && fabs(a.time - t) < 0.01 && fabs(b.time - t) < 0.01
+                 && fabs(b.integral - (-2400)) < 5 && a.integral < 0;
+    if (!ok) {
+      nbad++;
+      printf("peak %u: fex start %u width %u integral %.1f time %.3f, raw start %u width %u integral %.1f time %.3f, expected time %.3f\n",
+             k, a.start, a.width, a.integral, a.time, b.start, b.width, b.integral, b.time, t);
+    }
+  }
+
+  ctest_check(nbad == 0, "fex peaks enclose the raw peaks at the same time");
+
+  ctest_check(fex.parse_fex(*reinterpret_cast<const StreamHeader*>(&data[sizeof(StreamHeader)+2*nsamples]), pfex, 2) == nfex,
+              "dropped peaks are counted");
+  return psalg::ctest_status();
+}
+
+//-------------------
@@ -0,0 +1,194 @@
+// Checks the shared memory index rings of the XtcMonitorServer: the
+// order, bounds and depth of an IndexRing, that concurrent producers and
+// consumers pass every index exactly once, the doorbell of MonitorRings,
+// and prints the time of a hop through a ring and through a POSIX
+// message queue, the transport the rings replace.
+
+#include <stdio.h>
+#include <stdlib.h>    // EXIT_SUCCESS
+#include <fcntl.h>     // O_CREAT
+#include <mqueue.h>
+#include <unistd.h>    // getpid
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "psalg/shmem/IndexRing.hh"
+#include "psalg/shmem/XtcMonitorMsg.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check, ctest_time_sec
+
+using namespace psalg;
+using namespace psalg::shmem;
+
+//-------------------
+
+/// Memory for the rings, aligned as in the shared memory segment
+static void* ring_memory(size_t size) {
+  void* p = 0;
+  return posix_memalign(&p, 64, size) ? 0 : p;
+}
+
+//-------------------
+
+void test_ring() {
+  printf("test_ring\n");
+  const unsigned depth = 8;
+  IndexRing* ring = reinterpret_cast<IndexRing*>(ring_memory(IndexRing::size(depth)));
+  ring->init(depth);
+
+  uint32_t index;
+  ctest_check(!ring->pop(index) && ring->count() == 0, "new ring is empty");
+  bool ok = true;
+  for(uint32_t i=0; i<depth; i++) ok &= ring->push(100+i);
+  ctest_check(ok && ring->count() == depth, "push up to the depth");
+  ctest_check(!ring->push(999), "push to a full ring fails");
+
+  ok = true;
+  for(uint32_t i=0; i<depth; i++) ok &= ring->pop(index) && index == 100+i;
+  ctest_check(ok && !ring->pop(index), "pop in push order until empty");
+
+  // the positions wrap around the cells many times
+  ok = true;
+  for(uint32_t i=0; i<10*depth; i++) ok &= ring->push(i) && ring->pop(index) && index == i;
+  ctest_check(ok, "positions wrap around");
+
+  ring->depth(3);
+  unsigned n = 0;
+  while(ring->push(n)) n++;
+  ctest_check(n == 3, "reduced depth bounds the ring");
+  while(ring->pop(index));
+  ring->depth(2*depth);
+  n = 0;
+  while(ring->push(n)) n++;
+  ctest_check(n == depth, "depth is at most the initial one");
+  free(ring);
+}
+
+//-------------------
+
+void test_threads() {
+  printf("test_threads\n");
+  const unsigned depth = 64, nthreads = 4, nindices = 200000;
+  IndexRing* ring = reinterpret_cast<IndexRing*>(ring_memory(IndexRing::size(depth)));
+  ring->init(depth);
+
+  std::vector<std::atomic<unsigned> > seen(nindices);
+  for(auto& s : seen) s.store(0);
+  std::atomic<unsigned> popped(0);
+  std::vector<std::thread> threads;
+  for(unsigned t=0; t<nthreads; t++) {
+    threads.emplace_back([=]() {         // producer t pushes the indices t, t+nthreads, ...
+      for(uint32_t i=t; i<nindices; i+=nthreads)
+        while(!ring->push(i)) std::this_thread::yield();
+    });
+    threads.emplace_back([&]() {
+      uint32_t index;
+      while(popped.load() < nindices) {
+        if(ring->pop(index)) {
+          seen[index]++;
+          popped++;
+        }
+        else std::this_thread::yield();
+      }
+    });
+  }
+  for(auto& t : threads) t.join();
+
+  bool once = true;
+  for(auto& s : seen) once &= s.load() == 1;
+  ctest_check(once && ring->count() == 0, "each index popped once");
+  free(ring);
+}
+
+//-------------------
+
+void test_doorbell() {
+  printf("test_doorbell\n");
+  const unsigned nqueues = 2, nbuffers = 8;
+  void* p = ring_memory(MonitorRings::size(nqueues, nbuffers));
+  MonitorRings* rings = MonitorRings::create(p, nqueues, nbuffers);
+  ctest_check(MonitorRings::attach(p) == rings, "attach after create");
+
+  uint32_t index;
+  unsigned n = 0;
+  while(rings->post(0, n)) n++;
+  ctest_check(n == nbuffers/nqueues, "client queues share the buffers");
+  while(rings->take(0, index));
+
+  Doorbell& bell = rings->bell(1);
+  uint32_t seq = bell.sequence();
+  ctest_check(!bell.wait(seq, 10), "wait times out without a post");
+
+  bool woken = false;
+  uint32_t taken = ~0U;
+  std::thread client([&]() {
+    woken = bell.wait(seq, 5000) && rings->take(1, taken);
+  });
+  usleep(10000);
+  rings->post(1, 5);
+  client.join();
+  ctest_check(woken && taken == 5, "post wakes the waiting client");
+
+  seq = bell.sequence();
+  rings->post(1, 6);
+  ctest_check(bell.wait(seq, 5000), "no wait after a missed post");
+  free(p);
+}
+
+//-------------------
+
+void test_time() {
+  printf("test_time\n");
+  const unsigned nbuffers = 64, nhops = 200000;
+  void* p = ring_memory(MonitorRings::size(1, nbuffers));
+  MonitorRings* rings = MonitorRings::create(p, 1, nbuffers);
+
+  double t0 = ctest_time_sec();
+  uint32_t index;
+  bool ok = true;
+  for(unsigned i=0; i<nhops; i++) ok &= rings->post(0, i%nbuffers) && rings->take(0, index);
+  double t1 = ctest_time_sec();
+  ctest_check(ok, "ring hops");
+
+  char name[128];
+  sprintf(name, "/test_IndexRing_%d", getpid());
+  mq_attr attr;
+  attr.mq_flags   = 0;
+  attr.mq_maxmsg  = 4;
+  attr.mq_msgsize = sizeof(XtcMonitorMsg);
+  attr.mq_curmsgs = 0;
+  mqd_t q = mq_open(name, O_CREAT|O_RDWR|O_NONBLOCK, 0600, &attr);
+  if(q == (mqd_t)-1) {
+    perror("mq_open");
+    free(p);
+    return;
+  }
+  mq_unlink(name);
+  XtcMonitorMsg msg;
+  ok = true;
+  double t2 = ctest_time_sec();
+  for(unsigned i=0; i<nhops; i++) {
+    msg.bufferIndex(i%nbuffers);
+    ok &= mq_send(q, (const char*)&msg, sizeof(msg), 0) == 0 &&
+          mq_receive(q, (char*)&msg, sizeof(msg), 0) == sizeof(msg);
+  }
+  double t3 = ctest_time_sec();
+  mq_close(q);
+  ctest_check(ok, "message queue hops");
+  printf("  ring %.0f ns, message queue %.0f ns per hop (post and take)\n",
+         1e9*(t1-t0)/nhops, 1e9*(t3-t2)/nhops);
+  free(p);
+}
+
+//-------------------
+
+int main(int argc, char **argv) {
+  test_ring();
+  test_threads();
+  test_doorbell();
+  test_time();
+
+  return ctest_status();
+}
+
+//-------------------
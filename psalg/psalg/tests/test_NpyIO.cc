@@ -0,0 +1,152 @@
+// Saves and loads calibration arrays in the npy format, plain and
+// gzip-compressed, checks the values, that corrupt gzip data are refused,
+// and prints the time to load 3-gain constants of 8 jungfrau modules.
+//
+// The files are written to a new directory in the directory of the
+// argument, /tmp by default.
+
+#include <stdio.h>
+#include <stdlib.h>    // EXIT_SUCCESS
+#include <unistd.h>    // getpid, rmdir
+#include <sys/stat.h>  // mkdir
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "psalg/calib/NpyIO.hh"
+#include "psalg/calib/ArrayIO.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check, ctest_time_sec
+
+using namespace psalg;
+
+typedef psalg::types::shape_t shape_t;
+
+//-------------------
+
+template<typename T>
+static bool same(const NDArray<T>& a, const NDArray<T>& b) {
+  if(a.ndim() != b.ndim() || a.size() != b.size()) return false;
+  for(size_t i=0; i<a.ndim(); i++) if(a.shape()[i] != b.shape()[i]) return false;
+  for(size_t i=0; i<a.size(); i++) if(a.const_data()[i] != b.const_data()[i]) return false;
+  return true;
+}
+
+//-------------------
+
+void test_header() {
+  printf("test_header\n");
+  shape_t sh[] = {3,4};
+  std::string h = npy_header("<f4", sh, 2);
+  NpyHeader p;
+  ctest_check(h.size()%64 == 0 && h[h.size()-1] == '\n', "header is padded to 64 bytes");
+  ctest_check(parse_npy_header(h.data(), h.size(), p), "header is parsed");
+  ctest_check(p.descr == "<f4" && !p.fortran_order && p.shape.size() == 2 && p.shape[0] == 3 && p.shape[1] == 4,
+              "descr and shape");
+
+  // as written by numpy 1.x for np.zeros((5,), dtype=np.uint16)
+  const std::string d("{'descr': '<u2', 'fortran_order': False, 'shape': (5,), }");
+  std::string n("\x93NUMPY\x01\x00", 8);
+  n += (char)(d.size()+1); n += '\0'; n += d; n += '\n';
+  n.append(10, '\0');
+  NDArray<uint16_t> a;
+  ctest_check(set_ndarray_npy(a, n.data(), n.size()) && a.ndim() == 1 && a.size() == 5, "numpy header, 1-d");
+  NDArray<float> f;
+  ctest_check(!set_ndarray_npy(f, n.data(), n.size()), "dtype mismatch is refused");
+}
+
+//-------------------
+
+void test_gunzip() {
+  printf("test_gunzip\n");
+  std::string s(100000, 'a'), z, out;
+  for(size_t i=0; i<s.size(); i+=7) s[i] = 'b';
+  ctest_check(gzip(s.data(), s.size(), z) && gunzip(z.data(), z.size(), out) && out == s, "gzip and gunzip");
+  ctest_check(!gunzip(z.data(), z.size()/2, out), "truncated data do not inflate");
+
+  // the size in the trailer is not trusted beyond the ratio deflate can reach
+  std::string bad("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\x03\x01\x02\x03\xff\xff\xff\xff", 17);
+  out.clear();
+  ctest_check(!gunzip(bad.data(), bad.size(), out) && out.capacity() < (1<<20), "size of a corrupt trailer is capped");
+}
+
+//-------------------
+
+template<typename T>
+void test_save_load(const std::string& dir) {
+  printf("test_save_load %s\n", npy_descr<T>());
+  shape_t sh[] = {2,3,5};
+  NDArray<T> a(sh, 3);
+  for(size_t i=0; i<a.size(); i++) a.data()[i] = T(i*7 % 11);
+
+  const std::string fname = dir + "/test_NpyIO-" + npy_descr<T>()[1] + std::to_string(sizeof(T)) + ".npy";
+  ctest_check(save_npy(fname, a), "save");
+  ctest_check(save_npy(fname + ".gz", a, true), "save compressed");
+
+  NpyArray<T> m;
+  ctest_check(m.load(fname) && m.mapped() && same(m.ndarray(), a), "load mapped");
+  NpyArray<T> z;
+  ctest_check(z.load(fname + ".gz") && !z.mapped() && same(z.ndarray(), a), "load compressed");
+
+  ArrayIO<T> aio(fname);
+  ctest_check(aio.status() == ArrayIO<T>::LOADED && same(aio.ndarray(), a), "ArrayIO");
+  std::vector<T> buf(a.size());
+  ArrayIO<T> aiobuf(fname + ".gz", &buf[0]);
+  ctest_check(aiobuf.ndarray().data() == &buf[0] && same(aiobuf.ndarray(), a), "ArrayIO to external buffer");
+
+  std::ifstream f((fname + ".gz").c_str(), std::ios::binary);
+  std::stringstream ss; ss << f.rdbuf();
+  const std::string s = ss.str();
+  NpyArray<T> b;
+  ctest_check(is_gzip(s.data(), s.size()) && b.set_buffer(s.data(), s.size()) && same(b.ndarray(), a), "set_buffer compressed");
+
+  remove(fname.c_str());
+  remove((fname + ".gz").c_str());
+}
+
+//-------------------
+
+void test_jungfrau(const std::string& dir) {
+  printf("test_jungfrau\n");
+  shape_t sh[] = {3,8,512,1024}; // gain ranges, modules, rows, columns
+  NDArray<float> a(sh, 4);
+  for(size_t i=0; i<a.size(); i++) a.data()[i] = float(i%4099);
+  const std::string fname = dir + "/test_NpyIO-jungfrau.npy";
+  ctest_check(save_npy(fname, a) && save_npy(fname + ".gz", a, true), "save");
+
+  double t0 = ctest_time_sec();
+  NpyArray<float> m;
+  bool ok = m.load(fname);
+  double t1 = ctest_time_sec();
+  NpyArray<float> z;
+  ok = z.load(fname + ".gz") && ok;
+  double t2 = ctest_time_sec();
+  ctest_check(ok && same(m.ndarray(), a) && same(z.ndarray(), a), "load");
+  printf("  %.0f MB: mapped %.3f ms, compressed %.1f ms\n", a.size()*sizeof(float)/1e6, 1e3*(t1-t0), 1e3*(t2-t1));
+
+  remove(fname.c_str());
+  remove((fname + ".gz").c_str());
+}
+
+//-------------------
+
+int main(int argc, char **argv) {
+  std::stringstream ss;
+  ss << ((argc>1) ? argv[1] : "/tmp") << "/test_NpyIO-" << getpid();
+  const std::string dir = ss.str();
+  if(mkdir(dir.c_str(), 0777) != 0) {printf("can not create %s\n", dir.c_str()); return EXIT_FAILURE;}
+
+  test_header();
+  test_gunzip();
+  test_save_load<float>(dir);
+  test_save_load<double>(dir);
+  test_save_load<uint16_t>(dir);
+  test_save_load<int16_t>(dir);
+  test_save_load<uint8_t>(dir);
+  test_jungfrau(dir);
+
+  rmdir(dir.c_str());
+  return ctest_status();
+}
+
+//-------------------
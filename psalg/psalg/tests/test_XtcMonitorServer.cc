@@ -0,0 +1,230 @@
+// Runs an XtcMonitorServer and ShmemClients in threads of this process.
+// Checks that with the shared memory rings in broadcast mode every client
+// receives every event in order, that the buffers held by a client which
+// exits without releasing them are recovered for the others, and that a
+// client sampling the latest events gets the Configure and then events in
+// order, each with the size and the contents the server sent.
+
+#include <stdio.h>
+#include <stdlib.h>    // EXIT_SUCCESS
+#include <unistd.h>    // getpid, usleep
+#include <atomic>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "psalg/shmem/XtcMonitorServer.hh"
+#include "psalg/shmem/ShmemClient.hh"
+#include "xtcdata/xtc/Dgram.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check
+
+using namespace psalg;
+using namespace psalg::shmem;
+using namespace XtcData;
+
+static const unsigned SizeOfBuffers = 0x10000;
+static const unsigned NBuffers      = 8;
+
+//-------------------
+
+class TestServer : public XtcMonitorServer {
+public:
+  TestServer(const char* tag, unsigned nclients) :
+    XtcMonitorServer(tag, SizeOfBuffers, NBuffers, nclients, true), _dg(SizeOfBuffers) {
+    _init();
+    broadcast();
+  }
+  /// Builds a datagram of time n with a payload of size words n, n+1, ...
+  void send(TransitionId::Value tr, unsigned n, unsigned size) {
+    unsigned env = 0;
+    Dgram* dg = new(_dg.data()) Dgram(Transition(Dgram::Event, tr, TimeStamp(n,0), env),
+                                      Xtc(TypeId(TypeId::Parent,0)));
+    uint32_t* payload = reinterpret_cast<uint32_t*>(dg->xtc.alloc(size*sizeof(uint32_t), _dg.data()+_dg.size()));
+    for(unsigned i=0; i<size; i++) payload[i] = n+i;
+    events(dg);
+  }
+  void configure() {
+    send(TransitionId::Configure, 0, 4);
+    send(TransitionId::BeginRun,  0, 4);
+    send(TransitionId::BeginStep, 0, 4);
+    send(TransitionId::Enable,    0, 4);
+  }
+private:
+  std::vector<char> _dg;
+};
+
+/// The times of the L1Accepts a client receives
+class TestClient {
+public:
+  /// A client that stops releasing events after it got 'hold' of them,
+  /// then exits once it has been holding them for 'holdMs'
+  TestClient(const char* tag, int index, std::atomic<unsigned>& nconnected, unsigned hold=0, unsigned holdMs=0) :
+    _thread([=, &nconnected]() {
+      ShmemClient client;
+      if (client.connect(tag, index)) return;
+      nconnected++;
+      unsigned held = 0;
+      while (1) {
+        int i; size_t sz;
+        Dgram* dg = (Dgram*)client.get(i, sz);
+        if (!dg) break;
+        if (dg->service()==TransitionId::L1Accept) {
+          times.push_back(dg->time.seconds());
+          if (hold && ++held >= hold) {
+            usleep(1000*holdMs);
+            return;                     // exits holding the buffers
+          }
+          if (hold)  continue;
+        }
+        client.free(i, sz);
+      }
+    }) {}
+  void join() { _thread.join(); }
+  bool in_order() const {
+    for(size_t i=1; i<times.size(); i++) if (times[i] <= times[i-1]) return false;
+    return true;
+  }
+public:
+  std::vector<unsigned> times;
+private:
+  std::thread _thread;
+};
+
+/// Checks the datagram of time n with a payload of size words n, n+1, ...
+static bool valid(const Dgram* dg, size_t size) {
+  if (size != sizeof(Dgram) + dg->xtc.sizeofPayload() || dg->xtc.sizeofPayload() % sizeof(uint32_t))
+    return false;
+  const uint32_t* payload = reinterpret_cast<const uint32_t*>(dg->xtc.payload());
+  unsigned n = dg->time.seconds();
+  for(unsigned i=0; i<dg->xtc.sizeofPayload()/sizeof(uint32_t); i++)
+    if (payload[i] != n+i) return false;
+  return true;
+}
+
+static void wait_for(std::atomic<unsigned>& nconnected, unsigned n) {
+  for(unsigned i=0; i<5000 && nconnected.load() < n; i++) usleep(1000);
+  usleep(100000);                       // for the server to register them
+}
+
+//-------------------
+
+void test_broadcast() {
+  printf("test_broadcast\n");
+  const unsigned nevents = 200;
+  char tag[64];
+  sprintf(tag, "test_bcast_%d", getpid());
+  std::atomic<unsigned> nconnected(0);
+  TestServer* server = new TestServer(tag, 2);
+  TestClient c0(tag, 0, nconnected), c1(tag, 1, nconnected);
+  wait_for(nconnected, 2);
+  server->configure();
+  usleep(100000);
+  for(unsigned n=1; n<=nevents; n++) {
+    server->send(TransitionId::L1Accept, n, 64);
+    usleep(500);
+  }
+  usleep(100000);
+  server->unlink();
+  delete server;                        // the clients' get() returns NULL once the server is gone
+  c0.join();
+  c1.join();
+  ctest_check(nconnected.load() == 2, "clients connected");
+  ctest_check(c0.times.size() == nevents && c1.times.size() == nevents, "every client gets every event");
+  ctest_check(c0.in_order() && c1.in_order(), "in order");
+  printf("  events received %zu and %zu of %u\n", c0.times.size(), c1.times.size(), nevents);
+}
+
+//-------------------
+
+void test_retire() {
+  printf("test_retire\n");
+  const unsigned nevents = 400;
+  char tag[64];
+  sprintf(tag, "test_retire_%d", getpid());
+  std::atomic<unsigned> nconnected(0);
+  TestServer* server = new TestServer(tag, 2);
+  TestClient c0(tag, 0, nconnected);
+  // Holds every buffer of the server, so that no event is distributed
+  // after those until the client is retired and its holds are released
+  TestClient c1(tag, 1, nconnected, NBuffers, 50);
+  wait_for(nconnected, 2);
+  server->configure();
+  usleep(100000);
+  for(unsigned n=1; n<=nevents; n++) {
+    server->send(TransitionId::L1Accept, n, 64);
+    usleep(500);
+  }
+  usleep(100000);
+  c1.join();
+  server->unlink();
+  delete server;
+  c0.join();
+  ctest_check(c1.times.size() == NBuffers, "retired client held all buffers");
+  ctest_check(c0.in_order(), "in order");
+  ctest_check(!c0.times.empty() && c0.times.back() == nevents, "events distributed after the client left");
+  printf("  events received %zu of %u\n", c0.times.size(), nevents);
+}
+
+//-------------------
+
+void test_snapshot() {
+  printf("test_snapshot\n");
+  const unsigned nevents = 400;
+  char tag[64];
+  sprintf(tag, "test_snapshot_%d", getpid());
+  std::atomic<unsigned> nconnected(0);
+  TestServer* server = new TestServer(tag, 1);
+  TestClient c0(tag, 0, nconnected);
+  wait_for(nconnected, 1);
+
+  std::vector<TransitionId::Value> services;
+  std::vector<unsigned> times;
+  bool sizes = true, contents = true;
+  std::thread sampler([&]() {
+    ShmemClient client;
+    if (client.snapshot(tag)) return;
+    while (1) {
+      int i; size_t sz;
+      Dgram* dg = (Dgram*)client.get(i, sz);
+      if (!dg) break;
+      services.push_back(dg->service());
+      if (dg->service()==TransitionId::L1Accept)  times.push_back(dg->time.seconds());
+      sizes    &= sz == sizeof(Dgram) + dg->xtc.sizeofPayload() && sz < SizeOfBuffers;
+      contents &= valid(dg, sz);
+      client.free(i, sz);
+    }
+  });
+  usleep(100000);
+
+  server->configure();
+  usleep(100000);
+  for(unsigned n=1; n<=nevents; n++) {
+    server->send(TransitionId::L1Accept, n, 16 + n%48);  // a size of its own for many events
+    usleep(500);
+  }
+  usleep(100000);
+  server->unlink();
+  delete server;
+  sampler.join();
+  c0.join();
+
+  bool ordered = true;
+  for(size_t i=1; i<times.size(); i++) ordered &= times[i] > times[i-1];
+  ctest_check(!services.empty() && services[0] == TransitionId::Configure, "Configure first");
+  ctest_check(!times.empty() && ordered, "events in order");
+  ctest_check(sizes, "size of the datagram");
+  ctest_check(contents, "contents of the datagram");
+  printf("  %zu datagrams sampled, %zu events of %u\n", services.size(), times.size(), nevents);
+}
+
+//-------------------
+
+int main(int argc, char **argv) {
+  test_broadcast();
+  test_retire();
+  test_snapshot();
+
+  return ctest_status();
+}
+
+//-------------------
@@ -0,0 +1,267 @@
+// Runs XtcSimulator into a file, a buffer pool and a loopback socket,
+// reads the datagrams back and checks their transitions, data and damage,
+// decodes the hsd streams with Pds::HSD::Channel and prints the rates.
+//
+// The files are written to a new directory in the directory of the
+// argument, /tmp by default.
+
+#include <stdio.h>
+#include <stdlib.h>    // EXIT_SUCCESS
+#include <time.h>      // time
+#include <cmath>       // abs
+#include <string.h>    // memset, strcmp
+#include <unistd.h>    // getpid, close, read
+#include <fcntl.h>     // open
+#include <sys/stat.h>  // mkdir
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <algorithm>   // min, max
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "psalg/detector/XtcSimulator.hh"
+#include "xtcdata/xtc/XtcFileIterator.hh"
+#include "xtcdata/xtc/XtcIterator.hh"
+#include "xtcdata/xtc/ShapesData.hh"
+#include "xtcdata/xtc/NamesIter.hh"
+#include "psalg/alloc/Allocator.hh"
+#include "psalg/digitizer/Hsd.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check, ctest_time_sec
+
+using namespace XtcData;
+using namespace detector;
+using psalg::ctest_check;
+using psalg::ctest_time_sec;
+
+//-------------------
+
+/// Counts the Names and ShapesData of a datagram
+class CountIter : public XtcIterator {
+public:
+  enum {Stop, Continue};
+  CountIter() : nnames(0), nshapes(0) {}
+  int process(Xtc* xtc, const void* bufEnd) {
+    switch(xtc->contains.id()) {
+    case TypeId::Parent:     iterate(xtc, bufEnd); break;
+    case TypeId::Names:      nnames++;  break;
+    case TypeId::ShapesData: nshapes++; break;
+    default: break;
+    }
+    return Continue;
+  }
+  unsigned nnames, nshapes;
+};
+
+/// Decodes the channels of the hsd with Pds::HSD::Channel, as psana does, and
+/// counts those of a raw stream of nsamples with a pulse above the noise
+class HsdIter : public XtcIterator {
+public:
+  enum {Stop, Continue};
+  HsdIter(NamesLookup& namesLookup, unsigned nsamples)
+    : _namesLookup(namesLookup), _nsamples(nsamples), nchans(0), ngood(0) {}
+  int process(Xtc* xtc, const void* bufEnd) {
+    switch(xtc->contains.id()) {
+    case TypeId::Parent: iterate(xtc, bufEnd); break;
+    case TypeId::ShapesData: {
+      ShapesData& shapesdata = *(ShapesData*)xtc;
+      DescData descdata(shapesdata, _namesLookup[shapesdata.namesId()]);
+      Names& names = descdata.nameindex().names();
+      if(strcmp(names.detType(), "hsd") != 0) break;
+      uint32_t* evtheader = descdata.get_array<uint32_t>(0).data();
+      for(unsigned i=1; i<names.num(); i++) {
+        Pds::HSD::Channel chan(&_heap, evtheader, descdata.get_array<uint8_t>(i).data());
+        nchans++;
+        if(chan.numPixels != _nsamples || chan.waveform.num_elem() != _nsamples || chan.npeaks() != 0) continue;
+        uint16_t lo = 0xffff, hi = 0;
+        for(unsigned k=0; k<_nsamples; k++) {lo = std::min(lo, chan.waveform(k)); hi = std::max(hi, chan.waveform(k));}
+        if(hi > lo + 150) ngood++;
+      }
+      break;
+    }
+    default: break;
+    }
+    return Continue;
+  }
+private:
+  NamesLookup& _namesLookup;
+  Heap         _heap;
+  unsigned     _nsamples;
+public:
+  unsigned nchans, ngood;
+};
+
+/// Datagrams by transition, and the contributions of the L1Accepts
+struct Counts {
+  Counts() : nl1(0), ndamaged(0), ncontrib(0), nnames(0) {memset(ntr, 0, sizeof(ntr));}
+  void add(Dgram& dg, const void* bufEnd) {
+    CountIter it;
+    it.iterate(&dg.xtc, bufEnd);
+    ntr[dg.service()]++;
+    if(dg.service() == TransitionId::Configure) nnames += it.nnames;
+    if(dg.service() == TransitionId::L1Accept) {
+      nl1++;
+      ncontrib += it.nshapes;
+      if(dg.xtc.damage.value() & (1<<Damage::DroppedContribution)) ndamaged++;
+    }
+  }
+  unsigned ntr[TransitionId::NumberOf];
+  uint64_t nl1, ndamaged, ncontrib, nnames;
+};
+
+static void add_detectors(XtcSimulator& sim) {
+  unsigned sh[] = {4, 512, 1024};
+  sim.add_area_detector("jungfrau", "jungfrau", sh, 3);
+  sim.add_hsd("hsd", 4, 6000);
+  sim.add_bld("ebeam");
+}
+
+//-------------------
+
+void test_file(const std::string& dir) {
+  printf("test_file\n");
+  const uint64_t nevents = 1000;
+  XtcSimulator sim("tstx00117", 3, 7);
+  add_detectors(sim);
+  unsigned sh[MaxRank] = {2, 2, 2, 2, 2};
+  sim.add_area_detector("toolarge", "toolarge", sh, MaxRank); // refused, the largest rank is MaxRank-1
+  ctest_check(sim.detectors().size() == 3 && sim.detectors()[0].rank == 3, "detectors of a valid rank");
+  sim.set_damage(0.05);
+  const std::string fname = dir + "/test_XtcSimulator.xtc2";
+  {
+    SimFileSink file(fname.c_str());
+    ctest_check(file.ok() && sim.run(file, nevents) == nevents+7, "run");
+  }
+
+  int fd = open(fname.c_str(), O_RDONLY);
+  XtcFileIterator it(fd, sim.max_dgram_size());
+  Counts c;
+  Dgram* dg;
+  NamesIter namesIter;
+  HsdIter hsd(namesIter.namesLookup(), 6000);
+  unsigned sec = 0;
+  while((dg = it.next())) {
+    const void* bufEnd = (char*)dg + it.size();
+    c.add(*dg, bufEnd);
+    sec = dg->time.seconds();
+    if(dg->service() == TransitionId::Configure) namesIter.iterate(&dg->xtc, bufEnd);
+    if(dg->service() == TransitionId::L1Accept) hsd.iterate(&dg->xtc, bufEnd);
+  }
+  close(fd);
+  remove(fname.c_str());
+
+  ctest_check(c.ntr[TransitionId::Configure] == 1 && c.ntr[TransitionId::BeginRun] == 1
+           && c.ntr[TransitionId::Enable] == 1 && c.ntr[TransitionId::EndRun] == 1, "transitions");
+  ctest_check(c.nnames == 4, "names of runinfo and three detectors");
+  ctest_check(c.nl1 == nevents, "L1Accepts");
+  ctest_check(c.ncontrib + sim.ndamaged() == 3*nevents, "contributions and dropped contributions");
+  printf("  dropped %llu of %llu contributions in %llu events\n", (unsigned long long)sim.ndamaged(),
+         (unsigned long long)3*nevents, (unsigned long long)c.ndamaged);
+  ctest_check(sim.ndamaged() > 0.02*3*nevents && sim.ndamaged() < 0.08*3*nevents, "damage fraction");
+  ctest_check(std::abs(double(sec) + 631152000 - time(0)) < 3600, "time stamps of the EPICS epoch");
+  ctest_check(hsd.nchans > 0 && hsd.nchans%4 == 0, "hsd channels decoded");
+  ctest_check(hsd.ngood == hsd.nchans, "raw streams of 6000 samples with a pulse");
+}
+
+//-------------------
+
+void test_pool() {
+  printf("test_pool\n");
+  const uint64_t nevents = 2000;
+  const unsigned nthreads = 2;
+  XtcSimulator sim;
+  add_detectors(sim);
+  SimBufferPool pool(16, sim.max_dgram_size());
+
+  std::atomic<uint64_t> nl1(0), nbytes(0);
+  std::vector<std::thread> workers;
+  for(unsigned t=0; t<nthreads; t++) {
+    workers.emplace_back([&]() {
+      unsigned index;
+      Dgram* dg;
+      while((dg = pool.pop(index))) {
+        if(dg->service() == TransitionId::L1Accept) nl1++;
+        nbytes += sizeof(Dgram) + dg->xtc.sizeofPayload();
+        pool.release(index);
+      }
+    });
+  }
+  double t0 = ctest_time_sec();
+  uint64_t n = sim.run(pool, nevents);
+  pool.close();
+  for(unsigned t=0; t<nthreads; t++) workers[t].join();
+  double dt = ctest_time_sec() - t0;
+
+  ctest_check(n == nevents+7 && nl1 == nevents, "all datagrams are consumed");
+  printf("  %.0f events/s, %.0f MB/s\n", nevents/dt, nbytes/dt/1e6);
+}
+
+//-------------------
+
+void test_socket() {
+  printf("test_socket\n");
+  const uint64_t nevents = 200;
+  int lfd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  socklen_t len = sizeof(addr);
+  if(bind(lfd, (struct sockaddr*)&addr, len) != 0 || listen(lfd, 1) != 0
+  || getsockname(lfd, (struct sockaddr*)&addr, &len) != 0) {
+    ctest_check(false, "loopback socket");
+    return;
+  }
+
+  XtcSimulator sim;
+  add_detectors(sim);
+  sim.set_rate(2000.);
+  const size_t bufsize = sim.max_dgram_size();
+
+  Counts c;
+  std::thread receiver([&]() {
+    int fd = accept(lfd, 0, 0);
+    std::vector<char> buf(bufsize);
+    Dgram* dg = (Dgram*)&buf[0];
+    while(recv(fd, dg, sizeof(Dgram), MSG_WAITALL) == sizeof(Dgram)) {
+      const size_t size = dg->xtc.sizeofPayload();
+      if(size > bufsize-sizeof(Dgram) || recv(fd, dg->xtc.payload(), size, MSG_WAITALL) != (ssize_t)size) break;
+      c.add(*dg, &buf[0] + bufsize);
+    }
+    close(fd);
+  });
+
+  double t0 = ctest_time_sec();
+  {
+    SimSocketSink sock("127.0.0.1", ntohs(addr.sin_port));
+    ctest_check(sock.ok() && sim.run(sock, nevents) == nevents+7, "run");
+  }
+  double dt = ctest_time_sec() - t0;
+  receiver.join();
+  close(lfd);
+
+  ctest_check(c.ntr[TransitionId::Configure] == 1 && c.nl1 == nevents && c.ntr[TransitionId::EndRun] == 1, "received");
+  ctest_check(dt > 0.9*nevents/2000., "paced at 2 kHz");
+  printf("  %.0f events/s\n", nevents/dt);
+}
+
+//-------------------
+
+int main(int argc, char **argv) {
+  std::stringstream ss;
+  ss << ((argc>1) ? argv[1] : "/tmp") << "/test_XtcSimulator-" << getpid();
+  const std::string dir = ss.str();
+  if(mkdir(dir.c_str(), 0777) != 0) {printf("can not create %s\n", dir.c_str()); return EXIT_FAILURE;}
+
+  test_file(dir);
+  test_pool();
+  test_socket();
+
+  rmdir(dir.c_str());
+  return psalg::ctest_status();
+}
+
+//-------------------
@@ -0,0 +1,698 @@
+#ifndef PSALG_ASYNCLOG_H
+#define PSALG_ASYNCLOG_H
+
+//-------------------
+/** Asynchronous backend of psalg::SysLog and Logger::Logger.
+ *
+ *  The logging thread copies the format, the arguments and the strings they
+ *  point to into a fixed size record of its own single-producer ring, with no
+ *  lock, allocation or formatting; a background thread formats the records of
+ *  all rings in time order and hands them to their sink, syslog for SysLog.
+ *  A full ring drops the record and counts it, so a burst of messages does not
+ *  stall the caller.
+ *
+ *  Usage
+ *
+ *  #include "psalg/utils/AsyncLog.hh"
+ *
+ *  psalg::AsyncLog& alog = psalg::AsyncLog::instance();
+ *  alog.start();                   // or SysLog::init(instrument, level, true)
+ *  alog.log(psalg::AsyncLog::syslog_sink, LOG_INFO, "<I> ", "event %lu of %s", nevt, name);
+ *  alog.flush();                   // waits for the records logged so far by this thread
+ *  psalg::AsyncLog::Stats s = alog.stats();
+ *  alog.stop();
+ *
+ *  Arguments are integers, enums, floating point numbers, pointers and C strings,
+ *  at most MAX_ARGS of them, for printf conversions with flags, width, precision
+ *  and length modifiers, and %m with the errno of the call; %n is ignored.
+ *  Strings are copied up to the precision of their conversion, %.*s may point
+ *  to a buffer without a 0. A message which does not fit a record is formatted
+ *  on the calling thread into an allocated overflow buffer, which the record
+ *  hands whole to the background thread. log() returns false when the backend
+ *  is not running, in a forked child too, the caller then writes the message itself.
+ *
+ *  LogRateLimiter counts the messages of each call site, identified by the
+ *  address of its format, and refuses those above a number per second.
+ */
+
+#include <stdint.h>
+#include <stdio.h>     // snprintf
+#include <stdlib.h>    // malloc, free
+#include <stdarg.h>
+#include <string.h>    // memcpy, strnlen, strchr, strerror_r
+#include <errno.h>
+#include <pthread.h>   // pthread_atfork, pthread_setname_np
+#include <syslog.h>
+#include <sys/types.h> // ssize_t
+#include <time.h>      // clock_gettime
+#include <algorithm>   // std::min
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>     // std::nullptr_t, ptrdiff_t
+#include <mutex>
+#include <new>         // placement new
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace psalg {
+
+//-------------------
+
+/// Counts the messages of each call site in the current second, refuses those above the limit
+class LogRateLimiter {
+public:
+  enum {NSLOTS = 1024, NPROBES = 8};
+
+  LogRateLimiter() : _limit(0), _nsuppressed(0) {
+    for(unsigned i=0; i<NSLOTS; i++) {
+      _slots[i].site.store(0);
+      _slots[i].second.store(0);
+      _slots[i].count.store(0);
+      _slots[i].suppressed.store(0);
+    }
+  }
+
+  /// Messages per second of each call site, 0 - no limit
+  void set_limit(unsigned per_second) {_limit.store(per_second, std::memory_order_relaxed);}
+  unsigned limit() const {return _limit.load(std::memory_order_relaxed);}
+
+  /// false if the message of site is over the limit; when a new second starts
+  /// for site, suppressed is the number of its messages refused before
+  bool allow(const void* site, unsigned& suppressed) {
+    suppressed = 0;
+    const unsigned limit = _limit.load(std::memory_order_relaxed);
+    if(!limit) return true;
+    Slot* s = _slot(site);
+    if(!s) return true; // the table is full
+    const uint32_t now = _now();
+    uint32_t then = s->second.load(std::memory_order_relaxed);
+    if(then != now && s->second.compare_exchange_strong(then, now, std::memory_order_relaxed)) {
+      s->count.store(0, std::memory_order_relaxed);
+      suppressed = s->suppressed.exchange(0, std::memory_order_relaxed);
+    }
+    if(s->count.fetch_add(1, std::memory_order_relaxed) < limit) return true;
+    s->suppressed.fetch_add(1, std::memory_order_relaxed);
+    _nsuppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  /// Messages refused since the start
+  uint64_t nsuppressed() const {return _nsuppressed.load(std::memory_order_relaxed);}
+
+private:
+
+  struct Slot {
+    std::atomic<const void*> site;
+    std::atomic<uint32_t> second;
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> suppressed;
+  };
+
+  static uint32_t _now() {
+    struct timespec t;
+#ifdef CLOCK_MONOTONIC_COARSE
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &t);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &t);
+#endif
+    return t.tv_sec;
+  }
+
+  Slot* _slot(const void* site) {
+    const uint64_t h = (uint64_t(reinterpret_cast<uintptr_t>(site)) * 0x9E3779B97F4A7C15ull) >> 54;
+    for(unsigned i=0; i<NPROBES; i++) {
+      Slot& s = _slots[(h+i) & (NSLOTS-1)];
+      const void* cur = s.site.load(std::memory_order_relaxed);
+      if(!cur && s.site.compare_exchange_strong(cur, site)) return &s;
+      if(cur == site) return &s;
+    }
+    return 0;
+  }
+
+  std::atomic<unsigned> _limit;
+  std::atomic<uint64_t> _nsuppressed;
+  Slot _slots[NSLOTS];
+};
+
+//-------------------
+
+class AsyncLog {
+public:
+
+  enum {MAX_ARGS = 16, RECORD_SIZE = 512, MESSAGE_SIZE = 4096};
+
+  /// Writes a formatted message, called by the background thread
+  typedef void (*Sink)(int priority, const char* msg);
+
+  struct Stats {
+    uint64_t logged;     // records handed to their sinks
+    uint64_t dropped;    // records lost to full rings
+    uint64_t suppressed; // messages refused by the rate limiter
+  };
+
+  static AsyncLog& instance() {
+    static AsyncLog alog;
+    return alog;
+  }
+
+  static void syslog_sink(int priority, const char* msg) {syslog(priority, "%s", msg);}
+
+  /// Starts the background thread, with rings of nrecords (rounded up to a power of 2)
+  /// for the threads which log from now on, woken up every interval_ms
+  void start(unsigned nrecords=256, unsigned interval_ms=5) {
+    std::lock_guard<std::mutex> lock(_control);
+    if(running()) return;
+    unsigned n = 2;
+    while(n < nrecords) n <<= 1;
+    _nrecords = n;
+    _interval_ms = interval_ms ? interval_ms : 1;
+    static bool atfork = false;
+    if(!atfork) {pthread_atfork(0, 0, &AsyncLog::_atfork_child); atfork = true;}
+    _running.store(true);
+    _thread = std::thread(&AsyncLog::_run, this);
+  }
+
+  /// Writes the pending records and stops the background thread
+  void stop() {
+    std::lock_guard<std::mutex> lock(_control);
+    if(!_running.exchange(false)) return;
+    _wake();
+    _thread.join();
+    _drain(); // records of threads which found it running just before
+    _reap();
+  }
+
+  bool running() const {return _running.load(std::memory_order_relaxed);}
+
+  /// Waits for the background thread to write the records logged before
+  void flush() {
+    if(!running() || std::this_thread::get_id() == _thread.get_id()) return;
+    const uint64_t req = _flush_req.fetch_add(1) + 1;
+    std::unique_lock<std::mutex> lock(_wake_mutex);
+    _wakeup = true;
+    _wake_cv.notify_one();
+    _flush_cv.wait(lock, [this, req]() {return _flushed >= req || !running();});
+  }
+
+  Stats stats() const {
+    Stats s;
+    s.logged = _logged.load(std::memory_order_relaxed);
+    s.dropped = _ndropped();
+    s.suppressed = _limiter.nsuppressed();
+    return s;
+  }
+
+  LogRateLimiter& limiter() {return _limiter;}
+
+  /// Queues the message prefix+fmt with args for sink, false if not running
+  template<typename... Args>
+  bool log(Sink sink, int priority, const char* prefix, const char* fmt, Args... args) {
+    const int err = errno;
+    if(!running()) return false;
+    Ring* ring = _ring();
+    Record* r = _claim(ring);
+    if(!r) return true;
+    r->flags = 0;
+    r->nargs = 0;
+    r->size = 0;
+    _copy(*r, prefix, false);
+    if(!(r->flags & OVERFLOW)) r->size--; // fmt follows the prefix
+    _copy(*r, fmt, false);
+    Scan scan(fmt);
+    int expand[] = {0, (_capture(*r, scan, args), 0)...};
+    (void)expand;
+    if(r->flags & OVERFLOW) _format_now(*r, prefix, fmt, args...);
+    _publish(ring, r, sink, priority, err);
+    return true;
+  }
+
+  /// Queues the formatted text for sink, false if not running
+  bool log_text(Sink sink, int priority, const char* text) {
+    const int err = errno;
+    if(!running()) return false;
+    Ring* ring = _ring();
+    Record* r = _claim(ring);
+    if(!r) return true;
+    const size_t n = strlen(text);
+    char* overflow = (n < DATA_SIZE) ? 0 : (char*)malloc(n+1);
+    const size_t m = overflow ? n : std::min<size_t>(n, DATA_SIZE-1); // truncated without memory
+    char* t = overflow ? overflow : r->data;
+    memcpy(t, text, m);
+    t[m] = 0;
+    _set_text(*r, t);
+    _publish(ring, r, sink, priority, err);
+    return true;
+  }
+
+  AsyncLog(const AsyncLog&) = delete;
+  AsyncLog& operator = (const AsyncLog&) = delete;
+
+private:
+
+  enum Kind {INT, DBL, STR, PTR};
+  enum Flags {TEXT=1, OVERFLOW=2, HEAP=4};
+  enum {DATA_SIZE = RECORD_SIZE - 176};
+
+  struct Record {
+    uint64_t ns;       // time of the call, orders the records of the rings
+    Sink     sink;
+    int32_t  priority;
+    int32_t  err;      // errno of the call, for %m
+    uint16_t size;     // bytes used in data
+    uint8_t  nargs;
+    uint8_t  flags;
+    uint8_t  kinds[MAX_ARGS];
+    uint64_t args[MAX_ARGS];  // values, offsets in data for strings; the text of HEAP
+    char     data[DATA_SIZE]; // prefix and format, then the strings
+  };
+  static_assert(sizeof(Record) == RECORD_SIZE, "AsyncLog::Record layout");
+
+  /// Records of one logging thread, written by it and read by the background thread
+  struct Ring {
+    Ring(unsigned n) : records(n), mask(n-1), head(0), tail(0), dropped(0), retired(false) {}
+    std::vector<Record> records;
+    const uint64_t mask;
+    char _pad0[64];
+    std::atomic<uint64_t> head;    // next record to write
+    char _pad1[64];
+    std::atomic<uint64_t> tail;    // next record to read
+    char _pad2[64];
+    std::atomic<uint64_t> dropped;
+    std::atomic<bool>     retired; // the thread has exited
+  };
+
+  AsyncLog() : _running(false), _nrecords(256), _interval_ms(5), _logged(0), _dropped_retired(0),
+               _flush_req(0), _flushed(0), _wakeup(false) {}
+
+  /// Rings of threads still running are left, they may log from their destructors
+  ~AsyncLog() {stop();}
+
+  /// A forked child has no background thread, it logs on the calling thread
+  static void _atfork_child() {
+    AsyncLog& alog = instance();
+    if(!alog._running.exchange(false)) return;
+    new (&alog._thread) std::thread(); // the handle of the parent's thread can not be joined
+  }
+
+  static uint64_t _time_ns() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return uint64_t(t.tv_sec)*1000000000ull + t.tv_nsec;
+  }
+
+  Ring* _ring() {
+    struct Holder {
+      Ring* ring;
+      Holder() : ring(0) {}
+      ~Holder() {if(ring) ring->retired.store(true, std::memory_order_release); ring = 0;}
+    };
+    static thread_local Holder holder;
+    if(!holder.ring) {
+      holder.ring = new Ring(_nrecords);
+      std::lock_guard<std::mutex> lock(_rings_mutex);
+      _rings.push_back(holder.ring);
+    }
+    return holder.ring;
+  }
+
+  static Record* _claim(Ring* ring) {
+    const uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if(head - ring->tail.load(std::memory_order_acquire) > ring->mask) {
+      ring->dropped.store(ring->dropped.load(std::memory_order_relaxed)+1, std::memory_order_relaxed);
+      return 0;
+    }
+    return &ring->records[head & ring->mask];
+  }
+
+  void _publish(Ring* ring, Record* r, Sink sink, int priority, int err) {
+    r->ns = _time_ns();
+    r->sink = sink;
+    r->priority = priority;
+    r->err = err;
+    const uint64_t head = ring->head.load(std::memory_order_relaxed) + 1;
+    ring->head.store(head, std::memory_order_release);
+    if(2*(head - ring->tail.load(std::memory_order_relaxed)) > ring->mask+1) _wake(); // half full
+  }
+
+  void _wake() {
+    std::lock_guard<std::mutex> lock(_wake_mutex);
+    _wakeup = true;
+    _wake_cv.notify_one();
+  }
+
+  //-------------------
+  // argument capture, on the logging thread
+
+  static void _arg(Record& r, Kind kind, uint64_t value) {
+    if(r.nargs == MAX_ARGS) {r.flags |= OVERFLOW; return;}
+    r.kinds[r.nargs] = kind;
+    r.args[r.nargs++] = value;
+  }
+
+  /// Position of the arguments in the format, for the precision of their strings
+  struct Scan {
+    const char* p;
+    unsigned    pending;   // arguments left to the current conversion, its * first
+    int         precision; // -1 for none
+    bool        star;      // the precision is the last * argument
+    Scan(const char* fmt) : p(fmt), pending(0), precision(-1), star(false) {}
+
+    /// Moves to the next argument, true if it is the value of a conversion, not a * of it
+    bool next() {
+      if(!pending) {
+        precision = -1;
+        star = false;
+        while(*p) {
+          if(*p++ != '%') continue;
+          if(*p == '%') {p++; continue;}
+          while(*p && strchr("-+ #0'", *p)) p++;
+          unsigned nstars = 0;
+          if(*p == '*') {nstars++; p++;}
+          else while(*p >= '0' && *p <= '9') p++;
+          if(*p == '.') {
+            p++;
+            if(*p == '*') {nstars++; star = true; p++;}
+            else for(precision=0; *p >= '0' && *p <= '9'; p++) precision = 10*precision + (*p-'0');
+          }
+          while(*p && strchr("hlLqjzt", *p)) p++;
+          if(*p == 'm') {p++; precision = -1; star = false; continue;} // takes no argument
+          if(*p) p++;
+          pending = nstars+1;
+          break;
+        }
+        if(!pending) return true; // more arguments than conversions
+      }
+      return --pending == 0;
+    }
+
+    /// The * argument v, the precision if it is the last of the conversion
+    void star_value(int64_t v) {if(star && pending == 1) precision = (v < 0) ? -1 : int(std::min<int64_t>(v, DATA_SIZE));}
+  };
+
+  /// Copies the string s, at most max characters of it if max >= 0, with a 0 to data,
+  /// as an argument if arg
+  static void _copy(Record& r, const char* s, bool arg, int max=-1) {
+    const size_t avail = DATA_SIZE - r.size;
+    const size_t n = strnlen(s, (max >= 0 && size_t(max) < avail) ? size_t(max) : avail);
+    if(n == avail) {r.flags |= OVERFLOW; return;}
+    memcpy(r.data + r.size, s, n);
+    r.data[r.size + n] = 0;
+    if(arg) _arg(r, STR, r.size);
+    r.size += n+1;
+  }
+
+  template<typename T>
+  static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+  _capture(Record& r, Scan& scan, T v) {
+    if(!scan.next()) scan.star_value(static_cast<int64_t>(v));
+    _arg(r, INT, uint64_t(static_cast<int64_t>(v)));
+  }
+
+  template<typename T>
+  static typename std::enable_if<std::is_floating_point<T>::value>::type
+  _capture(Record& r, Scan& scan, T v) {
+    scan.next();
+    const double d = v;
+    uint64_t u;
+    memcpy(&u, &d, sizeof(u));
+    _arg(r, DBL, u);
+  }
+
+  template<typename T>
+  static void _capture(Record& r, Scan& scan, T* p) {scan.next(); _arg(r, PTR, reinterpret_cast<uintptr_t>(p));}
+
+  static void _capture(Record& r, Scan& scan, const char* s) {
+    const int max = scan.next() ? scan.precision : -1;
+    if(s) _copy(r, s, true, max); else _arg(r, PTR, 0);
+  }
+  static void _capture(Record& r, Scan& scan, char* s) {_capture(r, scan, (const char*)s);}
+  static void _capture(Record& r, Scan& scan, std::nullptr_t) {scan.next(); _arg(r, PTR, 0);}
+
+  /// Sets r to the formatted text t, which is its data or a buffer of malloc the record owns
+  static void _set_text(Record& r, char* t) {
+    r.nargs = 0;
+    if(t == r.data) {r.size = strlen(r.data) + 1; r.flags = TEXT; return;}
+    r.size = 0;
+    r.args[0] = reinterpret_cast<uintptr_t>(t);
+    r.flags = TEXT|HEAP;
+  }
+
+  /// Formats a message which does not fit the record, into an overflow buffer if it is too long for data
+  static void _format_now(Record& r, const char* prefix, const char* fmt, ...) {
+    va_list args, again;
+    va_start(args, fmt);
+    va_copy(again, args);
+    const size_t np = strlen(prefix);
+    const int nf = vsnprintf(0, 0, fmt, args);
+    const size_t n = np + (nf > 0 ? nf : 0);
+    char* t = (n < DATA_SIZE) ? 0 : (char*)malloc(n+1);
+    const size_t size = t ? n+1 : DATA_SIZE; // truncated without memory
+    if(!t) t = r.data;
+    snprintf(t, size, "%s", prefix);
+    if(np < size) vsnprintf(t + np, size - np, fmt, again);
+    va_end(again);
+    va_end(args);
+    _set_text(r, t);
+  }
+
+  //-------------------
+  // formatting, on the background thread
+
+  template<typename T>
+  static int _put(char* o, size_t size, const char* spec, const int* stars, unsigned nstars, T v) {
+    switch(nstars) {
+    case 0:  return snprintf(o, size, spec, v);
+    case 1:  return snprintf(o, size, spec, stars[0], v);
+    default: return snprintf(o, size, spec, stars[0], stars[1], v);
+    }
+  }
+
+  static int _put_signed(char* o, size_t size, const char* spec, const int* stars, unsigned nstars,
+                         const char* len, uint64_t v) {
+    switch(len[0]) {
+    case 'l': if(len[1] == 'l') return _put(o, size, spec, stars, nstars, (long long)v);
+              return _put(o, size, spec, stars, nstars, (long)v);
+    case 'q': return _put(o, size, spec, stars, nstars, (long long)v);
+    case 'j': return _put(o, size, spec, stars, nstars, (intmax_t)v);
+    case 'z': return _put(o, size, spec, stars, nstars, (ssize_t)v);
+    case 't': return _put(o, size, spec, stars, nstars, (ptrdiff_t)v);
+    default:  return _put(o, size, spec, stars, nstars, (int)v);
+    }
+  }
+
+  static int _put_unsigned(char* o, size_t size, const char* spec, const int* stars, unsigned nstars,
+                           const char* len, uint64_t v) {
+    switch(len[0]) {
+    case 'l': if(len[1] == 'l') return _put(o, size, spec, stars, nstars, (unsigned long long)v);
+              return _put(o, size, spec, stars, nstars, (unsigned long)v);
+    case 'q': return _put(o, size, spec, stars, nstars, (unsigned long long)v);
+    case 'j': return _put(o, size, spec, stars, nstars, (uintmax_t)v);
+    case 'z':
+    case 't': return _put(o, size, spec, stars, nstars, (size_t)v);
+    default:  return _put(o, size, spec, stars, nstars, (unsigned)v);
+    }
+  }
+
+  /// Formats the record into out, "<?>" for a conversion without a matching argument
+  static void _format(const Record& r, char* out, size_t size) {
+    if(r.flags & TEXT) {snprintf(out, size, "%s", r.data); return;}
+    char* o = out;
+    char* const end = out + size - 1;
+    unsigned a = 0;
+    const char* p = r.data;
+    while(*p && o < end) {
+      if(*p != '%') {*o++ = *p++; continue;}
+      if(p[1] == '%') {*o++ = '%'; p += 2; continue;}
+      const char* s = p++;
+      bool bad = false;
+      while(*p && strchr("-+ #0'", *p)) p++;
+      int stars[2];
+      unsigned nstars = 0;
+      for(int part=0; part<2; part++) {  // width and precision
+        if(part == 1) {if(*p != '.') break; p++;}
+        if(*p == '*') {
+          p++;
+          if(a < r.nargs && r.kinds[a] == INT) stars[nstars++] = int(r.args[a++]);
+          else bad = true;
+        }
+        else while(*p >= '0' && *p <= '9') p++;
+      }
+      char len[3] = {0, 0, 0};
+      for(unsigned n=0; n<2 && *p && strchr("hlLqjzt", *p); n++) len[n] = *p++;
+      const char conv = *p;
+      if(!conv) break;
+      p++;
+
+      char spec[32];
+      const size_t n = p - s;
+      if(n < sizeof(spec)) {memcpy(spec, s, n); spec[n] = 0;}
+      else bad = true;
+
+      const size_t avail = end - o + 1;
+      int m = -1;
+      if(conv == 'm') {
+        char buf[128];
+        const char* e = strerror_r(r.err, buf, sizeof(buf)); // GNU strerror_r
+        m = snprintf(o, avail, "%s", e);
+      }
+      else if(conv == 'n') {
+        if(a < r.nargs) a++;
+        m = 0;
+      }
+      else if(!bad && a < r.nargs) {
+        const Kind kind = Kind(r.kinds[a]);
+        const uint64_t v = r.args[a++];
+        double d;
+        memcpy(&d, &v, sizeof(d));
+        switch(conv) {
+        case 'd': case 'i':
+          if(kind == INT) m = _put_signed(o, avail, spec, stars, nstars, len, v);
+          break;
+        case 'o': case 'u': case 'x': case 'X':
+          if(kind == INT) m = _put_unsigned(o, avail, spec, stars, nstars, len, v);
+          break;
+        case 'c':
+          if(kind == INT) m = _put(o, avail, spec, stars, nstars, (int)v);
+          break;
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+          if(kind == DBL) m = (len[0] == 'L') ? _put(o, avail, spec, stars, nstars, (long double)d)
+                                              : _put(o, avail, spec, stars, nstars, d);
+          break;
+        case 's':
+          if(len[0]) break;
+          if(kind == STR) m = _put(o, avail, spec, stars, nstars, r.data + v);
+          else if(kind == PTR && !v) m = _put(o, avail, spec, stars, nstars, "(null)");
+          break;
+        case 'p':
+          if(kind == PTR || kind == INT) m = _put(o, avail, spec, stars, nstars, (const void*)(uintptr_t)v);
+          break;
+        default:
+          break;
+        }
+      }
+      if(m < 0) m = snprintf(o, avail, "<?>");
+      o += std::min<size_t>(m, end - o);
+    }
+    *o = 0;
+  }
+
+  //-------------------
+  // background thread
+
+  void _run() {
+#ifdef __linux__
+    pthread_setname_np(pthread_self(), "asynclog");
+#endif
+    uint64_t reported = 0;
+    uint64_t treported = 0;
+    while(true) {
+      const uint64_t req = _flush_req.load();
+      const bool stopping = !running();
+      _drain();
+      {
+        std::lock_guard<std::mutex> lock(_wake_mutex);
+        if(req > _flushed) {_flushed = req; _flush_cv.notify_all();}
+      }
+      _reap();
+
+      const uint64_t dropped = _ndropped();
+      const uint64_t now = _time_ns();
+      if(dropped > reported && (now - treported > 1000000000ull || stopping)) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "<W> AsyncLog: %llu log messages dropped", (unsigned long long)dropped);
+        syslog_sink(LOG_WARNING, msg);
+        reported = dropped;
+        treported = now;
+      }
+      if(stopping) break;
+
+      std::unique_lock<std::mutex> lock(_wake_mutex);
+      _wake_cv.wait_for(lock, std::chrono::milliseconds(_interval_ms), [this]() {return _wakeup;});
+      _wakeup = false;
+    }
+    std::lock_guard<std::mutex> lock(_wake_mutex);
+    _flush_cv.notify_all();
+  }
+
+  /// Writes the records of all rings, the oldest first
+  void _drain() {
+    std::vector<Ring*> rings;
+    {
+      std::lock_guard<std::mutex> lock(_rings_mutex);
+      rings = _rings;
+    }
+    char msg[MESSAGE_SIZE];
+    uint64_t n = 0;
+    while(true) {
+      Ring* next = 0;
+      const Record* first = 0;
+      for(size_t i=0; i<rings.size(); i++) {
+        Ring* ring = rings[i];
+        const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        if(tail == ring->head.load(std::memory_order_acquire)) continue;
+        const Record& rec = ring->records[tail & ring->mask];
+        if(!first || rec.ns < first->ns) {first = &rec; next = ring;}
+      }
+      if(!next) break;
+      if(first->flags & HEAP) {
+        char* text = reinterpret_cast<char*>(first->args[0]);
+        first->sink(first->priority, text);
+        free(text);
+      }
+      else {
+        _format(*first, msg, sizeof(msg));
+        first->sink(first->priority, msg);
+      }
+      next->tail.store(next->tail.load(std::memory_order_relaxed)+1, std::memory_order_release);
+      n++;
+    }
+    _logged.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  /// Deletes the empty rings of the threads which have exited
+  void _reap() {
+    std::lock_guard<std::mutex> lock(_rings_mutex);
+    for(size_t i=0; i<_rings.size();) {
+      Ring* ring = _rings[i];
+      if(ring->retired.load(std::memory_order_acquire)
+      && ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire)) {
+        _dropped_retired += ring->dropped.load(std::memory_order_relaxed);
+        delete ring;
+        _rings[i] = _rings.back();
+        _rings.pop_back();
+      }
+      else i++;
+    }
+  }
+
+  uint64_t _ndropped() const {
+    std::lock_guard<std::mutex> lock(_rings_mutex);
+    uint64_t n = _dropped_retired;
+    for(size_t i=0; i<_rings.size(); i++) n += _rings[i]->dropped.load(std::memory_order_relaxed);
+    return n;
+  }
+
+  std::atomic<bool>   _running;
+  unsigned            _nrecords;
+  unsigned            _interval_ms;
+  std::mutex          _control;  // start and stop
+  std::thread         _thread;
+  mutable std::mutex  _rings_mutex;
+  std::vector<Ring*>  _rings;
+  std::atomic<uint64_t> _logged;
+  uint64_t            _dropped_retired;
+  std::atomic<uint64_t> _flush_req;
+  uint64_t            _flushed;
+  bool                _wakeup;
+  std::mutex          _wake_mutex;
+  std::condition_variable _wake_cv;
+  std::condition_variable _flush_cv;
+  LogRateLimiter      _limiter;
+};
+
+//-------------------
+
+} // namespace psalg
+
+#endif // PSALG_ASYNCLOG_H
@@ -26,6 +26,7 @@
  *   LOGGER.setLevel(LL::DEBUG);
  *   LOGGER.setTimeFormat("%Y-%m-%d %H:%M:%S.%f");
  *   LOGGER.loggerInfo(std::cout); // or Logger::Logger::instance()->loggerIinfo(out);
+ *   LOGGER.setAsync(true);        // std streams are written by the psalg::AsyncLog thread
  */
 
 //-------------------
@@ -90,6 +91,10 @@ public:
   void addHandler(LogHandler* handler) {_handlers.push_back(handler);}
   void setTimeFormat(const std::string& timefmt="%Y-%m-%d %H:%M:%S.%f");
 
+  /// messages are formatted by the caller and written by the psalg::AsyncLog thread, FATAL waits for them
+  void setAsync(bool async);
+  inline bool async() const {return _async;}
+
 private:
   typedef std::vector<LogHandler*> HandlerList;
 
@@ -103,6 +108,7 @@ private:
   unsigned    _counter; // record counter
   std::string _logname; // logger name
   LEVEL       _level;   // level of messages
+  bool        _async;   // write through psalg::AsyncLog
   //const char* _tstamp_start; // start logeer timestamp
   const std::string _tstamp_start; // start logeer timestamp
 
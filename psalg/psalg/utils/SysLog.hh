@@ -4,6 +4,10 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <syslog.h>     // defines LOG_WARNING, etc
+#include <atomic>
+#include <string>
+
+#include "psalg/utils/AsyncLog.hh"
 
 #undef GET_PROGRAM_NAME
 #ifdef __GLIBC__
@@ -16,12 +20,25 @@
 
 #define SYSLOG_IDENT_MAX    32
 #define SYSLOG_FORMAT_MAX   4096
+#define SYSLOG_RATE_LIMIT   100
 
 namespace psalg {
+    /**
+     * Usage
+     *
+     * using logging = psalg::SysLog;
+     * logging::init(instrument, LOG_INFO);        // synchronous, vsyslog on the calling thread
+     * logging::init(instrument, LOG_INFO, true);  // asynchronous, see AsyncLog.hh
+     * logging::info("event %lu of %s", nevt, name);
+     *
+     * In asynchronous mode the messages are formatted and written by a background
+     * thread, each call site (format) logs at most SYSLOG_RATE_LIMIT messages per
+     * second, and critical() waits for the pending messages before it returns.
+     */
     class SysLog {
         public:
 
-        static void init(const char *instrument, int level)
+        static void init(const char *instrument, int level, bool async=false)
         {
             static char ident[SYSLOG_IDENT_MAX];
             if (instrument) {
@@ -31,55 +48,93 @@ namespace psalg {
             }
             openlog(ident, LOG_PID | LOG_PERROR, LOG_USER);
             setlogmask(LOG_UPTO(level));
+            _logmask() = LOG_UPTO(level);
+            if (async) {
+                AsyncLog::instance().start();
+                rate_limit(SYSLOG_RATE_LIMIT);
+            }
         }
 
-        static void debug(const char *fmt, ...)
+        /// Messages per second of each call site, 0 - no limit
+        static void rate_limit(unsigned per_second)
         {
-            char newfmt[SYSLOG_FORMAT_MAX];
-            va_list args;
-            va_start(args, fmt);
-            snprintf(newfmt, sizeof(newfmt), "<D> %s", fmt);
-            vsyslog(LOG_DEBUG, newfmt, args);
-            va_end(args);
+            AsyncLog::instance().limiter().set_limit(per_second);
         }
 
-        static void info(const char *fmt, ...)
+        /// Waits for the pending messages of the asynchronous mode
+        static void flush()
         {
-            char newfmt[SYSLOG_FORMAT_MAX];
-            va_list args;
-            va_start(args, fmt);
-            snprintf(newfmt, sizeof(newfmt), "<I> %s", fmt);
-            vsyslog(LOG_INFO, newfmt, args);
-            va_end(args);
+            AsyncLog::instance().flush();
         }
 
-        static void warning(const char *fmt, ...)
+        template<typename... Args>
+        static void debug(const char *fmt, const Args&... args)
         {
-            char newfmt[SYSLOG_FORMAT_MAX];
-            va_list args;
-            va_start(args, fmt);
-            snprintf(newfmt, sizeof(newfmt), "<W> %s", fmt);
-            vsyslog(LOG_WARNING, newfmt, args);
-            va_end(args);
+            _log(LOG_DEBUG, "<D> ", fmt, _value(args)...);
         }
 
-        static void error(const char *fmt, ...)
+        template<typename... Args>
+        static void info(const char *fmt, const Args&... args)
         {
-            char newfmt[SYSLOG_FORMAT_MAX];
-            va_list args;
-            va_start(args, fmt);
-            snprintf(newfmt, sizeof(newfmt), "<E> %s", fmt);
-            vsyslog(LOG_ERR, newfmt, args);
-            va_end(args);
+            _log(LOG_INFO, "<I> ", fmt, _value(args)...);
+        }
+
+        template<typename... Args>
+        static void warning(const char *fmt, const Args&... args)
+        {
+            _log(LOG_WARNING, "<W> ", fmt, _value(args)...);
+        }
+
+        template<typename... Args>
+        static void error(const char *fmt, const Args&... args)
+        {
+            _log(LOG_ERR, "<E> ", fmt, _value(args)...);
+        }
+
+        template<typename... Args>
+        static void critical(const char *fmt, const Args&... args)
+        {
+            _log(LOG_CRIT, "<C> ", fmt, _value(args)...);
+            flush();
+        }
+
+        private:
+
+        // std::string as its C string and std::atomic as its value, printf can not take them
+        template<typename T>
+        static const T& _value(const T& v)  { return v; }
+        static const char* _value(const std::string& s)  { return s.c_str(); }
+        template<typename T>
+        static T _value(const std::atomic<T>& v)  { return v.load(); }
+
+        static int& _logmask()
+        {
+            static int mask = LOG_UPTO(LOG_DEBUG);
+            return mask;
+        }
+
+        template<typename... Args>
+        static void _log(int priority, const char *prefix, const char *fmt, Args... args)
+        {
+            if (!(LOG_MASK(priority) & _logmask()))  return;
+            AsyncLog& alog = AsyncLog::instance();
+            unsigned suppressed;
+            if (!alog.limiter().allow(fmt, suppressed))  return;
+            if (suppressed) {
+                _log(LOG_WARNING, "<W> ", "%u messages suppressed: %s", suppressed, fmt);
+            }
+            if (!alog.log(AsyncLog::syslog_sink, priority, prefix, fmt, args...)) {
+                _syslog(priority, prefix, fmt, args...);
+            }
         }
 
-        static void critical(const char *fmt, ...)
+        static void _syslog(int priority, const char *prefix, const char *fmt, ...)
         {
             char newfmt[SYSLOG_FORMAT_MAX];
             va_list args;
             va_start(args, fmt);
-            snprintf(newfmt, sizeof(newfmt), "<C> %s", fmt);
-            vsyslog(LOG_CRIT, newfmt, args);
+            snprintf(newfmt, sizeof(newfmt), "%s%s", prefix, fmt);
+            vsyslog(priority, newfmt, args);
             va_end(args);
         }
     };
@@ -5,6 +5,9 @@
 //ctest_nda<T>(T *arr, int r, int c) {
 
 #include <unistd.h> // size_t, ssize_t, int16_t, ...
+#include <stdio.h>  // printf
+#include <stdlib.h> // EXIT_SUCCESS, EXIT_FAILURE
+#include <time.h>   // clock_gettime
 #include <vector>
 #include <iostream>
 
@@ -62,6 +65,32 @@ void ctest_vector(vector<T>& v) {
   cout << '\n';
 }
 
+//---------
+// Checks and timing of the test programs registered with add_test
+
+/// Monotonic time in seconds
+inline double ctest_time_sec() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1e-9*t.tv_nsec;
+}
+
+/// Number of failed checks
+inline int& ctest_nerrors() {static int n = 0; return n;}
+
+/// Prints the check and its result, counts it if it failed
+inline bool ctest_check(const bool ok, const char* what) {
+  printf("  %-48s %s\n", what, ok ? "ok" : "FAILED");
+  if(!ok) ctest_nerrors()++;
+  return ok;
+}
+
+/// Prints the number of failed checks, returns the exit status of the test
+inline int ctest_status() {
+  printf("errors: %d\n", ctest_nerrors());
+  return ctest_nerrors() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
 }; //namespace psalg
 
 //---------
@@ -2,6 +2,7 @@
 //-------------------
 #include "psalg/utils/Logger.hh" // MsgLog, Logger, LOGPRINT, LOGMSG
 #include "psalg/utils/MacTimeFix.hh" // 'Fixes' missing clock_gettime
+#include "psalg/utils/AsyncLog.hh"
 //-------------------
 #include <iostream> // cout
 #include <stdexcept>
@@ -60,7 +61,7 @@ namespace Logger {
 
 //-------------------
 
-  Logger::Logger() : _counter(0), _logname(""), _level(Logger::INFO), _tstamp_start(tstampNow(s_def_tst)), _handlers() {
+  Logger::Logger() : _counter(0), _logname(""), _level(Logger::INFO), _async(false), _tstamp_start(tstampNow(s_def_tst)), _handlers() {
   _initLevelNames();
   addHandler(new LogHandlerStdStreams);
 }
@@ -146,6 +147,13 @@ void Logger::setTimeFormat(const std::string& timefmt) {
 }
 //-------------------
 
+void Logger::setAsync(bool async) {
+  _async = async;
+  if(async) psalg::AsyncLog::instance().start();
+}
+
+//-------------------
+
 void Logger::setLogger(const LEVEL& level, const std::string& timefmt) {
   setLevel(level);
   setTimeFormat(timefmt);
@@ -244,12 +252,25 @@ LogHandlerStdStreams::LogHandlerStdStreams() : LogHandler() {}
 
 LogHandlerStdStreams::~LogHandlerStdStreams(){}
 
+static void stdout_sink(int, const char* msg) {std::cout << msg << std::endl;}
+static void stderr_sink(int, const char* msg) {std::cerr << msg << std::endl;}
+
 /// get the stream for the specified log level
 bool
 LogHandlerStdStreams::log(const LogRecord& record) const
 {
   //if(! logging(record.level())) return false;
 
+  if (LOGGER.async()) {
+    std::stringstream ss;
+    formatter().format(record, ss);
+    psalg::AsyncLog& alog = psalg::AsyncLog::instance();
+    bool queued = alog.log_text((record.level() <= Logger::LEVEL::INFO) ? stdout_sink : stderr_sink,
+                                record.level(), ss.str().c_str());
+    if (queued && record.level() >= Logger::LEVEL::FATAL) alog.flush();
+    if (queued) return true;
+  }
+
   if (record.level() <= Logger::LEVEL::INFO) {
     formatter().format(record, std::cout) ;
     std::cout << std::endl;
@@ -91,6 +91,50 @@ double find_root(const std::vector<double>& f, const std::vector<double>& df, do
   }
 }
 
+// The same as diff_table(3, x, y), eval_poly and find_root for the cubic of
+// getcfd, in arrays on the stack instead of vectors made for each crossing.
+static void diff_table3(const double x[4], const double y[4], double coeffs[4])
+{
+  const int rows = 4;
+  double table[rows*5] = {y[0], y[1], y[2], y[3]};
+  coeffs[0] = y[0];
+  for(int col = 0; col < 3; col++)
+  {
+    for(int row = 0; row < rows-(col+1); row++)
+    {
+      table[(col+1)*rows+row] = (table[col*rows+row+1] - table[col*rows+row]) / (x[row] - x[row+1]);
+    }
+    coeffs[col+1] = table[(col+1)*rows];
+  }
+}
+
+static double eval_poly(double x, const double* coeffs, int n)
+{
+  double s = 0;
+  for(int i = 0; i < n; i++)
+  {
+    s += coeffs[i]*pow(x, n-1-i);
+  }
+  return s;
+}
+
+static double find_root3(const double f[4], const double df[3], double error, double x0, int max_its=1000)
+{
+  double x = x0;
+  for(int end = 1; ; end++)
+  {
+    const double xn = x - eval_poly(x, f, 4)/eval_poly(x, df, 3);
+    if (fabs(xn - x) < error)
+      return xn;
+    else if (end-1 > max_its)
+      return NAN;
+    x = xn;
+  }
+}
+
+// samples per block of the vectorized search for crossings of the walk
+static const size_t CFD_BLOCK = 64;
+
 double getcfd(const double sampleInterval,
               const double horpos,
               const double gain,
@@ -116,139 +160,157 @@ double getcfd(const double sampleInterval,
   const double walkB        = walk / vGain;                                 //V -> ADC Bytes
   const double thresholdB   = threshold / vGain;                            //V -> ADC Bytes
 
+  if (wLength < 3) return 0.0;
+
   //--go through the waveform--//
-  for (size_t i=delay+1; i<wLength-2;++i)
+  //--a block at a time: the constant fraction signal of the block and the --//
+  //--criteria for a crossing are evaluated for all points at once, and    --//
+  //--only the blocks with a candidate are examined point by point         --//
+  double cfs[CFD_BLOCK+1];
+  for (size_t b=delay+1; b<wLength-2; b+=CFD_BLOCK)
   {
-    const double fx  = Data[i] - static_cast<double>(vOff);         //the original Point at i
-    const double fxd = Data[i-delay] - static_cast<double>(vOff);   //the delayed Point    at i
-    const double fsx = -fx*fraction + fxd;                          //the calculated CFPoint at i
+    const size_t e = (b+CFD_BLOCK < wLength-2) ? b+CFD_BLOCK : wLength-2;
+    for (size_t i=b; i<=e; ++i)
+      cfs[i-b] = -(Data[i] - static_cast<double>(vOff))*fraction + (Data[i-delay] - static_cast<double>(vOff));
+    int candidate = 0;
+    for (size_t i=b; i<e; ++i)
+      candidate |= (((cfs[i-b]-walkB) * (cfs[i-b+1]-walkB)) <= 0) & (fabs(Data[i] - static_cast<double>(vOff)) > thresholdB);
+    if (!candidate) continue;
+
+    for (size_t i=b; i<e;++i)
+    {
+      const double fx  = Data[i] - static_cast<double>(vOff);         //the original Point at i
+      const double fxd = Data[i-delay] - static_cast<double>(vOff);   //the delayed Point    at i
+      const double fsx = -fx*fraction + fxd;                          //the calculated CFPoint at i
 
-    const double fx_1  = Data[i+1] - static_cast<double>(vOff);        //original Point at i+1
-    const double fxd_1 = Data[i+1-delay] - static_cast<double>(vOff);  //delayed Point at i+1
-    const double fsx_1 = -fx_1*fraction + fxd_1;                       //calculated CFPoint at i+1
+      const double fx_1  = Data[i+1] - static_cast<double>(vOff);        //original Point at i+1
+      const double fxd_1 = Data[i+1-delay] - static_cast<double>(vOff);  //delayed Point at i+1
+      const double fsx_1 = -fx_1*fraction + fxd_1;                       //calculated CFPoint at i+1
 
-    //check wether the criteria for a Peak are fullfilled
-    if (((fsx-walkB) * (fsx_1-walkB)) <= 0 ) //one point above one below the walk
-      if (fabs(fx) > thresholdB)             //original point above the threshold
-      {
-        //--it could be that the first criteria is 0 because  --//
-        //--one of the Constant Fraction Signal Points or both--//
-        //--are exactly where the walk is                     --//
-        if (fabs(fsx-fsx_1) < 1e-8)    //both points are on the walk
+      //check wether the criteria for a Peak are fullfilled
+      if (((fsx-walkB) * (fsx_1-walkB)) <= 0 ) //one point above one below the walk
+        if (fabs(fx) > thresholdB)             //original point above the threshold
         {
-          //--go to next loop until at least one is over or under the walk--//
-          continue;
-        }
-        else if ((fsx-walkB) == 0)        //only first is on walk
-        {
-          //--Only the fist is on the walk, this is what we want--//
-          //--so:do nothing--//
-        }
-        else if ((fsx_1-walkB) == 0)        //only second is on walk
-        {
-          //--we want that the first point will be on the walk,--//
-          //--so in the next loop this point will be the first.--//
-          continue;
-        }
-        //does the peak have the right polarity?//
-        //if two pulses are close together then the cfsignal goes through the walk//
-        //three times, where only two crossings are good. So we need to check for//
-        //the one where it is not good//
-        if (fsx     > fsx_1)   //neg polarity
-          if (Data[i] > vOff)    //but pos Puls .. skip
+          //--it could be that the first criteria is 0 because  --//
+          //--one of the Constant Fraction Signal Points or both--//
+          //--are exactly where the walk is                     --//
+          if (fabs(fsx-fsx_1) < 1e-8)    //both points are on the walk
+          {
+            //--go to next loop until at least one is over or under the walk--//
             continue;
-        if (fsx     < fsx_1)   //pos polarity
-          if (Data[i] < vOff)    //but neg Puls .. skip
+          }
+          else if ((fsx-walkB) == 0)        //only first is on walk
+          {
+            //--Only the fist is on the walk, this is what we want--//
+            //--so:do nothing--//
+          }
+          else if ((fsx_1-walkB) == 0)        //only second is on walk
+          {
+            //--we want that the first point will be on the walk,--//
+            //--so in the next loop this point will be the first.--//
             continue;
+          }
+          //does the peak have the right polarity?//
+          //if two pulses are close together then the cfsignal goes through the walk//
+          //three times, where only two crossings are good. So we need to check for//
+          //the one where it is not good//
+          if (fsx     > fsx_1)   //neg polarity
+            if (Data[i] > vOff)    //but pos Puls .. skip
+              continue;
+          if (fsx     < fsx_1)   //pos polarity
+            if (Data[i] < vOff)    //but neg Puls .. skip
+              continue;
+
+
+          //--later we need two more points, create them here--//
+          const double fx_m1 = Data[i-1] - static_cast<double>(vOff);        //the original Point at i-1
+          const double fxd_m1 = Data[i-1-delay] - static_cast<double>(vOff); //the delayed Point    at i-1
+          const double fsx_m1 = -fx_m1*fraction + fxd_m1;                    //the calculated CFPoint at i-1
+
+          const double fx_2 = Data[i+2] - static_cast<double>(vOff);         //original Point at i+2
+          const double fxd_2 = Data[i+2-delay] - static_cast<double>(vOff);  //delayed Point at i+2
+          const double fsx_2 = -fx_2*fraction + fxd_2;                       //calculated CFPoint at i+2
+
+          //--find x with a linear interpolation between the two points--//
+          //const double m = fsx_1-fsx;                    //(fsx-fsx_1)/(i-(i+1));
+          //const double xLin = i + (walk - fsx)/m;        //PSF fx = (x - i)*m + cfs[i]
+
+          //--find x with a cubic polynomial interpolation between four points--//
+          //--do this with the Newtons interpolation Polynomial--//
+          const double x[4] = {static_cast<double>(i-1),
+                               static_cast<double>(i),
+                               static_cast<double>(i+1),
+                               static_cast<double>(i+2)};          //x vector
+          const double y[4] = {fsx_m1,fsx,fsx_1,fsx_2}; //y vector
+
+          double coeffs[4];
+          diff_table3(x, y, coeffs);
+
+          if (fabs(coeffs[0]) > 1e-8)
+          {
+            double a = coeffs[0];
+            for(int i = 0; i < 4; i++)
+            {
+              coeffs[i] /= a;
+            }
+          }
 
+          coeffs[3] -= walkB;
 
-        //--later we need two more points, create them here--//
-        const double fx_m1 = Data[i-1] - static_cast<double>(vOff);        //the original Point at i-1
-        const double fxd_m1 = Data[i-1-delay] - static_cast<double>(vOff); //the delayed Point    at i-1
-        const double fsx_m1 = -fx_m1*fraction + fxd_m1;                    //the calculated CFPoint at i-1
-
-        const double fx_2 = Data[i+2] - static_cast<double>(vOff);         //original Point at i+2
-        const double fxd_2 = Data[i+2-delay] - static_cast<double>(vOff);  //delayed Point at i+2
-        const double fsx_2 = -fx_2*fraction + fxd_2;                       //calculated CFPoint at i+2
-
-        //--find x with a linear interpolation between the two points--//
-        //const double m = fsx_1-fsx;                    //(fsx-fsx_1)/(i-(i+1));
-        //const double xLin = i + (walk - fsx)/m;        //PSF fx = (x - i)*m + cfs[i]
-
-        //--find x with a cubic polynomial interpolation between four points--//
-        //--do this with the Newtons interpolation Polynomial--//
-        const std::vector<double> x = {static_cast<double>(i-1),
-                                       static_cast<double>(i),
-                                       static_cast<double>(i+1),
-                                       static_cast<double>(i+2)};          //x vector
-        const std::vector<double> y = {fsx_m1,fsx,fsx_1,fsx_2}; //y vector
-
-        std::vector<double> coeffs = diff_table(3, x, y);
-
-        if (fabs(coeffs[0]) > 1e-8)
-        {
-          double a = coeffs[0];
-          for(int i = 0; i < 4; i++)
+          double dy[3];
+          for(int i = 0, size = 3; i < size; i++)
           {
-            coeffs[i] /= a;
+            dy[i] = coeffs[i]*(size-i);
           }
-        }
-
-        coeffs[3] -= walkB;
 
-        std::vector<double> dy;
-        for(int i = 0, size = coeffs.size()-1; i < size; i++)
-        {
-          dy.push_back(coeffs[i]*(size-i));
+          double x0 = find_root3(coeffs, dy, 1e-7, x[0]);
+          return x0;
+
+          //--numericaly solve the Newton Polynomial--//
+          //--give the lineare approach for x as Start Value--//
+          // const double xPoly = findXForGivenY<T>(x,coeff,walkB,xLin);
+          // const double pos = xPoly + static_cast<double>(idxToFiPoint) + horposNS;
+
+          //--create a new signal--//
+
+          //add the info//
+          // signal[time] = pos*sampleIntervalNS;
+          // signal[cfd]  = pos*sampleIntervalNS;
+          // if (fsx > fsx_1) signal[polarity] = Negative;
+          // if (fsx < fsx_1) signal[polarity] = Positive;
+          // if (fabs(fsx-fsx_1) < std::sqrt(std::numeric_limits<double>::epsilon()))
+          //   signal[polarity] = Bad;
+
+          //--start and stop of the puls--//
+          // startstop<T>(c,signal,param.threshold);
+
+          //--height of peak--//
+          // getmaximum<T>(c,signal,param.threshold);
+
+          //--width & fwhm of peak--//
+          // getfwhm<T>(c,signal,param.threshold);
+
+          //--the com and integral--//
+          // CoM<T>(c,signal,param.threshold);
+
+          //--add peak to signal if it fits the conditions--//
+          /** @todo make sure that is works right, since we get back a double */
+          // if(fabs(signal[polarity]-param.polarity) < std::sqrt(std::numeric_limits<double>::epsilon()))  //if it has the right polarity
+          // {
+          //   for (CFDParameters::timeranges_t::const_iterator it (param._timeranges.begin());
+          //        it != param._timeranges.end();
+          //        ++it)
+          //   {
+          //     if(signal[time] > it->first && signal[time] < it->second) //if signal is in the right timerange
+          //     {
+          //       signal[isUsed] = false;
+          //       sig.push_back(signal);
+          //       break;
+          //     }
+          //   }
+          // }
         }
-
-        double x0 = find_root(coeffs, dy, 1e-7, x[0]);
-        return x0;
-
-        //--numericaly solve the Newton Polynomial--//
-        //--give the lineare approach for x as Start Value--//
-        // const double xPoly = findXForGivenY<T>(x,coeff,walkB,xLin);
-        // const double pos = xPoly + static_cast<double>(idxToFiPoint) + horposNS;
-
-        //--create a new signal--//
-
-        //add the info//
-        // signal[time] = pos*sampleIntervalNS;
-        // signal[cfd]  = pos*sampleIntervalNS;
-        // if (fsx > fsx_1) signal[polarity] = Negative;
-        // if (fsx < fsx_1) signal[polarity] = Positive;
-        // if (fabs(fsx-fsx_1) < std::sqrt(std::numeric_limits<double>::epsilon()))
-        //   signal[polarity] = Bad;
-
-        //--start and stop of the puls--//
-        // startstop<T>(c,signal,param.threshold);
-
-        //--height of peak--//
-        // getmaximum<T>(c,signal,param.threshold);
-
-        //--width & fwhm of peak--//
-        // getfwhm<T>(c,signal,param.threshold);
-
-        //--the com and integral--//
-        // CoM<T>(c,signal,param.threshold);
-
-        //--add peak to signal if it fits the conditions--//
-        /** @todo make sure that is works right, since we get back a double */
-        // if(fabs(signal[polarity]-param.polarity) < std::sqrt(std::numeric_limits<double>::epsilon()))  //if it has the right polarity
-        // {
-        //   for (CFDParameters::timeranges_t::const_iterator it (param._timeranges.begin());
-        //        it != param._timeranges.end();
-        //        ++it)
-        //   {
-        //     if(signal[time] > it->first && signal[time] < it->second) //if signal is in the right timerange
-        //     {
-        //       signal[isUsed] = false;
-        //       sig.push_back(signal);
-        //       break;
-        //     }
-        //   }
-        // }
-      }
+    }
   }
 
   return 0.0;
@@ -3,11 +3,13 @@
 #include "fstream"
 //#include "stdio.h"
 #include "time.h"
+#include <vector>
 
 #define LINUX
 
 #ifdef LINUX
 	#include "string.h"
+	#include <sys/mman.h>
         #define _fseeki64 fseeko
 	#define _ftelli64 ftello
 
@@ -28,7 +30,8 @@
 class MyFILE
 {
 public:
-	MyFILE(bool mode_reading_) {error = 0; eof = false; mode_reading = mode_reading_; file = 0; position = 0; filesize = 0;}
+	// mapping_ false reads the file with fread only
+	MyFILE(bool mode_reading_, bool mapping_ = true) {error = 0; eof = false; mode_reading = mode_reading_; mapping = mapping_; file = 0; position = 0; filesize = 0; map = 0;}
 	~MyFILE() {close(); error = 0; eof = false;}
 
 	FILE * file;
@@ -42,11 +45,25 @@ public:
 			_fseeki64(file,  (unsigned __int64)0, SEEK_END);
 			filesize = _ftelli64(file);
 			_fseeki64(file,  (unsigned __int64)0, SEEK_SET);
+#ifdef LINUX
+			// The file is read from a memory window when it can be mapped,
+			// so that reading a value is a copy rather than a fread.
+			if (filesize && mapping) {
+				void * p = mmap(0, filesize, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+				if (p != MAP_FAILED) {
+					madvise(p, filesize, MADV_SEQUENTIAL);
+					map = (const __int8*)p;
+				}
+			}
+#endif
 		} else file = fopen(name,"wb");
 		if (file) return true; else {error = 1; return false;}
 	}
 
 	void close() {
+#ifdef LINUX
+		if (map) {munmap((void*)map, filesize); map = 0;}
+#endif
 		if (file) {fclose(file);  file = 0;} else error = 1;
 		position = 0; filesize = 0; eof = false;
 	}
@@ -54,7 +71,20 @@ public:
 	unsigned __int64 tell() {return position;}
 	void seek(unsigned __int64 pos);
 
+	// The mapped file, or 0 if it is read with fread
+	const __int8 * window() const {return map;}
+
 	void read(__int8* string,__int32 length_bytes) {
+		if (map) {
+			if (position + length_bytes <= filesize) memcpy(string, map + position, length_bytes);
+			else {
+				if (position < filesize) memcpy(string, map + position, size_t(filesize - position));
+				error = 1;
+				eof = true;
+			}
+			position += length_bytes;
+			return;
+		}
 		unsigned __int32 read_bytes = (unsigned __int32)(fread(string,1,length_bytes,file));
 		if (read_bytes != (unsigned __int32)length_bytes) {
 			error = 1;
@@ -63,14 +93,7 @@ public:
 		position += length_bytes;
 	}
 
-	void read(unsigned __int32 * dest,__int32 length_bytes) {
-		unsigned __int32 read_bytes = (unsigned __int32)(fread(dest,1,length_bytes,file));
-		if (read_bytes != (unsigned __int32)length_bytes) {
-			error = 1;
-			if (feof(file)) eof = true;
-		}
-		position += length_bytes;
-	}
+	void read(unsigned __int32 * dest,__int32 length_bytes) {read((__int8*)dest, length_bytes);}
 
 	void write(const __int8* string,__int32 length) {
 		fwrite(string,1,length,file);
@@ -109,7 +132,9 @@ public:
 
 private:
 	bool mode_reading;
+	bool mapping;
 	unsigned __int64 position;
+	const __int8 * map;
 };
 
 
@@ -395,6 +420,21 @@ public:
 	unsigned __int32	GetMaxNumberOfHits(); 
 	bool			SeekToEventNumber(unsigned __int64 Eventnumber);
 
+	// Reads up to max_events events into tdc[max_events][channels][hits],
+	// cnt[max_events][channels] and timestamps[max_events], with channels and hits
+	// of the constructor.  Returns the number of events read, which is smaller at
+	// the end of the file or on an error (see errorflag).
+	unsigned __int32	ReadNextEvents(unsigned __int32 max_events, double * tdc, __int32 * cnt, double * timestamps);
+
+	// Positions in the file of every every'th event from the current one on, for
+	// readers of chunks of the file (in parallel, each with its own LMF_IO).
+	// Reading goes on after the current event, whose data (hits, TDC data,
+	// timestamp) are kept.
+	// Returns the number of events scanned.
+	unsigned __int64	ScanEventPositions(std::vector<unsigned __int64> & positions, unsigned __int64 every = 1);
+	// Continues reading at a position from ScanEventPositions, of event number Eventnumber
+	bool			SeekToPosition(unsigned __int64 position, unsigned __int64 Eventnumber);
+
 	const char *	GetErrorText(__int32 error_id);
 	void			GetErrorText(__int32 error_id, __int8 char_buffer[]);
 	void			GetErrorText(__int8 char_buffer[]);
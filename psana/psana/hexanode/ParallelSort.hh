@@ -0,0 +1,99 @@
+#ifndef PARALLELSORT_H
+#define PARALLELSORT_H
+
+//-----------------------------
+
+/** Sorting of the DLD hits of many events in parallel.
+ *
+ * A sort_class keeps the state of the event it sorts, so that one instance
+ * can not be shared by threads.  ParallelSorter holds one sorter per thread,
+ * each configured from the same config file and calibration tables as in
+ * ex04_sort (read_config_file, read_calibration_tables), and with its own
+ * copy of the tdc arrays of the event.  The events of a batch are shared
+ * by the OpenMP threads and the results are stored by event index, so that
+ * they come out in the order of the input for any number of threads.
+ *
+ * Only the sorting commands (command 0 - run_without_sorting, 1 - sort) of
+ * the config file can run in parallel; the calibration commands (2, 3)
+ * accumulate all of the events in one sorter, see ex04_sort.
+ *
+ * Usage:
+ *   ParallelSorter ps("sorter.txt", "calibration_table.txt", 8, NUM_CHANNELS, NUM_IONS);
+ *   if (!ps.ok()) ...
+ *   ps.sort(nevents, &tdc_ns[0][0][0], &number_of_hits[0][0], &nparticles[0], &hits[0][0], NUM_HITS);
+ */
+
+#include <vector>
+
+//#include "psalg/hexanode/resort64c.hh"
+#include "roentdek/resort64c.h"
+
+//-----------------------------
+
+struct SortedHit {
+  double  x;
+  double  y;
+  double  time;
+  __int32 method;
+};
+
+//-----------------------------
+
+class ParallelSorter {
+public:
+
+  /// nthreads=0 uses omp_get_max_threads(); calib_file may be 0 without sum and pos corrections
+  ParallelSorter(const char* config_file, const char* calib_file, unsigned nthreads,
+                 __int32 nchannels, __int32 nhits, double tdc_resolution_ns=0.025);
+
+  ~ParallelSorter();
+
+  /// All sorters were configured and initialized
+  bool ok() const {return _ok;}
+
+  unsigned nthreads () const {return _workers.size();}
+  int      command  () const {return _command;}
+  __int32  nchannels() const {return _nchannels;}
+  __int32  nhits    () const {return _nhits;}
+
+  /// Sorter of thread i, e.g. for the channel numbers
+  sort_class* sorter(unsigned i=0) {return _workers[i].sorter;}
+
+  /**
+   * Sorts nevents events of tdc_ns[nevents][nchannels][nhits] (in ns) with
+   * counts[nevents][nchannels] hits.  Returns the number of particles of each
+   * event in nparticles[nevents] and the first max_hits of them in
+   * hits[nevents][max_hits].  The input arrays are not changed.
+   */
+  void sort(unsigned nevents, const double* tdc_ns, const __int32* counts,
+            __int32* nparticles, SortedHit* hits, unsigned max_hits);
+
+private:
+
+  struct Worker {
+    sort_class*          sorter;
+    std::vector<double>  tdc;
+    std::vector<__int32> count;
+  };
+
+  bool _configure(Worker& w, const char* config_file, const char* calib_file, double tdc_resolution_ns);
+  __int32 _sort_event(Worker& w, const double* tdc_ns, const __int32* counts,
+                      SortedHit* hits, unsigned max_hits);
+
+  std::vector<Worker> _workers;
+  __int32 _nchannels;
+  __int32 _nhits;
+  int     _command;
+  double  _offset_sum_u, _offset_sum_v, _offset_sum_w;
+  double  _w_offset, _pos_offset_x, _pos_offset_y;
+  bool    _ok;
+
+  ParallelSorter(const ParallelSorter&);
+  ParallelSorter& operator=(const ParallelSorter&);
+};
+
+//-----------------------------
+
+#endif
+
+//-----------------------------
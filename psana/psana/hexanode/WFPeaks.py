@@ -36,7 +36,7 @@ logger = logging.getLogger(__name__)
 import numpy as np
 import psana.pyalgos.generic.Utils as gu
 from psana.pyalgos.generic.NDArrUtils import print_ndarr
-from ndarray import wfpkfinder_cfd # from psana.pycalgos
+from ndarray import wfpkfinder_cfd, wfpkfinder_cfd_batch # from psana.pycalgos
 from psana.hexanode.WFUtils import peak_finder_v2, peak_finder_v3
 from psana.hexanode.PyCFD import PyCFD
 
@@ -129,6 +129,7 @@ class WFPeaks :
         self._pkvals = np.zeros((self.NUM_CHANNELS,self.NUM_HITS), dtype=np.double)
         self._pkinds = np.zeros((self.NUM_CHANNELS,self.NUM_HITS), dtype=np.uint32)
         self._pktsec = np.zeros((self.NUM_CHANNELS,self.NUM_HITS), dtype=np.double)
+        self._npks   = np.zeros((self.NUM_CHANNELS), dtype=np.uint32)
 
 
     def proc_waveforms(self, wfs, wts) :
@@ -153,6 +154,10 @@ class WFPeaks :
             self.wfsprep = wfs[:,self.WFBINBEG:self.WFBINEND] - offsets.reshape(-1, 1) # subtract wf-offset
         self.wtsprep = wts[:,self.WFBINBEG:self.WFBINEND] # sec
 
+        if self.VERSION == 1 : # all channels in one call
+            wfpkfinder_cfd_batch(self.wfsprep, self.BASE, self.THR, self.CFR, self.DEADTIME, self.LEADINGEDGE,\
+                                 self._pkvals, self._pkinds, self._npks)
+
         for ch in range(self.NUM_CHANNELS) :
 
             wf = self.wfsprep[ch,:]
@@ -177,8 +182,7 @@ class WFPeaks :
                     self.tbins = HBins(list(wt))
 
             else : # self.VERSION == 1
-                npeaks = wfpkfinder_cfd(wf, self.BASE, self.THR, self.CFR, self.DEADTIME, self.LEADINGEDGE,\
-                                        self._pkvals[ch,:], self._pkinds[ch,:])
+                npeaks = self._npks[ch]
 
             #print(' npeaks:', npeaks)
             #assert (npeaks<self.NUM_HITS), 'number of found peaks exceeds reserved array shape'
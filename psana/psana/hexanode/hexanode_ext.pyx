@@ -36,7 +36,7 @@
 #from cpython.string cimport *
 
 from libcpp.string cimport string
-#from libcpp.vector cimport vector
+from libcpp.vector cimport vector
 #from libcpp cimport bool
 
 from libc.time cimport time_t, ctime
@@ -790,6 +790,80 @@ def py_create_calibration_tables(const char* fname, py_sort_class sorter) :
 def py_sorter_scalefactors_calibration_map_is_full_enough(py_sort_class sorter) :
     return sorter_scalefactors_calibration_map_is_full_enough(sorter.cptr)
 
+#------------------------------
+#------------------------------
+#------ ParallelSort.hh -------
+#------------------------------
+#------------------------------
+
+cdef extern from "ParallelSort.hh":
+    cdef struct SortedHit:
+        double x
+        double y
+        double time
+        int32_t method
+
+    cdef cppclass ParallelSorter:
+        ParallelSorter(const char* config_file, const char* calib_file, unsigned nthreads,\
+                       int32_t nchannels, int32_t nhits, double tdc_resolution_ns) except +
+        bint ok()
+        unsigned nthreads()
+        int command()
+        int32_t nchannels()
+        int32_t nhits()
+        void sort(unsigned nevents, const double* tdc_ns, const int32_t* counts,\
+                  int32_t* nparticles, SortedHit* hits, unsigned max_hits) nogil
+
+#------------------------------
+
+sorted_hit_dtype = np.dtype({'names'   : ['x', 'y', 'time', 'method'],
+                             'formats' : [np.float64, np.float64, np.float64, np.int32],
+                             'offsets' : [0, 8, 16, 24],
+                             'itemsize': sizeof(SortedHit)})
+
+cdef class py_parallel_sorter:
+    """ Sorts the hits of batches of events with a sort_class per thread, see ParallelSort.hh.
+        The config file must have command 0 or 1.
+    """
+    cdef ParallelSorter* cptr  # holds a C++ instance
+
+    def __cinit__(self, const char* config_file, bytes calib_file=None, unsigned nthreads=0,\
+                  int32_t number_of_channels=32, int32_t number_of_hits=16, double tdc_resolution_ns=0.025):
+        cdef const char* calib = NULL
+        if calib_file is not None: calib = calib_file
+        self.cptr = new ParallelSorter(config_file, calib, nthreads,\
+                                       number_of_channels, number_of_hits, tdc_resolution_ns)
+        if self.cptr == NULL:
+            raise MemoryError('Not enough memory.')
+
+    def __dealloc__(self):
+        del self.cptr
+
+    def ok(self) : return self.cptr.ok()
+
+    def nthreads(self) : return self.cptr.nthreads()
+
+    def command(self) : return self.cptr.command()
+
+    def sort(self, np.ndarray[double, ndim=3, mode="c"] tdc_ns not None,\
+                   np.ndarray[int32_t, ndim=2, mode="c"] cnt not None, unsigned max_hits=16):
+        """Sorts the events of tdc_ns[nevents, channels, hits] (in ns) with cnt[nevents, channels] hits,
+           e.g. from lmf_io.read_next_events. Returns the numbers of particles [nevents] and
+           the hits [nevents, max_hits] of dtype sorted_hit_dtype, in the order of the events.
+        """
+        if tdc_ns.shape[1] != self.cptr.nchannels() or tdc_ns.shape[2] != self.cptr.nhits()\
+        or cnt.shape[0] != tdc_ns.shape[0] or cnt.shape[1] != self.cptr.nchannels():
+            raise ValueError('shapes of tdc_ns (%d, %d, %d) and cnt (%d, %d) do not match the sorter'\
+                             % (tdc_ns.shape[0], tdc_ns.shape[1], tdc_ns.shape[2], cnt.shape[0], cnt.shape[1]))
+        cdef unsigned nevents = tdc_ns.shape[0]
+        cdef np.ndarray[int32_t, ndim=1, mode="c"] npart = np.zeros(nevents, dtype=np.int32)
+        hits = np.zeros((nevents, max_hits), dtype=sorted_hit_dtype)
+        if nevents == 0 or max_hits == 0: return npart, hits
+        cdef SortedHit* phits = <SortedHit*>np.PyArray_DATA(hits)
+        with nogil:
+            self.cptr.sort(nevents, &tdc_ns[0,0,0], &cnt[0,0], &npart[0], phits, max_hits)
+        return npart, hits
+
 #------------------------------
 #------------- NEW ------------
 #------ interpolate_class -----
@@ -939,12 +1013,18 @@ cdef extern from "LMF_IO.hh":
         uint32_t GetMaxNumberOfHits()
         uint64_t GetLastLevelInfo()
         double GetDoubleTimeStamp()
+        uint32_t ReadNextEvents(uint32_t, double*, int32_t*, double*)
+        uint64_t ScanEventPositions(vector[unsigned long long]&, uint64_t)
+        bint SeekToPosition(uint64_t, uint64_t)
 
 cdef class lmf_io:
     cdef LMF_IO* cptr # holds a C++ instance
+    cdef int nchannels, nhits # of the arrays of an event
 
     def __cinit__(self, int number_of_channels, int number_of_hits):
         print("In LMF_IO.__cinit__ pars %d, %d" % (number_of_channels, number_of_hits))
+        self.nchannels = number_of_channels
+        self.nhits = number_of_hits
         self.cptr = new LMF_IO(number_of_channels, number_of_hits)
         if self.cptr == NULL:
             raise MemoryError('Not enough memory.')
@@ -973,13 +1053,44 @@ cdef class lmf_io:
     def get_event_number(self):
         return self.cptr.GetEventNumber()
 
-    def get_number_of_hits_array(self, np.ndarray[int32_t, ndim=1] arr1d not None):
+    def get_number_of_hits_array(self, np.ndarray[int32_t, ndim=1, mode="c"] arr1d not None):
+        if arr1d.shape[0] < self.nchannels:
+            raise ValueError('size %d of the array is smaller than %d channels' % (arr1d.shape[0], self.nchannels))
         self.cptr.GetNumberOfHitsArray(&arr1d[0])
 
     def get_tdc_data_array(self, np.ndarray[double, ndim=2, mode="c"] arr2d not None):
+        if arr2d.shape[0] != self.nchannels or arr2d.shape[1] != self.nhits:
+            raise ValueError('shape (%d, %d) of the array does not match lmf_io(%d, %d)'\
+                             % (arr2d.shape[0], arr2d.shape[1], self.nchannels, self.nhits))
         self.cptr.GetTDCDataArray(&arr2d[0,0])
         #self.cptr.GetTDCDataArray(<double*>arr2d.data) #depricated
 
+    def read_next_events(self, np.ndarray[double, ndim=3, mode="c"] tdc not None,\
+                               np.ndarray[int32_t, ndim=2, mode="c"] cnt not None,\
+                               np.ndarray[double, ndim=1, mode="c"] timestamps not None):
+        """Reads the next events into tdc[nevents, channels, hits], cnt[nevents, channels]
+           and timestamps[nevents], nevents at most, returns the number of events read.
+        """
+        if tdc.shape[1] != self.nchannels or tdc.shape[2] != self.nhits or cnt.shape[1] != self.nchannels:
+            raise ValueError('shapes of tdc (%d, %d, %d) and cnt (%d, %d) do not match lmf_io(%d, %d)'\
+                             % (tdc.shape[0], tdc.shape[1], tdc.shape[2], cnt.shape[0], cnt.shape[1],\
+                                self.nchannels, self.nhits))
+        cdef uint32_t nevents = min(tdc.shape[0], cnt.shape[0], timestamps.shape[0])
+        if nevents == 0: return 0
+        return self.cptr.ReadNextEvents(nevents, &tdc[0,0,0], &cnt[0,0], &timestamps[0])
+
+    def scan_event_positions(self, uint64_t every=1):
+        """Returns the file positions of every every'th event from the current one,
+           for lmf_io objects reading chunks of the file with seek_to_position.
+           The current event and the next event read are those before the scan.
+        """
+        cdef vector[unsigned long long] positions
+        self.cptr.ScanEventPositions(positions, every)
+        return np.array(positions, dtype=np.uint64)
+
+    def seek_to_position(self, uint64_t position, uint64_t event_number):
+        return self.cptr.SeekToPosition(position, event_number)
+
     def get_error_text(self, errcode):
         return self.cptr.GetErrorText(errcode)
 
@@ -0,0 +1,138 @@
+
+//-----------------------------
+
+#include "../ParallelSort.hh"
+#include "../SortUtils.hh"
+
+#include <string.h>  // memcpy
+#include <omp.h>
+
+//-----------------------------
+
+ParallelSorter::ParallelSorter(const char* config_file, const char* calib_file, unsigned nthreads,
+                               __int32 nchannels, __int32 nhits, double tdc_resolution_ns)
+	: _nchannels(nchannels)
+	, _nhits(nhits)
+	, _command(-1)
+	, _ok(false)
+{
+	if (nthreads == 0) nthreads = omp_get_max_threads();
+	_workers.resize(nthreads);
+	for (unsigned i=0; i<nthreads; ++i) {
+		_workers[i].sorter = 0;
+		_workers[i].tdc.resize(nchannels*nhits);
+		_workers[i].count.resize(nchannels);
+	}
+
+	// Each sorter is set up from the files, which is the same as a copy
+	// of the first one and does not depend on the internals of sort_class
+	for (unsigned i=0; i<nthreads; ++i) {
+		if (!_configure(_workers[i], config_file, calib_file, tdc_resolution_ns)) return;
+	}
+	_ok = true;
+}
+
+//-----------------------------
+
+ParallelSorter::~ParallelSorter()
+{
+	for (unsigned i=0; i<_workers.size(); ++i) {
+		if (_workers[i].sorter) {delete _workers[i].sorter; _workers[i].sorter = 0;}
+	}
+}
+
+//-----------------------------
+
+bool ParallelSorter::_configure(Worker& w, const char* config_file, const char* calib_file, double tdc_resolution_ns)
+{
+	w.sorter = new sort_class();
+
+	if (!read_config_file(config_file, w.sorter, _command,
+	                      _offset_sum_u, _offset_sum_v, _offset_sum_w,
+	                      _w_offset, _pos_offset_x, _pos_offset_y)) {
+		if (w.sorter) {delete w.sorter; w.sorter = 0;}
+		return false;
+	}
+	if (_command != 0 && _command != 1) {
+		printf("command %i of %s can not run in parallel\n", _command, config_file);
+		return false;
+	}
+	if (w.sorter->use_sum_correction || w.sorter->use_pos_correction) {
+		if (!read_calibration_tables(calib_file, w.sorter)) {
+			printf("calibration tables %s were not read\n", calib_file ? calib_file : "(none)");
+			return false;
+		}
+	}
+
+	w.sorter->TDC_resolution_ns = tdc_resolution_ns;
+	w.sorter->tdc_array_row_length = _nhits;
+	w.sorter->count = &w.count[0];
+	w.sorter->tdc_pointer = &w.tdc[0];
+
+	__int32 error_code = w.sorter->init_after_setting_parameters();
+	if (error_code) {
+		char error_text[512];
+		w.sorter->get_error_text(error_code, 512, error_text);
+		printf("sorter could not be initialized\nError %i: %s\n", error_code, error_text);
+		return false;
+	}
+	return true;
+}
+
+//-----------------------------
+
+__int32 ParallelSorter::_sort_event(Worker& w, const double* tdc_ns, const __int32* counts,
+                                    SortedHit* hits, unsigned max_hits)
+{
+	// the sorter shifts and reorders the tdc data in place
+	memcpy(&w.count[0], counts, _nchannels*sizeof(__int32));
+	for (__int32 i=0; i<_nchannels; ++i) {
+		__int32 n = (counts[i] < _nhits) ? counts[i] : _nhits;
+		if (n > 0) memcpy(&w.tdc[i*_nhits], tdc_ns + i*_nhits, n*sizeof(double));
+	}
+
+	sort_class* sorter = w.sorter;
+	if (sorter->use_HEX) {
+		sorter->shift_sums(+1, _offset_sum_u, _offset_sum_v, _offset_sum_w);
+		sorter->shift_layer_w(+1, _w_offset);
+	} else {
+		sorter->shift_sums(+1, _offset_sum_u, _offset_sum_v);
+	}
+	sorter->shift_position_origin(+1, _pos_offset_x, _pos_offset_y);
+
+	__int32 number_of_particles = (_command == 1) ? sorter->sort() : sorter->run_without_sorting();
+
+	for (__int32 i=0; i<number_of_particles && i<(__int32)max_hits; ++i) {
+		const hit_class* h = sorter->output_hit_array[i];
+		hits[i].x      = h->x;
+		hits[i].y      = h->y;
+		hits[i].time   = h->time;
+		hits[i].method = h->method;
+	}
+	return number_of_particles;
+}
+
+//-----------------------------
+
+void ParallelSorter::sort(unsigned nevents, const double* tdc_ns, const __int32* counts,
+                          __int32* nparticles, SortedHit* hits, unsigned max_hits)
+{
+	if (!_ok) {
+		for (unsigned e=0; e<nevents; ++e) nparticles[e] = 0;
+		return;
+	}
+	if (nevents == 0) return;
+
+	const size_t evsize = size_t(_nchannels)*_nhits;
+	const int nthreads = (nevents < _workers.size()) ? nevents : _workers.size();
+
+	// dynamic schedule: the time to sort an event grows fast with its number of hits
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic,16) if(nthreads>1)
+	for (unsigned e=0; e<nevents; ++e) {
+		Worker& w = _workers[omp_get_thread_num()];
+		nparticles[e] = _sort_event(w, tdc_ns + e*evsize, counts + e*_nchannels,
+		                            hits + size_t(e)*max_hits, max_hits);
+	}
+}
+
+//-----------------------------
@@ -7,17 +7,26 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <cinttypes>
+#include <vector>
 
 #include "psalg/digitizer/Stream.hh"
 
 namespace Pds {
   namespace HSD {
 
+    // A peak of the fex stream: its index in the raw waveform, and its
+    // first sample and number of samples in the fex stream
+    struct PeakRef {
+        uint32_t startPos;
+        uint32_t offset;
+        uint32_t width;
+    };
+
     class ChannelPython {
     public:
-        ChannelPython() {}
+        ChannelPython() : _evtheader(0), _data(0), _sh_raw(0), _sh_fex(0), _indexed(false) { _reset_peakiter(); }
         ChannelPython(uint32_t *evtheader, uint8_t* data) :
-            _evtheader(evtheader), _data(data), _sh_raw(0), _sh_fex(0)
+            _evtheader(evtheader), _data(data), _sh_raw(0), _sh_fex(0), _indexed(false)
         {
             _reset_peakiter();
             unsigned streams((evtheader[0]>>20)&0x3);
@@ -52,45 +61,79 @@ namespace Pds {
         //     return wf;
         // }
 
-        unsigned next_peak(unsigned& startPos, uint16_t** peakPtr) {
-            unsigned peakLen = 0; // indicate that, by default, we haven't found a peak
-            if (!_sh_fex) return peakLen; // no more peaks to look for
+        uint16_t* fex(unsigned& numsamples) {
+            if (!_sh_fex) return 0;
+            numsamples = _sh_fex->num_samples();
+            return (uint16_t*)(_sh_fex+1);
+        }
+
+        // Records all of the peaks of the fex stream in one pass, so that
+        // they can be accessed in any order.  Later calls do nothing.
+        unsigned index_peaks() {
+            if (_indexed) return _peaks.size();
+            _indexed = true;
+            if (!_sh_fex) return 0;
             const uint16_t* q = reinterpret_cast<const uint16_t*>(_sh_fex+1);
+            const unsigned n = _sh_fex->num_samples();
+            // a peak takes at least one group of 4 samples and a skip group
+            // separates it from the next one, so this is never exceeded
+            _peaks.reserve(n/8+1);
 
-            unsigned i;
-            for(i=_startSample; i<_sh_fex->num_samples();) {
+            unsigned ns = 0;       // number of skipped samples
+            unsigned totWidth = 0; // width of all of the previous peaks
+            bool     in = false;
+            PeakRef  pk = {0, 0, 0};
+            for(unsigned i=0; i<n;) {
                 if (q[i]&0x8000) { // are we a "skip" sample?
                     for (unsigned j=0; j<4; j++, i++) {
-                        _ns += (q[i]&0x7fff); // increment the number-of-skips
+                        ns += (q[i]&0x7fff);
                     }
-                    if (_in) { // if we were previously in a peak, this completes that peak
-                        _totWidth += _width; // add the width of the last peak to the cumulative sum
-                        peakLen = _width;
-                        _startSample = i; // remember where to start for next call
-                        _in = false; // we're not in a peak anymore
-                        return peakLen;
+                    if (in) { // this completes the previous peak
+                        totWidth += pk.width;
+                        _peaks.push_back(pk);
+                        in = false;
                     }
                 } else {
-                    if (!_in) { // we weren't previously in a peak, so start a new one
-                        _width = 0;
-                        startPos = _ns+_totWidth; // the index into the raw waveform: number-of-skips plus width of all previous peaks
-                        *peakPtr = (uint16_t *) (q+i); // pointer to the start of the peak array
+                    if (!in) { // the index into the raw waveform is the number-of-skips plus width of all previous peaks
+                        pk.startPos = ns+totWidth;
+                        pk.offset   = i;
+                        pk.width    = 0;
+                        in = true;
                     }
                     i += 4; // move to the next (interleaved) sample
-                    _width += 4; // increment the width of this peak
-                    _in = true; // we are in a peak
+                    pk.width += 4;
                 }
             }
-            if (_in) {
-                // I think this case happens when the last peak includes
-                // the very last uint16_t in sh_fex payload.
-                peakLen = _width;
+            if (in) // the last peak includes the last sample of the stream
+                _peaks.push_back(pk);
+            return _peaks.size();
+        }
+
+        unsigned num_peaks() { return index_peaks(); }
+
+        // Peak k of num_peaks(), returns its length
+        unsigned peak(unsigned k, unsigned& startPos, uint16_t** peakPtr) {
+            if (k >= index_peaks()) return 0;
+            const PeakRef& pk = _peaks[k];
+            startPos = pk.startPos;
+            *peakPtr = (uint16_t*)(_sh_fex+1) + pk.offset;
+            return pk.width;
+        }
+
+        // Copies the index of up to maxPeaks peaks to the arrays, returns num_peaks()
+        unsigned peaks(uint32_t* startPos, uint32_t* offset, uint32_t* width, unsigned maxPeaks) {
+            const unsigned npeaks = index_peaks();
+            for(unsigned k=0; k<npeaks && k<maxPeaks; k++) {
+                startPos[k] = _peaks[k].startPos;
+                offset  [k] = _peaks[k].offset;
+                width   [k] = _peaks[k].width;
             }
-            // these two lines will cause the iterator to return 0
-            // on the next call, ending the iteration.
-            _startSample = i;
-            _in = false;
-            return peakLen;
+            return npeaks;
+        }
+
+        // Iterates over the peaks: returns the length of the next peak, or 0 after the last one
+        unsigned next_peak(unsigned& startPos, uint16_t** peakPtr) {
+            return peak(_nextPeak++, startPos, peakPtr);
         }
     private:
         uint32_t* _evtheader;
@@ -99,20 +142,21 @@ namespace Pds {
         const StreamHeader* _sh_fex;
 
         void _reset_peakiter() {
-            _ns=0;
-            _in = false;
-            _width = 0;
-            _totWidth = 0;
-            _startSample = 0;
+            _nextPeak = 0;
         }
 
-        unsigned _ns;
-        bool     _in;
-        unsigned _width;
-        unsigned _totWidth;
-        unsigned _startSample;
+        bool     _indexed;
+        std::vector<PeakRef> _peaks;
+        unsigned _nextPeak;
 
     };
+
+    // Indexes the peaks of the channels of an event, in parallel
+    inline void index_channels(ChannelPython** chans, unsigned nchans) {
+#pragma omp parallel for schedule(dynamic) if(nchans>1)
+        for(unsigned i=0; i<nchans; i++)
+            chans[i]->index_peaks();
+    }
   } // HSD
 } // Pds
 
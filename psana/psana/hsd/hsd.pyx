@@ -24,6 +24,7 @@ from amitypes import HSDWaveforms, HSDPeaks, HSDAssemblies, HSDPeakTimes
 ################# High Speed Digitizer #################
 
 cimport libc.stdint as si
+from libcpp.vector cimport vector
 ctypedef si.uint32_t evthdr_t
 ctypedef si.uint8_t chan_t
 
@@ -37,27 +38,41 @@ cdef extern from "HsdPython.hh" namespace "Pds::HSD":
         ChannelPython(const evthdr_t *evtheader, const si.uint8_t *data)
         si.uint16_t* waveform(unsigned &numsamples)
         #si.uint16_t* sparse(unsigned &numsamples)
+        si.uint16_t* fex(unsigned &numsamples)
+        unsigned index_peaks() nogil
+        unsigned num_peaks()
+        unsigned peak(unsigned k, unsigned &sPos, si.uint16_t** peakPtr)
+        unsigned peaks(si.uint32_t* startPos, si.uint32_t* offset, si.uint32_t* width, unsigned maxPeaks)
         unsigned next_peak(unsigned &sPos, si.uint16_t** peakPtr)
+    void index_channels(ChannelPython** chans, unsigned nchans) nogil
 
 cdef class PyChannelPython:
+    """Waveform and fex peaks of a channel, as views of the event data.
+
+    The fex stream is indexed once, possibly by index_channels for all
+    channels of the event.  The peaks are then in the arrays startPos,
+    peakLen and peakOffset (into the fex samples), and peak k is fex(k);
+    the lists of the peaks are only made if they are asked for.
+    """
+    cdef ChannelPython chanpy
+    cdef object dgram
     cdef public cnp.ndarray waveform
     #cdef public cnp.ndarray sparse
-    cdef public list peakList
-    cdef public list startPosList
+    cdef public cnp.ndarray fexSamples
+    cdef public cnp.ndarray startPos
+    cdef public cnp.ndarray peakLen
+    cdef public cnp.ndarray peakOffset
+    cdef list _peakList
+    cdef list _startPosList
     def __init__(self, cnp.ndarray[evthdr_t, ndim=1, mode="c"] evtheader, cnp.ndarray[chan_t, ndim=1, mode="c"] chan, dgram):
         cdef cnp.npy_intp shape[1]
         cdef si.uint16_t* wf_ptr
-        cdef ChannelPython chanpy
         cdef unsigned numsamples = 0
-        cdef unsigned startSample = 0
-        cdef unsigned startPos = 0
-        cdef unsigned peakLen = 0
-        cdef si.uint16_t* peakPtr = <si.uint16_t*>0
-        cdef cnp.ndarray peak
 
-        chanpy = ChannelPython(&evtheader[0], &chan[0])
+        self.chanpy = ChannelPython(&evtheader[0], &chan[0])
+        self.dgram = dgram
 
-        wf_ptr = chanpy.waveform(numsamples)
+        wf_ptr = self.chanpy.waveform(numsamples)
         shape[0] = numsamples
         if numsamples:
             self.waveform = cnp.PyArray_SimpleNewFromData(1, shape, cnp.NPY_UINT16, wf_ptr)
@@ -75,20 +90,75 @@ cdef class PyChannelPython:
 #        else:
 #            self.sparse = None
 
-        self.peakList = None
-        self.startPosList = None
-        while True:
-            shape[0] = chanpy.next_peak(startPos,&peakPtr)
-            if not shape[0]: break
-            if self.peakList is None:
-                # we've found a peak so initialize the arrays
-                self.peakList = []
-                self.startPosList = []
-            peak = cnp.PyArray_SimpleNewFromData(1, shape, cnp.NPY_UINT16, peakPtr)
-            peak.base = <PyObject*> dgram
-            Py_INCREF(dgram)
-            self.peakList.append(peak)
-            self.startPosList.append(startPos)
+        self.fexSamples = None
+        self.startPos = None
+        self._peakList = None
+        self._startPosList = None
+
+    cdef _wrap_index(self):
+        """Indexes the fex stream, if that was not done yet, and exports the index"""
+        if self.startPos is not None: return
+        cdef cnp.npy_intp shape[1]
+        cdef si.uint16_t* fex_ptr
+        cdef unsigned numsamples = 0
+        cdef unsigned npeaks = self.chanpy.index_peaks()
+        cdef cnp.ndarray[si.uint32_t, ndim=1, mode="c"] startPos = np.empty(npeaks, dtype=np.uint32)
+        cdef cnp.ndarray[si.uint32_t, ndim=1, mode="c"] peakLen = np.empty(npeaks, dtype=np.uint32)
+        cdef cnp.ndarray[si.uint32_t, ndim=1, mode="c"] peakOffset = np.empty(npeaks, dtype=np.uint32)
+        if npeaks:
+            self.chanpy.peaks(&startPos[0], &peakOffset[0], &peakLen[0], npeaks)
+            fex_ptr = self.chanpy.fex(numsamples)
+            shape[0] = numsamples
+            self.fexSamples = cnp.PyArray_SimpleNewFromData(1, shape, cnp.NPY_UINT16, fex_ptr)
+            self.fexSamples.base = <PyObject*> self.dgram
+            Py_INCREF(self.dgram)
+        self.startPos = startPos
+        self.peakLen = peakLen
+        self.peakOffset = peakOffset
+
+    def num_peaks(self):
+        self._wrap_index()
+        return self.startPos.size
+
+    def fex(self, k):
+        """Samples of peak k, a view of the event data"""
+        self._wrap_index()
+        o = self.peakOffset[k]
+        return self.fexSamples[o:o+self.peakLen[k]]
+
+    def peak_arrays(self):
+        """(startPos, peakLen, peakOffset, fexSamples) of all of the peaks, or None if there are none"""
+        self._wrap_index()
+        if not self.startPos.size: return None
+        return (self.startPos, self.peakLen, self.peakOffset, self.fexSamples)
+
+    @property
+    def peakList(self):
+        """List of the samples of the peaks, or None if there are none"""
+        self._wrap_index()
+        if self._peakList is None and self.startPos.size:
+            self._peakList = [self.fexSamples[o:o+n] for o, n in zip(self.peakOffset, self.peakLen)]
+        return self._peakList
+
+    @property
+    def startPosList(self):
+        """List of the positions of the peaks in the raw waveform, or None if there are none"""
+        self._wrap_index()
+        if self._startPosList is None and self.startPos.size:
+            self._startPosList = self.startPos.tolist()
+        return self._startPosList
+
+def _index_channels(list pychans):
+    """Indexes the fex streams of the channels of an event in parallel"""
+    cdef vector[ChannelPython*] chans
+    cdef PyChannelPython pychan
+    for pychan in pychans:
+        chans.push_back(&pychan.chanpy)
+    if chans.size():
+        with nogil:
+            index_channels(chans.data(), chans.size())
+    for pychan in pychans:
+        pychan._wrap_index()
 
 class hsd_hsd_1_2_3(cyhsd_base_1_2_3, DetectorImpl):
 
@@ -142,6 +212,7 @@ cdef class cyhsd_base_1_2_3:
         self._peakTimesDict = {}
         self._evt = None
         self._hsdsegments = None
+        self._pychansegs = {}
 
         self._padDict = {}
         self._padValue = {}
@@ -186,20 +257,27 @@ cdef class cyhsd_base_1_2_3:
             self._padDict[iseg][chanNum] = padvalues
             self._padDict[iseg]["times"] = np.arange(self._padLength[iseg]) * 1/(6.4e9*13/14)
 
+    def _makePeaksDict(self):
+        if self._peaksDict or not self._pychansegs: return
+        for iseg, (chanNum, pychan) in self._pychansegs.items():
+            if pychan.num_peaks():
+                if iseg not in self._peaksDict.keys():
+                    self._peaksDict[iseg]={}
+                self._peaksDict[iseg][chanNum] = (pychan.startPosList,pychan.peakList)
+
     def _parseEvt(self, evt):
         self._wvDict = {}
         self._spDict = {}
         self._peaksDict = {}
         self._padDict = {}
         self._fexPeaks = []
+        # Keep segment-pychan data for slow padding routine when asked
+        self._pychansegs = {}
         self._hsdsegments = self._segments(evt)
         if self._hsdsegments is None: return # no segments at all
         self._evt = evt
         #seglist = [] # not used at the moment
 
-        # Keep segment-pychan data for slow padding routine when asked
-        self._pychansegs = {}
-
         cdef int iseg
         for iseg in self._hsdsegments:
             #seglist.append(iseg) # not used at the moment
@@ -227,10 +305,10 @@ cdef class cyhsd_base_1_2_3:
 #                            if iseg not in self._spDict.keys():
 #                                self._spDict[iseg] = {}
 #                                self._spDict[iseg][chanNum] = pychan.sparse
-                if pychan.peakList is not None:
-                    if iseg not in self._peaksDict.keys():
-                        self._peaksDict[iseg]={}
-                    self._peaksDict[iseg][chanNum] = (pychan.startPosList,pychan.peakList)
+
+        # the fex peaks of all channels are indexed at once, the lists of
+        # the peaks are only made if asked for (see _makePeaksDict)
+        _index_channels([pychan for (chanNum, pychan) in self._pychansegs.values()])
 
         # maybe check that we have all segments in the event?
         # FIXME: also check that we have all the channels we expect?
@@ -290,11 +368,30 @@ cdef class cyhsd_base_1_2_3:
         """
         if self._isNewEvt(evt):
             self._parseEvt(evt)
+        self._makePeaksDict()
         if not self._peaksDict:
             return None
         else:
             return self._peaksDict
 
+    def peak_arrays(self, evt):
+        """Return a dictionary of the peaks found in the event, as arrays,
+        without making an array per peak.
+        0:    tuple (startPos, peakLen, peakOffset, fexSamples) from channel 0
+        ...
+        The samples of peak k are fexSamples[peakOffset[k]:peakOffset[k]+peakLen[k]]
+        and its position in the raw waveform is startPos[k].
+        """
+        if self._isNewEvt(evt):
+            self._parseEvt(evt)
+        if not self._pychansegs: return None
+        arrays = {}
+        for iseg, (chanNum, pychan) in self._pychansegs.items():
+            peaks = pychan.peak_arrays()
+            if peaks is not None:
+                arrays.setdefault(iseg, {})[chanNum] = peaks
+        return arrays if arrays else None
+
     @cython.binding(True)
     def peak_times(self, evt) -> HSDPeakTimes:
         """Return a dictionary of available times of peaks found in the event.
@@ -11,6 +11,9 @@
 #include <cstddef>  // for size_t
 #include <cstring>  // for memcpy
 #include <cmath>    // for sqrt
+#include <limits>   // for numeric_limits
+#include <algorithm> // for fill_n, min, max
+#include <stdint.h> // for uint64_t
 
 #include "Types.hh"
 #include "psalg/alloc/AllocArray.hh"
@@ -74,6 +77,7 @@ namespace localextrema {
  *  
  *  size_t n = mapOfLocalMinimums(data, mask, rows, cols, rank, arr2d);
  *  size_t n = mapOfLocalMaximums(data, mask, rows, cols, rank, arr2d);
+ *  size_t n = mapOfLocalMaximumsScalar(data, mask, rows, cols, rank, arr2d); // the same map, slower
  *  size_t n = mapOfLocalMaximumsRank1Cross(data, mask, rows, cols, arr2d);
  *  size_t n = mapOfThresholdMaximums(data ,mask, rows, cols, rank, thr_low, thr_high, local_maxima)
  *
@@ -328,6 +332,202 @@ localMaxima1d(const T *data
 
 //-----------------------------
 
+//-----------------------------
+//-----------------------------
+  /**
+   * Separable search of local extrema, used by mapOfLocalMinimums/Maximums(_drp).
+   *
+   * A pixel is a maximum in its row (bit 1) if it is good, greater than its right
+   * neighbour (if any), no good pixel in the row within rank is greater, and it is
+   * more than rank pixels after the previous maximum found in the row; bit 2 is the
+   * same for the column, with the pixel below. These are the pixels which the scans
+   * with jumps ahead of mapOfLocalMaximumsScalar find, so the maps are identical.
+   *
+   * The maxima of the good pixels in the windows are evaluated for a whole row at a
+   * time, with loops over columns which the compiler vectorizes: along the row by
+   * doubling the window (log2(2*rank+1) passes), along the columns by the
+   * van Herk/Gil-Werman algorithm on blocks of 2*rank+1 rows (3 operations per pixel
+   * for any rank). The square test (bit 4) is done for the few pixels with bits 1 and 2.
+   */
+
+template <typename T>
+struct ExtremumMax {
+  static T none() {return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                                 : std::numeric_limits<T>::lowest();}
+  static T pick(const T& a, const T& b) {return (a>b) ? a : b;}
+  static bool beats(const T& a, const T& b) {return a>b;}
+};
+
+template <typename T>
+struct ExtremumMin {
+  static T none() {return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                                 : std::numeric_limits<T>::max();}
+  static T pick(const T& a, const T& b) {return (a<b) ? a : b;}
+  static bool beats(const T& a, const T& b) {return a<b;}
+};
+
+/// size in bytes of the work buffer of mapOfLocalExtremaSeparable
+template <typename T>
+size_t 
+workSizeOfLocalExtrema(const size_t& cols, const size_t& rank)
+{
+  size_t nt = (cols+2*rank) + (2*rank+1)*cols + 2*cols; // row window, column window block, 2 rows
+  return (nt*sizeof(T)+7)/8*8 + cols*sizeof(int);
+}
+
+template <typename T, typename E>
+size_t 
+mapOfLocalExtremaSeparable(const T *data
+                          ,const mask_t *mask
+                          ,const size_t& rows
+                          ,const size_t& cols
+                          ,const size_t& rank
+                          ,extrim_t *map
+                          ,void *work
+                          )
+{
+  const size_t w = 2*rank+1;
+  const size_t npad = cols+2*rank;
+  const T none = E::none();
+
+  T *pad  = (T*)work;       // good pixels of a row with rank bad ones on each side
+  T *hblk = pad + npad;     // suffix extrema of a block of w rows
+  T *grow = hblk + w*cols;  // prefix extremum of the next block
+  T *vext = grow + cols;    // extremum of the column windows of a row
+  int *last = (int*)((char*)work + ((npad + w*cols + 2*cols)*sizeof(T)+7)/8*8);
+
+  std::fill_n(map, rows*cols, extrim_t(0));
+  if(!cols) return 0;
+
+  // check rank extremum in rows and set the 1st bit (1)
+  for(size_t r=0; r<rows; r++) {
+    const T *d = &data[r*cols];
+    const mask_t *m = &mask[r*cols];
+    extrim_t *x = &map[r*cols];
+
+    std::fill_n(pad, rank, none);
+    std::fill_n(pad+rank+cols, rank, none);
+    #pragma omp simd
+    for(size_t c=0; c<cols; c++) {const T v = d[c]; pad[rank+c] = m[c] ? v : none;}
+
+    // extremum of [c, c+len) in place, doubling len up to the largest power of 2 <= w
+    size_t len = 1;
+    for(; 2*len<=w; len*=2) {
+      const size_t n = npad-2*len+1;
+      #pragma omp simd
+      for(size_t c=0; c<n; c++) pad[c] = E::pick(pad[c], pad[c+len]);
+    }
+    #pragma omp simd
+    for(size_t c=0; c<cols; c++) pad[c] = E::pick(pad[c], pad[c+w-len]); // [c-rank, c+rank] of the row
+
+    #pragma omp simd
+    for(size_t c=0; c<cols-1; c++) x[c] = (m[c]!=0) & !E::beats(pad[c], d[c]) & E::beats(d[c], d[c+1]);
+    x[cols-1] = (m[cols-1]!=0) & !E::beats(pad[cols-1], d[cols-1]);
+
+    // drop the candidates which the scan jumps over
+    int clast = -(int)rank-1;
+    for(size_t c=0; c<cols; c++) {
+      if(!x[c]) continue;
+      if((int)c <= clast+(int)rank) x[c] = 0;
+      else clast = c;
+    }
+  }
+
+  // check rank extremum in columns and set the 2nd bit (2);
+  // the window of row r is [r, r+w) of the rows padded by rank bad ones
+  std::fill_n(last, cols, -(int)rank-1);
+  for(size_t r=0; r<rows; r++) {
+    const size_t j = r%w;
+    const T *v = vext;
+
+    if(j==0) {
+      for(size_t k=w; k-- > 0;) {
+        T *h = &hblk[k*cols];
+        const size_t q = r+k;
+        const bool good = (q>=rank) && (q<rank+rows);
+        const T *d = good ? &data[(q-rank)*cols] : data;
+        const mask_t *m = good ? &mask[(q-rank)*cols] : mask;
+        if(k==w-1) {
+          if(!good) std::fill_n(h, cols, none);
+          else {
+            #pragma omp simd
+            for(size_t c=0; c<cols; c++) {const T v = d[c]; h[c] = m[c] ? v : none;}
+          }
+        }
+        else if(!good) std::copy(h+cols, h+2*cols, h);
+        else {
+          #pragma omp simd
+          for(size_t c=0; c<cols; c++) {const T v = d[c]; h[c] = E::pick(m[c] ? v : none, h[c+cols]);}
+        }
+      }
+      v = hblk;
+    }
+    else {
+      const size_t q = r+w-1; // in the next block
+      const bool good = q<rank+rows;
+      const T *d = good ? &data[(q-rank)*cols] : data;
+      const mask_t *m = good ? &mask[(q-rank)*cols] : mask;
+      const T *h = &hblk[j*cols];
+      if(!good) {
+        if(q%w==0) std::fill_n(grow, cols, none);
+      }
+      else if(q%w==0) {
+        #pragma omp simd
+        for(size_t c=0; c<cols; c++) {const T v = d[c]; grow[c] = m[c] ? v : none;}
+      }
+      else {
+        #pragma omp simd
+        for(size_t c=0; c<cols; c++) {const T v = d[c]; grow[c] = E::pick(grow[c], m[c] ? v : none);}
+      }
+      #pragma omp simd
+      for(size_t c=0; c<cols; c++) vext[c] = E::pick(h[c], grow[c]);
+    }
+
+    const T *d = &data[r*cols];
+    const mask_t *m = &mask[r*cols];
+    extrim_t *x = &map[r*cols];
+    const bool lastrow = (r+1==rows);
+    const T *dn = lastrow ? d : d+cols;
+    const int ir = r;
+    const int irank = rank;
+    #pragma omp simd
+    for(size_t c=0; c<cols; c++) {
+      const bool ext = (m[c]!=0) & !E::beats(v[c], d[c]) & (lastrow | E::beats(d[c], dn[c])) & (ir > last[c]+irank);
+      x[c] |= ext ? 2 : 0; // set 2nd bit
+      last[c] = ext ? ir : last[c];
+    }
+  }
+
+  // check rank extremum in "diagonal" regions and set the 3rd bit (4)
+  size_t counter = 0;
+  const int irank = rank;
+  for(size_t r=0; r<rows; r++) {
+    for(size_t c=0; c<cols; c++) {
+      const size_t irc = r*cols+c;
+      if(map[irc] != 3) continue;
+      map[irc] |= 4; // set 3rd bit
+
+      const int rmin = max(0, int(r)-irank), rmax = min(int(rows)-1, int(r)+irank);
+      const int cmin = max(0, int(c)-irank), cmax = min(int(cols)-1, int(c)+irank);
+      for(int ir=rmin; ir<=rmax && (map[irc] & 4); ir++) {
+        if(ir==(int)r) continue;
+        for(int ic=cmin; ic<=cmax; ic++) {
+          if(ic==(int)c) continue;
+          const size_t iric = ir*cols+ic;
+          if(mask[iric] && E::beats(data[iric], data[irc])) {
+            map[irc] &=~4; // clear 3rd bit
+            break;
+          }
+        }
+      }
+      if(map[irc] & 4) counter ++;
+    }
+  }
+  return counter;
+}
+
+//-----------------------------
+
 //-----------------------------
   /**
    * @brief returns map of local minimums of requested rank, 
@@ -355,143 +555,9 @@ mapOfLocalMinimums_drp(const T *data
                   ,Allocator *allocator
                   )
 {
-  #ifndef NDEBUG
-  std::cout << "XXX mapOfLocalMinimums point E \n";
-  #endif
-
-  // initialization of indexes
-  AllocArray1D<TwoIndexes> arr_inddiag_drp = evaluateDiagIndexes_drp(rank, allocator);
-
-  extrim_t *_local_minima = local_minima;
-  size_t size = rows*cols;
-  std::fill_n(_local_minima, int(size), extrim_t(0));
-
-  size_t counter = 0;
-
-  unsigned rmin = 0;
-  unsigned rmax = (int)rows;
-  unsigned cmin = 0;
-  unsigned cmax = (int)cols;
-  int irank = (int)rank;
-
-  int irc=0;
-  int ircd=0;
-  int irdc=0;
-  int iric=0;
-
-  // check rank minimum in columns and set the 1st bit (1)
-  for(unsigned r = rmin; r<rmax; r++) {
-    for(unsigned c = cmin; c<cmax; c++) {
-      irc = r*cols+c;
-
-      if(!mask[irc]) continue;
-      if((c+1<cmax) && !(data[irc]<data[irc+1])) continue;
-      _local_minima[irc] = 1;
-
-      // positive side of c 
-      unsigned dmax = min((int)cmax-1, int(c)+irank);
-      for(unsigned cd=c+1; cd<=dmax; cd++) {
-        ircd = r*cols+cd;
-        if(mask[ircd] && (data[ircd] < data[irc])) {
-              _local_minima[irc] &=~1; // clear 1st bit
-              c=cd-1; // jump ahead
-          break;
-        }
-      }
-
-      if(_local_minima[irc] & 1) {
-        // negative side of c 
-        unsigned dmin = max((int)cmin, int(c)-irank);
-        for(unsigned cd=dmin; cd<c; cd++) {
-          ircd = r*cols+cd;
-          if(mask[ircd] && (data[ircd] < data[irc])) {
-                _local_minima[irc] &=~1; // clear 1st bit
-                c=cd+rank; // jump ahead
-            break;
-          }
-        }
-      }
-
-      // (r,c) is a local dip, jump ahead through the tested rank range
-      if(!(c<cmax)) break;
-      if(_local_minima[irc] & 1) c+=rank;
-    }
-  }
-
-  // check rank minimum in rows and set the 2nd bit (2)
-  for(unsigned c = cmin; c<cmax; c++) {
-    for(unsigned r = rmin; r<rmax; r++) {
-      // if it is not a local maximum from previous algorithm
-      //if(!_local_minima[irc]) continue;
-      irc = r*cols+c;
-
-      if(!mask[irc]) continue;
-      if((r+1<rmax) && !(data[irc]<data[irc+cols])) continue;
-      _local_minima[irc] |= 2; // set 2nd bit
-
-      // positive side of r 
-      unsigned dmax = min((int)rmax-1, int(r)+irank);
-      for(unsigned rd=r+1; rd<=dmax; rd++) {
-        irdc = rd*cols+c;
-        if(mask[irdc] && (data[irdc] < data[irc])) {
-              _local_minima[irc] &=~2; // clear 2nd bit
-              r=rd-1; // jump ahead
-          break;
-        }
-      }
-
-      if(_local_minima[irc] & 2) {
-        // negative side of r
-        unsigned dmin = max((int)rmin, int(r)-irank);
-        for(unsigned rd=dmin; rd<r; rd++) {
-          irdc = rd*cols+c;
-          if(mask[irdc] && (data[irdc] < data[irc])) {
-                _local_minima[irc] &=~2; // clear 2nd bit
-                r=rd+rank; // jump ahead
-            break;
-          }
-        }
-      }
-
-      // (r,c) is a local dip, jump ahead through the tested rank range
-      if(!(r<rmax)) break;
-      if(_local_minima[irc] & 2) r+=rank;
-    }
-  }
-
-  // check rank minimum in "diagonal" regions and set the 3rd bit (4)
-  for(unsigned r = rmin; r<rmax; r++) {
-    for(unsigned c = cmin; c<cmax; c++) {
-      irc = r*cols+c;
-      // if it is not a local minimum from two previous algorithm
-      if(_local_minima[irc] != 3) continue;
-      _local_minima[irc] |= 4; // set 3rd bit
-
-      for(unsigned int ii = 0; ii < arr_inddiag_drp.num_elem(); ii++) {
-        
-        int ir = r + (arr_inddiag_drp(ii).i);
-        int ic = c + (arr_inddiag_drp(ii).j);
-        
-        if(  ir<(int)rmin)  continue;
-        if(  ic<(int)cmin)  continue;
-        if(!(ir<(int)rmax)) continue;
-        if(!(ic<(int)cmax)) continue;
-
-        iric = ir*cols+ic;
-        if(mask[iric] && (data[iric] < data[irc])) {
-              _local_minima[irc] &=~4; // clear 3rd bit
-          break;
-        }
-      }
-
-      // (r,c) is a local peak, jump ahead through the tested rank range
-      if(_local_minima[irc] & 4) {
-         c+=rank;
-         counter ++;
-      }
-    }
-  }
-
+  void *work = allocator->malloc(workSizeOfLocalExtrema<T>(cols, rank));
+  size_t counter = mapOfLocalExtremaSeparable<T, ExtremumMin<T> >(data, mask, rows, cols, rank, local_minima, work);
+  allocator->free(work);
   return counter;
 }
 
@@ -521,142 +587,12 @@ mapOfLocalMaximums_drp(const T *data
                   ,Allocator *allocator
                   )
 {
-  #ifndef NDEBUG
-  std::cout << "in mapOfLocalMaximums, rank=" << rank << "\n";
-  #endif
-
-  AllocArray1D<TwoIndexes> arr_inddiag_drp = evaluateDiagIndexes_drp(rank, allocator);
-
-  extrim_t *_local_maxima = local_maxima;
-  std::fill_n(&_local_maxima[0], int(rows*cols), extrim_t(0));
-
-  size_t counter = 0;
-
-  unsigned rmin = 0;
-  unsigned rmax = (int)rows;
-  unsigned cmin = 0;
-  unsigned cmax = (int)cols;
-  int irank = (int)rank;
-
-  int irc=0;
-  int ircd=0;
-  int irdc=0;
-  int iric=0;
-
-  // check rank maximum in columns and set the 1st bit (1)
-  for(unsigned r = rmin; r<rmax; r++) {
-    for(unsigned c = cmin; c<cmax; c++) {
-      irc = r*cols+c;
-      if(!mask[irc]) continue;
-      if((c+1<cmax) && !(data[irc]>data[irc+1])) continue;
-      _local_maxima[irc] = 1;
-
-      // positive side of c 
-      unsigned dmax = min((int)cmax-1, int(c)+irank);
-      for(unsigned cd=c+1; cd<=dmax; cd++) {
-        ircd = r*cols+cd;
-        if(mask[ircd] && (data[ircd] > data[irc])) {
-              _local_maxima[irc] &=~1; // clear 1st bit
-              c=cd-1; // jump ahead
-          break;
-        }
-      }
-
-      if(_local_maxima[irc] & 1) {
-        // negative side of c 
-        unsigned dmin = max((int)cmin, int(c)-irank);
-        for(unsigned cd=dmin; cd<c; cd++) {
-          ircd = r*cols+cd;
-          if(mask[ircd] && (data[ircd] > data[irc])) {
-                _local_maxima[irc] &=~1; // clear 1st bit
-                c=cd+rank; // jump ahead
-            break;
-          }
-        }
-      }
-
-      // (r,c) is a local dip, jump ahead through the tested rank range
-      if(!(c<cmax)) break;
-      if(_local_maxima[irc] & 1) c+=rank;
-    }
-  }
-
-  // check rank maximum in rows and set the 2nd bit (2)
-  for(unsigned c = cmin; c<cmax; c++) {
-    for(unsigned r = rmin; r<rmax; r++) {
-      irc = r*cols+c;
-      // if it is not a local maximum from previous algorithm
-      //if(!_local_maxima[irc]) continue;
-
-      if(!mask[irc]) continue;
-      if((r+1<rmax) && !(data[irc]>data[irc+cols])) continue;
-      _local_maxima[irc] |= 2; // set 2nd bit
-
-      // positive side of r 
-      unsigned dmax = min((int)rmax-1, int(r)+irank);
-      for(unsigned rd=r+1; rd<=dmax; rd++) {
-        irdc = rd*cols+c;
-        if(mask[irdc] && (data[irdc] > data[irc])) {
-              _local_maxima[irc] &=~2; // clear 2nd bit
-              r=rd-1; // jump ahead
-          break;
-        }
-      }
-
-      if(_local_maxima[irc] & 2) {
-        // negative side of r
-        unsigned dmin = max((int)rmin, int(r)-irank);
-        for(unsigned rd=dmin; rd<r; rd++) {
-          irdc = rd*cols+c;
-          if(mask[irdc] && (data[irdc] > data[irc])) {
-                _local_maxima[irc] &=~2; // clear 2nd bit
-                r=rd+rank; // jump ahead
-            break;
-          }
-        }
-      }
-
-      // (r,c) is a local dip, jump ahead through the tested rank range
-      if(!(r<rmax)) break;
-      if(_local_maxima[irc] & 2) r+=rank;
-    }
-  }
-
-  // check rank maximum in "diagonal" regions and set the 3rd bit (4)
-  for(unsigned r = rmin; r<rmax; r++) {
-    for(unsigned c = cmin; c<cmax; c++) {
-      // if it is not a local maximum from two previous algorithm
-      irc = r*cols+c;
-
-      if(_local_maxima[irc] != 3) continue;
-      _local_maxima[irc] |= 4; // set 3rd bit
-
-      for(unsigned int ii = 0; ii < arr_inddiag_drp.num_elem(); ii++) {
-        int ir = r + (arr_inddiag_drp(ii).i);
-        int ic = c + (arr_inddiag_drp(ii).j);
-
-        if(  ir<(int)rmin)  continue;
-        if(  ic<(int)cmin)  continue;
-        if(!(ir<(int)rmax)) continue;
-        if(!(ic<(int)cmax)) continue;
-
-        iric = ir*cols+ic;
-        if(mask[iric] && (data[iric] > data[irc])) {
-              _local_maxima[irc] &=~4; // clear 3rd bit
-          break;
-        }
-      }
-
-      // (r,c) is a local peak, jump ahead through the tested rank range
-      if(_local_maxima[irc] & 4) {
-        c+=rank;
-        counter ++;
-      }
-    }
-  }
-
+  void *work = allocator->malloc(workSizeOfLocalExtrema<T>(cols, rank));
+  size_t counter = mapOfLocalExtremaSeparable<T, ExtremumMax<T> >(data, mask, rows, cols, rank, local_maxima, work);
+  allocator->free(work);
   return counter;
 }
+
 //-----------------------------
 
   /**
@@ -881,10 +817,25 @@ mapOfLocalMinimums(const T *data
                   ,extrim_t *local_minima
                   )
 {
-  #ifndef NDEBUG
-  std::cout << "XXX mapOfLocalMinimums point E \n";
-  #endif
+  std::vector<uint64_t> work((workSizeOfLocalExtrema<T>(cols, rank)+7)/8);
+  return mapOfLocalExtremaSeparable<T, ExtremumMin<T> >(data, mask, rows, cols, rank, local_minima, &work[0]);
+}
 
+//-----------------------------
+  /**
+   * @brief the same as mapOfLocalMinimums, with scans of the rank region of each candidate pixel;
+   *        the reference for the separable search, e.g. in test_LocalExtrema.
+   */
+template <typename T>
+size_t 
+mapOfLocalMinimumsScalar(const T *data
+                  ,const mask_t *mask
+                  ,const size_t& rows
+                  ,const size_t& cols
+                  ,const size_t& rank
+                  ,extrim_t *local_minima
+                  )
+{
   // initialization of indexes
   //if(v_inddiag.empty())   
   std::vector<TwoIndexes> v_inddiag = evaluateDiagIndexes(rank);
@@ -1049,10 +1000,25 @@ mapOfLocalMaximums(const T *data
                   ,extrim_t *local_maxima
                   )
 {
-  #ifndef NDEBUG
-  std::cout << "in mapOfLocalMaximums, rank=" << rank << "\n";
-  #endif
+  std::vector<uint64_t> work((workSizeOfLocalExtrema<T>(cols, rank)+7)/8);
+  return mapOfLocalExtremaSeparable<T, ExtremumMax<T> >(data, mask, rows, cols, rank, local_maxima, &work[0]);
+}
 
+//-----------------------------
+  /**
+   * @brief the same as mapOfLocalMaximums, with scans of the rank region of each candidate pixel;
+   *        the reference for the separable search, e.g. in test_LocalExtrema.
+   */
+template <typename T>
+size_t 
+mapOfLocalMaximumsScalar(const T *data
+                  ,const mask_t *mask
+                  ,const size_t& rows
+                  ,const size_t& cols
+                  ,const size_t& rank
+                  ,extrim_t *local_maxima
+                  )
+{
   // initialization of indexes
   std::vector<TwoIndexes> v_inddiag = evaluateDiagIndexes(rank);
 
@@ -39,10 +39,20 @@ namespace psalg {
 typedef uint32_t index_t;
 typedef double wfdata_t;
 
+/// Edge parameters of a channel for find_edges_batch, as the arguments of find_edges
+struct EdgePars {
+  double baseline;
+  double threshold;
+  double fraction;
+  double deadtime;
+  bool   leading_edge;
+};
+
 template <typename T>
 void
 _add_edge(
-  const std::vector<T>& v,
+  const T* v,
+  index_t  size,
   bool     rising,
   double   fraction,
   double   deadtime,
@@ -67,6 +77,46 @@ find_edges(
   bool     leading_edge
 );
 
+/// The same for the size samples of wf, without a copy to a vector.
+/// The samples below threshold are skipped with vectorized compares, a block
+/// at a time, and only the pulses are walked sample by sample.
+template <typename T>
+index_t
+find_edges(
+  index_t  npkmax,
+  T*       pkvals,
+  index_t* pkinds,
+  const T* wf,
+  index_t  size,
+  double   baseline,
+  double   threshold,
+  double   fraction,
+  double   deadtime,
+  bool     leading_edge
+);
+
+/**
+ * @brief Edges of nchan waveforms, e.g. all channels of a digitizer in an event.
+ *
+ * Waveform c has nsamples samples from wfs[c*stride] and is processed with pars[c].
+ * Its edges go to pkvals[c*npkmax] and pkinds[c*npkmax], npkmax of each
+ * preallocated per channel, and their number to npks[c].  The channels are
+ * shared between the OpenMP threads when there are enough samples.
+ */
+template <typename T>
+void
+find_edges_batch(
+  index_t  nchan,
+  index_t  nsamples,
+  index_t  stride,
+  const T* wfs,
+  const EdgePars* pars,
+  index_t  npkmax,
+  T*       pkvals,
+  index_t* pkinds,
+  index_t* npks
+);
+
 } // namespace psalg
 
 #endif // PSALG_PEAKS_WFALGOS_H
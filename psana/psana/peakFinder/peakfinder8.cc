@@ -20,6 +20,9 @@
 #include <cstring>
 #include <stdio.h>
 #include <float.h>
+#include <algorithm>
+
+#include <omp.h>
 
 #include "peakfinder8.hh"
 
@@ -71,163 +74,13 @@ void freePeakList(tPeakList peak)
 }
 
 
-struct radial_stats
-{
-	float *roffset;
-	float *rthreshold;
-	float *lthreshold;
-	float *rsigma;
-	int *rcount;
-	int n_rad_bins;
-};
-
-
-struct peakfinder_intern_data
-{
-	char *pix_in_peak_map;
-	int *infs;
-	int *inss;
-	int *peak_pixels;
-};
-
-
-struct peakfinder_peak_data
-{
-	int num_found_peaks;
-	int *npix;
-	float *com_fs;
-	float *com_ss;
-	int *com_index;
-	float *tot_i;
-	float *max_i;
-	float *sigma;
-	float *snr;
-};
-
-
-static void compute_num_radial_bins(int w, int h, float *r_map, float *max_r)
-{
-	int ifs, iss;
-	int pidx;
-
-	for ( iss=0 ; iss<h ; iss++ ) {
-		for ( ifs=0 ; ifs<w ; ifs++ ) {
-			pidx = iss * w + ifs;
-			if ( r_map[pidx] > *max_r ) {
-				*max_r = r_map[pidx];
-			}
-		}
-	}
-}
-
-
-static struct radial_stats* allocate_radial_stats(int num_rad_bins)
-{
-	struct radial_stats* rstats;
-
-	rstats = (struct radial_stats *)malloc(sizeof(struct radial_stats));
-	if ( rstats == NULL ) {
-		return NULL;
-	}
-
-	rstats->roffset = (float *)malloc(num_rad_bins*sizeof(float));
-	if ( rstats->roffset == NULL ) {
-		free(rstats);
-		return NULL;
-	}
-
-	rstats->rthreshold = (float *)malloc(num_rad_bins*sizeof(float));
-	if ( rstats->rthreshold == NULL ) {
-		free(rstats->roffset);
-		free(rstats);
-		return NULL;
-	}
-
-	rstats->lthreshold = (float *)malloc(num_rad_bins*sizeof(float));
-	if ( rstats->lthreshold == NULL ) {
-		free(rstats->rthreshold);
-		free(rstats->roffset);
-		free(rstats);
-		return NULL;
-	}
-
-	rstats->rsigma = (float *)malloc(num_rad_bins*sizeof(float));
-	if ( rstats->rsigma == NULL ) {
-		free(rstats->roffset);
-		free(rstats->rthreshold);
-		free(rstats->lthreshold);
-		free(rstats);
-		return NULL;
-	}
-
-	rstats->rcount = (int *)malloc(num_rad_bins*sizeof(int));
-	if ( rstats->rcount == NULL ) {
-		free(rstats->roffset);
-		free(rstats->rthreshold);
-		free(rstats->lthreshold);
-		free(rstats->rsigma);
-		free(rstats);
-		return NULL;
-	}
-
-	rstats->n_rad_bins = num_rad_bins;
-
-	return rstats;
-}
-
-
-static void free_radial_stats(struct radial_stats *rstats)
-{
-	free(rstats->roffset);
-	free(rstats->rthreshold);
-	free(rstats->lthreshold);
-	free(rstats->rsigma);
-	free(rstats->rcount);
-	free(rstats);
-}
-
-
-static void fill_radial_bins(float *data,
-                             int w,
-                             int h,
-                             float *r_map,
-                             char *mask,
-                             float *rthreshold,
-                             float *lthreshold,
-                             float *roffset,
-                             float *rsigma,
-                             int *rcount)
-{
-	int iss, ifs;
-	int pidx;
-
-	int curr_r;
-	float value;
-
-	for ( iss=0; iss<h ; iss++ ) {
-		for ( ifs=0; ifs<w ; ifs++ ) {
-			pidx = iss * w + ifs;
-			if ( mask[pidx] != 0 ) {
-				curr_r = (int)rint(r_map[pidx]);
-				value = data[pidx];
-				if ( value < rthreshold[curr_r]
-				  && value > lthreshold[curr_r] )
-				{
-					roffset[curr_r] += value;
-					rsigma[curr_r] += (value * value);
-					rcount[curr_r] += 1;
-				}
-			}
-		}
-	}
-}
-
-
-static void compute_radial_stats(float *rthreshold,
+static void compute_radial_stats(double *rsum,
+                                 double *rsum2,
+                                 int *rcount,
+                                 float *rthreshold,
                                  float *lthreshold,
                                  float *roffset,
                                  float *rsigma,
-                                 int *rcount,
                                  int num_rad_bins,
                                  float min_snr,
                                  float acd_threshold)
@@ -243,8 +96,8 @@ static void compute_radial_stats(float *rthreshold,
 			rthreshold[ri] = FLT_MAX;
 			lthreshold[ri] = FLT_MIN;
 		} else {
-			this_offset = roffset[ri] / rcount[ri];
-			this_sigma = rsigma[ri] / rcount[ri] - (this_offset * this_offset);
+			this_offset = rsum[ri] / rcount[ri];
+			this_sigma = rsum2[ri] / rcount[ri] - (this_offset * this_offset);
 			if ( this_sigma >= 0 ) {
 				this_sigma = sqrt(this_sigma);
 			}
@@ -263,237 +116,9 @@ static void compute_radial_stats(float *rthreshold,
 }
 
 
-static struct radial_stats *compute_radial_bins(float *data,
-                                                char *mask,
-                                                int num_pix,
-                                                float *r_map,
-                                                int iterations,
-                                                float min_snr,
-                                                float acd_threshold,
-                                                int num_pix_fs,
-                                                int num_pix_ss)
-{
-	float max_r;
-	int it_counter;
-	int i;
-	int num_rad_bins;
-	struct radial_stats *rstats;
-
-	max_r = -1e9;
-
-	compute_num_radial_bins(num_pix_fs, num_pix_ss, r_map, &max_r);
-
-	num_rad_bins = (int)ceil(max_r) + 1;
-
-	// Allocate and zero arrays
-	rstats = allocate_radial_stats(num_rad_bins);
-	if ( rstats == NULL ) {
-		return NULL;
-	}
-
-	for ( i=0; i<num_rad_bins; i++ ) {
-		rstats->rthreshold[i] = 1e9;
-		rstats->lthreshold[i] = -1e9;
-	}
-
-	// Compute sigma and average of data values at each radius
-	// From this, compute the ADC threshold to be applied at each radius
-	// Iterate a few times to reduce the effect of positive outliers (ie: peaks)
-	for ( it_counter=0 ; it_counter<iterations ; it_counter++ ) {
-
-		for ( i=0; i<num_rad_bins; i++ ) {
-			rstats->roffset[i] = 0;
-			rstats->rsigma[i] = 0;
-			rstats->rcount[i] = 0;
-		}
-
-		fill_radial_bins(data,
-                         num_pix_fs,
-                         num_pix_ss,
-		                 r_map,
-		                 mask,
-		                 rstats->rthreshold,
-		                 rstats->lthreshold,
-		                 rstats->roffset,
-		                 rstats->rsigma,
-		                 rstats->rcount);
-
-		compute_radial_stats(rstats->rthreshold,
-		                     rstats->lthreshold,
-		                     rstats->roffset,
-		                     rstats->rsigma,
-		                     rstats->rcount,
-		                     num_rad_bins,
-		                     min_snr,
-		                     acd_threshold);
-
-	}
-	return rstats;
-}
-
-
-struct peakfinder_peak_data *allocate_peak_data(int max_num_peaks)
-{
-	struct peakfinder_peak_data *pkdata;
-
-	pkdata = (struct peakfinder_peak_data*)malloc(sizeof(struct peakfinder_peak_data));
-	if ( pkdata == NULL ) {
-		return NULL;
-	}
-
-	pkdata->npix = (int *)malloc(max_num_peaks*sizeof(int));
-	if ( pkdata->npix == NULL ) {
-		free(pkdata->npix);
-		free(pkdata);
-		return NULL;
-	}
-
-	pkdata->com_fs = (float *)malloc(max_num_peaks*sizeof(float));
-	if ( pkdata->com_fs == NULL ) {
-		free(pkdata->npix);
-		free(pkdata);
-		return NULL;
-	}
-
-	pkdata->com_ss = (float *)malloc(max_num_peaks*sizeof(float));
-	if ( pkdata->com_ss == NULL ) {
-		free(pkdata->npix);
-		free(pkdata->com_fs);
-		free(pkdata);
-		return NULL;
-	}
-
-	pkdata->com_index = (int *)malloc(max_num_peaks*sizeof(int));
-	if ( pkdata->com_ss == NULL ) {
-		free(pkdata->npix);
-		free(pkdata->com_fs);
-		free(pkdata->com_ss);
-		free(pkdata);
-		return NULL;
-	}
-
-	pkdata->tot_i = (float *)malloc(max_num_peaks*sizeof(float));
-	if ( pkdata->tot_i == NULL ) {
-		free(pkdata->npix);
-		free(pkdata->com_fs);
-		free(pkdata->com_ss);
-		free(pkdata->com_index);
-		free(pkdata);
-		return NULL;
-	}
-
-	pkdata->max_i = (float *)malloc(max_num_peaks*sizeof(float));
-	if ( pkdata->max_i == NULL ) {
-		free(pkdata->npix);
-		free(pkdata->com_fs);
-		free(pkdata->com_ss);
-		free(pkdata->com_index);
-		free(pkdata->tot_i);
-		free(pkdata);
-		return NULL;
-	}
-
-	pkdata->sigma = (float *)malloc(max_num_peaks*sizeof(float));
-	if ( pkdata->sigma == NULL ) {
-		free(pkdata->npix);
-		free(pkdata->com_fs);
-		free(pkdata->com_ss);
-		free(pkdata->com_index);
-		free(pkdata->tot_i);
-		free(pkdata->max_i);
-		free(pkdata);
-		return NULL;
-	}
-
-	pkdata->snr = (float *)malloc(max_num_peaks*sizeof(float));
-	if ( pkdata->snr == NULL ) {
-		free(pkdata->npix);
-		free(pkdata->com_fs);
-		free(pkdata->com_ss);
-		free(pkdata->com_index);
-		free(pkdata->tot_i);
-		free(pkdata->max_i);
-		free(pkdata->sigma);
-		free(pkdata);
-		return NULL;
-	}
-
-	return pkdata;
-}
-
-
-static void free_peak_data(struct peakfinder_peak_data *pkdata) {
-	free(pkdata->npix);
-	free(pkdata->com_fs);
-	free(pkdata->com_ss);
-	free(pkdata->com_index);
-	free(pkdata->tot_i);
-	free(pkdata->max_i);
-	free(pkdata->sigma);
-	free(pkdata->snr);
-	free(pkdata);
-}
-
-
-static struct peakfinder_intern_data *allocate_peakfinder_intern_data(int data_size,
-                                                                      int max_pix_count)
-{
-
-	struct peakfinder_intern_data *intern_data;
-
-	intern_data = (struct peakfinder_intern_data *)malloc(sizeof(struct peakfinder_intern_data));
-	if ( intern_data == NULL ) {
-		return NULL;
-	}
-
-	intern_data->pix_in_peak_map =(char *)calloc(data_size, sizeof(char));
-	if ( intern_data->pix_in_peak_map == NULL ) {
-		free(intern_data);
-		return NULL;
-	}
-
-	intern_data->infs =(int *)calloc(data_size, sizeof(int));
-	if ( intern_data->infs == NULL ) {
-		free(intern_data->pix_in_peak_map);
-		free(intern_data);
-		return NULL;
-	}
-
-	intern_data->inss =(int *)calloc(data_size, sizeof(int));
-	if ( intern_data->inss == NULL ) {
-		free(intern_data->pix_in_peak_map);
-		free(intern_data->infs);
-		free(intern_data);
-		return NULL;
-	}
-
-	intern_data->peak_pixels =(int *)calloc(max_pix_count, sizeof(int));
-	if ( intern_data->peak_pixels == NULL ) {
-		free(intern_data->pix_in_peak_map);
-		free(intern_data->infs);
-		free(intern_data->inss);
-		free(intern_data);
-		return NULL;
-	}
-
-	return intern_data;
-}
-
-
-static void free_peakfinder_intern_data(struct peakfinder_intern_data *pfid)
-{
-	free(pfid->peak_pixels);
-	free(pfid->pix_in_peak_map);
-	free(pfid->infs);
-	free(pfid->inss);
-	free(pfid);
-}
-
-
-
 static void peak_search(int p,
                         struct peakfinder_intern_data *pfinter,
-                        float *copy, char *mask, float *r_map,
+                        float *copy, char *mask, int *r_bin,
                         float *rthreshold, float *roffset,
                         int *num_pix_in_peak, int asic_size_fs,
                         int asic_size_ss, int aifs, int aiss,
@@ -525,7 +150,7 @@ static void peak_search(int p,
 		curr_ss = pfinter->inss[p] + search_ss[k] + aiss * asic_size_ss;
 		pi = curr_fs + curr_ss * num_pix_fs;
 
-		curr_radius = (int)rint(r_map[pi]);
+		curr_radius = r_bin[pi];
 		curr_threshold = rthreshold[curr_radius];
 
 		// Above threshold?
@@ -551,7 +176,7 @@ static void peak_search(int p,
 
 
 static void search_in_ring(int ring_width, int com_fs_int, int com_ss_int,
-                           float *copy, float *r_map,
+                           float *copy, int *r_bin,
                            float *rthreshold, float *roffset,
                            char *pix_in_peak_map, char *mask, int asic_size_fs,
                            int asic_size_ss, int aifs, int aiss,
@@ -601,7 +226,7 @@ static void search_in_ring(int ring_width, int com_fs_int, int com_ss_int,
 			curr_ss = com_ss_int + ssj + aiss * asic_size_ss;
 			pi = curr_fs + curr_ss * num_pix_fs;
 
-			curr_radius = (int)rint(r_map[pi]);
+			curr_radius = r_bin[pi];
 			curr_threshold = rthreshold[curr_radius];
 
 			// Intensity above background ??? just intensity?
@@ -632,7 +257,7 @@ static void search_in_ring(int ring_width, int com_fs_int, int com_ss_int,
 			*local_sigma = 0.01;
 		}
 	} else {
-		local_radius = (int)rint(r_map[(int)rint(com_idx)]);
+		local_radius = r_bin[com_idx];
 		*local_offset = roffset[local_radius];
 		*local_sigma = 0.01;
 	}
@@ -643,9 +268,8 @@ static void process_panel(int asic_size_fs, int asic_size_ss, int num_pix_fs,
                           int aiss, int aifs, float *rthreshold,
                           float *roffset, int *peak_count,
                           float *copy, struct peakfinder_intern_data *pfinter,
-                          float *r_map, char *mask, int *npix, float *com_fs,
-                          float *com_ss, int *com_index, float *tot_i,
-                          float *max_i, float *sigma, float *snr,
+                          int *r_bin, char *mask,
+                          std::vector<peakfinder_peak> &peaks,
                           int min_pix_count, int max_pix_count,
                           int local_bg_radius, float min_snr, int max_n_peaks)
 {
@@ -663,7 +287,7 @@ static void process_panel(int asic_size_fs, int asic_size_ss, int num_pix_fs,
 			pxidx = (pxss + aiss * asic_size_ss) * num_pix_fs +
 			pxfs + aifs * asic_size_fs;
 
-			curr_rad = (int)rint(r_map[pxidx]);
+			curr_rad = r_bin[pxidx];
 			curr_thresh = rthreshold[curr_rad];
 
 			if ( copy[pxidx] > curr_thresh
@@ -699,11 +323,13 @@ static void process_panel(int asic_size_fs, int asic_size_ss, int num_pix_fs,
 				do {
 					lt_num_pix_in_pk = num_pix_in_peak;
 
-					// Loop through points known to be within this peak
-					for ( p=0; p<=num_pix_in_peak; p++ ) { //changed from 1 to 0 by O.Y.
+					// Loop through points known to be within this peak; the seed is
+					// searched before it is counted, but no entry beyond the peak is,
+					// as that is left over from whatever peak the thread grew before
+					for ( p=0; p<num_pix_in_peak || p==0; p++ ) { //changed from 1 to 0 by O.Y.
 						peak_search(p,
 						            pfinter, copy, mask,
-						            r_map,
+						            r_bin,
 						            rthreshold,
 						            roffset,
 						            &num_pix_in_peak,
@@ -744,7 +370,7 @@ static void process_panel(int asic_size_fs, int asic_size_ss, int num_pix_fs,
 
 				search_in_ring(ring_width, peak_com_fs_int,
 				               peak_com_ss_int,
-				               copy, r_map, rthreshold,
+				               copy, r_bin, rthreshold,
 				               roffset,
 				               pfinter->pix_in_peak_map,
 				               mask, asic_size_fs,
@@ -836,20 +462,21 @@ static void process_panel(int asic_size_fs, int asic_size_ss, int num_pix_fs,
 					int peak_com_idx;
 					peak_com_idx = (int)rint(peak_com_fs) + (int)rint(peak_com_ss) *
 						                num_pix_fs;
-					// Remember peak information
+					// Remember peak information; peaks beyond max_n_peaks in this
+					// panel can not make it into the merged list
 					if ( *peak_count < max_n_peaks ) {
 
-						int pidx;
-						pidx = *peak_count;
-
-						npix[pidx] = num_pix_in_peak;
-						com_fs[pidx] = peak_com_fs;
-						com_ss[pidx] = peak_com_ss;
-						com_index[pidx] = peak_com_idx;
-						tot_i[pidx] = peak_tot_i;
-						max_i[pidx] = peak_max_i;
-						sigma[pidx] = local_sigma;
-						snr[pidx] = peak_snr;
+						peakfinder_peak pk;
+
+						pk.npix = num_pix_in_peak;
+						pk.com_fs = peak_com_fs;
+						pk.com_ss = peak_com_ss;
+						pk.com_index = peak_com_idx;
+						pk.tot_i = peak_tot_i;
+						pk.max_i = peak_max_i;
+						pk.sigma = local_sigma;
+						pk.snr = peak_snr;
+						peaks.push_back(pk);
 					}
 					*peak_count += 1;
 				}
@@ -859,54 +486,227 @@ static void process_panel(int asic_size_fs, int asic_size_ss, int num_pix_fs,
 }
 
 
-static int peakfinder8_base(float *roffset, float *rthreshold,
-                            float *data, char *mask, float *r_map,
-                            int asic_size_fs, int num_asics_fs,
-                            int asic_size_ss, int num_asics_ss,
-                            int max_n_peaks, int *num_found_peaks,
-                            int *npix, float *com_fs,
-                            float *com_ss, int *com_index, float *tot_i,
-                            float *max_i, float *sigma, float *snr,
-                            int min_pix_count, int max_pix_count,
-                            int local_bg_radius, float min_snr,
-                            char* outliersMask)
+PeakFinder8::PeakFinder8(float *pix_r, char *mask_in,
+                         long asic_nx, long asic_ny, long nasics_x, long nasics_y)
 {
+	int num_panels, num_pix_tot;
+	int pan, ifs, iss, pidx;
+	float max_r;
 
-	int num_pix_fs, num_pix_ss, num_pix_tot;
-	int aifs, aiss;
-	int peak_count;
-	struct peakfinder_intern_data *pfinter;
-
+	asic_size_fs = asic_nx;
+	asic_size_ss = asic_ny;
+	num_asics_fs = nasics_x;
+	num_asics_ss = nasics_y;
 	num_pix_fs = asic_size_fs * num_asics_fs;
 	num_pix_ss = asic_size_ss * num_asics_ss;
 	num_pix_tot = num_pix_fs * num_pix_ss;
+	num_panels = num_asics_fs * num_asics_ss;
+
+	max_r = -1e9;
+	for ( pidx=0 ; pidx<num_pix_tot ; pidx++ ) {
+		if ( pix_r[pidx] > max_r ) {
+			max_r = pix_r[pidx];
+		}
+	}
+	n_rad_bins = (int)ceil(max_r) + 1;
+
+	rbin.resize(num_pix_tot);
+	mask.assign(mask_in, mask_in + num_pix_tot);
+	for ( pidx=0 ; pidx<num_pix_tot ; pidx++ ) {
+		rbin[pidx] = (int)rint(pix_r[pidx]);
+	}
+
+	// Only the radial bins spanned by a panel get partial sums for it
+	panel_rmin.assign(num_panels, 0);
+	panel_rmax.assign(num_panels, -1);
+	panel_roff.assign(num_panels + 1, 0);
+	for ( pan=0 ; pan<num_panels ; pan++ ) {
+		int aiss = pan / num_asics_fs;
+		int aifs = pan % num_asics_fs;
+		int rmin = n_rad_bins;
+		int rmax = -1;
+		for ( iss=aiss*asic_size_ss ; iss<(aiss+1)*asic_size_ss ; iss++ ) {
+			for ( ifs=aifs*asic_size_fs ; ifs<(aifs+1)*asic_size_fs ; ifs++ ) {
+				pidx = iss * num_pix_fs + ifs;
+				if ( mask[pidx] == 0 ) continue;
+				rmin = std::min(rmin, rbin[pidx]);
+				rmax = std::max(rmax, rbin[pidx]);
+			}
+		}
+		if ( rmax >= rmin ) {
+			panel_rmin[pan] = rmin;
+			panel_rmax[pan] = rmax;
+		}
+		panel_roff[pan+1] = panel_roff[pan] + panel_rmax[pan] - panel_rmin[pan] + 1;
+	}
+	part_sum.resize(panel_roff[num_panels]);
+	part_sum2.resize(panel_roff[num_panels]);
+	part_count.resize(panel_roff[num_panels]);
+
+	roffset.resize(n_rad_bins);
+	rthreshold.resize(n_rad_bins);
+	lthreshold.resize(n_rad_bins);
+	rsigma.resize(n_rad_bins);
+
+	pix_in_peak_map.resize(num_pix_tot);
+	panel_peaks.resize(num_panels);
+	panel_count.resize(num_panels);
+}
+
+
+// Compute sigma and average of data values at each radius
+// From this, compute the ADC threshold to be applied at each radius
+// Iterate a few times to reduce the effect of positive outliers (ie: peaks)
+void PeakFinder8::compute_radial_stats(float *data, int iterations,
+                                       float min_snr, float acd_threshold)
+{
+	int num_panels = num_asics_fs * num_asics_ss;
+	std::vector<double> rsum(n_rad_bins), rsum2(n_rad_bins);
+	std::vector<int> rcount(n_rad_bins);
+	int it_counter, pan, ri;
+
+	std::fill(rthreshold.begin(), rthreshold.end(), 1e9);
+	std::fill(lthreshold.begin(), lthreshold.end(), -1e9);
+
+	for ( it_counter=0 ; it_counter<iterations ; it_counter++ ) {
+
+		// Partial sums of the panels, summed in panel order below so that the
+		// thresholds do not depend on the number of threads
+		#pragma omp parallel for schedule(dynamic,1)
+		for ( pan=0 ; pan<num_panels ; pan++ ) {
+			int aiss = pan / num_asics_fs;
+			int aifs = pan % num_asics_fs;
+			int r0 = panel_rmin[pan];
+			double *psum = &part_sum[panel_roff[pan]] - r0;
+			double *psum2 = &part_sum2[panel_roff[pan]] - r0;
+			int *pcount = &part_count[panel_roff[pan]] - r0;
+			int iss, ifs, pidx, curr_r, rj;
+			float value;
+
+			for ( rj=r0 ; rj<=panel_rmax[pan] ; rj++ ) {
+				psum[rj] = 0;
+				psum2[rj] = 0;
+				pcount[rj] = 0;
+			}
+
+			for ( iss=aiss*asic_size_ss ; iss<(aiss+1)*asic_size_ss ; iss++ ) {
+				for ( ifs=aifs*asic_size_fs ; ifs<(aifs+1)*asic_size_fs ; ifs++ ) {
+					pidx = iss * num_pix_fs + ifs;
+					if ( mask[pidx] != 0 ) {
+						curr_r = rbin[pidx];
+						value = data[pidx];
+						if ( value < rthreshold[curr_r]
+						  && value > lthreshold[curr_r] )
+						{
+							psum[curr_r] += value;
+							psum2[curr_r] += (value * value);
+							pcount[curr_r] += 1;
+						}
+					}
+				}
+			}
+		}
 
-	pfinter = allocate_peakfinder_intern_data(num_pix_tot, max_pix_count);
-	if ( pfinter == NULL ) {
-		return 1;
+		std::fill(rsum.begin(), rsum.end(), 0);
+		std::fill(rsum2.begin(), rsum2.end(), 0);
+		std::fill(rcount.begin(), rcount.end(), 0);
+		for ( pan=0 ; pan<num_panels ; pan++ ) {
+			int k = panel_roff[pan];
+			for ( ri=panel_rmin[pan] ; ri<=panel_rmax[pan] ; ri++, k++ ) {
+				rsum[ri] += part_sum[k];
+				rsum2[ri] += part_sum2[k];
+				rcount[ri] += part_count[k];
+			}
+		}
+
+		::compute_radial_stats(&rsum[0], &rsum2[0], &rcount[0],
+		                       &rthreshold[0], &lthreshold[0],
+		                       &roffset[0], &rsigma[0],
+		                       n_rad_bins, min_snr, acd_threshold);
 	}
+}
+
 
-	peak_count = 0;
-
-	// Loop over modules (nxn array)
-	for ( aiss=0 ; aiss<num_asics_ss ; aiss++ ) {
-		for ( aifs=0 ; aifs<num_asics_fs ; aifs++ ) {                 // ??? to change to proper panels need
-			process_panel(asic_size_fs, asic_size_ss, num_pix_fs, // change copy, mask, r_map
-			              aiss, aifs, rthreshold, roffset,
-			              &peak_count, data, pfinter, r_map, mask,
-			              npix, com_fs, com_ss, com_index, tot_i,
-			              max_i, sigma, snr, min_pix_count,
-			              max_pix_count, local_bg_radius, min_snr,
-			              max_n_peaks);
+int PeakFinder8::find(tPeakList *peaklist, float *data,
+                      float ADCthresh, float hitfinderMinSNR,
+                      long hitfinderMinPixCount, long hitfinderMaxPixCount,
+                      long hitfinderLocalBGRadius, char* outliersMask)
+{
+	int num_panels = num_asics_fs * num_asics_ss;
+	int max_num_peaks = peaklist->nPeaks_max;
+	int max_pix_count = hitfinderMaxPixCount;
+	int nthreads = omp_get_max_threads();
+	int iterations = 5;
+	int pan, pki;
+	long peaks_to_add;
+
+	// Compute radial statistics as 1 function (O.Y.)
+	compute_radial_stats(data, iterations, hitfinderMinSNR, ADCthresh);
+
+	// Workspaces persist between calls; they only grow
+	if ( (int)workspaces.size() < nthreads ) {
+		workspaces.resize(nthreads);
+	}
+	for ( pki=0 ; pki<nthreads ; pki++ ) {
+		peakfinder_intern_data &ws = workspaces[pki];
+		ws.pix_in_peak_map = &pix_in_peak_map[0];
+		if ( (int)ws.infs.size() < asic_size_fs * asic_size_ss ) {
+			ws.infs.resize(asic_size_fs * asic_size_ss);
+			ws.inss.resize(asic_size_fs * asic_size_ss);
+		}
+		if ( (int)ws.peak_pixels.size() < std::max(max_pix_count, 1) ) {
+			ws.peak_pixels.resize(std::max(max_pix_count, 1));
 		}
 	}
-	*num_found_peaks = peak_count;
+
+	// Loop over modules (nxn array); the search of a panel stays within it,
+	// so the threads share the pixel in peak map without conflicts
+	#pragma omp parallel for schedule(dynamic,1)
+	for ( pan=0 ; pan<num_panels ; pan++ ) {
+		int aiss = pan / num_asics_fs;
+		int aifs = pan % num_asics_fs;
+		int iss;
+
+		for ( iss=aiss*asic_size_ss ; iss<(aiss+1)*asic_size_ss ; iss++ ) {
+			memset(&pix_in_peak_map[iss * num_pix_fs + aifs * asic_size_fs], 0,
+			       asic_size_fs * sizeof(char));
+		}
+
+		panel_peaks[pan].clear();
+		panel_count[pan] = 0;
+		process_panel(asic_size_fs, asic_size_ss, num_pix_fs,
+		              aiss, aifs, &rthreshold[0], &roffset[0],
+		              &panel_count[pan], data,
+		              &workspaces[omp_get_thread_num()],
+		              &rbin[0], &mask[0], panel_peaks[pan],
+		              hitfinderMinPixCount, max_pix_count,
+		              hitfinderLocalBGRadius, hitfinderMinSNR,
+		              max_num_peaks);
+	}
 
 	if (outliersMask != NULL) {
-		memcpy(outliersMask, pfinter->pix_in_peak_map, num_pix_tot*sizeof(char));
+		memcpy(outliersMask, &pix_in_peak_map[0], num_pix()*sizeof(char));
+	}
+
+	// Merge in panel order, as the panels were searched by a single thread
+	peaks_to_add = 0;
+	for ( pan=0 ; pan<num_panels ; pan++ ) {
+		const std::vector<peakfinder_peak> &peaks = panel_peaks[pan];
+		for ( pki=0 ; pki<(int)peaks.size() && peaks_to_add<max_num_peaks ; pki++ ) {
+			const peakfinder_peak &pk = peaks[pki];
+			peaklist->peak_maxintensity[peaks_to_add] = pk.max_i;
+			peaklist->peak_totalintensity[peaks_to_add] = pk.tot_i;
+			peaklist->peak_sigma[peaks_to_add] = pk.sigma;
+			peaklist->peak_snr[peaks_to_add] = pk.snr;
+			peaklist->peak_npix[peaks_to_add] = pk.npix;
+			peaklist->peak_com_x[peaks_to_add] = pk.com_fs;
+			peaklist->peak_com_y[peaks_to_add] = pk.com_ss;
+			peaklist->peak_com_index[peaks_to_add] = pk.com_index;
+			peaks_to_add++;
+		}
 	}
 
-	free_peakfinder_intern_data(pfinter);
+	peaklist->nPeaks = peaks_to_add;
 
 	return 0;
 }
@@ -915,94 +715,18 @@ static int peakfinder8_base(float *roffset, float *rthreshold,
 // Count peaks by searching for connected pixels above threshold
 // Includes modifications during Cherezov December 2014 LE80
 // Anton Barty
+//
+// Sets up the radial bins on each call; use PeakFinder8 to process many events
+// with the same layout, radius map and mask.
 int peakfinder8(tPeakList *peaklist, float *data, char *mask, float *pix_r,
                 long asic_nx, long asic_ny, long nasics_x, long nasics_y,
                 float ADCthresh, float hitfinderMinSNR,
                 long hitfinderMinPixCount, long hitfinderMaxPixCount,
                 long hitfinderLocalBGRadius, char* outliersMask)
 {
-	struct radial_stats *rstats;
-	struct peakfinder_peak_data *pkdata;
-	int iterations;
-	int num_pix_fs, num_pix_ss;
-	int num_pix_tot;
-	int max_num_peaks;
-	int num_found_peaks;
-	int ret;
-	int pki;
-	int peaks_to_add;
-
-	max_num_peaks = peaklist->nPeaks_max;
-
-	// Derived values
-	num_pix_fs = asic_nx * nasics_x;
-	num_pix_ss = asic_ny * nasics_y;
-	num_pix_tot = num_pix_fs * num_pix_ss;
+	PeakFinder8 pf8(pix_r, mask, asic_nx, asic_ny, nasics_x, nasics_y);
 
-	// Compute radial statistics as 1 function (O.Y.)
-	iterations = 5;
-	rstats = compute_radial_bins(data, mask, num_pix_tot, pix_r,
-	                             iterations, hitfinderMinSNR, ADCthresh,
-	                             num_pix_fs, num_pix_ss);
-
-	pkdata = allocate_peak_data(max_num_peaks);
-	if ( pkdata == NULL ) {
-		free_radial_stats(rstats);
-		return 1;
-	}
-
-	num_found_peaks = 0;
-
-	ret = peakfinder8_base(rstats->roffset,
-	                       rstats->rthreshold,
-	                       data,
-	                       mask,
-	                       pix_r,
-	                       asic_nx, nasics_x,
-	                       asic_ny, nasics_y,
-	                       max_num_peaks  ,
-	                       &num_found_peaks,
-	                       pkdata->npix,
-	                       pkdata->com_fs,
-	                       pkdata->com_ss,
-	                       pkdata->com_index,
-	                       pkdata->tot_i,
-	                       pkdata->max_i,
-	                       pkdata->sigma,
-	                       pkdata->snr,
-	                       hitfinderMinPixCount,
-	                       hitfinderMaxPixCount,
-	                       hitfinderLocalBGRadius,
-	                       hitfinderMinSNR,
-	                       outliersMask);
-
-	if ( ret != 0 ) {
-		free_radial_stats(rstats);
-		free_peak_data(pkdata);
-		return 1;
-	}
-
-	peaks_to_add = num_found_peaks;
-
-	if ( num_found_peaks > max_num_peaks ) {
-		peaks_to_add = max_num_peaks;
-	}
-
-	for ( pki=0 ; pki<peaks_to_add ; pki++ ) {
-
-		peaklist->peak_maxintensity[pki] = pkdata->max_i[pki];
-		peaklist->peak_totalintensity[pki] = pkdata->tot_i[pki];
-		peaklist->peak_sigma[pki] = pkdata->sigma[pki];
-		peaklist->peak_snr[pki] = pkdata->snr[pki];
-		peaklist->peak_npix[pki] = pkdata->npix[pki];
-		peaklist->peak_com_x[pki] = pkdata->com_fs[pki];
-		peaklist->peak_com_y[pki] = pkdata->com_ss[pki];
-		peaklist->peak_com_index[pki] = pkdata->com_index[pki];
-	}
-
-	peaklist->nPeaks = peaks_to_add;
-
-	free_radial_stats(rstats);
-	free_peak_data(pkdata);
-	return 0;
+	return pf8.find(peaklist, data, ADCthresh, hitfinderMinSNR,
+	                hitfinderMinPixCount, hitfinderMaxPixCount,
+	                hitfinderLocalBGRadius, outliersMask);
 }
@@ -18,6 +18,8 @@
 #ifndef PEAKFINDER8_H
 #define PEAKFINDER8_H
 
+#include <vector>
+
 typedef struct {
 public:
 	long	    nPeaks;
@@ -54,4 +56,75 @@ int peakfinder8(tPeakList *peaklist, float *data, char *mask, float *pix_r,
 				long hitfinderMinPixCount, long hitfinderMaxPixCount,
 				long hitfinderLocalBGRadius, char* outliersMask);
 
+
+// Per-thread scratch arrays of the connected pixel search in one panel
+struct peakfinder_intern_data
+{
+	char *pix_in_peak_map;		// of the whole image, shared by the threads
+	std::vector<int> infs;		// panel pixels of the peak being grown
+	std::vector<int> inss;
+	std::vector<int> peak_pixels;	// image pixels of the peak, up to max_pix_count
+};
+
+
+struct peakfinder_peak
+{
+	int npix;
+	float com_fs;
+	float com_ss;
+	int com_index;
+	float tot_i;
+	float max_i;
+	float sigma;
+	float snr;
+};
+
+
+// Peakfinder8 for a fixed detector layout, radius map and mask.
+//
+// The radial bin of each pixel is computed once, in the constructor, and the
+// radial statistics, the search workspaces of the threads and the peak lists of
+// the panels are kept between calls of find().  The panels are searched in
+// parallel with OpenMP; their peak lists are merged in panel order, so the
+// result does not depend on the number of threads and is that of peakfinder8().
+class PeakFinder8
+{
+public:
+	PeakFinder8(float *pix_r, char *mask,
+	            long asic_nx, long asic_ny, long nasics_x, long nasics_y);
+
+	int find(tPeakList *peaklist, float *data,
+	         float ADCthresh, float hitfinderMinSNR,
+	         long hitfinderMinPixCount, long hitfinderMaxPixCount,
+	         long hitfinderLocalBGRadius, char* outliersMask);
+
+	long num_pix() const { return num_pix_fs * num_pix_ss; }
+	int num_rad_bins() const { return n_rad_bins; }
+
+private:
+	void compute_radial_stats(float *data, int iterations,
+	                          float min_snr, float acd_threshold);
+
+	int asic_size_fs, asic_size_ss;
+	int num_asics_fs, num_asics_ss;
+	int num_pix_fs, num_pix_ss;
+	int n_rad_bins;
+
+	std::vector<int> rbin;		// rint(pix_r) of each pixel
+	std::vector<char> mask;
+
+	// Radial bins spanned by the unmasked pixels of each panel, and the offsets
+	// of the panel in the partial sums
+	std::vector<int> panel_rmin, panel_rmax, panel_roff;
+	std::vector<double> part_sum, part_sum2;
+	std::vector<int> part_count;
+
+	std::vector<float> roffset, rthreshold, lthreshold, rsigma;
+
+	std::vector<char> pix_in_peak_map;
+	std::vector<peakfinder_intern_data> workspaces;
+	std::vector<std::vector<peakfinder_peak> > panel_peaks;
+	std::vector<int> panel_count;
+};
+
 #endif // PEAKFINDER8_H
@@ -60,6 +60,55 @@ cdef extern from "peakfinder8.hh":
                     long hitfinderMinPixCount, long hitfinderMaxPixCount,
                     long hitfinderLocalBGRadius, char *outliersMask)
 
+    cppclass cPeakFinder8 "PeakFinder8":
+        cPeakFinder8(float *pix_r, char *mask, long asic_nx, long asic_ny,
+                     long nasics_x, long nasics_y) except +
+        int find(tPeakList *peaklist, float *data, float ADCthresh,
+                 float hitfinderMinSNR, long hitfinderMinPixCount,
+                 long hitfinderMaxPixCount, long hitfinderLocalBGRadius,
+                 char *outliersMask)
+        long num_pix()
+
+
+cdef _peak_list_tuple(tPeakList *peak_list, int max_num_peaks):
+    cdef int i
+    cdef float peak_x, peak_y, peak_value
+    cdef vector[double] peak_list_x
+    cdef vector[double] peak_list_y
+    cdef vector[long] peak_list_index
+    cdef vector[double] peak_list_value
+    cdef vector[double] peak_list_npix
+    cdef vector[double] peak_list_maxi
+    cdef vector[double] peak_list_sigma
+    cdef vector[double] peak_list_snr
+
+    num_peaks = peak_list.nPeaks
+
+    if num_peaks > max_num_peaks:
+        num_peaks = max_num_peaks
+
+    for i in range(0, num_peaks):
+
+        peak_x = peak_list.peak_com_x[i]
+        peak_y = peak_list.peak_com_y[i]
+        peak_index = peak_list.peak_com_index[i]
+        peak_value = peak_list.peak_totalintensity[i]
+        peak_npix = peak_list.peak_npix[i]
+        peak_maxi = peak_list.peak_maxintensity[i]
+        peak_sigma = peak_list.peak_sigma[i]
+        peak_snr = peak_list.peak_snr[i]
+
+        peak_list_x.push_back(peak_x)
+        peak_list_y.push_back(peak_y)
+        peak_list_index.push_back(peak_index)
+        peak_list_value.push_back(peak_value)
+        peak_list_npix.push_back(peak_npix)
+        peak_list_maxi.push_back(peak_maxi)
+        peak_list_sigma.push_back(peak_sigma)
+        peak_list_snr.push_back(peak_snr)
+
+    return (peak_list_x, peak_list_y, peak_list_value, peak_list_index,
+            peak_list_npix, peak_list_maxi, peak_list_sigma, peak_list_snr)
 
 def peakfinder_8(int max_num_peaks, float[:,::1] data, char[:,::1] mask,
                  float[:,::1] pix_r, long asic_nx, long asic_ny, long nasics_x,
@@ -118,42 +167,7 @@ def peakfinder_8(int max_num_peaks, float[:,::1] data, char[:,::1] mask,
                 hitfinder_min_pix_count, hitfinder_max_pix_count,
                 hitfinder_local_bg_radius, NULL)
 
-    cdef int i
-    cdef float peak_x, peak_y, peak_value
-    cdef vector[double] peak_list_x
-    cdef vector[double] peak_list_y
-    cdef vector[long] peak_list_index
-    cdef vector[double] peak_list_value
-    cdef vector[double] peak_list_npix
-    cdef vector[double] peak_list_maxi
-    cdef vector[double] peak_list_sigma
-    cdef vector[double] peak_list_snr
-
-    num_peaks = peak_list.nPeaks
-
-    if num_peaks > max_num_peaks:
-        num_peaks = max_num_peaks
-
-    for i in range(0, num_peaks):
-
-        peak_x = peak_list.peak_com_x[i]
-        peak_y = peak_list.peak_com_y[i]
-        peak_index = peak_list.peak_com_index[i]
-        peak_value = peak_list.peak_totalintensity[i]
-        peak_npix = peak_list.peak_npix[i]
-        peak_maxi = peak_list.peak_maxintensity[i]
-        peak_sigma = peak_list.peak_sigma[i]
-        peak_snr = peak_list.peak_snr[i]
-
-        peak_list_x.push_back(peak_x)
-        peak_list_y.push_back(peak_y)
-        peak_list_index.push_back(peak_index)
-        peak_list_value.push_back(peak_value)
-        peak_list_npix.push_back(peak_npix)
-        peak_list_maxi.push_back(peak_maxi)
-        peak_list_sigma.push_back(peak_sigma)
-        peak_list_snr.push_back(peak_snr)
-
+    result = _peak_list_tuple(&peak_list, max_num_peaks)
     freePeakList(peak_list)
 
 
@@ -184,5 +198,51 @@ def peakfinder_8(int max_num_peaks, float[:,::1] data, char[:,::1] mask,
     #
     # peak_list_snr: a list storing the signal-to-noise ratio of each peak
     #            against the local background
-    return (peak_list_x, peak_list_y, peak_list_value, peak_list_index,
-            peak_list_npix, peak_list_maxi, peak_list_sigma, peak_list_snr)
+    return result
+
+
+cdef class PeakFinder8:
+    # peakfinder_8 for many frames of the same layout: the radial bins of
+    # pix_r and the mask are set up once, the work buffers and the peak list
+    # are kept between frames, and the ASICs are searched in parallel. The
+    # arguments are those of peakfinder_8 and find returns the same tuple.
+    #
+    #     pf8 = PeakFinder8(pix_r, mask, asic_nx, asic_ny, nasics_x, nasics_y)
+    #     for each frame:
+    #         peaks = pf8.find(max_num_peaks, data, adc_thresh, ...)
+    cdef cPeakFinder8 *_pf8
+    cdef tPeakList _peak_list
+    cdef long _max_num_peaks    # allocated size of the peak list
+
+    def __cinit__(self, float[:,::1] pix_r, char[:,::1] mask, long asic_nx,
+                  long asic_ny, long nasics_x, long nasics_y):
+        if pix_r.shape[0] * pix_r.shape[1] != asic_nx * asic_ny * nasics_x * nasics_y \
+           or mask.shape[0] != pix_r.shape[0] or mask.shape[1] != pix_r.shape[1]:
+            raise ValueError('pix_r and mask must have asic_nx*asic_ny*nasics_x*nasics_y pixels')
+        self._pf8 = new cPeakFinder8(&pix_r[0, 0], &mask[0, 0], asic_nx, asic_ny,
+                                     nasics_x, nasics_y)
+
+    def __dealloc__(self):
+        if self._max_num_peaks > 0:
+            freePeakList(self._peak_list)
+        del self._pf8
+
+    def find(self, int max_num_peaks, float[:,::1] data, float adc_thresh,
+             float hitfinder_min_snr, long hitfinder_min_pix_count,
+             long hitfinder_max_pix_count, long hitfinder_local_bg_radius):
+        if data.shape[0] * data.shape[1] != self._pf8.num_pix():
+            raise ValueError('data does not have the shape of pix_r')
+
+        # the peak list only grows
+        if max_num_peaks > self._max_num_peaks:
+            if self._max_num_peaks > 0:
+                freePeakList(self._peak_list)
+            allocatePeakList(&self._peak_list, max_num_peaks)
+            self._max_num_peaks = max_num_peaks
+        self._peak_list.nPeaks_max = max_num_peaks
+
+        self._pf8.find(&self._peak_list, &data[0, 0], adc_thresh, hitfinder_min_snr,
+                       hitfinder_min_pix_count, hitfinder_max_pix_count,
+                       hitfinder_local_bg_radius, NULL)
+
+        return _peak_list_tuple(&self._peak_list, max_num_peaks)
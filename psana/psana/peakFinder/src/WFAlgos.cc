@@ -12,7 +12,8 @@ namespace psalg {
 template <typename T>
 void
 _add_edge(
-  const std::vector<T>& v,
+  const T* v,
+  index_t  size,
   bool     rising, // leading positive or trailing negative edge
   double   fraction,
   double   deadtime,
@@ -39,11 +40,11 @@ _add_edge(
   double edge_v = fraction;
   index_t i=start;
   if (rising) {
-    while(v[i] < edge_v)
+    while(i+1<size && v[i] < edge_v)
       i++;
   }
   else { // trailing positive edge, or leading negative edge
-    while(v[i] > edge_v)
+    while(i+1<size && v[i] > edge_v)
       i++;
   }
   double edge = i>0 ?
@@ -60,6 +61,33 @@ _add_edge(
 }
 
 
+// samples per vectorized compare of find_edges
+static const index_t EDGE_BLOCK = 64;
+
+/// Index of the first sample from k which is over threshold, or size
+template <typename T>
+static inline index_t
+_next_over(const T* wf, index_t k, index_t size, T threshold, bool rising)
+{
+  // whole blocks below threshold are skipped by a branch-free reduction
+  for(; k+EDGE_BLOCK<=size; k+=EDGE_BLOCK) {
+    const T* w = wf+k;
+    int any = 0;
+    if(rising) {
+#pragma omp simd reduction(|:any)
+      for(index_t i=0; i<EDGE_BLOCK; i++) any |= (w[i] > threshold);
+    }
+    else {
+#pragma omp simd reduction(|:any)
+      for(index_t i=0; i<EDGE_BLOCK; i++) any |= (w[i] < threshold);
+    }
+    if(any) break;
+  }
+  if(rising) {for(; k<size && !(wf[k] > threshold); k++);}
+  else       {for(; k<size && !(wf[k] < threshold); k++);}
+  return k;
+}
+
 //find leading or trailing edges
 template <typename T>
 index_t
@@ -67,7 +95,8 @@ find_edges(
   index_t  npkmax,
   T*       pkvals,
   index_t* pkinds,
-  const std::vector<T>& wf,
+  const T* wf,
+  index_t  size,
   double   baseline_f8,
   double   threshold_f8,
   double   fraction,
@@ -75,7 +104,7 @@ find_edges(
   bool     leading_edge)
 {
   //std::cout << "In WFAlgos.cc - find_edges wf: ";
-  //for(typename std::vector<T>::const_iterator i=wf.begin(); i<wf.end(); ++i) std::cout << *i << ' ';
+  //for(index_t i=0; i<size; ++i) std::cout << wf[i] << ' ';
   /*
     std::cout << "In WFAlgos.cc - find_edges input parameters: "
               << " baseline:" << baseline_f8
@@ -83,7 +112,7 @@ find_edges(
               << " fraction:" << fraction
               << " deadtime:" << deadtime
               << " leading_edge:" << leading_edge
-              << " wf.size():" << wf.size()
+              << " size:" << size
               << '\n';
   */
 
@@ -97,7 +126,10 @@ find_edges(
 
   index_t  start  = 0;
   index_t  k=0;
-  for(; k<wf.size(); k++) {
+  for(; k<size; k++) {
+    // samples which are not over threshold change nothing until the next crossing
+    if(!crossed && (k=_next_over(wf, k, size, threshold, rising))==size) break;
+
     T y = wf[k];
     bool over =
        (rising && y>threshold) ||
@@ -111,7 +143,7 @@ find_edges(
     else if(crossed && !over) {
       // add peak if its width exceeds deadtime
       if(double(k-start)>deadtime)
-        _add_edge(wf, rising==leading_edge, fraction*(peak-baseline)+baseline,
+        _add_edge(wf, size, rising==leading_edge, fraction*(peak-baseline)+baseline,
                      deadtime, peak, start, last, npk, pkvals, pkinds);
       crossed = false;
       if(!(npk < npkmax)) break;
@@ -126,7 +158,7 @@ find_edges(
 
   // the last edge may not have fallen back below threshold
   if(crossed && (npk < npkmax) && (double(k-start)>deadtime)) {
-    _add_edge(wf, rising==leading_edge, fraction*(peak-baseline)+baseline,
+    _add_edge(wf, size, rising==leading_edge, fraction*(peak-baseline)+baseline,
                  deadtime, peak, start, last, npk, pkvals, pkinds);
   }
 
@@ -138,12 +170,59 @@ find_edges(
   return npk;
 }
 
+
+template <typename T>
+index_t
+find_edges(
+  index_t  npkmax,
+  T*       pkvals,
+  index_t* pkinds,
+  const std::vector<T>& wf,
+  double   baseline,
+  double   threshold,
+  double   fraction,
+  double   deadtime,
+  bool     leading_edge)
+{
+  return find_edges(npkmax, pkvals, pkinds, wf.data(), (index_t)wf.size(),
+                    baseline, threshold, fraction, deadtime, leading_edge);
+}
+
+
+template <typename T>
+void
+find_edges_batch(
+  index_t  nchan,
+  index_t  nsamples,
+  index_t  stride,
+  const T* wfs,
+  const EdgePars* pars,
+  index_t  npkmax,
+  T*       pkvals,
+  index_t* pkinds,
+  index_t* npks)
+{
+  // a thread per channel pays off only for long waveforms
+  const bool parallel = nchan>1 && size_t(nchan)*nsamples >= (1<<16);
+#pragma omp parallel for schedule(dynamic) if(parallel)
+  for(index_t c=0; c<nchan; c++) {
+    const EdgePars& p = pars[c];
+    npks[c] = find_edges(npkmax, pkvals+size_t(c)*npkmax, pkinds+size_t(c)*npkmax,
+                         wfs+size_t(c)*stride, nsamples,
+                         p.baseline, p.threshold, p.fraction, p.deadtime, p.leading_edge);
+  }
+}
+
 #ifdef INST_FIND_EDGES
 #undef INST_FIND_EDGES
 #endif
 #define INST_FIND_EDGES(T)\
   template index_t find_edges<T>\
-    (index_t,T*,index_t*,const std::vector<T>&,double,double,double,double,bool);
+    (index_t,T*,index_t*,const std::vector<T>&,double,double,double,double,bool);\
+  template index_t find_edges<T>\
+    (index_t,T*,index_t*,const T*,index_t,double,double,double,double,bool);\
+  template void find_edges_batch<T>\
+    (index_t,index_t,index_t,const T*,const EdgePars*,index_t,T*,index_t*,index_t*);
 
 INST_FIND_EDGES(double)
 INST_FIND_EDGES(float)
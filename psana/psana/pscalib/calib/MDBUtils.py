@@ -933,6 +933,21 @@ def dict_from_data_string(s):
     return d
 
 
+def ndarray_from_npy(s):
+    """Returns ndarray of npy data s, optionally gzip-compressed, or None if s does not decode as npy,
+       e.g. raw data which happen to start as gzip or npy does.
+    """
+    if s[:2] == b'\x1f\x8b': # gzip-compressed npy
+        import gzip, zlib
+        try: s = gzip.decompress(s)
+        except (OSError, EOFError, zlib.error): return None
+    if s[:6] != b'\x93NUMPY': # npy, with its own dtype and shape
+        return None
+    from io import BytesIO
+    try: return np.load(BytesIO(s))
+    except (ValueError, EOFError, OSError): return None
+
+
 def object_from_data_string(s, doc):
     """Returns str, ndarray, or dict"""
     data_type = doc.get('data_type', None)
@@ -949,6 +964,9 @@ def object_from_data_string(s, doc):
         return data
 
     elif data_type == 'ndarray':
+        nda = ndarray_from_npy(s)
+        if nda is not None:
+            return nda
         str_dtype = doc.get('data_dtype', None)
         nda = np.frombuffer(s, dtype=str_dtype)
         nda.shape = eval(doc.get('data_shape', None)) # eval converts string shape to tuple
@@ -246,4 +246,62 @@ def wfpkfinder_cfd(wf, dtypesv baseline, dtypesv threshold, fraction, deadtime,
     #print 'In NDArray_ext::wfpkfinder_cfd - npeaks: %d' % npeaks
     return npeaks
 
+
+cdef extern from "peakFinder/WFAlgos.hh" namespace "psalg":
+    cdef struct EdgePars:
+        double baseline
+        double threshold
+        double fraction
+        double deadtime
+        bool leading_edge
+
+    void find_edges_batch[T](
+        index_t nchan,
+        index_t nsamples,
+        index_t stride,
+        const T* wfs,
+        const EdgePars* pars,
+        index_t npkmax,
+        T* pkvals,
+        index_t* pkinds,
+        index_t* npks) except +
+
+ctypedef fused wftypes2d :
+    cnp.ndarray[cnp.float64_t,ndim=2]
+    cnp.ndarray[cnp.float32_t,ndim=2]
+    cnp.ndarray[cnp.int64_t,  ndim=2]
+    cnp.ndarray[cnp.int32_t,  ndim=2]
+    cnp.ndarray[cnp.int16_t,  ndim=2]
+
+def wfpkfinder_cfd_batch(wftypes2d wfs, baseline, threshold, fraction, deadtime, leading_edges,\
+                         wftypes2d pkvals,\
+                         cnp.ndarray[cnp.uint32_t,ndim=2] pkinds,\
+                         cnp.ndarray[cnp.uint32_t,ndim=1] npks):
+    """Edges of all channels wfs[nchan,nsamples] in one call, as wfpkfinder_cfd of each row.
+       The parameters are scalars or per channel sequences; pkvals and pkinds of shape
+       [nchan,npkmax] and npks[nchan] are preallocated by the caller and filled.
+    """
+    nchan = wfs.shape[0]
+    assert pkvals.shape[0] == nchan and pkinds.shape[0] == nchan and npks.size == nchan
+    assert pkvals.shape[1] == pkinds.shape[1]
+    if wfs.strides[1] != wfs.itemsize: wfs = np.ascontiguousarray(wfs)
+    assert pkvals.flags['C_CONTIGUOUS'] and pkinds.flags['C_CONTIGUOUS']
+
+    cdef vector[EdgePars] pars = vector[EdgePars](nchan)
+    base = np.broadcast_to(np.asarray(baseline,      dtype=np.float64), (nchan,))
+    thr  = np.broadcast_to(np.asarray(threshold,     dtype=np.float64), (nchan,))
+    cfr  = np.broadcast_to(np.asarray(fraction,      dtype=np.float64), (nchan,))
+    dead = np.broadcast_to(np.asarray(deadtime,      dtype=np.float64), (nchan,))
+    lead = np.broadcast_to(np.asarray(leading_edges, dtype=np.bool_),   (nchan,))
+    for c in range(nchan):
+        pars[c].baseline     = base[c]
+        pars[c].threshold    = thr[c]
+        pars[c].fraction     = cfr[c]
+        pars[c].deadtime     = dead[c]
+        pars[c].leading_edge = lead[c]
+
+    find_edges_batch(nchan, wfs.shape[1], wfs.strides[0]//wfs.itemsize, &wfs[0,0], &pars[0],\
+                     pkinds.shape[1], &pkvals[0,0], &pkinds[0,0], &npks[0])
+    return npks
+
 # EOF
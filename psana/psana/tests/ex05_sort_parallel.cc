@@ -0,0 +1,100 @@
+/*
+ * Sorts the events of an lmf file with ParallelSorter for a number of
+ * threads, checks that the hits are the same as those of one thread,
+ * in the same order, and prints the throughput.
+ *
+ * syntax: ex05_sort_parallel [filename [config [calibration table [max threads]]]]
+ */
+
+#define NUM_CHANNELS 32
+#define NUM_IONS 16
+#define NUM_HITS 16
+
+#include <stdio.h>
+#include <stdlib.h>  // atoi, EXIT_FAILURE
+#include <vector>
+
+#include "psana/hexanode/LMF_IO.hh"
+#include "psana/hexanode/ParallelSort.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check, ctest_time_sec
+
+using psalg::ctest_time_sec;
+
+char DEFAULT_FILE_NAME[]  = "/reg/g/psdm/detector/data_test/lmf/hexanode-example-CO_4.lmf";
+char TEST_CONFIG_FILE[]   = "/reg/g/psdm/detector/data_test/lmf/sorter.txt";
+char TEST_CALIB_TABLES[]  = "calibration_table.txt";
+
+//-------------------
+
+int main(int argc, char* argv[])
+{
+	const char* fname  = (argc>1) ? argv[1] : DEFAULT_FILE_NAME;
+	const char* config = (argc>2) ? argv[2] : TEST_CONFIG_FILE;
+	const char* calib  = (argc>3) ? argv[3] : TEST_CALIB_TABLES;
+	const unsigned max_threads = (argc>4) ? atoi(argv[4]) : 8;
+
+	LMF_IO* LMF = new LMF_IO(NUM_CHANNELS, NUM_IONS);
+	if (!LMF->OpenInputLMF((char*)fname)) {
+		printf("Can't open file: %s\n", fname);
+		return EXIT_FAILURE;
+	}
+
+	// all of the events in memory, in ns
+	const unsigned evsize = NUM_CHANNELS*NUM_IONS;
+	const unsigned batch = 10000;
+	std::vector<double>  tdc_ns;
+	std::vector<__int32> counts;
+	std::vector<double>  timestamps(batch);
+	unsigned nevents = 0;
+	while (true) {
+		tdc_ns.resize((nevents+batch)*evsize);
+		counts.resize((nevents+batch)*NUM_CHANNELS);
+		unsigned n = LMF->ReadNextEvents(batch, &tdc_ns[nevents*evsize], &counts[nevents*NUM_CHANNELS], &timestamps[0]);
+		nevents += n;
+		if (n < batch) break;
+	}
+	for (unsigned i=0; i<nevents*evsize; ++i) tdc_ns[i] *= LMF->tdcresolution;
+	delete LMF;
+	printf("%s: %u events\n", fname, nevents);
+
+	std::vector<__int32>   nref(nevents), npart(nevents);
+	std::vector<SortedHit> ref(nevents*NUM_HITS), hits(nevents*NUM_HITS);
+
+	int nbad = 0;
+	double rate1 = 0;
+	for (unsigned nthreads=1; nthreads<=max_threads; nthreads*=2) {
+		ParallelSorter ps(config, calib, nthreads, NUM_CHANNELS, NUM_IONS);
+		if (!ps.ok()) {
+			printf("sorters were not configured from %s\n", config);
+			return EXIT_FAILURE;
+		}
+
+		double t0 = ctest_time_sec();
+		ps.sort(nevents, &tdc_ns[0], &counts[0], &npart[0], &hits[0], NUM_HITS);
+		double dt = ctest_time_sec() - t0;
+
+		if (nthreads==1) {
+			nref.swap(npart);
+			ref.swap(hits);
+			rate1 = nevents/dt;
+		} else {
+			for (unsigned e=0; e<nevents; ++e) {
+				bool same = npart[e]==nref[e];
+				for (__int32 i=0; same && i<npart[e] && i<NUM_HITS; ++i) {
+					const SortedHit& a = hits[e*NUM_HITS+i];
+					const SortedHit& b = ref [e*NUM_HITS+i];
+					same = a.x==b.x && a.y==b.y && a.time==b.time && a.method==b.method;
+				}
+				if (!same) nbad++;
+			}
+		}
+		printf("threads %2u: %8.3f s  %10.0f events/s  speedup %5.2f\n",
+		       nthreads, dt, nevents/dt, nevents/dt/rate1);
+	}
+
+	printf("events which differ from one thread: %d\n", nbad);
+	psalg::ctest_check(nbad == 0, "hits of all threads == hits of one thread");
+	return psalg::ctest_status();
+}
+
+//-------------------
@@ -0,0 +1,124 @@
+/*
+ * Compares getcfd, which looks for the crossing of the walk a block of
+ * samples at a time, with the walk of the waveform sample by sample it
+ * replaced (getcfd_ref), on random waveforms with pulses of both polarities,
+ * and prints the time per waveform.
+ */
+
+#include <stdio.h>
+#include <stdlib.h> // rand
+#include <math.h>
+#include <vector>
+
+#include "psana/constFracDiscrim/ConstFracDiscrim.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check, ctest_time_sec
+
+using namespace psalgos;
+using psalg::ctest_check;
+using psalg::ctest_status;
+using psalg::ctest_time_sec;
+
+//-------------------
+
+/// Sample by sample walk of getcfd, as it was before the search by blocks
+double getcfd_ref(const double gain, const double offset, const Waveform& Data,
+                  const int32_t delay, const double walk, const double threshold, const double fraction)
+{
+  const int32_t vOff = static_cast<int32_t>(offset / gain);
+  const size_t wLength = Data.size();
+  const double walkB = walk / gain;
+  const double thresholdB = threshold / gain;
+
+  for (size_t i=delay+1; i<wLength-2; ++i) {
+    const double fx    = Data[i] - static_cast<double>(vOff);
+    const double fsx   = -fx*fraction + (Data[i-delay] - static_cast<double>(vOff));
+    const double fsx_1 = -(Data[i+1] - static_cast<double>(vOff))*fraction + (Data[i+1-delay] - static_cast<double>(vOff));
+
+    if (((fsx-walkB) * (fsx_1-walkB)) > 0 || fabs(fx) <= thresholdB) continue;
+    if (fabs(fsx-fsx_1) < 1e-8) continue;
+    else if ((fsx-walkB) == 0) {}
+    else if ((fsx_1-walkB) == 0) continue;
+    if (fsx > fsx_1 && Data[i] > vOff) continue;
+    if (fsx < fsx_1 && Data[i] < vOff) continue;
+
+    const double fsx_m1 = -(Data[i-1] - static_cast<double>(vOff))*fraction + (Data[i-1-delay] - static_cast<double>(vOff));
+    const double fsx_2  = -(Data[i+2] - static_cast<double>(vOff))*fraction + (Data[i+2-delay] - static_cast<double>(vOff));
+    const std::vector<double> x = {double(i-1), double(i), double(i+1), double(i+2)};
+    const std::vector<double> y = {fsx_m1, fsx, fsx_1, fsx_2};
+
+    std::vector<double> coeffs = diff_table(3, x, y);
+    if (fabs(coeffs[0]) > 1e-8) {
+      double a = coeffs[0];
+      for(int k = 0; k < 4; k++) coeffs[k] /= a;
+    }
+    coeffs[3] -= walkB;
+    std::vector<double> dy;
+    for(int k = 0, size = coeffs.size()-1; k < size; k++) dy.push_back(coeffs[k]*(size-k));
+    return find_root(coeffs, dy, 1e-7, x[0]);
+  }
+  return 0.0;
+}
+
+//-------------------
+
+/// Noise around an offset with a few pulses of random polarity, width and height
+static void make_waveform(Waveform& wf, size_t nsamples, double offset, int npulses) {
+  wf.resize(nsamples);
+  for(size_t i=0; i<nsamples; i++) wf[i] = offset + rand()%9 - 4;
+  for(int p=0; p<npulses; p++) {
+    const int c = rand()%nsamples, w = 2+rand()%12;
+    const double h = (rand()%2 ? 1 : -1)*(10+rand()%500);
+    for(int k=-w; k<=w; k++) {const int j = c+k; if(j>=0 && j<int(nsamples)) wf[j] += h*(w+1-abs(k))/(w+1.);}
+  }
+}
+
+static bool same(double a, double b) {return (isnan(a) && isnan(b)) || a == b;}
+
+//-------------------
+
+int main(int argc, char **argv) {
+  printf("test_getcfd\n");
+  srand(1);
+  const unsigned nwfs = 2000;
+  unsigned nbad = 0, nfound = 0;
+  Waveform wf;
+  for(unsigned n=0; n<nwfs; n++) {
+    // lengths around the block size, and pulses anywhere including the ends
+    const size_t nsamples = 3 + rand()%(n%4 ? 300 : 5000);
+    const double offset = rand()%3 ? 0 : rand()%200 - 100;
+    make_waveform(wf, nsamples, offset, rand()%4);
+    const int32_t delay   = 1 + rand()%8;
+    const double fraction = 0.2 + 0.1*(rand()%7);
+    const double walk     = rand()%3 ? 0 : rand()%5 - 2;
+    const double threshold = 5 + rand()%100;
+    const double gain     = rand()%2 ? 1 : 0.5;
+    const double t    = getcfd    (1, 0, gain, offset*gain, wf, delay, walk, threshold, fraction);
+    const double tref = getcfd_ref(gain, offset*gain, wf, delay, walk, threshold, fraction);
+    if(!same(t, tref)) {
+      nbad++;
+      printf("waveform %u of %zu samples: %.9g, %.9g in the reference\n", n, nsamples, t, tref);
+    }
+    if(tref != 0) nfound++;
+  }
+  printf("  %u waveforms, %u with a crossing, %u differ\n", nwfs, nfound, nbad);
+  ctest_check(nfound > nwfs/4, "crossings found");
+  ctest_check(nbad == 0, "getcfd == scalar walk");
+
+  printf("test_time\n");
+  const unsigned nevts = 1000;
+  make_waveform(wf, 20000, 0, 0);
+  for(size_t i=19000; i<19020; i++) wf[i] -= 300; // the pulse is near the end
+  double x = 0, xref = 0;
+  double t0 = ctest_time_sec();
+  for(unsigned e=0; e<nevts; e++) x += getcfd(1, 0, 1, 0, wf, 3, 0, 150, 0.5);
+  double t1 = ctest_time_sec();
+  for(unsigned e=0; e<nevts; e++) xref += getcfd_ref(1, 0, wf, 3, 0, 150, 0.5);
+  double t2 = ctest_time_sec();
+  ctest_check(x != 0 && x == xref, "crossing near the end of a long waveform");
+  printf("  getcfd %.1f us, scalar walk %.1f us per waveform of %zu samples\n",
+         1e6*(t1-t0)/nevts, 1e6*(t2-t1)/nevts, wf.size());
+
+  return ctest_status();
+}
+
+//-------------------
@@ -0,0 +1,205 @@
+/*
+ * Compares the peaks of the fex stream indexed by ChannelPython, as returned
+ * by next_peak, by peak(k) in any order, by the batch export peaks() and after
+ * index_channels, with those of the sequential scan of the stream which
+ * next_peak did before the index (PeakIterRef), on random streams of data
+ * and skip groups (bit 15 set), and prints the time per channel.
+ */
+
+#include <stdio.h>
+#include <stdlib.h> // rand
+#include <stdint.h>
+#include <string.h> // memcpy
+#include <vector>
+
+#include "psana/hsd/HsdPython.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check, ctest_time_sec
+
+using namespace Pds::HSD;
+using psalg::ctest_check;
+using psalg::ctest_status;
+using psalg::ctest_time_sec;
+
+//-------------------
+
+/// The sequential scan of next_peak, as it was before the index
+class PeakIterRef {
+public:
+  PeakIterRef(const uint16_t* q, unsigned n) : _q(q), _n(n), _ns(0), _in(false), _width(0), _totWidth(0), _startSample(0) {}
+  unsigned next_peak(unsigned& startPos, const uint16_t** peakPtr) {
+    unsigned peakLen = 0;
+    unsigned i;
+    for(i=_startSample; i<_n;) {
+      if (_q[i]&0x8000) {
+        for (unsigned j=0; j<4; j++, i++) _ns += (_q[i]&0x7fff);
+        if (_in) {
+          _totWidth += _width;
+          _startSample = i;
+          _in = false;
+          return _width;
+        }
+      } else {
+        if (!_in) {
+          _width = 0;
+          startPos = _ns+_totWidth;
+          *peakPtr = _q+i;
+        }
+        i += 4;
+        _width += 4;
+        _in = true;
+      }
+    }
+    if (_in) peakLen = _width;
+    _startSample = i;
+    _in = false;
+    return peakLen;
+  }
+private:
+  const uint16_t* _q;
+  unsigned _n, _ns;
+  bool     _in;
+  unsigned _width, _totWidth, _startSample;
+};
+
+//-------------------
+
+/// The data of a channel with a raw stream of nraw samples and a fex stream of
+/// ngroups random groups of 4 samples, either skips or samples of a peak
+static void make_channel(std::vector<uint32_t>& evtheader, std::vector<uint8_t>& data,
+                         unsigned nraw, unsigned ngroups, unsigned pskip) {
+  std::vector<uint16_t> fex(4*ngroups);
+  for(unsigned g=0; g<ngroups; g++) {
+    const bool skip = unsigned(rand()%100) < pskip;
+    for(unsigned j=0; j<4; j++)
+      fex[4*g+j] = skip ? 0x8000 | (rand()%3 ? rand()%64 : rand()&0x7fff) : rand()&0x7fff;
+  }
+  const uint32_t raw_hdr[4] = {nraw, 0u<<24, 0, 0};
+  const uint32_t fex_hdr[4] = {unsigned(fex.size()), 1u<<24, 0, 0};
+  data.resize(2*sizeof(raw_hdr) + 2*nraw + 2*fex.size());
+  uint8_t* p = &data[0];
+  memcpy(p, raw_hdr, sizeof(raw_hdr));  p += sizeof(raw_hdr);
+  for(unsigned i=0; i<nraw; i++, p+=2) {uint16_t s = rand()&0x7ff; memcpy(p, &s, 2);}
+  memcpy(p, fex_hdr, sizeof(fex_hdr));  p += sizeof(fex_hdr);
+  if(!fex.empty()) memcpy(p, &fex[0], 2*fex.size());
+  evtheader.assign(8, 0);
+  evtheader[0] = 3<<20;                 // the raw and fex streams
+}
+
+struct Peak {unsigned startPos, width; const uint16_t* ptr;};
+
+static bool operator!=(const Peak& a, const Peak& b) {return a.startPos!=b.startPos || a.width!=b.width || a.ptr!=b.ptr;}
+
+//-------------------
+
+int main(int argc, char **argv) {
+  printf("test_peaks\n");
+  srand(1);
+  const unsigned nchans = 500;
+  unsigned nbad_iter = 0, nbad_random = 0, nbad_batch = 0, nbad_index = 0, nover = 0, npeaks_tot = 0;
+  std::vector<std::vector<uint32_t> > headers(nchans);
+  std::vector<std::vector<uint8_t> >  datas(nchans);
+  std::vector<std::vector<Peak> >     refs(nchans);
+  for(unsigned c=0; c<nchans; c++) {
+    // empty streams, streams of skips only or of peaks only, and mixed ones
+    const unsigned ngroups = c%50==0 ? 0 : 1 + rand()%(c%2 ? 20 : 400);
+    const unsigned pskip   = c%25==1 ? 100 : c%25==2 ? 0 : 10 + rand()%80;
+    make_channel(headers[c], datas[c], 16 + rand()%64, ngroups, pskip);
+
+    ChannelPython refchan(&headers[c][0], &datas[c][0]);
+    unsigned nfex = 0;
+    const uint16_t* q = refchan.fex(nfex);
+    PeakIterRef iter(q, nfex);
+    Peak pk;
+    while((pk.width = iter.next_peak(pk.startPos, &pk.ptr))) refs[c].push_back(pk);
+    const std::vector<Peak>& ref = refs[c];
+    npeaks_tot += ref.size();
+
+    // sequential
+    ChannelPython chan(&headers[c][0], &datas[c][0]);
+    std::vector<Peak> peaks;
+    uint16_t* ptr = 0;
+    while((pk.width = chan.next_peak(pk.startPos, &ptr))) {pk.ptr = ptr; peaks.push_back(pk);}
+    bool ok = peaks.size() == ref.size();
+    for(size_t k=0; ok && k<ref.size(); k++) ok = !(peaks[k] != ref[k]);
+    if(!ok) nbad_iter++;
+    if(chan.num_peaks() > 4*ngroups/8+1) nover++;
+
+    // random access, backwards, and past the end
+    ok = chan.num_peaks() == ref.size();
+    for(size_t k=ref.size(); ok && k-- > 0;) {
+      pk.width = chan.peak(k, pk.startPos, &ptr);
+      pk.ptr = ptr;
+      ok = !(pk != ref[k]);
+    }
+    ok = ok && chan.peak(ref.size(), pk.startPos, &ptr) == 0;
+    if(!ok) nbad_random++;
+
+    // batch export, all of the peaks and fewer
+    const unsigned n = ref.size();
+    std::vector<uint32_t> startPos(n+1), offset(n+1), width(n+1);
+    ok = chan.peaks(&startPos[0], &offset[0], &width[0], n) == n;
+    for(unsigned k=0; ok && k<n; k++)
+      ok = startPos[k] == ref[k].startPos && width[k] == ref[k].width && q+offset[k] == ref[k].ptr;
+    if(n > 1) {
+      startPos[n/2] = ~0u;
+      ok = ok && chan.peaks(&startPos[0], &offset[0], &width[0], n/2) == n && startPos[n/2] == ~0u;
+    }
+    if(!ok) nbad_batch++;
+  }
+
+  // the channels of an event indexed in parallel, then iterated
+  std::vector<ChannelPython> chans;
+  std::vector<ChannelPython*> pchans;
+  for(unsigned c=0; c<nchans; c++) chans.push_back(ChannelPython(&headers[c][0], &datas[c][0]));
+  for(unsigned c=0; c<nchans; c++) pchans.push_back(&chans[c]);
+  index_channels(&pchans[0], nchans);
+  for(unsigned c=0; c<nchans; c++) {
+    std::vector<Peak> peaks;
+    Peak pk;
+    uint16_t* ptr;
+    while((pk.width = chans[c].next_peak(pk.startPos, &ptr))) {pk.ptr = ptr; peaks.push_back(pk);}
+    bool ok = peaks.size() == refs[c].size();
+    for(size_t k=0; ok && k<peaks.size(); k++) ok = !(peaks[k] != refs[c][k]);
+    if(!ok) nbad_index++;
+  }
+
+  printf("  %u channels, %u peaks\n", nchans, npeaks_tot);
+  ctest_check(npeaks_tot > nchans, "peaks found");
+  ctest_check(nbad_iter == 0, "next_peak == sequential scan");
+  ctest_check(nbad_random == 0, "peak(k) == sequential scan");
+  ctest_check(nbad_batch == 0, "peaks() == sequential scan");
+  ctest_check(nbad_index == 0, "index_channels == sequential scan");
+  ctest_check(nover == 0, "peaks within the reserved index");
+
+  printf("test_time\n");
+  std::vector<uint32_t> header;
+  std::vector<uint8_t>  data;
+  make_channel(header, data, 16, 20000, 50);
+  const unsigned nevts = 1000;
+  unsigned nref = 0, nidx = 0;
+  double t0 = ctest_time_sec();
+  for(unsigned e=0; e<nevts; e++) {
+    ChannelPython chan(&header[0], &data[0]);
+    unsigned nfex = 0;
+    const uint16_t* q = chan.fex(nfex);
+    PeakIterRef iter(q, nfex);
+    unsigned startPos;
+    const uint16_t* ptr;
+    while(iter.next_peak(startPos, &ptr)) nref++;
+  }
+  double t1 = ctest_time_sec();
+  for(unsigned e=0; e<nevts; e++) {
+    ChannelPython chan(&header[0], &data[0]);
+    unsigned startPos;
+    uint16_t* ptr;
+    while(chan.next_peak(startPos, &ptr)) nidx++;
+  }
+  double t2 = ctest_time_sec();
+  ctest_check(nref == nidx, "same number of peaks");
+  printf("  sequential scan %.1f us, index and iteration %.1f us per channel of %u peaks\n",
+         1e6*(t1-t0)/nevts, 1e6*(t2-t1)/nevts, nref/nevts);
+
+  return ctest_status();
+}
+
+//-------------------
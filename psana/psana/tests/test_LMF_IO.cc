@@ -0,0 +1,184 @@
+/*
+ * Writes an lmf file of random events, checks that ReadNextEvents gives the
+ * events of ReadNextEvent, that ScanEventPositions keeps the data of the
+ * current event and the next event read, that readers seeking to the scanned
+ * positions with SeekToPosition give the events of their chunks, and prints
+ * the time to read the file from the memory map and with fread, and per
+ * event and in batches.
+ *
+ * syntax: test_LMF_IO [filename [number of events]]
+ */
+
+#define NUM_CHANNELS 8
+#define NUM_IONS 16
+
+#include <stdio.h>
+#include <stdlib.h>  // rand, atoi
+#include <unistd.h>  // getpid, unlink
+#include <string.h>  // memcmp
+#include <vector>
+#include <algorithm> // std::min
+
+#include "psana/hexanode/LMF_IO.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check, ctest_time_sec
+
+using psalg::ctest_check;
+using psalg::ctest_status;
+using psalg::ctest_time_sec;
+
+static const unsigned evsize = NUM_CHANNELS*NUM_IONS;
+
+//-------------------
+
+/// Events of 0 to 5 hits per channel in the simple format of 32-bit words
+static bool write_file(const char* fname, unsigned nevents) {
+	LMF_IO out(NUM_CHANNELS, NUM_IONS);
+	out.DAQ_ID_output = DAQ_ID_SIMPLE;
+	out.number_of_channels_output = NUM_CHANNELS;
+	out.max_number_of_hits_output = NUM_IONS;
+	out.data_format_in_userheader_output = 10;
+	out.DAQVersion_output = 0;               // no event header, no timestamp
+	out.timestamp_format_output = 0;
+	if (!out.OpenOutputLMF((__int8*)fname)) return false;
+	unsigned __int32 cnt[NUM_CHANNELS];
+	__int32 tdc[evsize];
+	for (unsigned e=0; e<nevents; ++e) {
+		for (unsigned c=0; c<NUM_CHANNELS; ++c) {
+			cnt[c] = rand()%6;
+			for (unsigned h=0; h<cnt[c]; ++h) tdc[c*NUM_IONS+h] = rand()%100000 - 1000;
+		}
+		out.WriteTDCData((unsigned __int64)e, cnt, tdc);
+	}
+	out.CloseOutputLMF();
+	return true;
+}
+
+/// The hits of an event, with the TDC data of the channels past their hits set to 0
+struct Events {
+	std::vector<double>  tdc;
+	std::vector<__int32> cnt;
+	void resize(unsigned n) {tdc.assign(n*evsize, 0); cnt.assign(n*NUM_CHANNELS, 0);}
+	void clean(unsigned e) {
+		for (unsigned c=0; c<NUM_CHANNELS; ++c)
+			for (unsigned h=cnt[e*NUM_CHANNELS+c]; h<NUM_IONS; ++h) tdc[e*evsize+c*NUM_IONS+h] = 0;
+	}
+	bool same(unsigned e, const Events& o, unsigned eo) const {
+		return !memcmp(&cnt[e*NUM_CHANNELS], &o.cnt[eo*NUM_CHANNELS], NUM_CHANNELS*sizeof(__int32)) &&
+		       !memcmp(&tdc[e*evsize], &o.tdc[eo*evsize], evsize*sizeof(double));
+	}
+};
+
+static unsigned read_events(LMF_IO& lmf, Events& evts, unsigned first, unsigned n, unsigned batch) {
+	std::vector<double> timestamps(batch);
+	unsigned nread = 0;
+	while (nread < n) {
+		unsigned m = lmf.ReadNextEvents(std::min(batch, n-nread), &evts.tdc[(first+nread)*evsize],
+		                                &evts.cnt[(first+nread)*NUM_CHANNELS], &timestamps[0]);
+		for (unsigned e=first+nread; e<first+nread+m; ++e) evts.clean(e);
+		nread += m;
+		if (m == 0) break;
+	}
+	return nread;
+}
+
+//-------------------
+
+int main(int argc, char* argv[])
+{
+	char tmpname[128];
+	sprintf(tmpname, "/tmp/test_LMF_IO_%d.lmf", getpid());
+	const char* fname = (argc>1) ? argv[1] : tmpname;
+	const unsigned nevents = (argc>2) ? atoi(argv[2]) : 200000;
+	srand(1);
+	if (!write_file(fname, nevents)) {
+		printf("Can't write file: %s\n", fname);
+		return EXIT_FAILURE;
+	}
+
+	printf("test_batch\n");
+	Events ref, evts;
+	ref.resize(nevents+1);
+	LMF_IO* lmf = new LMF_IO(NUM_CHANNELS, NUM_IONS);
+	ctest_check(lmf->OpenInputLMF((__int8*)fname), "file opened");
+	unsigned n = 0;
+	double t0 = ctest_time_sec();
+	while (n <= nevents && lmf->ReadNextEvent()) {
+		lmf->GetNumberOfHitsArray(&ref.cnt[n*NUM_CHANNELS]);
+		lmf->GetTDCDataArray(&ref.tdc[n*evsize]);
+		ref.clean(n++);
+	}
+	double t1 = ctest_time_sec();
+	delete lmf;
+	ctest_check(n == nevents, "events read one by one");
+
+	evts.resize(nevents+1);
+	lmf = new LMF_IO(NUM_CHANNELS, NUM_IONS);
+	lmf->OpenInputLMF((__int8*)fname);
+	double t2 = ctest_time_sec();
+	n = read_events(*lmf, evts, 0, nevents+1, 1000);
+	double t3 = ctest_time_sec();
+	delete lmf;
+	bool same = n == nevents;
+	for (unsigned e=0; same && e<nevents; ++e) same = evts.same(e, ref, e);
+	ctest_check(same, "ReadNextEvents == ReadNextEvent");
+	printf("  %u events, ReadNextEvent %.0f ns, ReadNextEvents %.0f ns per event\n",
+	       nevents, 1e9*(t1-t0)/nevents, 1e9*(t3-t2)/nevents);
+
+	printf("test_scan\n");
+	const unsigned current = 10, every = 1000;
+	lmf = new LMF_IO(NUM_CHANNELS, NUM_IONS);
+	lmf->OpenInputLMF((__int8*)fname);
+	evts.resize(current+2);
+	read_events(*lmf, evts, 0, current+1, current+1);
+	std::vector<unsigned __int64> positions;
+	unsigned __int64 nscanned = lmf->ScanEventPositions(positions, every);
+	ctest_check(nscanned == nevents-current-1, "events scanned");
+	ctest_check(positions.size() == (nscanned+every-1)/every, "positions of every every'th event");
+	lmf->GetNumberOfHitsArray(&evts.cnt[0]);
+	lmf->GetTDCDataArray(&evts.tdc[0]);
+	evts.clean(0);
+	ctest_check(evts.same(0, ref, current), "current event kept by the scan");
+	ctest_check(lmf->GetEventNumber() == current+1, "event number kept by the scan");
+	read_events(*lmf, evts, current+1, 1, 1);
+	ctest_check(evts.same(current+1, ref, current+1), "next event read after the scan");
+	delete lmf;
+
+	printf("test_seek\n");
+	// readers of chunks of the file, each from a position of the scan
+	evts.resize(nevents);
+	same = true;
+	for (unsigned k=0; k<positions.size(); ++k) {
+		const unsigned first = current+1 + k*every;
+		const unsigned last  = std::min(first+every, nevents);
+		LMF_IO chunk(NUM_CHANNELS, NUM_IONS);
+		chunk.OpenInputLMF((__int8*)fname);
+		same = same && chunk.SeekToPosition(positions[k], first);
+		same = same && read_events(chunk, evts, first, last-first, 100) == last-first;
+		for (unsigned e=first; same && e<last; ++e) same = evts.same(e, ref, e);
+	}
+	ctest_check(same, "chunks read from the scanned positions");
+
+	printf("test_time\n");
+	// the words of the file through MyFILE, from the memory map and with fread
+	double tmap = 0, tfread = 0;
+	unsigned __int64 summap = 0, sumfread = 0, nwords = 1;
+	for (int mapping=1; mapping>=0; --mapping) {
+		MyFILE f(true, mapping);
+		f.open((__int8*)fname);
+		unsigned __int64 sum = 0;
+		unsigned __int32 w;
+		nwords = f.filesize/sizeof(w);
+		double t = ctest_time_sec();
+		for (unsigned __int64 i=0; i<nwords; ++i) {f >> w; sum += w;}
+		t = ctest_time_sec() - t;
+		if (mapping) {tmap = t; summap = sum;} else {tfread = t; sumfread = sum;}
+	}
+	ctest_check(summap == sumfread, "same words mapped and with fread");
+	printf("  %.1f ns mapped, %.1f ns with fread per 32-bit word, %.1fx\n",
+	       1e9*tmap/nwords, 1e9*tfread/nwords, tfread/tmap);
+
+	if (argc<2) unlink(fname);
+	return ctest_status();
+}
+
+//-------------------
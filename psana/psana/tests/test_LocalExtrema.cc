@@ -0,0 +1,88 @@
+/*
+ * Compares the maps of local extrema of the separable search in LocalExtrema.hh
+ * with those of the scans of the rank region (mapOfLocal*Scalar)
+ * and prints the time per image.
+ */
+
+#include <stdio.h>
+#include <stdlib.h> // rand
+#include <vector>
+
+#include "psana/peakFinder/LocalExtrema.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check, ctest_time_sec
+
+using namespace localextrema;
+using psalg::ctest_time_sec;
+
+//-------------------
+
+/// Random data with ties (small range) and bad pixels, for all ranks up to 7
+template <typename T>
+static int test_maps(const char* name, const size_t rows, const size_t cols, const int range, const int badpct) {
+  std::vector<T> data(rows*cols);
+  std::vector<mask_t> mask(rows*cols);
+  for(size_t i=0; i<rows*cols; i++) {
+    data[i] = T(rand()%range);
+    mask[i] = (rand()%100 < badpct) ? 0 : 1;
+  }
+
+  std::vector<extrim_t> map(rows*cols), ref(rows*cols);
+  Heap heap;
+  int nbad = 0;
+  for(size_t rank=0; rank<=7; rank++) {
+    size_t n    = mapOfLocalMaximums      (&data[0], &mask[0], rows, cols, rank, &map[0]);
+    size_t nref = mapOfLocalMaximumsScalar(&data[0], &mask[0], rows, cols, rank, &ref[0]);
+    if(n!=nref || map!=ref) {nbad++; printf("%s %zux%zu rank %zu: maxima differ\n", name, rows, cols, rank);}
+
+    n    = mapOfLocalMinimums_drp  (&data[0], &mask[0], rows, cols, rank, &map[0], &heap);
+    nref = mapOfLocalMinimumsScalar(&data[0], &mask[0], rows, cols, rank, &ref[0]);
+    if(n!=nref || map!=ref) {nbad++; printf("%s %zux%zu rank %zu: minima differ\n", name, rows, cols, rank);}
+  }
+  return nbad;
+}
+
+//-------------------
+
+template <typename T>
+static void time_maps(const char* name, const size_t rows, const size_t cols, const size_t rank) {
+  std::vector<T> data(rows*cols);
+  std::vector<mask_t> mask(rows*cols, 1);
+  std::vector<extrim_t> map(rows*cols);
+  for(size_t i=0; i<rows*cols; i++) data[i] = T(rand()%1000);
+
+  const unsigned nevts = 10;
+  double t0 = ctest_time_sec();
+  for(unsigned e=0; e<nevts; e++) mapOfLocalMaximums(&data[0], &mask[0], rows, cols, rank, &map[0]);
+  double t1 = ctest_time_sec();
+  for(unsigned e=0; e<nevts; e++) mapOfLocalMaximumsScalar(&data[0], &mask[0], rows, cols, rank, &map[0]);
+  double t2 = ctest_time_sec();
+
+  printf("%-8s %zux%zu rank %zu  separable %7.3f ms  scalar %7.3f ms per image\n",
+         name, rows, cols, rank, 1e3*(t1-t0)/nevts, 1e3*(t2-t1)/nevts);
+}
+
+//-------------------
+
+int main(int argc, char* argv[]) {
+  int nbad = 0;
+  srand(1);
+  const size_t shapes[][2] = {{185,388}, {352,384}, {1,50}, {13,1}, {7,3}};
+  for(const auto& sh : shapes) {
+    for(int range : {3, 1000}) {
+      nbad += test_maps<uint16_t>("uint16", sh[0], sh[1], range, 10);
+      nbad += test_maps<float>   ("float",  sh[0], sh[1], range, 10);
+      nbad += test_maps<double>  ("double", sh[0], sh[1], range, 0);
+      nbad += test_maps<int16_t> ("int16",  sh[0], sh[1], range, 50);
+    }
+  }
+  printf("maps of local extrema: %d differ\n", nbad);
+  psalg::ctest_check(nbad == 0, "separable search == scans of the rank region");
+
+  for(size_t rank : {1, 3, 5}) {
+    time_maps<uint16_t>("uint16", 1408, 1536, rank);
+    time_maps<float>   ("float",  1408, 1536, rank);
+  }
+  return psalg::ctest_status();
+}
+
+//-------------------
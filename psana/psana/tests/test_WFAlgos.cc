@@ -5,12 +5,14 @@
 #include "psalg/utils/Logger.hh" // MSG, LOGGER,...
 
 #include <stdio.h>
+#include <stdlib.h> // rand
 #include <iostream> // cout
 #include <sstream>
 //#include <vector>
 
 #include "psalg/calib/NDArray.hh"
 #include "psana/peakFinder/WFAlgos.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check, ctest_time_sec
 
 using namespace psalg;
 
@@ -114,6 +116,92 @@ void test_find_edges() {
   std::cout << '\n';
 }
 
+//-------------------
+
+/// Sample by sample walk of find_edges, as it was before the vectorized skip of the baseline
+template <typename T>
+index_t find_edges_ref(index_t npkmax, T* pkvals, index_t* pkinds, const std::vector<T>& wf,
+                       double baseline_f8, double threshold_f8, double fraction, double deadtime, bool leading_edge) {
+  T baseline = (T)baseline_f8;
+  T threshold = (T)threshold_f8;
+  T peak = threshold;
+  double last = -deadtime-1.0;
+  bool rising = threshold > baseline;
+  bool crossed = false;
+  index_t npk = 0, start = 0, k = 0, size = wf.size();
+  for(; k<size; k++) {
+    T y = wf[k];
+    bool over = (rising && y>threshold) || (!rising && y<threshold);
+    if(!crossed && over) {crossed = true; start = k; peak = y;}
+    else if(crossed && !over) {
+      if(double(k-start)>deadtime)
+        _add_edge(wf.data(), size, rising==leading_edge, fraction*(peak-baseline)+baseline,
+                  deadtime, peak, start, last, npk, pkvals, pkinds);
+      crossed = false;
+      if(!(npk < npkmax)) break;
+    }
+    else if((rising && y>peak) || (!rising && y<peak)) {peak = y; if(!leading_edge) start = k;}
+  }
+  if(crossed && (npk < npkmax) && (double(k-start)>deadtime))
+    _add_edge(wf.data(), size, rising==leading_edge, fraction*(peak-baseline)+baseline,
+              deadtime, peak, start, last, npk, pkvals, pkinds);
+  return npk;
+}
+
+/// Noisy channels with negative pulses, some at the waveform ends, for both edges and npkmax
+void test_find_edges_batch() {
+  printf("In test_WFAlgos::test_find_edges_batch\n");
+
+  const index_t nchan = 8, nsamples = 10000, stride = nsamples+13, npkmax = 64;
+  std::vector<double> wfs(nchan*stride);
+  srand(1);
+  for(index_t c=0; c<nchan; c++) {
+    double* wf = &wfs[c*stride];
+    for(index_t i=0; i<nsamples; i++) wf[i] = rand()%9 - 4;
+    for(index_t i=(c%2) ? 0 : 50; i<nsamples; i+=40+rand()%400) {
+      const int w = 2+rand()%10, h = 10+rand()%200;
+      for(int k=-w; k<=w; k++) {const int j = int(i)+k; if(j>=0 && j<int(nsamples)) wf[j] -= h*(w+1-abs(k))/(w+1.);}
+    }
+  }
+
+  int nbad = 0;
+  std::vector<double>  pkvals(nchan*npkmax), refvals(npkmax);
+  std::vector<index_t> pkinds(nchan*npkmax), refinds(npkmax), npks(nchan);
+  for(bool leading : {true, false}) {
+    for(index_t npkm : {npkmax, index_t(5)}) {
+      std::vector<EdgePars> pars(nchan);
+      for(index_t c=0; c<nchan; c++) pars[c] = EdgePars{0, -8.-c, 0.5, double(c%3), leading};
+      find_edges_batch(nchan, nsamples, stride, &wfs[0], &pars[0], npkm, &pkvals[0], &pkinds[0], &npks[0]);
+      for(index_t c=0; c<nchan; c++) {
+        std::vector<double> wf(&wfs[c*stride], &wfs[c*stride]+nsamples);
+        const EdgePars& p = pars[c];
+        index_t nref = find_edges_ref(npkm, &refvals[0], &refinds[0], wf, p.baseline, p.threshold, p.fraction, p.deadtime, p.leading_edge);
+        bool ok = npks[c]==nref && nref>0;
+        for(index_t i=0; ok && i<nref; i++)
+          ok = pkvals[c*npkm+i]==refvals[i] && pkinds[c*npkm+i]==refinds[i];
+        if(!ok) {nbad++; printf("channel %u leading %d npkmax %u: %u edges, %u in the reference\n", c, leading, npkm, npks[c], nref);}
+      }
+    }
+  }
+
+  const unsigned nevts = 100;
+  std::vector<EdgePars> pars(nchan, EdgePars{0, -8, 0.5, 0, true});
+  double t0 = ctest_time_sec();
+  for(unsigned e=0; e<nevts; e++)
+    find_edges_batch(nchan, nsamples, stride, &wfs[0], &pars[0], npkmax, &pkvals[0], &pkinds[0], &npks[0]);
+  double t1 = ctest_time_sec();
+  for(unsigned e=0; e<nevts; e++)
+    for(index_t c=0; c<nchan; c++) {
+      std::vector<double> wf(&wfs[c*stride], &wfs[c*stride]+nsamples);
+      find_edges_ref(npkmax, &refvals[0], &refinds[0], wf, 0, -8, 0.5, 0, true);
+    }
+  double t2 = ctest_time_sec();
+
+  printf("find_edges_batch: %d channels differ, %u channels of %u samples batch %.3f ms scalar %.3f ms per event\n",
+         nbad, nchan, nsamples, 1e3*(t1-t0)/nevts, 1e3*(t2-t1)/nevts);
+  ctest_check(nbad == 0, "find_edges_batch == scalar walk");
+}
+
 //-------------------
  
 void test_input_pars(int i, const int j, int& k, const int& l) {
@@ -138,6 +226,7 @@ std::string usage(const std::string& tname="")
   if (tname == "") ss << "Usage command> test_WFAlgos <test-number>\n  where test-number";
   if (tname == "" || tname=="1"	) ss << "\n  1  - test_cpp()";
   if (tname == "" || tname=="2"	) ss << "\n  2  - test_find_edges() - uses vectors for IO";
+  if (tname == "" || tname=="3"	) ss << "\n  3  - test_find_edges_batch() - compares with the scalar walk";
   ss << '\n';
   return ss.str();
 }
@@ -159,10 +248,11 @@ int main(int argc, char* argv[])
 
   if      (tname=="1")  test_cpp();
   else if (tname=="2")  test_find_edges();
+  else if (tname=="3")  test_find_edges_batch();
   else MSG(WARNING, "Undefined test name \"" << tname << '\"');
  
   print_hline(80,'_');
-  return EXIT_SUCCESS;
+  return ctest_status();
 }
 
 //-------------------
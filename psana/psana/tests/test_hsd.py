@@ -82,6 +82,37 @@ def test_hsd():
         if nevt == 20: break # stop early since this xtc file has incomplete dg
     assert(nevt>0) # make sure we received events
 
+def test_hsd_peak_arrays():
+    dir_path = os.path.dirname(os.path.realpath(__file__))
+    ds = DataSource(files=os.path.join(dir_path,'test_hsd.xtc2'))
+
+    myrun = next(ds.runs())
+    det = myrun.Detector('xpphsd')
+
+    npeaks = 0
+    for nevt,evt in enumerate(myrun.events()):
+        fex = det.hsd.peaks(evt)
+        arrays = det.hsd.peak_arrays(evt)
+
+        # the arrays hold the peaks of the lists, in the same order
+        if not fex:
+            assert arrays is None
+        else:
+            assert arrays.keys() == fex.keys()
+            for digitizer,fexdata in fex.items():
+                assert arrays[digitizer].keys() == fexdata.keys()
+                for channel,(startpos,peaks) in fexdata.items():
+                    start,length,offset,samples = arrays[digitizer][channel]
+                    assert list(start) == list(startpos), (start, startpos)
+                    assert len(length) == len(offset) == len(peaks)
+                    for n,o,peak in zip(length,offset,peaks):
+                        assert (samples[o:o+n]==peak).all(), (samples[o:o+n], peak)
+                    npeaks += len(peaks)
+        if nevt == 20: break # stop early since this xtc file has incomplete dg
+    assert(nevt>0) # make sure we received events
+    assert(npeaks>0)
+
 if __name__ == "__main__":
     test_hsd()
     test_hsd_padonly()
+    test_hsd_peak_arrays()
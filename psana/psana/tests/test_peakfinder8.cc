@@ -0,0 +1,170 @@
+/*
+ * Checks the peaks of peakfinder8 on a synthetic frame of 2x2 ASICs against
+ * psana/tests/peakfinder8_ref.txt, the peaks found by the implementation which
+ * set up the radial bins and work buffers on each call, that on a frame of
+ * touching peaks no peak takes in pixels of an other one (the seed loop of that
+ * implementation searched one entry past the peak), that a PeakFinder8 engine
+ * gives the same peaks whatever frames it processed before and whatever the
+ * number of threads, and prints the time per frame.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+#include <algorithm> // std::min, std::max
+
+#include <omp.h>
+
+#include "psana/peakFinder/peakfinder8.hh"
+#include "psalg/utils/ctest_utils.hh" // ctest_check, ctest_time_sec
+
+using namespace psalg;
+
+static const long AsicNx = 96, AsicNy = 96, NAsicsX = 2, NAsicsY = 2;
+static const long Nx = AsicNx*NAsicsX, Ny = AsicNy*NAsicsY;
+static const int  MaxPeaks = 500;
+
+//-------------------
+
+/// Uniform in [0,1), the same on every platform
+static float uniform(uint32_t& state) {
+  state = state*1664525u + 1013904223u;
+  return (state >> 8) * (1.f/16777216.f);
+}
+
+/// Noisy background with npeaks gaussian spots, some touching each other
+static void make_frame(uint32_t seed, int npeaks, std::vector<float>& data) {
+  uint32_t s = seed;
+  data.resize(Nx*Ny);
+  for(long i=0; i<Nx*Ny; i++) data[i] = 10 + 4*(uniform(s)-0.5f);
+  for(int k=0; k<npeaks; k++) {
+    float x0 = 3 + (Nx-6)*uniform(s);
+    float y0 = 3 + (Ny-6)*uniform(s);
+    float a  = 50 + 250*uniform(s);
+    float w  = 0.7f + 0.8f*uniform(s);
+    for(long y=std::max(long(y0)-4, 0L); y<=std::min(long(y0)+4, Ny-1); y++)
+      for(long x=std::max(long(x0)-4, 0L); x<=std::min(long(x0)+4, Nx-1); x++)
+        data[y*Nx+x] += a*expf(-((x-x0)*(x-x0) + (y-y0)*(y-y0))/(2*w*w));
+  }
+}
+
+struct Peak {float x, y, value; long index; float npix, maxi, sigma, snr;};
+
+/// The peak list is allocated once, as by the PeakFinder8 of the pyx
+static void find(PeakFinder8& pf8, std::vector<float>& data, std::vector<Peak>& peaks) {
+  static tPeakList pl;
+  if(!pl.memoryAllocated) allocatePeakList(&pl, MaxPeaks);
+  pf8.find(&pl, &data[0], 20, 5, 2, 50, 3, NULL);
+  peaks.resize(pl.nPeaks);
+  for(long i=0; i<pl.nPeaks; i++) {
+    Peak p = {pl.peak_com_x[i], pl.peak_com_y[i], pl.peak_totalintensity[i], pl.peak_com_index[i],
+              pl.peak_npix[i], pl.peak_maxintensity[i], pl.peak_sigma[i], pl.peak_snr[i]};
+    peaks[i] = p;
+  }
+}
+
+static bool same(const std::vector<Peak>& a, const std::vector<Peak>& b) {
+  if(a.size() != b.size()) return false;
+  for(size_t i=0; i<a.size(); i++)
+    if(a[i].x != b[i].x || a[i].y != b[i].y || a[i].value != b[i].value || a[i].index != b[i].index ||
+       a[i].npix != b[i].npix || a[i].maxi != b[i].maxi || a[i].sigma != b[i].sigma || a[i].snr != b[i].snr)
+      return false;
+  return true;
+}
+
+static bool close(float a, float b) {return fabs(a-b) <= 1e-4*(fabs(a)+fabs(b)) + 1e-4;}
+
+//-------------------
+
+int main(int argc, char **argv) {
+  const char* fname = argc > 1 ? argv[1] : "psana/tests/peakfinder8_ref.txt";
+
+  std::vector<float> pix_r(Nx*Ny);
+  std::vector<char>  mask(Nx*Ny, 1);
+  for(long y=0; y<Ny; y++)
+    for(long x=0; x<Nx; x++) pix_r[y*Nx+x] = sqrtf((x-Nx/2+0.5f)*(x-Nx/2+0.5f) + (y-Ny/2+0.5f)*(y-Ny/2+0.5f));
+  for(long i=0; i<Nx*Ny; i+=97) mask[i] = 0;
+
+  std::vector<float> frame, other;
+  make_frame(1, 120, frame);
+  make_frame(2, 300, other);
+
+  //-------------------
+  printf("test_reference\n");
+  std::vector<Peak> ref;
+  FILE* f = fopen(fname, "r");
+  if(f) {
+    Peak p;
+    while(fscanf(f, "%f %f %f %ld %f %f %f %f", &p.x, &p.y, &p.value, &p.index,
+                 &p.npix, &p.maxi, &p.sigma, &p.snr) == 8) ref.push_back(p);
+    fclose(f);
+  }
+  ctest_check(!ref.empty(), "reference peaks read");
+
+  std::vector<Peak> peaks;
+  tPeakList pl;
+  allocatePeakList(&pl, MaxPeaks);
+  peakfinder8(&pl, &frame[0], &mask[0], &pix_r[0], AsicNx, AsicNy, NAsicsX, NAsicsY, 20, 5, 2, 50, 3, NULL);
+  bool match = pl.nPeaks == (long)ref.size();
+  for(long i=0; i<pl.nPeaks && match; i++)
+    match = close(pl.peak_com_x[i], ref[i].x) && close(pl.peak_com_y[i], ref[i].y) &&
+            close(pl.peak_totalintensity[i], ref[i].value) && pl.peak_com_index[i] == ref[i].index &&
+            pl.peak_npix[i] == ref[i].npix && close(pl.peak_maxintensity[i], ref[i].maxi) &&
+            close(pl.peak_sigma[i], ref[i].sigma) && close(pl.peak_snr[i], ref[i].snr);
+  printf("  %ld peaks, %zu reference peaks\n", pl.nPeaks, ref.size());
+  ctest_check(match, "peakfinder8 gives the reference peaks");
+  freePeakList(pl);
+
+  //-------------------
+  printf("test_seed\n");
+  // the center of mass of a peak grown from connected pixels is in the peak,
+  // it was not for a peak which took in the pixels of an other one
+  std::vector<char> outliers(Nx*Ny);
+  allocatePeakList(&pl, MaxPeaks);
+  peakfinder8(&pl, &other[0], &mask[0], &pix_r[0], AsicNx, AsicNy, NAsicsX, NAsicsY, 20, 5, 2, 50, 3, &outliers[0]);
+  long nout = 0;
+  for(long i=0; i<pl.nPeaks; i++) if(outliers[pl.peak_com_index[i]] != 2) nout++;
+  printf("  %ld peaks, %ld with the center of mass outside\n", pl.nPeaks, nout);
+  ctest_check(pl.nPeaks > 0 && nout == 0, "center of mass of each peak in the peak");
+  freePeakList(pl);
+
+  //-------------------
+  printf("test_engine\n");
+  PeakFinder8 pf8(&pix_r[0], &mask[0], AsicNx, AsicNy, NAsicsX, NAsicsY);
+  std::vector<Peak> first, again, reused;
+  find(pf8, frame, first);
+  find(pf8, other, again);
+  find(pf8, frame, reused);
+  ctest_check(same(first, reused), "same peaks after an other frame");
+
+  const int nthreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  std::vector<Peak> single;
+  PeakFinder8 pf8single(&pix_r[0], &mask[0], AsicNx, AsicNy, NAsicsX, NAsicsY);
+  find(pf8single, other, single);
+  find(pf8single, frame, single);
+  omp_set_num_threads(nthreads > 1 ? nthreads : 4);
+  std::vector<Peak> multi;
+  find(pf8, frame, multi);
+  ctest_check(same(first, single) && same(first, multi), "same peaks with 1 and more threads");
+
+  //-------------------
+  printf("test_time\n");
+  const unsigned nframes = 200;
+  double t0 = ctest_time_sec();
+  for(unsigned n=0; n<nframes; n++) find(pf8, n%2 ? other : frame, peaks);
+  double t1 = ctest_time_sec();
+  for(unsigned n=0; n<nframes; n++) {
+    allocatePeakList(&pl, MaxPeaks);
+    peakfinder8(&pl, n%2 ? &other[0] : &frame[0], &mask[0], &pix_r[0], AsicNx, AsicNy, NAsicsX, NAsicsY,
+                20, 5, 2, 50, 3, NULL);
+    freePeakList(pl);
+  }
+  double t2 = ctest_time_sec();
+  printf("  PeakFinder8 %.1f us, peakfinder8 %.1f us per frame\n", 1e6*(t1-t0)/nframes, 1e6*(t2-t1)/nframes);
+
+  return ctest_status();
+}
+
+//-------------------
@@ -155,7 +155,7 @@ if 'PEAKFINDER' in BUILD_LIST :
                              "psana/peakFinder/src/LocalExtrema.cc"],
                     libraries = ['utils'], # for SysLog
                     language="c++",
-                    extra_compile_args = extra_cxx_compile_args,
+                    extra_compile_args = extra_cxx_compile_args + ['-fopenmp-simd'],
                     extra_link_args = extra_link_args_rpath,
                     include_dirs=[np.get_include(), os.path.join(instdir, 'include')],
                     library_dirs = [os.path.join(instdir, 'lib')],
@@ -169,7 +169,7 @@ if 'PEAKFINDER' in BUILD_LIST :
                              "psana/peakFinder/src/LocalExtrema.cc"],
                     libraries = ['utils'], # for SysLog
                     language="c++",
-                    extra_compile_args = extra_cxx_compile_args,
+                    extra_compile_args = extra_cxx_compile_args + ['-fopenmp-simd'],
                     extra_link_args = extra_link_args_rpath,
                     include_dirs=[np.get_include(), os.path.join(instdir, 'include')],
                     library_dirs = [os.path.join(instdir, 'lib')],
@@ -181,8 +181,8 @@ if 'PEAKFINDER' in BUILD_LIST :
                              "psana/peakFinder/peakfinder8.cc"],
                     libraries = ['utils'], # for SysLog
                     language="c++",
-                    extra_compile_args = extra_cxx_compile_args,
-                    extra_link_args = extra_link_args_rpath,
+                    extra_compile_args = extra_cxx_compile_args + openmp_compile_args,
+                    extra_link_args = extra_link_args_rpath + openmp_link_args,
                     include_dirs=[np.get_include(), os.path.join(instdir, 'include')],
                     library_dirs = [os.path.join(instdir, 'lib')],
     )
@@ -198,13 +198,14 @@ if 'HEXANODE' in BUILD_LIST :
                                  "psana/hexanode/src/cfib.cc",
                                  "psana/hexanode/src/wrap_resort64c.cc",
                                  "psana/hexanode/src/SortUtils.cc",
+                                 "psana/hexanode/src/ParallelSort.cc",
                                  "psana/hexanode/src/LMF_IO.cc"],
                         language="c++",
-                        extra_compile_args = extra_cxx_compile_args,
+                        extra_compile_args = extra_cxx_compile_args + openmp_compile_args,
                         include_dirs=[os.path.join(sys.prefix,'include'), np.get_include(), os.path.join(instdir, 'include')],
                         library_dirs = [os.path.join(instdir, 'lib'), os.path.join(sys.prefix, 'lib')],
                         libraries=['Resort64c_x64'],
-                        extra_link_args = extra_link_args,
+                        extra_link_args = extra_link_args + openmp_link_args,
         )
         CYTHON_EXTS.append(ext)
 
@@ -321,12 +322,12 @@ if 'HSD' in BUILD_LIST :
                     sources=["psana/hsd/hsd.pyx"],
                     libraries=[],
                     language="c++",
-                    extra_compile_args=extra_cxx_compile_args,
+                    extra_compile_args=extra_cxx_compile_args + openmp_compile_args,
                     include_dirs=[np.get_include(),
                                   "../install/include",
                                   os.path.join(instdir, 'include')],
                     library_dirs = [os.path.join(instdir, 'lib')],
-                    extra_link_args = extra_link_args_rpath,
+                    extra_link_args = extra_link_args_rpath + openmp_link_args,
     )
     CYTHON_EXTS.append(ext)
 
@@ -336,11 +337,11 @@ if 'NDARRAY' in BUILD_LIST :
                     sources=["psana/pycalgos/NDArray_ext.pyx",
                              "psana/peakFinder/src/WFAlgos.cc"],
                     language="c++",
-                    extra_compile_args = extra_cxx_compile_args,
+                    extra_compile_args = extra_cxx_compile_args + openmp_compile_args,
                     include_dirs=["psana",os.path.join(sys.prefix,'include'),np.get_include(),os.path.join(instdir,'include')],
                     library_dirs = [os.path.join(instdir, 'lib')],
                     libraries=[],
-                    extra_link_args = extra_link_args,
+                    extra_link_args = extra_link_args + openmp_link_args,
     )
     CYTHON_EXTS.append(ext)
 
@@ -124,7 +124,7 @@ void AreaDetector::event(XtcData::Dgram& dgram, const void* bufEnd, PGPEvent* ev
             uint32_t dmaIndex = event->buffers[i].index;
             uint8_t* rawdata = ((uint8_t*)m_pool->dmaBuffers[dmaIndex]) + 32;
 
-            memcpy((uint8_t*)raw.data() + size, (uint8_t*)rawdata, dataSize);
+            m_pool->copyPayload((uint8_t*)raw.data() + size, (uint8_t*)rawdata, dataSize);
             size += dataSize;
             nlanes++;
          }
@@ -1194,6 +1194,8 @@ int main(int argc, char* argv[])
         if (kwargs.first == "pebbleBufCount") continue;  // DrpBase
         if (kwargs.first == "batching")       continue;  // DrpBase
         if (kwargs.first == "directIO")       continue;  // DrpBase
+        if (kwargs.first == "traceInterval")  continue;  // DrpBase
+        if (kwargs.first == "traceFile")      continue;  // DrpBase
         if (kwargs.first == "interface")      continue;
         logging::critical("Unrecognized kwarg '%s=%s'\n",
                           kwargs.first.c_str(), kwargs.second.c_str());
@@ -1201,6 +1201,8 @@ int main(int argc, char* argv[])
         if (kwargs.first == "pebbleBufCount") continue;  // DrpBase
         if (kwargs.first == "batching")       continue;  // DrpBase
         if (kwargs.first == "directIO")       continue;  // DrpBase
+        if (kwargs.first == "traceInterval")  continue;  // DrpBase
+        if (kwargs.first == "traceFile")      continue;  // DrpBase
         if (kwargs.first == "interface")      continue;
         if (kwargs.first == "timeout")        continue;
         logging::critical("Unrecognized kwarg '%s=%s'\n",
@@ -8,6 +8,7 @@
 #include "rapidjson/document.h"
 #include "xtcdata/xtc/XtcIterator.hh"
 #include "psalg/digitizer/Hsd.hh"
+#include "psalg/digitizer/HsdFex.hh"
 #include "DataDriver.h"
 #include "Si570.hh"
 #include "psalg/utils/SysLog.hh"
@@ -47,6 +48,26 @@ public:
     }
 };
 
+class FexDef : public VarDef
+{
+public:
+    enum index {Start = 0, Width, Integral, Time, NumFields};
+    FexDef(unsigned lane_mask)
+    {
+        static const char* fieldName[] = {"start", "width", "integral", "time"};
+        static const Name::DataType fieldType[] = {Name::UINT32, Name::UINT32, Name::FLOAT, Name::FLOAT};
+        const unsigned nameLen = 16;
+        char chanName[nameLen];
+        for (unsigned i = 0; i < sizeof(lane_mask)*sizeof(uint8_t); i++){
+            if (!((1<<i)&lane_mask)) continue;
+            for (unsigned f = 0; f < NumFields; f++) {
+                snprintf(chanName, nameLen, "chan%2.2d_%s", i, fieldName[f]);
+                NameVec.push_back({chanName, fieldType[f], 1});
+            }
+        }
+    }
+};
+
 static PyObject* check(PyObject* obj, const char* err) {
     if (!obj) {
         logging::critical("Python error: '%s'", err);
@@ -58,10 +79,24 @@ static PyObject* check(PyObject* obj, const char* err) {
 
 Digitizer::Digitizer(Parameters* para, MemPool* pool) :
     Detector    (para, pool),
-    m_epics_name(para->kwargs["hsd_epics_prefix"])
+    m_epics_name(para->kwargs["hsd_epics_prefix"]),
+    m_fexEnabled(false),
+    m_fexDropRaw(false),
+    m_fexFraction(0.5),
+    m_fex       (0)
 {
     printf("*** found epics name %s\n",m_epics_name.c_str());
 
+    //
+    //  Optional peak lists next to the raw data
+    //
+    if (para->kwargs.find("hsd_fex") != para->kwargs.end())
+        m_fexEnabled = para->kwargs["hsd_fex"] == "yes";
+    if (para->kwargs.find("hsd_fex_dropraw") != para->kwargs.end())
+        m_fexDropRaw = para->kwargs["hsd_fex_dropraw"] == "yes";
+    if (para->kwargs.find("hsd_fex_fraction") != para->kwargs.end())
+        m_fexFraction = std::stof(para->kwargs["hsd_fex_fraction"]);
+
     //
     // Check PGP reference clock, reprogram if necessary
     //
@@ -160,6 +195,7 @@ Digitizer::Digitizer(Parameters* para, MemPool* pool) :
 
 Digitizer::~Digitizer()
 {
+    delete m_fex;
     delete m_configScanner;
     Py_DECREF(m_module);
 }
@@ -224,6 +260,8 @@ unsigned Digitizer::_addJson(Xtc& xtc, const void* bufEnd, NamesId& configNamesI
     auto payload = xtc.alloc(jsonxtc.sizeofPayload(), bufEnd);
     memcpy(payload,(const void*)jsonxtc.payload(),jsonxtc.sizeofPayload());
 
+    _fexConfig(json);
+
     // get the lane mask from the json
     unsigned lane_mask = 1;
     printf("hsd lane_mask is 0x%x\n",lane_mask);
@@ -274,9 +312,79 @@ unsigned Digitizer::configure(const std::string& config_alias, Xtc& xtc, const v
     HsdDef myHsdDef(lane_mask);
     eventNames.add(xtc, bufEnd, myHsdDef);
     m_namesLookup[m_evtNamesId] = NameIndex(eventNames);
+
+    // set up the names for the peak lists
+    if (m_fex) {
+        m_fexNamesId = NamesId(nodeId, FexNamesIndex);
+        Alg fexAlg("fex", 1, 0, 0);
+        Names& fexNames = *new(xtc, bufEnd) Names(bufEnd,
+                                                  m_para->detName.c_str(), fexAlg,
+                                                  m_para->detType.c_str(), m_para->serNo.c_str(), m_fexNamesId, m_para->detSegment);
+        FexDef myFexDef(lane_mask);
+        fexNames.add(xtc, bufEnd, myFexDef);
+        m_namesLookup[m_fexNamesId] = NameIndex(fexNames);
+    }
     return 0;
 }
 
+void Digitizer::_fexConfig(const char* json)
+{
+    delete m_fex;
+    m_fex = 0;
+    if (!m_fexEnabled) return;
+
+    // the firmware sparsifies samples inside of [ymin,ymax], which is also
+    // the band used to find peaks in the raw waveforms
+    Document top;
+    top.Parse(json);
+    if (top.HasParseError() || !top.HasMember("user") || !top["user"].HasMember("fex") ||
+        !top["user"]["fex"].HasMember("ymin") || !top["user"]["fex"].HasMember("ymax")) {
+        logging::error("hsd_fex: no user.fex.ymin/ymax in the configuration.  Peak lists disabled.");
+        return;
+    }
+    const Value& fex = top["user"]["fex"];
+    m_fex = new Pds::HSD::PeakExtractor(fex["ymin"].GetInt(), fex["ymax"].GetInt(), m_fexFraction);
+    logging::info("hsd_fex: peak lists for ymin %d ymax %d fraction %f%s",
+                  fex["ymin"].GetInt(), fex["ymax"].GetInt(), m_fexFraction,
+                  m_fexDropRaw ? ", raw data only with the raw stream" : "");
+}
+
+void Digitizer::_fexEvent(XtcData::Dgram& dgram, const void* bufEnd, PGPEvent* event, const uint32_t* evtheader)
+{
+    CreateData fex(dgram.xtc, bufEnd, m_namesLookup, m_fexNamesId);
+
+    // peaks are found on the stack, so that the workers share nothing
+    Pds::HSD::Peak peaks[MaxFexPeaks];
+    unsigned shape[MaxRank];
+    unsigned index = 0;
+    for (int i=0; i<PGP_MAX_LANES; i++) {
+        if (!(event->mask & (1 << i))) continue;
+        unsigned npeaks = 0;
+        unsigned data_size = event->buffers[i].size - sizeof(Pds::TimingHeader);
+        if (data_size < 1000000) {
+            uint32_t dmaIndex = event->buffers[i].index;
+            const uint8_t* p = (const uint8_t*)m_pool->dmaBuffers[dmaIndex]+sizeof(Pds::TimingHeader);
+            npeaks = m_fex->extract(evtheader, p, data_size, peaks, MaxFexPeaks);
+            if (npeaks > MaxFexPeaks) {
+                dgram.xtc.damage.increase(Damage::Truncated);
+                npeaks = MaxFexPeaks;
+            }
+        }
+        shape[0] = npeaks;
+        Array<uint32_t> start    = fex.allocate<uint32_t>(index+FexDef::Start,    shape);
+        Array<uint32_t> width    = fex.allocate<uint32_t>(index+FexDef::Width,    shape);
+        Array<float>    integral = fex.allocate<float>   (index+FexDef::Integral, shape);
+        Array<float>    time     = fex.allocate<float>   (index+FexDef::Time,     shape);
+        for (unsigned k=0; k<npeaks; k++) {
+            start   (k) = peaks[k].start;
+            width   (k) = peaks[k].width;
+            integral(k) = peaks[k].integral;
+            time    (k) = peaks[k].time;
+        }
+        index += FexDef::NumFields;
+    }
+}
+
 void Digitizer::event(XtcData::Dgram& dgram, const void* bufEnd, PGPEvent* event)
 {
     CreateData hsd(dgram.xtc, bufEnd, m_namesLookup, m_evtNamesId);
@@ -309,10 +417,14 @@ void Digitizer::event(XtcData::Dgram& dgram, const void* bufEnd, PGPEvent* event
               dgram.xtc.damage.increase(Damage::UserDefined);
               continue;
             }
-            shape[0] = data_size;
+            // with peak lists, the raw data can be kept only on the events
+            // where the firmware sent the raw waveform (see raw prescale)
+            bool dropRaw = m_fex && m_fexDropRaw && !(arrayH(0) & (1<<20));
+            shape[0] = dropRaw ? 0 : data_size;
             Array<uint8_t> arrayT = hsd.allocate<uint8_t>(i+1, shape);
             uint32_t dmaIndex = event->buffers[i].index;
-            memcpy(arrayT.data(), (uint8_t*)m_pool->dmaBuffers[dmaIndex] + sizeof(Pds::TimingHeader), data_size);
+            if (!dropRaw)
+                m_pool->copyPayload(arrayT.data(), (uint8_t*)m_pool->dmaBuffers[dmaIndex] + sizeof(Pds::TimingHeader), data_size);
             //
             // Check the overflow bit in the stream headers
             //
@@ -336,6 +448,9 @@ void Digitizer::event(XtcData::Dgram& dgram, const void* bufEnd, PGPEvent* event
             //printf("*** npeaks %d\n",channel.npeaks());
          }
     }
+
+    if (m_fex)
+        _fexEvent(dgram, bufEnd, event, timing_header->_opaque);
 }
 
 void Digitizer::shutdown()
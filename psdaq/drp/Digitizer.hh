@@ -8,6 +8,8 @@
 #include "psalg/alloc/Allocator.hh"
 #include <Python.h>
 
+namespace Pds { namespace HSD { class PeakExtractor; } }
+
 namespace Drp {
     class PythonConfigScanner;
 
@@ -27,16 +29,24 @@ namespace Drp {
 
     private:
         unsigned _addJson(XtcData::Xtc& xtc, const void* bufEnd, XtcData::NamesId& configNamesId, const std::string& config_alias);
+        void _fexConfig(const char* json);
+        void _fexEvent(XtcData::Dgram& dgram, const void* bufEnd, PGPEvent* event, const uint32_t* evtheader);
     private:
-        enum {ConfigNamesIndex = NamesIndex::BASE, EventNamesIndex, UpdateNamesIndex};
+        enum {ConfigNamesIndex = NamesIndex::BASE, EventNamesIndex, UpdateNamesIndex, FexNamesIndex};
+        enum {MaxFexPeaks = 1024};    // per lane and event
         unsigned             m_readoutGroup;
         XtcData::NamesId     m_evtNamesId;
+        XtcData::NamesId     m_fexNamesId;
         std::string          m_connect_json;
         std::string          m_epics_name;
         Heap                 m_allocator;
         PyObject*            m_module;        // python module
         PythonConfigScanner* m_configScanner;
         unsigned             m_paddr;
+        bool                 m_fexEnabled;    // kwarg hsd_fex=yes
+        bool                 m_fexDropRaw;    // kwarg hsd_fex_dropraw=yes
+        float                m_fexFraction;   // kwarg hsd_fex_fraction
+        Pds::HSD::PeakExtractor* m_fex;       // 0 unless the peak lists are configured
     };
 
 }
@@ -53,22 +53,6 @@ static long readInfinibandCounter(const std::string& counter)
     }
 }
 
-static unsigned nextPowerOf2(unsigned n)
-{
-    unsigned count = 0;
-
-    if (n && !(n & (n - 1))) {
-        return n;
-    }
-
-    while( n != 0) {
-        n >>= 1;
-        count += 1;
-    }
-
-    return 1 << count;
-}
-
 
 void Pebble::create(unsigned nL1Buffers, size_t l1BufSize, unsigned nTrBuffers, size_t trBufSize)
 {
@@ -87,6 +71,7 @@ void Pebble::create(unsigned nL1Buffers, size_t l1BufSize, unsigned nTrBuffers,
 }
 
 MemPool::MemPool(Parameters& para) :
+    m_trBufSize(para.maxTrSize),
     m_transitionBuffers(nextPowerOf2(Pds::Eb::TEB_TR_BUFFERS)), // See eb.hh
     m_dmaAllocs(0),
     m_dmaFrees(0),
@@ -127,7 +112,7 @@ MemPool::MemPool(Parameters& para) :
                         m_nbuffers, m_nDmaBuffers);
       abort();
     }
-    auto nTrBuffers = m_transitionBuffers.size();
+    auto nTrBuffers = m_transitionBuffers.count();
     pebble.create(m_nbuffers, maxL1ASize, nTrBuffers, para.maxTrSize);
     logging::info("nL1Buffers %u,  pebble buffer size %zu", m_nbuffers, pebble.bufferSize());
     logging::info("nTrBuffers %u,  transition buffer size %zu", nTrBuffers, para.maxTrSize);
@@ -135,11 +120,21 @@ MemPool::MemPool(Parameters& para) :
     pgpEvents.resize(m_nDmaBuffers);
     transitionDgrams.resize(m_nbuffers);
 
+    // The pebble and transition buffers are handed out by index from lock-free
+    // rings so that neither allocation nor release crosses a mutex
+    m_pebbleBuffers = std::make_unique<IndexAllocator>(m_nbuffers);
+
+    // Sample 1 in traceInterval events for per-stage latency tracing
+    unsigned traceInterval = para.kwargs.find("traceInterval") == para.kwargs.end()
+                           ? 0 : std::stoul(para.kwargs["traceInterval"]);
+    trace.init(m_nbuffers, traceInterval);
+
+    // Leave pass-through payloads in the DMA buffers until the dgram is written
+    m_zeroCopy = para.kwargs["zeroCopy"] == "yes";
+    m_payloadRefs.resize(m_nbuffers);
+
     // Put the transition buffer pool at the end of the pebble buffers
-    uint8_t* buffer = pebble[m_nbuffers];
-    for (size_t i = 0; i < m_transitionBuffers.size(); i++) {
-        m_transitionBuffers.push(&buffer[i * para.maxTrSize]);
-    }
+    m_trBuffers = pebble[m_nbuffers];
     m_setMaskBytesDone = false;
 }
 
@@ -158,20 +153,14 @@ unsigned MemPool::countDma()
 
 unsigned MemPool::allocate()
 {
-    auto allocs = m_allocs.fetch_add(1, std::memory_order_acq_rel);
-    asm volatile("mfence" ::: "memory");
-    auto frees  = m_frees.load(std::memory_order_acquire);
-
     // Block when there are no available pebble buffers
-    if (allocs - frees == m_nbuffers - 1) {
-        std::unique_lock<std::mutex> lock(m_lock);
-        m_condition.wait(lock, [this] {
-            return (m_allocs.load(std::memory_order_acquire) -
-                    m_frees.load(std::memory_order_acquire)) != m_nbuffers;
-        });
+    uint32_t index;
+    if (!m_pebbleBuffers->allocate(index)) {
+        return InvalidIndex;            // Can happen during shutdown
     }
+    m_allocs.fetch_add(1, std::memory_order_relaxed);
 
-    return allocs;
+    return index;
 }
 
 void MemPool::freeDma(std::vector<uint32_t>& indices, unsigned count)
@@ -181,40 +170,96 @@ void MemPool::freeDma(std::vector<uint32_t>& indices, unsigned count)
     m_dmaFrees.fetch_add(count, std::memory_order_acq_rel);
 }
 
-void MemPool::freePebble()
+void MemPool::freePebble(unsigned index)
+{
+    m_frees.fetch_add(1, std::memory_order_relaxed);
+
+    // Wakes up the allocator if it was waiting for a free pebble buffer
+    m_pebbleBuffers->free(index);
+}
+
+uint8_t* MemPool::_dgram(unsigned index)
+{
+    // The dgram is written from its XtcData::Dgram, after the PulseId of the EbDgram
+    XtcData::Dgram* dgram = reinterpret_cast<Pds::EbDgram*>(pebble[index]);
+    return reinterpret_cast<uint8_t*>(dgram);
+}
+
+void MemPool::copyPayload(void* dst, const void* src, size_t size)
+{
+    // Only L1Accept dgrams in the pebble can refer to the DMA buffers
+    uint8_t* p = static_cast<uint8_t*>(dst);
+    if (m_zeroCopy && p >= pebble[0] && p < pebble[m_nbuffers]) {
+        unsigned index = (p - pebble[0]) / bufferSize();
+        if (m_payloadRefs[index].add(_dgram(index), dst, src, size))  return;
+    }
+    memcpy(dst, src, size);
+}
+
+void MemPool::resolvePayload(unsigned index)
+{
+    // Copy for the consumers that need the dgram in contiguous memory
+    m_payloadRefs[index].resolve(_dgram(index));
+}
+
+void MemPool::holdDma(PGPEvent* event)
 {
-    auto frees  = m_frees.fetch_add(1, std::memory_order_acq_rel);
-    asm volatile("mfence" ::: "memory");
-    auto allocs = m_allocs.load(std::memory_order_acquire);
+    PayloadRefs& refs = m_payloadRefs[event->pebbleIndex];
+    for (int i=0; i<PGP_MAX_LANES; i++) {
+        if (event->mask &  (1 << i)) {
+            event->mask ^= (1 << i);
+            refs.dmaIndex[refs.nDma++] = event->buffers[i].index;
+        }
+    }
+}
 
-    // Release when all pebble buffers were in use but now one is free
-    if (allocs - frees == m_nbuffers) {
-        std::unique_lock<std::mutex> lock(m_lock);
-        m_condition.notify_one();
+void MemPool::releasePayload(unsigned index)
+{
+    PayloadRefs& refs = m_payloadRefs[index];
+    refs.count = 0;
+    if (refs.nDma) {
+        dmaRetIndexes(m_fd, refs.nDma, refs.dmaIndex);
+        m_dmaFrees.fetch_add(refs.nDma, std::memory_order_acq_rel);
+        refs.nDma = 0;
     }
 }
 
 Pds::EbDgram* MemPool::allocateTr()
 {
-    void* dgram = nullptr;
-    if (!m_transitionBuffers.pop(dgram)) {
+    uint32_t index;
+    if (!m_transitionBuffers.allocate(index)) {
         // See comments for setting the number of transition buffers in eb.hh
-        return nullptr;
+        return nullptr;                 // Can happen during shutdown
     }
-    return static_cast<Pds::EbDgram*>(dgram);
+    return reinterpret_cast<Pds::EbDgram*>(&m_trBuffers[index * m_trBufSize]);
+}
+
+void MemPool::freeTr(Pds::EbDgram* dgram)
+{
+    size_t offset = reinterpret_cast<uint8_t*>(dgram) - m_trBuffers;
+    m_transitionBuffers.free(offset / m_trBufSize);
 }
 
 void MemPool::resetCounters()
 {
+    // Return the DMA buffers still held for dgrams that were not written
+    for (unsigned i = 0; i < m_payloadRefs.size(); i++) {
+        releasePayload(i);
+    }
+
     m_dmaAllocs.store(0);
     m_dmaFrees .store(0);
     m_allocs   .store(0);
     m_frees    .store(0);
+
+    // All pebble buffers are free when the counters are reset
+    m_pebbleBuffers->reset();
 }
 
 void MemPool::shutdown()
 {
     m_transitionBuffers.shutdown();
+    m_pebbleBuffers->shutdown();
 }
 
 int MemPool::setMaskBytes(uint8_t laneMask, unsigned virtChan)
@@ -358,8 +403,12 @@ const Pds::TimingHeader* PgpReader::handle(Detector* det, unsigned current)
 
     if (event->mask == m_para.laneMask) {
         // Allocate a pebble buffer once the event is built
-        auto counter = m_pool.allocate(); // This can block
-        event->pebbleIndex = counter & (m_pool.nbuffers() - 1);
+        event->pebbleIndex = m_pool.allocate(); // This can block
+        if (event->pebbleIndex == MemPool::InvalidIndex) {
+            freeDma(event);             // Leaves event mask = 0
+            return nullptr;             // Can happen during shutdown
+        }
+        m_pool.trace.start(event->pebbleIndex, evtCounter, timingHeader->pulseId(), transitionId);
 
         if (transitionId != XtcData::TransitionId::L1Accept) {
             if (transitionId != XtcData::TransitionId::SlowUpdate) {
@@ -398,9 +447,9 @@ const Pds::TimingHeader* PgpReader::handle(Detector* det, unsigned current)
         m_lastTid = transitionId;
         memcpy(m_lastData, data, 24);
 
-        // Allocate a transition datagram from the pool.  Since a
-        // SPSCQueue is used (not an SPMC queue), this can be done here,
-        // but not in the workers or there will be concurrency issues.
+        // Allocate a transition datagram from the pool.  The allocation
+        // is done here so that the transition buffers are handed out in
+        // the same order as the pebble buffers.
         if (transitionId != XtcData::TransitionId::L1Accept) {
             uint32_t evtIndex = event->pebbleIndex;
             m_pool.transitionDgrams[evtIndex] = m_pool.allocateTr();
@@ -659,10 +708,17 @@ void EbReceiver::resetCounters(bool all = false)
     m_latency = 0;
 }
 
-void EbReceiver::_writeDgram(XtcData::Dgram* dgram)
+void EbReceiver::_writeDgram(XtcData::Dgram* dgram, const PayloadRefs* refs)
 {
     size_t size = sizeof(*dgram) + dgram->xtc.sizeofPayload();
-    m_fileWriter.writeEvent(dgram, size, dgram->time);
+    if (refs && refs->count) {
+        // Gather the dgram from the pebble and the DMA buffers it refers to
+        struct iovec iov[2*PGP_MAX_LANES+1];
+        int n = refs->gather(reinterpret_cast<const uint8_t*>(dgram), size, iov);
+        m_fileWriter.writeEvent(iov, n, size, dgram->time);
+    }
+    else
+        m_fileWriter.writeEvent(dgram, size, dgram->time);
 
     // small data writing
     Smd smd;
@@ -682,6 +738,8 @@ void EbReceiver::process(const Pds::Eb::ResultDgram& result, unsigned index)
         error = true;
     }
 
+    m_pool.trace.stamp(index, EventTrace::ResultArrival);
+
     Pds::EbDgram* dgram = (Pds::EbDgram*)m_pool.pebble[index];
     uint64_t pulseId = dgram->pulseId();
     XtcData::TransitionId::Value transitionId = dgram->service();
@@ -786,7 +844,8 @@ void EbReceiver::process(const Pds::Eb::ResultDgram& result, unsigned index)
         if (m_writing) {                    // Won't ever be true for Configure
             // write event to file if it passes event builder or if it's a transition
             if (result.persist() || result.prescale()) {
-                _writeDgram(dgram);
+                _writeDgram(dgram, transitionId == XtcData::TransitionId::L1Accept ? &m_pool.payloadRefs(index) : nullptr);
+                m_pool.trace.stamp(index, EventTrace::FileWrite);
             }
             else if (transitionId != XtcData::TransitionId::L1Accept) {
                 if (transitionId == XtcData::TransitionId::BeginRun) {
@@ -817,6 +876,7 @@ void EbReceiver::process(const Pds::Eb::ResultDgram& result, unsigned index)
             // L1Accept
             if (result.isEvent()) {
                 if (result.monitor()) {
+                    m_pool.resolvePayload(index);
                     m_mon.post(dgram, result.monBufNo());
                 }
             }
@@ -853,8 +913,16 @@ void EbReceiver::process(const Pds::Eb::ResultDgram& result, unsigned index)
         m_pool.freeTr(dgram);
     }
 
+    // Return the DMA buffers the dgram referred to
+    if (transitionId == XtcData::TransitionId::L1Accept) {
+        m_pool.releasePayload(index);
+    }
+
+    // Record the event's trace, if it was sampled, before its buffer is reused
+    m_pool.trace.complete(index);
+
     // Free the pebble datagram buffer
-    m_pool.freePebble();
+    m_pool.freePebble(index);
 }
 
 
@@ -910,6 +978,8 @@ DrpBase::DrpBase(Parameters& para, ZmqContext& context) :
                     [&](){return pool.inUse();});
     m_exporter->constant("drp_pebble_in_use_max", labels, pool.nbuffers());
 
+    pool.trace.registerMetrics(m_exporter, labels);
+
     m_exporter->addFloat("drp_deadtime", labels,
                          [&](double& value){return _pvVectElem(m_deadtimePv, m_xpmPort, value);});
 
@@ -1158,6 +1228,12 @@ void DrpBase::unconfigure()
         m_mebContributor->unconfigure();
     }
     m_ebRecv->unconfigure();
+
+    // Save the most recent event traces for examination with drp_trace_dump
+    auto it = m_para.kwargs.find("traceFile");
+    if (pool.trace.enabled() && it != m_para.kwargs.end()) {
+        pool.trace.dump(it->second);
+    }
 }
 
 void DrpBase::disconnect()
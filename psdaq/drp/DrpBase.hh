@@ -103,7 +103,7 @@ public:
     static const uint64_t DefaultChunkThresh = 500ull * 1024ull * 1024ull * 1024ull;    // 500 GB
     FileParameters *fileParameters()    { return &m_fileParameters; }
 private:
-    void _writeDgram(XtcData::Dgram* dgram);
+    void _writeDgram(XtcData::Dgram* dgram, const PayloadRefs* refs = nullptr);
 private:
     MemPool& m_pool;
     Detector* m_det;
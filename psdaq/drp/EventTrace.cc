@@ -0,0 +1,141 @@
+#include "EventTrace.hh"
+#include "psdaq/service/MetricExporter.hh"
+#include "psalg/utils/SysLog.hh"
+
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+
+using logging = psalg::SysLog;
+
+namespace Drp {
+
+static double calibrateTsc()
+{
+    auto     t0 = std::chrono::steady_clock::now();
+    uint64_t c0 = __rdtsc();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto     t1 = std::chrono::steady_clock::now();
+    uint64_t c1 = __rdtsc();
+    auto     us = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / 1000.0;
+    return double(c1 - c0) / us;
+}
+
+EventTrace::EventTrace() :
+    m_interval  (0),
+    m_ticksPerUs(1.0),
+    m_ringMask  (0),
+    m_head      (0)
+{
+}
+
+void EventTrace::init(unsigned nbuffers, unsigned interval, unsigned ringSize)
+{
+    m_interval = interval;
+    if (!m_interval)  return;
+
+    unsigned size = 1;
+    while (size < ringSize)  size <<= 1;
+
+    m_slots.resize(nbuffers);
+    for (auto& rec : m_slots)  rec.pulseId = 0;
+    m_ring     = std::unique_ptr<Entry[]>(new Entry[size]);
+    m_ringMask = size - 1;
+    for (unsigned i = 0; i < size; ++i)  m_ring[i].seq.store(0, std::memory_order_relaxed);
+    m_head.store(0, std::memory_order_relaxed);
+
+    m_ticksPerUs = calibrateTsc();
+    logging::info("Event tracing enabled: 1 in %u events, TSC %.1f ticks/us", m_interval, m_ticksPerUs);
+}
+
+void EventTrace::registerMetrics(const std::shared_ptr<Pds::MetricExporter>& exporter,
+                                 const std::map<std::string, std::string>& labels)
+{
+    if (!m_interval)  return;
+
+    // Latency of each stage with respect to the previous visited one, in us
+    m_histos.resize(NumStages);
+    for (unsigned i = WorkerStart; i < NumStages; ++i) {
+        std::string name = std::string("drp_stage_latency_") + stageNames[i];
+        m_histos[i] = exporter->histogram(name, labels, 100, 10.0);
+    }
+}
+
+void EventTrace::complete(unsigned index)
+{
+    if (!m_interval)  return;
+    Record& rec = m_slots[index];
+    if (!rec.pulseId)  return;
+
+    rec.tsc[Released] = __rdtsc();
+
+    if (!m_histos.empty()) {
+        uint64_t prev = rec.tsc[EventBuilt];
+        for (unsigned i = WorkerStart; i < NumStages; ++i) {
+            if (!rec.tsc[i])  continue;
+            m_histos[i]->observe(double(rec.tsc[i] - prev) / m_ticksPerUs);
+            prev = rec.tsc[i];
+        }
+    }
+
+    // Single producer: the sequence is odd while the entry is being written
+    uint64_t pos   = m_head.load(std::memory_order_relaxed);
+    Entry&   entry = m_ring[pos & m_ringMask];
+    entry.seq.store(2 * pos + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    entry.record = rec;
+    entry.seq.store(2 * pos + 2, std::memory_order_release);
+    m_head.store(pos + 1, std::memory_order_release);
+
+    rec.pulseId = 0;
+}
+
+size_t EventTrace::snapshot(std::vector<Record>& records) const
+{
+    records.clear();
+    if (!m_interval)  return 0;
+
+    uint64_t head  = m_head.load(std::memory_order_acquire);
+    uint64_t size  = m_ringMask + 1;
+    uint64_t first = head > size ? head - size : 0;
+    records.reserve(head - first);
+    for (uint64_t pos = first; pos < head; ++pos) {
+        const Entry& entry = m_ring[pos & m_ringMask];
+        if (entry.seq.load(std::memory_order_acquire) != 2 * pos + 2)  continue;
+        Record rec = entry.record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (entry.seq.load(std::memory_order_relaxed) != 2 * pos + 2)  continue; // Overwritten
+        records.push_back(rec);
+    }
+    return records.size();
+}
+
+int EventTrace::dump(const std::string& fileName) const
+{
+    std::vector<Record> records;
+    snapshot(records);
+
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file) {
+        logging::error("Error opening trace file %s: %m", fileName.c_str());
+        return -1;
+    }
+    FileHeader hdr;
+    hdr.magic      = Magic;
+    hdr.version    = Version;
+    hdr.numStages  = NumStages;
+    hdr.numRecords = records.size();
+    hdr.ticksPerUs = m_ticksPerUs;
+    int rc = 0;
+    if (fwrite(&hdr, sizeof(hdr), 1, file) != 1 ||
+        fwrite(records.data(), sizeof(Record), records.size(), file) != records.size()) {
+        logging::error("Error writing trace file %s: %m", fileName.c_str());
+        rc = -1;
+    }
+    fclose(file);
+    if (!rc)  logging::info("Wrote %zu event trace records to %s", records.size(), fileName.c_str());
+    return rc;
+}
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <x86intrin.h>                  // __rdtsc()
+
+namespace Pds {
+    class MetricExporter;
+    class PromHistogram;
+};
+
+namespace Drp {
+
+// Low overhead per-event timestamping of the DRP pipeline stages.
+//
+// One event in every 'interval' is sampled when its pebble buffer is
+// allocated.  Each stage then records the TSC in the pebble's trace slot.
+// Since a pebble buffer is owned by exactly one thread at a time (reader,
+// worker, collector, EbReceiver) and is handed between them through the
+// existing queues, the slots need no locking.  When the EbReceiver releases
+// the pebble, the stage-to-stage latencies are added to Prometheus
+// histograms and the record is appended to a lock-free flight-recorder
+// ring that can be dumped to a file and examined with drp_trace_dump.
+class EventTrace
+{
+public:
+    enum Stage { EventBuilt, WorkerStart, WorkerDone, TebPost, ResultArrival, FileWrite, Released, NumStages };
+
+    struct Record
+    {
+        uint64_t pulseId;
+        uint32_t evtCounter;
+        uint32_t service;
+        uint64_t tsc[NumStages];        // 0 when the stage was not visited
+    };
+
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t numStages;
+        uint32_t numRecords;
+        double   ticksPerUs;
+    };
+    static const uint32_t Magic   = 0x44525054; // "DRPT"
+    static const uint32_t Version = 1;
+
+    static const char* name(Stage stage)
+    {
+        static const char* const names[] = { "event_built", "worker_start", "worker_done",
+                                             "teb_post", "result_arrival", "file_write", "released" };
+        return stage < NumStages ? names[stage] : "unknown";
+    }
+
+public:
+    EventTrace();
+    void init(unsigned nbuffers, unsigned interval, unsigned ringSize = 4096);
+    void registerMetrics(const std::shared_ptr<Pds::MetricExporter>& exporter,
+                         const std::map<std::string, std::string>& labels);
+    bool enabled() const { return m_interval != 0; }
+
+    // Called by the reader when a pebble buffer is allocated to an event,
+    // i.e. once the DMA buffers of all its lanes have been seen
+    inline void start(unsigned index, uint32_t evtCounter, uint64_t pulseId, unsigned service)
+    {
+        if (!m_interval)  return;
+        Record& rec  = m_slots[index];
+        rec.pulseId  = 0;
+        if ((evtCounter % m_interval) == 0) {
+            for (unsigned i = 0; i < NumStages; ++i)  rec.tsc[i] = 0;
+            rec.evtCounter = evtCounter;
+            rec.service    = service;
+            rec.pulseId    = pulseId;
+            rec.tsc[EventBuilt] = __rdtsc();
+        }
+    }
+
+    inline void stamp(unsigned index, Stage stage)
+    {
+        if (!m_interval)  return;
+        Record& rec = m_slots[index];
+        if (rec.pulseId)  rec.tsc[stage] = __rdtsc();
+    }
+
+    // Called by the EbReceiver when the pebble buffer is released
+    void complete(unsigned index);
+
+    // Copy out the most recent completed records, oldest first
+    size_t snapshot(std::vector<Record>& records) const;
+    int dump(const std::string& fileName) const;
+    double ticksPerUs() const { return m_ticksPerUs; }
+private:
+    struct Entry
+    {
+        std::atomic<uint64_t> seq;
+        Record                record;
+    };
+    unsigned                  m_interval;
+    double                    m_ticksPerUs;
+    std::vector<Record>       m_slots;  // Indexed by pebble index
+    std::unique_ptr<Entry[]>  m_ring;
+    uint64_t                  m_ringMask;
+    alignas(64) std::atomic<uint64_t> m_head;
+    std::vector<std::shared_ptr<Pds::PromHistogram> > m_histos;
+};
+
+}
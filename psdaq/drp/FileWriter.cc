@@ -270,6 +270,12 @@ void BufferedFileWriterMT::writeEvent(const void* data, size_t size, XtcData::Ti
     // _write(m_fd, data, size);
     // return;
 
+    struct iovec iov = {const_cast<void*>(data), size};
+    writeEvent(&iov, 1, size, timestamp);
+}
+
+void BufferedFileWriterMT::writeEvent(const struct iovec* iov, int iovcnt, size_t size, XtcData::TimeStamp timestamp)
+{
     // triggered only when starting from scratch
     if (m_batch_starttime.value()==0) m_batch_starttime = timestamp;
 
@@ -298,8 +304,10 @@ void BufferedFileWriterMT::writeEvent(const void* data, size_t size, XtcData::Ti
         std::cout<<"Buffer size "<<(m_bufferSize-b.count)<<" too small for dgram with size "<<size<<'\n';
         throw "FileWriterMT.cc buffer size too small";
     }
-    memcpy(b.p+b.count, data, size);
-    b.count += size;
+    for (int i=0; i<iovcnt; i++) {
+        memcpy(b.p+b.count, iov[i].iov_base, iov[i].iov_len);
+        b.count += iov[i].iov_len;
+    }
 }
 
 void BufferedFileWriterMT::run()
@@ -4,6 +4,7 @@
 #include <string>
 #include <thread>
 #include <vector>
+#include <sys/uio.h>                    // struct iovec
 #include "psdaq/service/Fifo.hh"
 #include "psdaq/service/Task.hh"
 #include "xtcdata/xtc/VarDef.hh"
@@ -39,6 +40,8 @@ public:
     int close();
     void flush();
     void writeEvent(const void* data, size_t size, XtcData::TimeStamp ts);
+    // Gathers the event from iovcnt pieces of size bytes in total
+    void writeEvent(const struct iovec* iov, int iovcnt, size_t size, XtcData::TimeStamp ts);
     void run();
     const uint64_t depth() const { return m_depth; }
     const uint64_t size()  const { return m_size; }
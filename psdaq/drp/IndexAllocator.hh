@@ -0,0 +1,190 @@
+#ifndef INDEXALLOCATOR_H
+#define INDEXALLOCATOR_H
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <climits>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "psalg/utils/SysLog.hh"
+
+// Bounded, lock-free allocator of buffer indices in the range [0, count).
+// The free indices are kept in a ring (Vyukov style MPMC queue) so that
+// allocate() and free() may be called from any number of threads.  When
+// indices are freed in the order they were allocated, they are handed out
+// again in that same order, which preserves the pebble ordering the DRP
+// relies on.  A caller only enters the kernel (futex) when the ring is
+// empty and it has to wait for an index to be returned.
+class IndexAllocator
+{
+public:
+    IndexAllocator(unsigned count) : m_count(count), m_terminate(false), m_futex(0), m_waiters(0)
+    {
+        unsigned capacity = 1;
+        while (capacity < count)  capacity <<= 1;
+        m_ring = std::vector<Cell>(capacity);
+        m_mask = capacity - 1;
+        reset();
+    }
+
+    IndexAllocator(const IndexAllocator&) = delete;
+    void operator=(const IndexAllocator&) = delete;
+
+    // (Re)fill the ring with all indices in ascending order.
+    // Must not be called while other threads are using the allocator.
+    void reset()
+    {
+        for (uint64_t i = 0; i < m_ring.size(); ++i) {
+            m_ring[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_relaxed);
+        for (unsigned i = 0; i < m_count; ++i) {
+            _push(i);
+        }
+        m_terminate.store(false, std::memory_order_release);
+    }
+
+    // Non-blocking allocation: returns false when no index is free
+    bool try_allocate(uint32_t& index)
+    {
+        return _pop(index);
+    }
+
+    // Blocking allocation: spins briefly, then sleeps on a futex until an
+    // index is freed.  Returns false only after shutdown() with an empty ring.
+    bool allocate(uint32_t& index)
+    {
+        for (unsigned i = 0; i < SpinCount; ++i) {
+            if (_pop(index))  return true;
+            asm volatile("pause" ::: "memory");
+        }
+        while (!_pop(index)) {
+            if (m_terminate.load(std::memory_order_acquire))  return false;
+
+            m_waiters.fetch_add(1, std::memory_order_seq_cst);
+            uint32_t seq = m_futex.load(std::memory_order_acquire);
+            // Re-check after announcing ourselves to avoid a lost wakeup
+            if (!empty() || m_terminate.load(std::memory_order_acquire)) {
+                m_waiters.fetch_sub(1, std::memory_order_relaxed);
+                continue;
+            }
+            _futexWait(seq);
+            m_waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    void free(uint32_t index)
+    {
+        if (!_push(index)) {
+            psalg::SysLog::error("IndexAllocator: free of index %u overflowed ring of %u", index, m_count);
+            return;
+        }
+        // avoid reordering of the ring store and the waiters load
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_relaxed)) {
+            m_futex.fetch_add(1, std::memory_order_release);
+            _futexWake(1);
+        }
+    }
+
+    // Wake all waiters; allocate() then fails once the ring is empty
+    void shutdown()
+    {
+        m_terminate.store(true, std::memory_order_release);
+        m_futex.fetch_add(1, std::memory_order_release);
+        _futexWake(INT_MAX);
+    }
+
+    bool empty() const
+    {
+        uint64_t pos = m_head.load(std::memory_order_acquire);
+        return m_ring[pos & m_mask].sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    unsigned count() const { return m_count; }
+
+    // Approximate number of indices currently handed out
+    unsigned inUse() const
+    {
+        int64_t avail = m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_relaxed);
+        return avail < 0 ? m_count : m_count - unsigned(avail);
+    }
+
+private:
+    static const unsigned SpinCount = 256;
+
+    struct Cell
+    {
+        Cell() : sequence(0), value(0) {}
+        Cell(const Cell& c) : sequence(c.sequence.load()), value(c.value) {}
+        std::atomic<uint64_t> sequence;
+        uint32_t value;
+    };
+
+    bool _push(uint32_t value)
+    {
+        uint64_t pos = m_tail.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = m_ring[pos & m_mask];
+            int64_t diff = int64_t(cell.sequence.load(std::memory_order_acquire)) - int64_t(pos);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;           // Full
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool _pop(uint32_t& value)
+    {
+        uint64_t pos = m_head.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = m_ring[pos & m_mask];
+            int64_t diff = int64_t(cell.sequence.load(std::memory_order_acquire)) - int64_t(pos + 1);
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;           // Empty
+            } else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void _futexWait(uint32_t value)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_futex), FUTEX_WAIT_PRIVATE, value, nullptr, nullptr, 0);
+    }
+
+    void _futexWake(int count)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_futex), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+    }
+
+private:
+    std::vector<Cell> m_ring;
+    uint64_t m_mask;
+    unsigned m_count;
+    std::atomic<bool> m_terminate;
+    alignas(64) std::atomic<uint64_t> m_head;
+    alignas(64) std::atomic<uint64_t> m_tail;
+    alignas(64) std::atomic<uint32_t> m_futex;
+    std::atomic<uint32_t> m_waiters;
+    char _pad[64 - 2 * sizeof(std::atomic<uint32_t>)];
+};
+
+#endif // INDEXALLOCATOR_H
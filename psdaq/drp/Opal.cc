@@ -342,7 +342,7 @@ void Opal::write_image(XtcData::Xtc& xtc, const void* bufEnd, std::vector< XtcDa
     shape[0] = m_rows;
     shape[1] = m_columns;
     Array<uint16_t> arrayT = cd.allocate<uint16_t>(RawDef::image, shape);
-    memcpy(arrayT.data(), subframes[2].data(), subframes[2].shape()[0]);
+    m_pool->copyPayload(arrayT.data(), subframes[2].data(), subframes[2].shape()[0]);
 }
 
 void     Opal::slowupdate(XtcData::Xtc& xtc, const void* bufEnd)
@@ -463,23 +463,24 @@ bool OpalTT::event(XtcData::Xtc& xtc, const void* bufEnd, std::vector< XtcData::
 {
     m_fex.reset();
 
-    std::vector<double> sig, ref;
+    //  One pair per worker thread, so their storage is reused from event to event
+    static thread_local std::vector<double> sig, ref;
     OpalTTFex::TTResult result = m_fex.analyze(subframes,sig,ref);
 
     if (result == OpalTTFex::INVALID) {
         xtc.damage.increase(Damage::UserDefined);
     }
     else if (result == OpalTTFex::VALID) {
-        //  Live feedback
-	m_vec = new double[6];
-        pvd::shared_vector<const double> ttvec(m_vec,0,6);
-        m_vec[0] = m_fex.filtered_position();
-        m_vec[1] = m_fex.filtered_pos_ps();
-        m_vec[2] = m_fex.amplitude();
-        m_vec[3] = m_fex.next_amplitude();
-        m_vec[4] = m_fex.ref_amplitude();
-        m_vec[5] = m_fex.filtered_fwhm();
+        //  Live feedback (the PV takes ownership of the array)
         if (m_ttpv) {
+            m_vec = new double[6];
+            pvd::shared_vector<const double> ttvec(m_vec,0,6);
+            m_vec[0] = m_fex.filtered_position();
+            m_vec[1] = m_fex.filtered_pos_ps();
+            m_vec[2] = m_fex.amplitude();
+            m_vec[3] = m_fex.next_amplitude();
+            m_vec[4] = m_fex.ref_amplitude();
+            m_vec[5] = m_fex.filtered_fwhm();
             m_fex_pv.put(m_request).set<const double>("value",ttvec).exec();
         }
         //  Insert the results
@@ -8,6 +8,8 @@
 
 #include "psalg/calib/NDArray.hh"
 
+#include "TTKernels.hh"
+
 #include <vector>
 #include <string>
 
@@ -105,6 +107,7 @@ private:
     double   m_sb_convergence;
 
     std::vector<double> m_fir_weights;
+    TTKernels::FirFilter m_fir;
     std::vector<double> m_calib_poly;
 
     bool m_ref_empty;
@@ -114,9 +117,6 @@ private:
     std::vector<double> m_ref_avg; // accumulated reference
     Pds::Semaphore m_sb_avg_sem;
     std::vector<double> m_sb_avg;  // averaged sideband region
-    std::vector<int>    m_sig;     // signal region projection
-    std::vector<int>    m_sb;      // sideband region
-    std::vector<int>    m_ref;     // reference region projection
     unsigned m_pedestal; // from Opal camera configuration
 
     double m_flt_position;
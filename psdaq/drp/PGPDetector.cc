@@ -91,7 +91,7 @@ void  drpSendReceive(int inpMqId, int resMqId, int inpShmId, int resShmId, void*
 }
 
 
-void workerFunc(const Parameters& para, DrpBase& drp, Detector* det,
+void workerFunc(const Parameters& para, DrpBase& drp, PGPDetector& pgp, Detector* det,
                 SPSCQueue<Batch>& inputQueue, SPSCQueue<Batch>& outputQueue, bool pythonDrp,
                 int inpMqId, int resMqId, int inpShmId, int resShmId, size_t shmemSize,
                 unsigned threadNum, std::atomic<int>& threadCountPush, std::atomic<int>& threadCountWrite)
@@ -191,7 +191,14 @@ void workerFunc(const Parameters& para, DrpBase& drp, Detector* det,
                 Pds::EbDgram* dgram = new(pool.pebble[pebbleIndex]) Pds::EbDgram(*timingHeader, src, para.rogMask);
 
                 const void* bufEnd = (char*)dgram + pool.bufferSize();
+                pool.trace.stamp(pebbleIndex, EventTrace::WorkerStart);
                 det->event(*dgram, bufEnd, event);
+                pool.trace.stamp(pebbleIndex, EventTrace::WorkerDone);
+
+                // The python drp and the trigger primitive read the payload in place
+                if (pythonDrp || triggerPrimitive) {
+                    pool.resolvePayload(pebbleIndex);
+                }
 
                 if ( pythonDrp) {
                     XtcData::Dgram* inpDg = dgram;
@@ -242,6 +249,9 @@ void workerFunc(const Parameters& para, DrpBase& drp, Detector* det,
             // transitions
             } else {
                 transition = true;
+                // The transition thread must have finished filling in the
+                // transition dgram before it can be passed on to the TEB
+                if (!pgp.transitionReady(pebbleIndex))  break; // Shutting down
                 // Pds::EbDgram* dgram = reinterpret_cast<Pds::EbDgram*>(pool.pebble[pebbleIndex]);
                 Pds::EbDgram* trDgram = pool.transitionDgrams[pebbleIndex];
                 if ( pythonDrp) {
@@ -297,7 +307,10 @@ void workerFunc(const Parameters& para, DrpBase& drp, Detector* det,
 PGPDetector::PGPDetector(const Parameters& para, DrpBase& drp, Detector* det,
                          bool pythonDrp, int* inpMqId, int* resMqId, int* inpShmId, int* resShmId,
                          size_t shmemSize) :
-    PgpReader(para, drp.pool, MAX_RET_CNT_C, para.batchSize), m_terminate(false),
+    PgpReader(para, drp.pool, MAX_RET_CNT_C, para.batchSize),
+    m_transitionQueue(nextPowerOf2(drp.pool.nbuffers())), // pebbleBufCount may not be a power of 2
+    m_transitionReady(drp.pool.nbuffers()),
+    m_terminate(false),
     m_flushTmo(1.1 * drp.tebPrms().maxEntries * 14/13),
     m_shmemSize(shmemSize),
     pythonDrp(pythonDrp)
@@ -315,14 +328,15 @@ PGPDetector::PGPDetector(const Parameters& para, DrpBase& drp, Detector* det,
     }
 
     for (unsigned i=0; i<para.nworkers; i++) {
-        m_workerInputQueues.emplace_back(SPSCQueue<Batch>(drp.pool.nbuffers()));
-        m_workerOutputQueues.emplace_back(SPSCQueue<Batch>(drp.pool.nbuffers()));
+        m_workerInputQueues.emplace_back(SPSCQueue<Batch>(nextPowerOf2(drp.pool.nbuffers())));
+        m_workerOutputQueues.emplace_back(SPSCQueue<Batch>(nextPowerOf2(drp.pool.nbuffers())));
     }
 
     for (unsigned i = 0; i < para.nworkers; i++) {
         m_workerThreads.emplace_back(workerFunc,
                                      std::ref(para),
                                      std::ref(drp),
+                                     std::ref(*this),
                                      det,
                                      std::ref(m_workerInputQueues[i]),
                                      std::ref(m_workerOutputQueues[i]),
@@ -402,6 +416,9 @@ void PGPDetector::reader(std::shared_ptr<Pds::MetricExporter> exporter, Detector
     uint64_t batchId = 0L;
     resetEventCounter();
 
+    m_transitionQueue.startup();
+    std::thread transitionThread(&PGPDetector::transitioner, this, det, std::ref(tebContributor));
+
     enum TmoState { None, Started, Finished };
     TmoState tmoState(TmoState::None);
     const std::chrono::microseconds tmo(m_flushTmo);
@@ -467,32 +484,14 @@ void PGPDetector::reader(std::shared_ptr<Pds::MetricExporter> exporter, Detector
                     if (event->mask == 0)
                         continue;               // Skip broken event
 
+                    // Hand the transition off to the transition thread so that
+                    // DMA reading isn't held up by copying its payload.  The
+                    // worker that gets this batch waits for it to be ready,
+                    // which keeps the pebble order seen by the collector.
                     unsigned pebbleIndex = event->pebbleIndex;
-                    XtcData::Src src = det->nodeId;
-                    Pds::EbDgram* dgram = new(m_pool.pebble[pebbleIndex]) Pds::EbDgram(*timingHeader,
-                                            src, m_para.rogMask);
-
-                    logging::debug("PGPDetector saw %s @ %u.%09u (%014lx)",
-                                XtcData::TransitionId::name(transitionId),
-                                dgram->time.seconds(), dgram->time.nanoseconds(),
-                                dgram->pulseId());
-
-                    // Initialize the transition dgram's header
-                    Pds::EbDgram* trDgram = m_pool.transitionDgrams[pebbleIndex];
-                    if (!trDgram)  continue; // Can occur when shutting down
-                    memcpy((void*)trDgram, (const void*)dgram, sizeof(*dgram) - sizeof(dgram->xtc));
-
-                    // copy the temporary xtc created on phase 1 of the transition
-                    // into the real location
-                    XtcData::Xtc& trXtc = det->transitionXtc();
-                    trDgram->xtc = trXtc; // Preserve header info, but allocate to check fit
-                    const void*   bufEnd  = (char*)trDgram + m_para.maxTrSize;
-                    auto payload = trDgram->xtc.alloc(trXtc.sizeofPayload(), bufEnd);
-                    memcpy(payload, (const void*)trXtc.payload(), trXtc.sizeofPayload());
-
-                    // Prepare the trigger primitive with whatever input is needed for the TEB to meke trigger decisions
-                    auto l3InpBuf = tebContributor.fetch(pebbleIndex);
-                    new(l3InpBuf) Pds::EbDgram(*dgram);
+                    if (!m_pool.transitionDgrams[pebbleIndex])  continue; // Can occur when shutting down
+                    m_transitionReady[pebbleIndex].store(false, std::memory_order_relaxed);
+                    m_transitionQueue.push({timingHeader, pebbleIndex});
 
                     // set thread counter and broadcast transition
                     threadCountWrite.store(m_para.nworkers);
@@ -515,9 +514,75 @@ void PGPDetector::reader(std::shared_ptr<Pds::MetricExporter> exporter, Detector
             }
         }
     }
+    m_transitionQueue.shutdown();
+    if (transitionThread.joinable()) {
+        transitionThread.join();
+    }
     logging::info("PGPReader is exiting");
 }
 
+void PGPDetector::transitioner(Detector* det, Pds::Eb::TebContributor& tebContributor)
+{
+    TransitionJob job;
+    while (true) {
+        if (!m_transitionQueue.popW(job)) {
+            break;
+        }
+        const Pds::TimingHeader* timingHeader = job.timingHeader;
+        unsigned pebbleIndex = job.pebbleIndex;
+        XtcData::TransitionId::Value transitionId = timingHeader->service();
+        XtcData::Src src = det->nodeId;
+        Pds::EbDgram* dgram = new(m_pool.pebble[pebbleIndex]) Pds::EbDgram(*timingHeader,
+                                src, m_para.rogMask);
+
+        logging::debug("PGPDetector saw %s @ %u.%09u (%014lx)",
+                    XtcData::TransitionId::name(transitionId),
+                    dgram->time.seconds(), dgram->time.nanoseconds(),
+                    dgram->pulseId());
+
+        // Initialize the transition dgram's header
+        Pds::EbDgram* trDgram = m_pool.transitionDgrams[pebbleIndex];
+        memcpy((void*)trDgram, (const void*)dgram, sizeof(*dgram) - sizeof(dgram->xtc));
+
+        // copy the temporary xtc created on phase 1 of the transition
+        // into the real location
+        XtcData::Xtc& trXtc = det->transitionXtc();
+        trDgram->xtc = trXtc; // Preserve header info, but allocate to check fit
+        const void*   bufEnd  = (char*)trDgram + m_para.maxTrSize;
+        auto payload = trDgram->xtc.alloc(trXtc.sizeofPayload(), bufEnd);
+        memcpy(payload, (const void*)trXtc.payload(), trXtc.sizeofPayload());
+
+        // Prepare the trigger primitive with whatever input is needed for the TEB to meke trigger decisions
+        auto l3InpBuf = tebContributor.fetch(pebbleIndex);
+        new(l3InpBuf) Pds::EbDgram(*dgram);
+
+        {
+            std::lock_guard<std::mutex> lock(m_transitionMutex);
+            m_transitionReady[pebbleIndex].store(true, std::memory_order_release);
+        }
+        m_transitionCondition.notify_all();
+    }
+    logging::info("PGPTransitioner is exiting");
+}
+
+bool PGPDetector::transitionReady(unsigned pebbleIndex)
+{
+    // The transition is usually ready by the time a worker gets to it, so
+    // spin briefly before blocking until the transition thread is done
+    for (unsigned i = 0; i < 1000; ++i) {
+        if (m_transitionReady[pebbleIndex].load(std::memory_order_acquire)) {
+            return true;
+        }
+        asm volatile("pause" ::: "memory");
+    }
+    std::unique_lock<std::mutex> lock(m_transitionMutex);
+    m_transitionCondition.wait(lock, [&] {
+        return m_transitionReady[pebbleIndex].load(std::memory_order_acquire) ||
+               m_terminate.load(std::memory_order_acquire);
+    });
+    return m_transitionReady[pebbleIndex].load(std::memory_order_acquire);
+}
+
 void PGPDetector::collector(Pds::Eb::TebContributor& tebContributor)
 {
     int64_t worker = 0L;
@@ -533,7 +598,11 @@ void PGPDetector::collector(Pds::Eb::TebContributor& tebContributor)
             if (event->mask == 0)
                 continue;               // Skip broken event
             unsigned pebbleIndex = event->pebbleIndex;
-            freeDma(event);
+            if (m_pool.payloadRefs(pebbleIndex).count)
+                m_pool.holdDma(event);  // Returned once the dgram is written
+            else
+                freeDma(event);
+            m_pool.trace.stamp(pebbleIndex, EventTrace::TebPost);
             tebContributor.process(pebbleIndex);
         }
         if (batch.size == 0) {
@@ -562,6 +631,11 @@ void PGPDetector::shutdown()
         return;                         // Already shut down
     m_terminate.store(true, std::memory_order_release);
     logging::info("shutting down PGPReader");
+    {
+        // Release the workers waiting for a transition to be ready
+        std::lock_guard<std::mutex> lock(m_transitionMutex);
+    }
+    m_transitionCondition.notify_all();
     for (unsigned i = 0; i < m_para.nworkers; i++) {
         m_workerInputQueues[i].shutdown();
         if (m_workerThreads[i].joinable()) {
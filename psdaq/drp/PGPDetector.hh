@@ -3,6 +3,8 @@
 #include <vector>
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include "Detector.hh"
 #include "drp.hh"
 #include "spscqueue.hh"
@@ -20,6 +22,12 @@ struct Batch
     uint32_t size;
 };
 
+struct TransitionJob
+{
+    const Pds::TimingHeader* timingHeader;
+    unsigned pebbleIndex;
+};
+
 class DrpBase;
 
 class PGPDetector : public PgpReader
@@ -30,6 +38,8 @@ public:
     virtual ~PGPDetector();
     void reader(std::shared_ptr<Pds::MetricExporter> exporter, Detector* det, Pds::Eb::TebContributor& tebContributor);
     void collector(Pds::Eb::TebContributor& tebContributor);
+    void transitioner(Detector* det, Pds::Eb::TebContributor& tebContributor);
+    bool transitionReady(unsigned pebbleIndex);
     virtual void handleBrokenEvent(const PGPEvent& event) override;
     virtual void resetEventCounter() override;
     void shutdown();
@@ -38,6 +48,10 @@ private:
     std::vector<SPSCQueue<Batch> > m_workerInputQueues;
     std::vector<SPSCQueue<Batch> > m_workerOutputQueues;
     std::vector<std::thread> m_workerThreads;
+    SPSCQueue<TransitionJob> m_transitionQueue;
+    std::vector<std::atomic<bool> > m_transitionReady;
+    std::mutex m_transitionMutex;
+    std::condition_variable m_transitionCondition;
     std::atomic<bool> m_terminate;
     Batch m_batch;
     unsigned m_nodeId;
@@ -345,7 +345,7 @@ void Piranha4::write_image(XtcData::Xtc& xtc, const void* bufEnd, std::vector< X
     unsigned shape[MaxRank];
     shape[0] = m_pixels;
     Array<uint16_t> arrayT = cd.allocate<uint16_t>(Piranha::RawDef::image, shape);
-    memcpy(arrayT.data(), subframes[2].data(), subframes[2].shape()[0]);
+    m_pool->copyPayload(arrayT.data(), subframes[2].data(), subframes[2].shape()[0]);
 }
 
 void     Piranha4::slowupdate(XtcData::Xtc& xtc, const void* bufEnd)
@@ -465,23 +465,24 @@ bool TT::event(XtcData::Xtc& xtc, const void* bufEnd, std::vector< XtcData::Arra
 {
     m_fex.reset();
 
-    std::vector<double> sig, ref;
+    //  One pair per worker thread, so their storage is reused from event to event
+    static thread_local std::vector<double> sig, ref;
     Piranha4TTFex::TTResult result = m_fex.analyze(subframes,sig,ref);
 
     if (result == Piranha4TTFex::INVALID) {
         xtc.damage.increase(Damage::UserDefined);
     }
     else if (result == Piranha4TTFex::VALID) {
-        //  Live feedback
-        m_vec = new double[6];
-        pvd::shared_vector<const double> ttvec(m_vec,0,6);
-        m_vec[0] = m_fex.amplitude();
-        m_vec[1] = m_fex.filtered_position();
-        m_vec[2] = m_fex.filtered_pos_ps();
-        m_vec[3] = m_fex.filtered_fwhm();
-        m_vec[4] = m_fex.next_amplitude();
-        m_vec[5] = m_fex.ref_amplitude();
+        //  Live feedback (the PV takes ownership of the array)
         if (m_ttpv) {
+            m_vec = new double[6];
+            pvd::shared_vector<const double> ttvec(m_vec,0,6);
+            m_vec[0] = m_fex.amplitude();
+            m_vec[1] = m_fex.filtered_position();
+            m_vec[2] = m_fex.filtered_pos_ps();
+            m_vec[3] = m_fex.filtered_fwhm();
+            m_vec[4] = m_fex.next_amplitude();
+            m_vec[5] = m_fex.ref_amplitude();
             m_fex_pv.put(m_request).set<const double>("value",ttvec).exec();
         }
         //  Insert the results
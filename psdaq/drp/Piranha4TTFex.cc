@@ -6,7 +6,6 @@
 #include "psalg/detector/UtilsConfig.hh"
 #include "psalg/utils/SysLog.hh"
 
-#include <list>
 #include <math.h>
 
 //#define DBUG
@@ -32,21 +31,7 @@ static const char* cuts[] = {"NCalls",
 static void                read_roi(Roi& roi, DescData& descdata, const char* name,
                                     unsigned pixels);
 // formerly psalg functions
-static std::vector<int>    extract_roi(NDArray<uint16_t>&, Roi&, unsigned);
-//static void                rolling_average(std::vector<int>& a,
-//                                           std::vector<double>& avg,
-//                                           double fraction);
-static void                rolling_average(std::vector<double>& a,
-                                           std::vector<double>& avg,
-                                           double fraction);
-//static void                rolling_average(NDArray<double>& a,
-//                                           NDArray<double>& avg,
-//                                           double fraction);
-static std::vector<double> finite_impulse_response(std::vector<double>& filter,
-                                                   std::vector<double>& sample);
-static std::list<unsigned> find_peaks(std::vector<double>&, double, unsigned);
-static std::vector<double> parab_fit(double* input, unsigned len);
-static std::vector<double> parab_fit(double* qwf, unsigned ix, unsigned len, double nxta);
+static void                extract_roi(std::vector<int>&, const uint16_t*, const Roi&, unsigned);
 
 #define MLOOKUP(m,name,dflt) (m.find(name)==m.end() ? dflt : m[name])
 
@@ -182,6 +167,7 @@ void Piranha4TTFex::configure(XtcData::ConfigIter& configo,
   }
 
   read_roi(m_sig_roi, descdata, "fex.sig.roi", m_pixels);
+  m_fir.configure(m_fir_weights, m_sig_roi.x1-m_sig_roi.x0+1);
 
   int32_t m_ref_record;
   GET_ENUM(ref,record,recordEnum);
@@ -310,12 +296,14 @@ Piranha4TTFex::TTResult Piranha4TTFex::analyze(std::vector< XtcData::Array<uint8
   //
   //  Extract signal ROI
   //
-  m_sig = extract_roi(f, m_sig_roi, m_pedestal);
+  TTKernels::Scratch& scratch = TTKernels::Scratch::local();
+  std::vector<int>& sig = scratch.sig;
+  extract_roi(sig, f.data(), m_sig_roi, m_pedestal);
 
   m_prescale_averages_counter++;
 
-  sigd.resize(m_sig.size());
-  std::vector<double> refd(m_sig.size());
+  sigd.resize(sig.size());
+  std::vector<double>& refd = scratch.refd;
 
   // If the size stored in the file is out of date,
   // resetting the size to 0 here will cause a new m_ref_avg
@@ -327,8 +315,8 @@ Piranha4TTFex::TTResult Piranha4TTFex::analyze(std::vector< XtcData::Array<uint8
       m_ref_avg_sem.give();
   }
 
-  for(unsigned i=0; i<m_sig.size(); i++)
-      sigd[i] = double(m_sig[i]);
+  for(unsigned i=0; i<sig.size(); i++)
+      sigd[i] = double(sig[i]);
 
   refd = sigd;
 
@@ -353,7 +341,7 @@ Piranha4TTFex::TTResult Piranha4TTFex::analyze(std::vector< XtcData::Array<uint8
       // For the reference, the signal when NOBEAM is used
       _monitor_ref_sig( refd );
       m_ref_avg_sem.take();
-      rolling_average(refd, m_ref_avg, m_ref_convergence);
+      TTKernels::rolling_average(refd, m_ref_avg, m_ref_convergence);
       m_ref_avg_sem.give();
 
 #ifdef DBUG
@@ -384,7 +372,7 @@ Piranha4TTFex::TTResult Piranha4TTFex::analyze(std::vector< XtcData::Array<uint8
   //  Average the signal
   //
   m_sig_avg_sem.take();
-  rolling_average(sigd, m_sig_avg, m_sig_convergence);
+  TTKernels::rolling_average(sigd, m_sig_avg, m_sig_convergence);
   sigd = m_sig_avg;
   m_sig_avg_sem.give();
 
@@ -403,7 +391,9 @@ Piranha4TTFex::TTResult Piranha4TTFex::analyze(std::vector< XtcData::Array<uint8
   //
   //  Apply the digital filter
   //
-  std::vector<double> qwf = finite_impulse_response(m_fir_weights,sigd);
+  std::vector<double>& qwf = scratch.qwf;
+  qwf.resize(m_fir.outputSize(sigd.size()));
+  m_fir.apply(sigd.data(), sigd.size(), qwf.data());
 
   _monitor_flt_sig( qwf );
 
@@ -418,30 +408,30 @@ Piranha4TTFex::TTResult Piranha4TTFex::analyze(std::vector< XtcData::Array<uint8
   //  Find the two highest peaks that are well-separated
   //
   const double afrac = 0.50;
-  std::list<unsigned> peaks = find_peaks(qwf, afrac, 2);
+  TTKernels::Peaks peaks = TTKernels::find_peaks(qwf.data(), qwf.size(), afrac, 2);
 
-  unsigned nfits = peaks.size();
+  unsigned nfits = peaks.n;
   if (nfits>0) {
-    unsigned ix = *peaks.begin();
-    std::vector<double> pFit0 = parab_fit(qwf.data(),ix,qwf.size(),0.8);
-    if (pFit0[2]>0) {
-      double   xflt = pFit0[1]+m_sig_roi.x0;
+    unsigned ix = peaks.index[0];
+    TTKernels::ParabFit pFit0 = TTKernels::parab_fit(qwf.data(),ix,qwf.size(),0.8);
+    if (pFit0.fwhm>0) {
+      double   xflt = pFit0.position+m_sig_roi.x0;
 
       double  xfltc = 0;
       for(unsigned i=m_calib_poly.size(); i!=0; )
         xfltc = xfltc*xflt + m_calib_poly[--i];
 
-      m_amplitude        = pFit0[0];
+      m_amplitude        = pFit0.amplitude;
       m_flt_position     = xflt;
       m_flt_position_ps  = xfltc;
-      m_flt_fwhm         = pFit0[2];
+      m_flt_fwhm         = pFit0.fwhm;
       m_ref_amplitude    = m_ref_avg[ix];
 
       if (nfits>1) {
-        std::vector<double> pFit1 =
-          parab_fit(qwf.data(),*(++peaks.begin()),qwf.size(),0.8);
-        if (pFit1[2]>0)
-          m_nxt_amplitude = pFit1[0];
+        TTKernels::ParabFit pFit1 =
+          TTKernels::parab_fit(qwf.data(),peaks.index[1],qwf.size(),0.8);
+        if (pFit1.fwhm>0)
+          m_nxt_amplitude = pFit1.amplitude;
       }
     }
   }
@@ -515,235 +505,17 @@ void read_roi(Roi& roi, DescData& descdata, const char* name, unsigned pixels)
 }
 
 
-std::vector<int> extract_roi(NDArray<uint16_t>& f,
-                             Roi& roi,
-                             unsigned ped)
+void extract_roi(std::vector<int>& result,
+                 const uint16_t*   line,
+                 const Roi&        roi,
+                 unsigned          ped)
 {
 #ifdef DBUG2
   printf("extract roi [%u,%u]\n",
          roi.x0,roi.x1);
 #endif
-  std::vector<int> result(roi.x1-roi.x0+1);
-  for(unsigned i=0; i<result.size(); i++) result[i]=-ped;
-  for(unsigned j=roi.x0, k=0; j<=roi.x1; j++,k++)
-    result[k] += f(j);
-  return result;
-}
-
-void rolling_average(std::vector<int>& a, std::vector<double>& avg, double fraction)
-{
-  if (avg.size()==0) {
-    avg.resize(a.size());
-    for(unsigned i=0; i<a.size(); i++)
-      avg[i] = a[i];
-  } else if (avg.size()!=a.size()) {
-    logging::critical("rolling average (int/double) with different sizes");
-    throw std::string("rolling average with different sizes");
-  } else {
-    double g = (1-fraction);
-    double f = fraction;
-    for(unsigned i=0; i<a.size(); i++)
-      avg[i] = avg[i]*g + double(a[i])*f;
-  }
-}
-
-void rolling_average(std::vector<double>& a, std::vector<double>& avg, double fraction)
-{
-  if (avg.size()==0) {
-    avg.resize(a.size());
-    for(unsigned i=0; i<a.size(); i++)
-      avg[i] = a[i];
-  } else if (avg.size()!=a.size()) {
-    logging::critical("rolling average (double/double) with different sizes");
-    throw std::string("rolling average with different sizes");
-  } else {
-    double g = (1-fraction);
-    double f = fraction;
-    for(unsigned i=0; i<a.size(); i++)
-      avg[i] = avg[i]*g + a[i]*f;
-  }
-}
-
-//void rolling_average(NDArray<double>& a, NDArray<double>& avg, double fraction)
-//{
-//  if (avg.size()==0)
-//    avg = a;
-//  else if (avg.size()!=a.size()) {
-//      throw std::string("rolling average with different sizes");
-//  }
-//  else {
-//    double g = (1-fraction);
-//    double f = fraction;
-//    const size_t sz = a.size();
-//    double* ad   = a  .data();
-//    double* avgd = avg.data();
-//    for(unsigned i=0; i<sz; i++)
-//      avgd[i] = avgd[i]*g + ad[i]*f;
-//  }
-//}
-
-std::vector<double> finite_impulse_response(std::vector<double>& filter,
-                                            std::vector<double>& sample)
-{
-  unsigned nf = filter.size();
-  if (sample.size()<filter.size()) {
-    logging::critical("Piranha4TTFex sample size %i smaller than filter size %i", sample.size(), filter.size());
-    throw("Error Piranha4TTFex sample size too small");
-  } else {
-    unsigned len = sample.size()-nf;
-    std::vector<double> result = std::vector<double>(len);
-    for(unsigned i=0; i<len; i++) {
-      double v = 0;
-      for(unsigned j=0; j<nf; j++)
-        v += sample[i+j]*filter[j];
-      result[i] = v;
-    }
-    return result;
-  }
-}
-
-std::list<unsigned> find_peaks(std::vector<double>& a,
-                               double afrac,
-                               unsigned max_peaks)
-{
-  std::list<unsigned> peaks;
-
-  double amax    = a[0];
-  double aleft   = amax;
-  double aright  = 0;
-  unsigned imax  = 0;
-
-  bool lpeak = false;
-
-  for(unsigned i=1; i<a.size(); i++) {
-    if (a[i] > amax) {
-      amax = a[i];
-      double af = afrac*amax;
-      if (af > aleft) {
-        imax = i;
-        lpeak  = true;
-        aright = af;
-      }
-    }
-    else if (lpeak && a[i] < aright) {
-      if (peaks.size()==max_peaks && a[peaks.back()]>amax)
-        ;
-      else {
-        if (peaks.size()==max_peaks)
-          peaks.pop_back();
-
-        int sz = peaks.size();
-        for(std::list<unsigned>::iterator it=peaks.begin(); it!=peaks.end(); it++)
-          if (a[*it]<amax) {
-            peaks.insert(it,imax);
-            break;
-          }
-        if (sz == int(peaks.size()))
-          peaks.push_back(imax);
-      }
-
-      lpeak = false;
-      amax  = aleft = (a[i]>0 ? a[i] : 0);
-    }
-    else if (!lpeak && a[i] < aleft) {
-      amax = aleft = (a[i] > 0 ? a[i] : 0);
-    }
-  }
-  return peaks;
-}
-
-std::vector<double> parab_fit(double* input, unsigned len)
-{
-  std::vector<double> result(3);
-
-  double xx[5], xy[3];
-  memset(xx,0,5*sizeof(double));
-  memset(xy,0,3*sizeof(double));
-
-  for(unsigned ix=0; ix<len; ix++) {
-    double x = double(ix);
-    double qx=x;
-    double y = input[ix];
-    xx[0] += 1;
-    xy[0] += y;
-    xx[1] += x;
-    xy[1] += (y*=x);
-    xx[2] += (qx*=x);
-    xy[2] += y*x;
-    xx[3] += (qx*=x);
-    xx[4] += qx*x;
-  }
-
-  double a11 = xx[0];
-  double a21 = xx[1];
-  double a31 = xx[2];
-  double a22 = xx[2];
-  double a32 = xx[3];
-  double a33 = xx[4];
-
-  double b11 = a22*a33-a32*a32;
-  double b21 = a21*a33-a32*a31;
-  double b31 = a21*a32-a31*a22;
-  double b22 = a11*a33-a31*a31;
-  double b32 = a11*a32-a21*a31;
-  double b33 = a11*a22-a21*a21;
-
-  double det = a11*b11 - a21*b21 + a31*b31;
-
-  if (det==0) {
-    result[0] = 0;
-    result[1] = 0;
-    result[2] = 0;
-  }
-  else {
-    result[0] = ( b11*xy[0] - b21*xy[1] + b31*xy[2])/det;
-    result[1] = (-b21*xy[0] + b22*xy[1] - b32*xy[2])/det;
-    result[2] = ( b31*xy[0] - b32*xy[1] + b33*xy[2])/det;
-  }
-  return result;
-}
-
-std::vector<double> parab_fit(double* input,
-                              unsigned ix,
-                              unsigned len,
-                              double afrac)
-{
-  enum { Amplitude, Position, FWHM, NParms };
-  std::vector<double> _p(NParms);
-
-  const double trf = afrac*input[ix];
-  int ix_left(ix);
-  while(--ix_left > 0) {
-    if (input[ix_left] < trf)
-      break;
-  }
-
-  int ix_right(ix);
-  while(++ix_right < int(len)) {
-    if (input[ix_right] < trf)
-      break;
-  }
-
-  std::vector<double> a = parab_fit(&input[ix_left],ix_right-ix_left+1);
-
-  if (a[2] < 0) {  // a maximum
-    _p[Amplitude] = a[0] - 0.2*a[1]*a[1]/a[2];
-    _p[Position ] = double(ix_left)-0.5*a[1]/a[2];
-
-    const double hm = 0.5*input[ix];
-    while(input[ix_left]>hm && ix_left>0)
-      ix_left--;
-    while(input[ix_right]>hm && ix_right<int(len-1))
-      ix_right++;
-
-    _p[FWHM] = sqrt(-2*_p[Amplitude]/a[2]);
-  }
-  else {
-    _p[Amplitude] = -1;
-    _p[Position ] = -1;
-    _p[FWHM     ] = -1;
-  }
-  return _p;
+  result.resize(roi.x1-roi.x0+1);
+  TTKernels::extract_roi(line, roi.x0, roi.x1, ped, result.data());
 }
 
 void Piranha4TTFex::_monitor_raw_sig (std::vector<double>& a)
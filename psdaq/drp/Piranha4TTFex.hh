@@ -8,6 +8,8 @@
 
 #include "psalg/calib/NDArray.hh"
 
+#include "TTKernels.hh"
+
 #include <vector>
 #include <string>
 
@@ -100,6 +102,7 @@ private:
     double   m_ref_convergence;
 
     std::vector<double> m_fir_weights;
+    TTKernels::FirFilter m_fir;
     std::vector<double> m_calib_poly;
 
     bool m_ref_empty;
@@ -107,7 +110,6 @@ private:
     std::vector<double> m_sig_avg; // accumulated signal
     Pds::Semaphore m_ref_avg_sem;
     std::vector<double> m_ref_avg; // accumulated reference
-    std::vector<int>    m_sig;     // signal region
     int m_pedestal; // from Piranha4 camera configuration
 
     double m_flt_position;
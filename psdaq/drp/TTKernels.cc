@@ -0,0 +1,675 @@
+#include "TTKernels.hh"
+#include "psalg/utils/SysLog.hh"
+
+#include <immintrin.h>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using logging = psalg::SysLog;
+
+namespace Drp {
+namespace TTKernels {
+
+//
+//  Scalar implementations, also used for the tails of the vector loops
+//
+
+static void project_x_scalar(const uint16_t* frame, unsigned stride,
+                             unsigned x0, unsigned x1, unsigned y0, unsigned y1,
+                             unsigned ped, int* result)
+{
+    unsigned w = x1-x0+1;
+    for(unsigned k=0; k<w; k++) result[k] = -ped*(y1-y0+1);
+    for(unsigned i=y0; i<=y1; i++) {
+        const uint16_t* row = frame + size_t(i)*stride + x0;
+        for(unsigned k=0; k<w; k++)
+            result[k] += row[k];
+    }
+}
+
+static void project_y_scalar(const uint16_t* frame, unsigned stride,
+                             unsigned x0, unsigned x1, unsigned y0, unsigned y1,
+                             unsigned ped, int* result)
+{
+    unsigned w = x1-x0+1;
+    for(unsigned i=y0, k=0; i<=y1; i++, k++) {
+        const uint16_t* row = frame + size_t(i)*stride + x0;
+        int sum = 0;
+        for(unsigned j=0; j<w; j++)
+            sum += row[j];
+        result[k] = sum - ped*w;
+    }
+}
+
+static void extract_roi_scalar(const uint16_t* line, unsigned x0, unsigned x1,
+                               unsigned ped, int* result)
+{
+    for(unsigned j=x0, k=0; j<=x1; j++, k++)
+        result[k] = int(line[j]) - int(ped);
+}
+
+static void rolling_average_int_scalar(const int* a, double* avg, size_t n, double fraction)
+{
+    double g = (1-fraction);
+    double f = fraction;
+    for(size_t i=0; i<n; i++)
+        avg[i] = avg[i]*g + double(a[i])*f;
+}
+
+static void rolling_average_dbl_scalar(const double* a, double* avg, size_t n, double fraction)
+{
+    double g = (1-fraction);
+    double f = fraction;
+    for(size_t i=0; i<n; i++)
+        avg[i] = avg[i]*g + a[i]*f;
+}
+
+static void correlate_scalar(const double* filter, size_t nf,
+                             const double* sample, size_t n, double* result)
+{
+    size_t len = n > nf ? n-nf : 0;
+    for(size_t i=0; i<len; i++) {
+        double v = 0;
+        for(size_t j=0; j<nf; j++)
+            v += sample[i+j]*filter[j];
+        result[i] = v;
+    }
+}
+
+//
+//  AVX2 implementations
+//
+
+__attribute__((target("avx2")))
+static void project_x_avx2(const uint16_t* frame, unsigned stride,
+                           unsigned x0, unsigned x1, unsigned y0, unsigned y1,
+                           unsigned ped, int* result)
+{
+    unsigned w = x1-x0+1;
+    for(unsigned k=0; k<w; k++) result[k] = -ped*(y1-y0+1);
+    for(unsigned i=y0; i<=y1; i++) {
+        const uint16_t* row = frame + size_t(i)*stride + x0;
+        unsigned k=0;
+        for(; k+16<=w; k+=16) {
+            __m256i p  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row+k));
+            __m256i lo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(p));
+            __m256i hi = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(p, 1));
+            __m256i* r = reinterpret_cast<__m256i*>(result+k);
+            _mm256_storeu_si256(r  , _mm256_add_epi32(_mm256_loadu_si256(r  ), lo));
+            _mm256_storeu_si256(r+1, _mm256_add_epi32(_mm256_loadu_si256(r+1), hi));
+        }
+        for(; k<w; k++)
+            result[k] += row[k];
+    }
+}
+
+__attribute__((target("avx2")))
+static inline int hsum_epi32(__m256i v)
+{
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1,0,3,2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2,3,0,1)));
+    return _mm_cvtsi128_si32(s);
+}
+
+__attribute__((target("avx2")))
+static void project_y_avx2(const uint16_t* frame, unsigned stride,
+                           unsigned x0, unsigned x1, unsigned y0, unsigned y1,
+                           unsigned ped, int* result)
+{
+    unsigned w = x1-x0+1;
+    for(unsigned i=y0, k=0; i<=y1; i++, k++) {
+        const uint16_t* row = frame + size_t(i)*stride + x0;
+        __m256i acc = _mm256_setzero_si256();
+        unsigned j=0;
+        for(; j+16<=w; j+=16) {
+            __m256i p  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row+j));
+            acc = _mm256_add_epi32(acc, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(p)));
+            acc = _mm256_add_epi32(acc, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(p, 1)));
+        }
+        int sum = hsum_epi32(acc);
+        for(; j<w; j++)
+            sum += row[j];
+        result[k] = sum - ped*w;
+    }
+}
+
+__attribute__((target("avx2")))
+static void extract_roi_avx2(const uint16_t* line, unsigned x0, unsigned x1,
+                             unsigned ped, int* result)
+{
+    unsigned w = x1-x0+1;
+    const uint16_t* p = line + x0;
+    __m256i vped = _mm256_set1_epi32(int(ped));
+    unsigned k=0;
+    for(; k+8<=w; k+=8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p+k));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(result+k),
+                            _mm256_sub_epi32(_mm256_cvtepu16_epi32(v), vped));
+    }
+    for(; k<w; k++)
+        result[k] = int(p[k]) - int(ped);
+}
+
+__attribute__((target("avx2,fma")))
+static void rolling_average_int_avx2(const int* a, double* avg, size_t n, double fraction)
+{
+    __m256d g = _mm256_set1_pd(1-fraction);
+    __m256d f = _mm256_set1_pd(fraction);
+    size_t i=0;
+    for(; i+4<=n; i+=4) {
+        __m256d v = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a+i)));
+        _mm256_storeu_pd(avg+i, _mm256_fmadd_pd(_mm256_loadu_pd(avg+i), g, _mm256_mul_pd(v, f)));
+    }
+    rolling_average_int_scalar(a+i, avg+i, n-i, fraction);
+}
+
+__attribute__((target("avx2,fma")))
+static void rolling_average_dbl_avx2(const double* a, double* avg, size_t n, double fraction)
+{
+    __m256d g = _mm256_set1_pd(1-fraction);
+    __m256d f = _mm256_set1_pd(fraction);
+    size_t i=0;
+    for(; i+4<=n; i+=4) {
+        __m256d v = _mm256_loadu_pd(a+i);
+        _mm256_storeu_pd(avg+i, _mm256_fmadd_pd(_mm256_loadu_pd(avg+i), g, _mm256_mul_pd(v, f)));
+    }
+    rolling_average_dbl_scalar(a+i, avg+i, n-i, fraction);
+}
+
+//  Sixteen outputs per pass with four independent accumulators to cover
+//  the FMA latency; each filter weight is broadcast once per pass.
+__attribute__((target("avx2,fma")))
+static void correlate_avx2(const double* filter, size_t nf,
+                           const double* sample, size_t n, double* result)
+{
+    size_t len = n > nf ? n-nf : 0;
+    size_t i=0;
+    for(; i+16<=len; i+=16) {
+        __m256d a0 = _mm256_setzero_pd();
+        __m256d a1 = _mm256_setzero_pd();
+        __m256d a2 = _mm256_setzero_pd();
+        __m256d a3 = _mm256_setzero_pd();
+        const double* s = sample+i;
+        for(size_t j=0; j<nf; j++) {
+            __m256d w = _mm256_broadcast_sd(filter+j);
+            a0 = _mm256_fmadd_pd(_mm256_loadu_pd(s+j   ), w, a0);
+            a1 = _mm256_fmadd_pd(_mm256_loadu_pd(s+j+ 4), w, a1);
+            a2 = _mm256_fmadd_pd(_mm256_loadu_pd(s+j+ 8), w, a2);
+            a3 = _mm256_fmadd_pd(_mm256_loadu_pd(s+j+12), w, a3);
+        }
+        _mm256_storeu_pd(result+i   , a0);
+        _mm256_storeu_pd(result+i+ 4, a1);
+        _mm256_storeu_pd(result+i+ 8, a2);
+        _mm256_storeu_pd(result+i+12, a3);
+    }
+    for(; i+4<=len; i+=4) {
+        __m256d a0 = _mm256_setzero_pd();
+        for(size_t j=0; j<nf; j++)
+            a0 = _mm256_fmadd_pd(_mm256_loadu_pd(sample+i+j), _mm256_broadcast_sd(filter+j), a0);
+        _mm256_storeu_pd(result+i, a0);
+    }
+    if (i<len)
+        correlate_scalar(filter, nf, sample+i, len-i+nf, result+i);
+}
+
+//
+//  AVX-512 implementations
+//
+
+__attribute__((target("avx512f")))
+static void project_x_avx512(const uint16_t* frame, unsigned stride,
+                             unsigned x0, unsigned x1, unsigned y0, unsigned y1,
+                             unsigned ped, int* result)
+{
+    unsigned w = x1-x0+1;
+    for(unsigned k=0; k<w; k++) result[k] = -ped*(y1-y0+1);
+    for(unsigned i=y0; i<=y1; i++) {
+        const uint16_t* row = frame + size_t(i)*stride + x0;
+        unsigned k=0;
+        for(; k+16<=w; k+=16) {
+            __m512i v = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row+k)));
+            _mm512_storeu_si512(result+k, _mm512_add_epi32(_mm512_loadu_si512(result+k), v));
+        }
+        for(; k<w; k++)
+            result[k] += row[k];
+    }
+}
+
+__attribute__((target("avx512f")))
+static void project_y_avx512(const uint16_t* frame, unsigned stride,
+                             unsigned x0, unsigned x1, unsigned y0, unsigned y1,
+                             unsigned ped, int* result)
+{
+    unsigned w = x1-x0+1;
+    for(unsigned i=y0, k=0; i<=y1; i++, k++) {
+        const uint16_t* row = frame + size_t(i)*stride + x0;
+        __m512i acc = _mm512_setzero_si512();
+        unsigned j=0;
+        for(; j+16<=w; j+=16)
+            acc = _mm512_add_epi32(acc, _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row+j))));
+        int sum = _mm512_reduce_add_epi32(acc);
+        for(; j<w; j++)
+            sum += row[j];
+        result[k] = sum - ped*w;
+    }
+}
+
+__attribute__((target("avx512f")))
+static void correlate_avx512(const double* filter, size_t nf,
+                             const double* sample, size_t n, double* result)
+{
+    size_t len = n > nf ? n-nf : 0;
+    size_t i=0;
+    for(; i+32<=len; i+=32) {
+        __m512d a0 = _mm512_setzero_pd();
+        __m512d a1 = _mm512_setzero_pd();
+        __m512d a2 = _mm512_setzero_pd();
+        __m512d a3 = _mm512_setzero_pd();
+        const double* s = sample+i;
+        for(size_t j=0; j<nf; j++) {
+            __m512d w = _mm512_set1_pd(filter[j]);
+            a0 = _mm512_fmadd_pd(_mm512_loadu_pd(s+j   ), w, a0);
+            a1 = _mm512_fmadd_pd(_mm512_loadu_pd(s+j+ 8), w, a1);
+            a2 = _mm512_fmadd_pd(_mm512_loadu_pd(s+j+16), w, a2);
+            a3 = _mm512_fmadd_pd(_mm512_loadu_pd(s+j+24), w, a3);
+        }
+        _mm512_storeu_pd(result+i   , a0);
+        _mm512_storeu_pd(result+i+ 8, a1);
+        _mm512_storeu_pd(result+i+16, a2);
+        _mm512_storeu_pd(result+i+24, a3);
+    }
+    if (i<len)
+        correlate_avx2(filter, nf, sample+i, len-i+nf, result+i);
+}
+
+//
+//  Run time dispatch
+//
+
+struct Dispatch
+{
+    Isa isa;
+    void (*project_x)(const uint16_t*, unsigned, unsigned, unsigned, unsigned, unsigned, unsigned, int*);
+    void (*project_y)(const uint16_t*, unsigned, unsigned, unsigned, unsigned, unsigned, unsigned, int*);
+    void (*extract_roi)(const uint16_t*, unsigned, unsigned, unsigned, int*);
+    void (*rolling_average_int)(const int*, double*, size_t, double);
+    void (*rolling_average_dbl)(const double*, double*, size_t, double);
+    void (*correlate)(const double*, size_t, const double*, size_t, double*);
+};
+
+static Dispatch choose()
+{
+    __builtin_cpu_init();
+    Isa isa = Scalar;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        isa = __builtin_cpu_supports("avx512f") ? Avx512 : Avx2;
+
+    const char* env = getenv("TTKERNELS_ISA");
+    if (env) {
+        if      (strcmp(env, "scalar") == 0)                 isa = Scalar;
+        else if (strcmp(env, "avx2")   == 0 && isa > Avx2)   isa = Avx2;
+    }
+
+    Dispatch d;
+    d.isa = isa;
+    switch(isa) {
+    case Avx512:
+        d.project_x           = project_x_avx512;
+        d.project_y           = project_y_avx512;
+        d.extract_roi         = extract_roi_avx2;
+        d.rolling_average_int = rolling_average_int_avx2;
+        d.rolling_average_dbl = rolling_average_dbl_avx2;
+        d.correlate           = correlate_avx512;
+        break;
+    case Avx2:
+        d.project_x           = project_x_avx2;
+        d.project_y           = project_y_avx2;
+        d.extract_roi         = extract_roi_avx2;
+        d.rolling_average_int = rolling_average_int_avx2;
+        d.rolling_average_dbl = rolling_average_dbl_avx2;
+        d.correlate           = correlate_avx2;
+        break;
+    default:
+        d.project_x           = project_x_scalar;
+        d.project_y           = project_y_scalar;
+        d.extract_roi         = extract_roi_scalar;
+        d.rolling_average_int = rolling_average_int_scalar;
+        d.rolling_average_dbl = rolling_average_dbl_scalar;
+        d.correlate           = correlate_scalar;
+        break;
+    }
+    logging::debug("TTKernels using %s", isaName(isa));
+    return d;
+}
+
+static const Dispatch& dispatch()
+{
+    static const Dispatch d = choose();
+    return d;
+}
+
+Isa isa() { return dispatch().isa; }
+
+const char* isaName(Isa isa)
+{
+    switch(isa) {
+    case Avx512: return "AVX-512";
+    case Avx2:   return "AVX2";
+    default:     return "scalar";
+    }
+}
+
+void project_x(const uint16_t* frame, unsigned stride,
+               unsigned x0, unsigned x1, unsigned y0, unsigned y1,
+               unsigned ped, int* result)
+{
+    dispatch().project_x(frame, stride, x0, x1, y0, y1, ped, result);
+}
+
+void project_y(const uint16_t* frame, unsigned stride,
+               unsigned x0, unsigned x1, unsigned y0, unsigned y1,
+               unsigned ped, int* result)
+{
+    dispatch().project_y(frame, stride, x0, x1, y0, y1, ped, result);
+}
+
+void extract_roi(const uint16_t* line, unsigned x0, unsigned x1,
+                 unsigned ped, int* result)
+{
+    dispatch().extract_roi(line, x0, x1, ped, result);
+}
+
+void rolling_average(const int* a, double* avg, size_t n, double fraction)
+{
+    dispatch().rolling_average_int(a, avg, n, fraction);
+}
+
+void rolling_average(const double* a, double* avg, size_t n, double fraction)
+{
+    dispatch().rolling_average_dbl(a, avg, n, fraction);
+}
+
+void rolling_average(const std::vector<int>& a, std::vector<double>& avg, double fraction)
+{
+    if (avg.size()==0) {
+        avg.resize(a.size());
+        for(unsigned i=0; i<a.size(); i++)
+            avg[i] = a[i];
+    } else if (avg.size()!=a.size()) {
+        logging::critical("rolling average (int/double) with different sizes");
+        throw std::string("rolling average with different sizes");
+    } else
+        rolling_average(a.data(), avg.data(), a.size(), fraction);
+}
+
+void rolling_average(const std::vector<double>& a, std::vector<double>& avg, double fraction)
+{
+    if (avg.size()==0) {
+        avg = a;
+    } else if (avg.size()!=a.size()) {
+        logging::critical("rolling average (double/double) with different sizes");
+        throw std::string("rolling average with different sizes");
+    } else
+        rolling_average(a.data(), avg.data(), a.size(), fraction);
+}
+
+void correlate(const double* filter, size_t nf,
+               const double* sample, size_t n, double* result)
+{
+    dispatch().correlate(filter, nf, sample, n, result);
+}
+
+Peaks find_peaks(const double* a, size_t n, double afrac, unsigned max_peaks)
+{
+    Peaks peaks;
+    peaks.n = 0;
+    if (max_peaks > Peaks::MaxPeaks)
+        max_peaks = Peaks::MaxPeaks;
+    if (!n || !max_peaks)
+        return peaks;
+
+    double amax    = a[0];
+    double aleft   = amax;
+    double aright  = 0;
+    unsigned imax  = 0;
+
+    bool lpeak = false;
+
+    for(unsigned i=1; i<n; i++) {
+        if (a[i] > amax) {
+            amax = a[i];
+            double af = afrac*amax;
+            if (af > aleft) {
+                imax = i;
+                lpeak  = true;
+                aright = af;
+            }
+        }
+        else if (lpeak && a[i] < aright) {
+            if (peaks.n==max_peaks && a[peaks.index[peaks.n-1]]>amax)
+                ;
+            else {
+                if (peaks.n==max_peaks)
+                    peaks.n--;
+
+                //  Insert before the first smaller peak, keeping the order
+                unsigned k=0;
+                while(k<peaks.n && !(a[peaks.index[k]]<amax))
+                    k++;
+                for(unsigned m=peaks.n; m>k; m--)
+                    peaks.index[m] = peaks.index[m-1];
+                peaks.index[k] = imax;
+                peaks.n++;
+            }
+
+            lpeak = false;
+            amax  = aleft = (a[i]>0 ? a[i] : 0);
+        }
+        else if (!lpeak && a[i] < aleft) {
+            amax = aleft = (a[i] > 0 ? a[i] : 0);
+        }
+    }
+    return peaks;
+}
+
+//  Least squares fit of y = a0 + a1*x + a2*x^2 for x in [0,len)
+static void parab_fit(const double* input, unsigned len, double* result)
+{
+    double xx[5], xy[3];
+    memset(xx,0,5*sizeof(double));
+    memset(xy,0,3*sizeof(double));
+
+    for(unsigned ix=0; ix<len; ix++) {
+        double x = double(ix);
+        double qx=x;
+        double y = input[ix];
+        xx[0] += 1;
+        xy[0] += y;
+        xx[1] += x;
+        xy[1] += (y*=x);
+        xx[2] += (qx*=x);
+        xy[2] += y*x;
+        xx[3] += (qx*=x);
+        xx[4] += qx*x;
+    }
+
+    double a11 = xx[0];
+    double a21 = xx[1];
+    double a31 = xx[2];
+    double a22 = xx[2];
+    double a32 = xx[3];
+    double a33 = xx[4];
+
+    double b11 = a22*a33-a32*a32;
+    double b21 = a21*a33-a32*a31;
+    double b31 = a21*a32-a31*a22;
+    double b22 = a11*a33-a31*a31;
+    double b32 = a11*a32-a21*a31;
+    double b33 = a11*a22-a21*a21;
+
+    double det = a11*b11 - a21*b21 + a31*b31;
+
+    if (det==0) {
+        result[0] = 0;
+        result[1] = 0;
+        result[2] = 0;
+    }
+    else {
+        result[0] = ( b11*xy[0] - b21*xy[1] + b31*xy[2])/det;
+        result[1] = (-b21*xy[0] + b22*xy[1] - b32*xy[2])/det;
+        result[2] = ( b31*xy[0] - b32*xy[1] + b33*xy[2])/det;
+    }
+}
+
+ParabFit parab_fit(const double* input, unsigned ix, unsigned len, double afrac)
+{
+    ParabFit p;
+
+    const double trf = afrac*input[ix];
+    int ix_left(ix);
+    while(--ix_left > 0) {
+        if (input[ix_left] < trf)
+            break;
+    }
+
+    int ix_right(ix);
+    while(++ix_right < int(len)) {
+        if (input[ix_right] < trf)
+            break;
+    }
+
+    double a[3];
+    parab_fit(&input[ix_left],ix_right-ix_left+1,a);
+
+    if (a[2] < 0) {  // a maximum
+        p.amplitude = a[0] - 0.2*a[1]*a[1]/a[2];
+        p.position  = double(ix_left)-0.5*a[1]/a[2];
+        p.fwhm      = sqrt(-2*p.amplitude/a[2]);
+    }
+    else {
+        p.amplitude = -1;
+        p.position  = -1;
+        p.fwhm      = -1;
+    }
+    return p;
+}
+
+//
+//  Scratch
+//
+
+Scratch& Scratch::local()
+{
+    static thread_local Scratch scratch;
+    return scratch;
+}
+
+//
+//  FirFilter
+//
+
+//  Avoids the NaN/Inf recovery of the std::complex operator
+static inline std::complex<double> cmul(const std::complex<double>& a, const std::complex<double>& b)
+{
+    return std::complex<double>(a.real()*b.real() - a.imag()*b.imag(),
+                                a.real()*b.imag() + a.imag()*b.real());
+}
+
+void FirFilter::configure(const std::vector<double>& weights, size_t sampleSize)
+{
+    m_weights    = weights;
+    m_sampleSize = sampleSize;
+    m_fftSize    = 0;
+    m_spectrum.clear();
+    m_twiddles.clear();
+    m_bitrev.clear();
+
+    size_t nf = weights.size();
+    if (sampleSize <= nf)
+        return;
+
+    //  The output samples of the circular convolution that wrap around
+    //  are not used as long as the transform is at least sampleSize long
+    size_t n = 1;
+    unsigned bits = 0;
+    while (n < sampleSize) { n <<= 1; bits++; }
+
+    //  Rough cost model: the direct kernel retires 'lanes' multiply-adds
+    //  per cycle, while the two transforms cost about 5*n*log2(n)
+    double lanes  = isa()==Avx512 ? 16 : isa()==Avx2 ? 8 : 1;
+    double direct = double(sampleSize-nf)*double(nf)/lanes;
+    double fft    = 5.*double(n)*double(bits);
+    if (direct <= fft)
+        return;
+    m_fftSize = n;
+
+    m_twiddles.resize(n/2);
+    for(size_t k=0; k<n/2; k++)
+        m_twiddles[k] = std::polar(1.0, -2*M_PI*double(k)/double(n));
+
+    m_bitrev.resize(n);
+    for(size_t k=0; k<n; k++) {
+        unsigned r = 0;
+        for(unsigned b=0; b<bits; b++)
+            if (k & (1ul<<b))  r |= 1u<<(bits-1-b);
+        m_bitrev[k] = r;
+    }
+
+    //  Correlation is convolution with the reversed filter.  The 1/n
+    //  normalization of the inverse transform is folded in here.
+    m_spectrum.assign(n, cplx(0,0));
+    for(size_t j=0; j<nf; j++)
+        m_spectrum[nf-1-j] = cplx(weights[j]/double(n), 0);
+    _fft(m_spectrum.data(), false);
+}
+
+void FirFilter::apply(const double* sample, size_t n, double* result) const
+{
+    size_t nf = m_weights.size();
+    if (n < nf) {
+        logging::critical("FirFilter sample size %zu smaller than filter size %zu", n, nf);
+        throw std::string("FirFilter sample size too small");
+    }
+    if (!usesFft(n)) {
+        correlate(m_weights.data(), nf, sample, n, result);
+        return;
+    }
+
+    std::vector<cplx>& work = Scratch::local().fft;
+    work.resize(m_fftSize);
+    for(size_t i=0; i<n; i++)           work[i] = cplx(sample[i], 0);
+    for(size_t i=n; i<m_fftSize; i++)   work[i] = cplx(0, 0);
+    _fft(work.data(), false);
+    for(size_t i=0; i<m_fftSize; i++)   work[i] = cmul(work[i], m_spectrum[i]);
+    _fft(work.data(), true);
+    for(size_t i=0; i<n-nf; i++)        result[i] = work[i+nf-1].real();
+}
+
+//  Iterative radix-2 decimation in time transform (unnormalized)
+void FirFilter::_fft(cplx* data, bool inverse) const
+{
+    size_t n = m_fftSize;
+    for(size_t k=0; k<n; k++)
+        if (k < m_bitrev[k])  std::swap(data[k], data[m_bitrev[k]]);
+
+    for(size_t len=2; len<=n; len<<=1) {
+        size_t half = len/2;
+        size_t step = n/len;
+        for(size_t i=0; i<n; i+=len) {
+            for(size_t k=0; k<half; k++) {
+                cplx w = m_twiddles[k*step];
+                if (inverse)  w = std::conj(w);
+                cplx u = data[i+k];
+                cplx v = cmul(data[i+k+half], w);
+                data[i+k]      = u+v;
+                data[i+k+half] = u-v;
+            }
+        }
+    }
+}
+
+}
+}
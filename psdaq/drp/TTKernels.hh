@@ -0,0 +1,124 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Drp {
+
+// Numerical kernels shared by the timetool feature extraction of the
+// OpalTTFex and Piranha4TTFex detectors.
+//
+// The kernels write into caller provided buffers and dispatch at run time
+// to AVX-512, AVX2 or scalar implementations depending on what the CPU
+// supports, so no special compiler flags are needed to build them.
+namespace TTKernels {
+
+enum Isa { Scalar, Avx2, Avx512 };
+
+// The instruction set selected for this CPU (may be lowered with the
+// TTKERNELS_ISA environment variable set to "scalar" or "avx2")
+Isa isa();
+const char* isaName(Isa);
+
+// Sum of the pixels of the ROI [x0,x1]x[y0,y1] (inclusive) of a frame with
+// 'stride' pixels per row, along y (one value per column, project_x) or
+// along x (one value per row, project_y).  The pedestal is subtracted for
+// each summed pixel.
+void project_x(const uint16_t* frame, unsigned stride,
+               unsigned x0, unsigned x1, unsigned y0, unsigned y1,
+               unsigned ped, int* result);
+void project_y(const uint16_t* frame, unsigned stride,
+               unsigned x0, unsigned x1, unsigned y0, unsigned y1,
+               unsigned ped, int* result);
+
+// Pixels [x0,x1] of a line with the pedestal subtracted
+void extract_roi(const uint16_t* line, unsigned x0, unsigned x1,
+                 unsigned ped, int* result);
+
+// avg = avg*(1-fraction) + a*fraction
+void rolling_average(const int*    a, double* avg, size_t n, double fraction);
+void rolling_average(const double* a, double* avg, size_t n, double fraction);
+
+// As above, but initialize an empty average to 'a'.
+// Throws std::string when the sizes differ.
+void rolling_average(const std::vector<int>&    a, std::vector<double>& avg, double fraction);
+void rolling_average(const std::vector<double>& a, std::vector<double>& avg, double fraction);
+
+// result[i] = sum_j sample[i+j]*filter[j] for i in [0, n-nf)
+void correlate(const double* filter, size_t nf,
+               const double* sample, size_t n, double* result);
+
+// The highest peaks of a waveform, largest first
+struct Peaks
+{
+    enum { MaxPeaks = 4 };
+    unsigned n;
+    unsigned index[MaxPeaks];
+};
+
+// Peaks separated by the waveform falling below afrac of the peak value.
+// At most min(max_peaks, Peaks::MaxPeaks) are returned.
+Peaks find_peaks(const double* a, size_t n, double afrac, unsigned max_peaks);
+
+// Parabolic fit of the region around input[ix] that is above afrac of it.
+// All fields are -1 when the region is not a maximum.
+struct ParabFit
+{
+    double amplitude;
+    double position;
+    double fwhm;
+};
+ParabFit parab_fit(const double* input, unsigned ix, unsigned len, double afrac);
+
+// Working storage for the analysis of one event.  There is one instance per
+// thread (local()), so the DRP workers neither share nor contend for it, and
+// since the buffers only ever grow, the analysis does not allocate memory
+// once they have reached the size of the configured ROIs.
+class Scratch
+{
+public:
+    static Scratch& local();
+public:
+    std::vector<int>    sig;    // signal region projection
+    std::vector<int>    ref;    // reference region projection
+    std::vector<int>    sb;     // sideband region projection
+    std::vector<double> refd;
+    std::vector<double> qwf;    // filtered signal
+    std::vector<std::complex<double> > fft; // FirFilter transform
+};
+
+// Finite impulse response filter with the filter weights of a configuration.
+// Long filters are applied by FFT based convolution, which is O(n log n)
+// rather than O(n*nf), when that is estimated to be cheaper than the direct
+// SIMD kernel for the instruction set in use.
+class FirFilter
+{
+public:
+    FirFilter() : m_sampleSize(0), m_fftSize(0) {}
+    void configure(const std::vector<double>& weights, size_t sampleSize);
+    size_t size() const { return m_weights.size(); }
+    size_t outputSize(size_t sampleSize) const
+    { return sampleSize > m_weights.size() ? sampleSize - m_weights.size() : 0; }
+    bool usesFft(size_t sampleSize) const
+    { return m_fftSize && sampleSize == m_sampleSize; }
+
+    // Writes outputSize(n) values to result.  Safe to call concurrently,
+    // the FFT path works in the calling thread's Scratch.
+    void apply(const double* sample, size_t n, double* result) const;
+private:
+    typedef std::complex<double> cplx;
+    void _fft(cplx* data, bool inverse) const;
+private:
+    std::vector<double> m_weights;
+    size_t              m_sampleSize;
+    size_t              m_fftSize;
+    std::vector<cplx>   m_spectrum;   // Of the reversed, zero padded filter
+    std::vector<cplx>   m_twiddles;
+    std::vector<unsigned> m_bitrev;
+};
+
+}
+
+}
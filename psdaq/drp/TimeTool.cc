@@ -66,7 +66,7 @@ void TimeTool::_event(XtcData::Xtc& xtc, const void* bufEnd, std::vector< XtcDat
       unsigned shape[MaxRank];
       shape[0] = subframes[2].shape()[0];
       Array<uint8_t> arrayT = cd.allocate<uint8_t>(TTDef::image, shape);
-      memcpy(arrayT.data(), subframes[2].data(), subframes[2].shape()[0]);
+      m_pool->copyPayload(arrayT.data(), subframes[2].data(), subframes[2].shape()[0]);
     }
 }
 
@@ -66,8 +66,8 @@ int main(int argc, char* argv[])
     }
 
     switch (para.verbose) {
-      case 0:  logging::init(para.instrument.c_str(), LOG_INFO);     break;
-      default: logging::init(para.instrument.c_str(), LOG_DEBUG);    break;
+      case 0:  logging::init(para.instrument.c_str(), LOG_INFO, true);   break;
+      default: logging::init(para.instrument.c_str(), LOG_DEBUG, true);  break;
     }
     logging::info("logging configured");
     if (optind < argc)
@@ -122,6 +122,9 @@ int main(int argc, char* argv[])
         if (kwargs.first == "pebbleBufCount")    continue;  // DrpBase
         if (kwargs.first == "batching")          continue;  // DrpBase
         if (kwargs.first == "directIO")          continue;  // DrpBase
+        if (kwargs.first == "traceInterval")     continue;  // DrpBase
+        if (kwargs.first == "traceFile")         continue;  // DrpBase
+        if (kwargs.first == "zeroCopy")          continue;  // DrpBase
         if (para.detType == "opal") {
             if (kwargs.first == "simxtc")            continue;  // Opal
             if (kwargs.first == "simxtc2")           continue;  // Opal
@@ -130,8 +133,12 @@ int main(int argc, char* argv[])
         }
         if (para.detType == "tt")
             if (kwargs.first == "ttreffile")         continue;  // OpalTTFex
-        if (para.detType == "hsd")
+        if (para.detType == "hsd") {
             if (kwargs.first == "hsd_epics_prefix")  continue;  // Digitizer
+            if (kwargs.first == "hsd_fex")           continue;  // Digitizer
+            if (kwargs.first == "hsd_fex_dropraw")   continue;  // Digitizer
+            if (kwargs.first == "hsd_fex_fraction")  continue;  // Digitizer
+        }
         if (para.detType == "wave8")
             if (kwargs.first == "epics_prefix")      continue;  // Wave8
         if (para.detType == "epixhremu") {
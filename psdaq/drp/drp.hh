@@ -7,8 +7,13 @@
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
+#include <memory>
 #include <string>
+#include <cstring>
+#include <sys/uio.h>                    // struct iovec
 #include "spscqueue.hh"
+#include "IndexAllocator.hh"
+#include "EventTrace.hh"
 
 #define PGP_MAX_LANES 8
 
@@ -71,6 +76,74 @@ struct PGPEvent
     unsigned pebbleIndex;
 };
 
+// Region of an L1Accept dgram whose bytes were left in a DMA buffer
+// (see MemPool::copyPayload)
+struct PayloadRef
+{
+    uint32_t offset;                    // from the start of the XtcData::Dgram
+    uint32_t size;
+    const void* src;
+};
+
+// The offsets are relative to base, the XtcData::Dgram of the pebble's
+// Pds::EbDgram, which is the address the dgram is written from
+struct PayloadRefs
+{
+    unsigned count = 0;                 // refs, in increasing offset
+    PayloadRef ref[PGP_MAX_LANES];
+    unsigned nDma = 0;                  // DMA buffers held until the dgram is written
+    uint32_t dmaIndex[PGP_MAX_LANES];
+
+    // Records the region at dst, false if it can't be tracked
+    bool add(const uint8_t* base, const void* dst, const void* src, size_t size)
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(dst);
+        if (p < base || count == PGP_MAX_LANES)  return false;
+        size_t offset = p - base;
+        if (count && offset < ref[count-1].offset + ref[count-1].size)  return false;
+        ref[count++] = {uint32_t(offset), uint32_t(size), src};
+        return true;
+    }
+    // Copies the regions into the dgram at base
+    void resolve(uint8_t* base)
+    {
+        for (unsigned i = 0; i < count; i++) {
+            memcpy(base + ref[i].offset, ref[i].src, ref[i].size);
+        }
+        count = 0;
+    }
+    // Splits the size bytes of the dgram at base into pieces of the dgram and
+    // the regions, returns the number of iovecs, at most 2*PGP_MAX_LANES+1
+    int gather(const uint8_t* base, size_t size, struct iovec* iov) const
+    {
+        size_t pos = 0;
+        int n = 0;
+        for (unsigned i = 0; i < count; i++) {
+            iov[n++] = {(void*)(base + pos), ref[i].offset - pos};
+            iov[n++] = {(void*)ref[i].src, ref[i].size};
+            pos = ref[i].offset + ref[i].size;
+        }
+        iov[n++] = {(void*)(base + pos), size - pos};
+        return n;
+    }
+};
+
+inline unsigned nextPowerOf2(unsigned n)
+{
+    unsigned count = 0;
+
+    if (n && !(n & (n - 1))) {
+        return n;
+    }
+
+    while( n != 0) {
+        n >>= 1;
+        count += 1;
+    }
+
+    return 1 << count;
+}
+
 class Pebble
 {
 public:
@@ -97,12 +170,14 @@ private:
 class MemPool
 {
 public:
+    static const unsigned InvalidIndex = ~0u; // allocate() after shutdown()
     MemPool(Parameters& para);
     ~MemPool();
     Pebble pebble;
     std::vector<PGPEvent> pgpEvents;
     std::vector<Pds::EbDgram*> transitionDgrams;
     void** dmaBuffers;
+    EventTrace trace;
     unsigned nDmaBuffers() const {return m_nDmaBuffers;}
     unsigned dmaSize() const {return m_dmaSize;}
     unsigned nbuffers() const {return m_nbuffers;}
@@ -110,11 +185,17 @@ public:
     int fd() const {return m_fd;}
     void shutdown();
     Pds::EbDgram* allocateTr();
-    void freeTr(Pds::EbDgram* dgram) { m_transitionBuffers.push(dgram); }
+    void freeTr(Pds::EbDgram* dgram);
     unsigned countDma();
     unsigned allocate();
     void freeDma(std::vector<uint32_t>& indices, unsigned count);
-    void freePebble();
+    void freePebble(unsigned index);
+    bool zeroCopy() const {return m_zeroCopy;}
+    void copyPayload(void* dst, const void* src, size_t size);
+    const PayloadRefs& payloadRefs(unsigned index) const {return m_payloadRefs[index];}
+    void resolvePayload(unsigned index);
+    void holdDma(PGPEvent* event);
+    void releasePayload(unsigned index);
     const int64_t dmaInUse() const { return m_dmaAllocs.load(std::memory_order_relaxed) -
                                             m_dmaFrees.load(std::memory_order_relaxed); }
     const int64_t inUse() const { return m_allocs.load(std::memory_order_relaxed) -
@@ -127,13 +208,17 @@ private:
     unsigned m_dmaSize;
     int m_fd;
     bool m_setMaskBytesDone;
-    SPSCQueue<void*> m_transitionBuffers;
+    size_t m_trBufSize;
+    uint8_t* m_trBuffers;
+    IndexAllocator m_transitionBuffers;
+    std::unique_ptr<IndexAllocator> m_pebbleBuffers;
+    uint8_t* _dgram(unsigned index);
+    bool m_zeroCopy;
+    std::vector<PayloadRefs> m_payloadRefs;
     std::atomic<uint64_t> m_dmaAllocs;
     std::atomic<uint64_t> m_dmaFrees;
     std::atomic<uint64_t> m_allocs;
     std::atomic<uint64_t> m_frees;
-    std::mutex m_lock;
-    std::condition_variable m_condition;
 };
 
 }
@@ -0,0 +1,99 @@
+// Examine the per-event stage traces written by a DRP run with the
+// traceInterval and traceFile kwargs.  By default a summary of the latency
+// of each stage with respect to the previous visited one is printed.  With
+// -c, every record is printed in CSV form for further analysis.
+
+#include "EventTrace.hh"
+
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace Drp;
+
+static void usage(const char* name)
+{
+    printf("Usage: %s [-c] <traceFile>\n", name);
+    printf("  -c  Print each record as comma separated values (us since the event was built)\n");
+}
+
+int main(int argc, char** argv)
+{
+    bool csv = false;
+    int c;
+    while ((c = getopt(argc, argv, "ch")) != EOF) {
+        switch (c) {
+            case 'c':  csv = true;  break;
+            default:   usage(argv[0]);  return 1;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE* file = fopen(argv[optind], "r");
+    if (!file) {
+        perror(argv[optind]);
+        return 1;
+    }
+    EventTrace::FileHeader hdr;
+    if (fread(&hdr, sizeof(hdr), 1, file) != 1 || hdr.magic != EventTrace::Magic) {
+        fprintf(stderr, "%s is not a DRP trace file\n", argv[optind]);
+        fclose(file);
+        return 1;
+    }
+    if (hdr.version != EventTrace::Version || hdr.numStages != EventTrace::NumStages) {
+        fprintf(stderr, "Unsupported trace file version %u with %u stages\n", hdr.version, hdr.numStages);
+        fclose(file);
+        return 1;
+    }
+    std::vector<EventTrace::Record> records(hdr.numRecords);
+    size_t n = fread(records.data(), sizeof(EventTrace::Record), records.size(), file);
+    fclose(file);
+    records.resize(n);
+
+    auto us = [&](uint64_t ticks) { return double(ticks) / hdr.ticksPerUs; };
+
+    if (csv) {
+        printf("pulseId,evtCounter,service");
+        for (unsigned i = 0; i < EventTrace::NumStages; ++i)
+            printf(",%s", EventTrace::name(EventTrace::Stage(i)));
+        printf("\n");
+        for (const auto& rec : records) {
+            printf("0x%014lx,%u,%u", rec.pulseId, rec.evtCounter, rec.service);
+            for (unsigned i = 0; i < EventTrace::NumStages; ++i) {
+                if (rec.tsc[i])  printf(",%.3f", us(rec.tsc[i] - rec.tsc[EventTrace::EventBuilt]));
+                else             printf(",");
+            }
+            printf("\n");
+        }
+        return 0;
+    }
+
+    std::vector<std::vector<double> > deltas(EventTrace::NumStages);
+    for (const auto& rec : records) {
+        uint64_t prev = rec.tsc[EventTrace::EventBuilt];
+        for (unsigned i = EventTrace::WorkerStart; i < EventTrace::NumStages; ++i) {
+            if (!rec.tsc[i])  continue;
+            deltas[i].push_back(us(rec.tsc[i] - prev));
+            prev = rec.tsc[i];
+        }
+    }
+
+    printf("%zu records, %.1f TSC ticks/us\n", records.size(), hdr.ticksPerUs);
+    printf("%-16s %10s %10s %10s %10s %10s\n", "stage (us)", "count", "mean", "median", "99%", "max");
+    for (unsigned i = EventTrace::WorkerStart; i < EventTrace::NumStages; ++i) {
+        auto& d = deltas[i];
+        if (d.empty())  continue;
+        std::sort(d.begin(), d.end());
+        double sum = 0.0;
+        for (auto v : d)  sum += v;
+        printf("%-16s %10zu %10.1f %10.1f %10.1f %10.1f\n", EventTrace::name(EventTrace::Stage(i)),
+               d.size(), sum / d.size(), d[d.size() / 2], d[(d.size() * 99) / 100], d.back());
+    }
+
+    return 0;
+}
@@ -0,0 +1,191 @@
+// Microbenchmark of the pebble index allocator under the DRP's threading
+// pattern: a reader thread allocates pebble (and occasionally transition)
+// indices and hands events round-robin to worker threads, a collector
+// gathers them back in order and an EbReceiver thread releases them.
+//
+// The lock-free IndexAllocator is compared against the counter plus
+// mutex/condition variable scheme MemPool used previously.
+
+#include "IndexAllocator.hh"
+#include "spscqueue.hh"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+using us_t = std::chrono::microseconds;
+
+// The scheme MemPool used before IndexAllocator
+class CountingPool
+{
+public:
+    CountingPool(unsigned nbuffers) : m_nbuffers(nbuffers), m_allocs(0), m_frees(0) {}
+    unsigned allocate()
+    {
+        auto allocs = m_allocs.fetch_add(1, std::memory_order_acq_rel);
+        asm volatile("mfence" ::: "memory");
+        auto frees  = m_frees.load(std::memory_order_acquire);
+        if (allocs - frees == m_nbuffers - 1) {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_condition.wait(lock, [this] {
+                return (m_allocs.load(std::memory_order_acquire) -
+                        m_frees.load(std::memory_order_acquire)) != m_nbuffers;
+            });
+        }
+        return allocs & (m_nbuffers - 1);
+    }
+    void free(unsigned)
+    {
+        auto frees  = m_frees.fetch_add(1, std::memory_order_acq_rel);
+        asm volatile("mfence" ::: "memory");
+        auto allocs = m_allocs.load(std::memory_order_acquire);
+        if (allocs - frees == m_nbuffers) {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_condition.notify_one();
+        }
+    }
+private:
+    uint64_t m_nbuffers;
+    std::atomic<uint64_t> m_allocs;
+    std::atomic<uint64_t> m_frees;
+    std::mutex m_lock;
+    std::condition_variable m_condition;
+};
+
+class RingPool
+{
+public:
+    RingPool(unsigned nbuffers) : m_allocator(nbuffers) {}
+    unsigned allocate()     { uint32_t idx = 0; m_allocator.allocate(idx); return idx; }
+    void free(unsigned idx) { m_allocator.free(idx); }
+private:
+    IndexAllocator m_allocator;
+};
+
+struct Event
+{
+    uint64_t seq;
+    unsigned pebble;
+    int      transition;
+};
+
+template <class Pool>
+static double run(unsigned nbuffers, unsigned nworkers, uint64_t nevents, unsigned trInterval, unsigned work)
+{
+    Pool pebbles(nbuffers);
+    Pool transitions(16);
+    std::vector<Event> events(nbuffers);
+    std::vector<SPSCQueue<uint64_t>> inputs;
+    std::vector<SPSCQueue<uint64_t>> outputs;
+    for (unsigned i = 0; i < nworkers; ++i) {
+        inputs.emplace_back(SPSCQueue<uint64_t>(nbuffers));
+        outputs.emplace_back(SPSCQueue<uint64_t>(nbuffers));
+    }
+    SPSCQueue<unsigned> results(nbuffers);
+    std::atomic<uint64_t> checksum(0);
+    std::atomic<bool> error(false);
+
+    auto t0 = std::chrono::steady_clock::now();
+
+    std::thread reader([&]() {
+        for (uint64_t i = 0; i < nevents; ++i) {
+            unsigned pebble = pebbles.allocate();
+            Event& ev = events[pebble];
+            ev.seq        = i;
+            ev.pebble     = pebble;
+            ev.transition = (trInterval && (i % trInterval) == 0) ? int(transitions.allocate()) : -1;
+            inputs[i % nworkers].push(pebble);
+        }
+    });
+
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < nworkers; ++w) {
+        workers.emplace_back([&, w]() {
+            uint64_t pebble;
+            while (inputs[w].pop(pebble)) {
+                uint64_t sum = 0;
+                for (unsigned k = 0; k < work; ++k)  sum += (pebble + k) * 2654435761u;
+                checksum.fetch_add(sum & 1, std::memory_order_relaxed);
+                outputs[w].push(pebble);
+            }
+        });
+    }
+
+    std::thread collector([&]() {
+        uint64_t pebble;
+        for (uint64_t i = 0; i < nevents; ++i) {
+            if (!outputs[i % nworkers].pop(pebble))  break;
+            results.push(unsigned(pebble));
+        }
+    });
+
+    // EbReceiver: releases the buffers in the order they were allocated
+    std::thread receiver([&]() {
+        unsigned pebble;
+        unsigned last = nbuffers - 1;
+        for (uint64_t i = 0; i < nevents; ++i) {
+            if (!results.pop(pebble))  break;
+            if (pebble != ((last + 1) % nbuffers) || events[pebble].seq != i)  error = true;
+            last = pebble;
+            if (events[pebble].transition >= 0)  transitions.free(events[pebble].transition);
+            pebbles.free(pebble);
+        }
+    });
+
+    reader.join();
+    collector.join();
+    receiver.join();
+    for (unsigned w = 0; w < nworkers; ++w)  inputs[w].shutdown();
+    for (auto& t : workers)  t.join();
+
+    auto t1 = std::chrono::steady_clock::now();
+    if (error)  fprintf(stderr, "*** Pebble ordering was violated\n");
+
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()) / double(nevents);
+}
+
+static void usage(const char* name)
+{
+    printf("Usage: %s [-b <nbuffers>] [-w <nworkers>] [-n <nevents>] [-t <trInterval>] [-c <work>]\n", name);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned nbuffers   = 1024;
+    unsigned nworkers   = 10;
+    uint64_t nevents    = 4000000;
+    unsigned trInterval = 100000;
+    unsigned work       = 100;
+    int c;
+    while ((c = getopt(argc, argv, "b:w:n:t:c:h")) != EOF) {
+        switch (c) {
+            case 'b':  nbuffers   = std::strtoul(optarg, nullptr, 0);  break;
+            case 'w':  nworkers   = std::strtoul(optarg, nullptr, 0);  break;
+            case 'n':  nevents    = std::strtoull(optarg, nullptr, 0); break;
+            case 't':  trInterval = std::strtoul(optarg, nullptr, 0);  break;
+            case 'c':  work       = std::strtoul(optarg, nullptr, 0);  break;
+            default:   usage(argv[0]);  return 1;
+        }
+    }
+    if (nbuffers & (nbuffers - 1)) {
+        fprintf(stderr, "nbuffers must be a power of 2\n");
+        return 1;
+    }
+
+    printf("nbuffers %u, nworkers %u, nevents %lu, trInterval %u, work %u\n",
+           nbuffers, nworkers, nevents, trInterval, work);
+    for (unsigned pass = 0; pass < 2; ++pass) {
+        double tMutex = run<CountingPool>(nbuffers, nworkers, nevents, trInterval, work);
+        double tRing  = run<RingPool>    (nbuffers, nworkers, nevents, trInterval, work);
+        printf("  pass %u:  mutex/condvar %7.1f ns/event,  lock-free ring %7.1f ns/event\n",
+               pass, tMutex, tRing);
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Writes L1Accept dgrams whose payloads were left in DMA buffers
+// (PayloadRefs, as recorded by MemPool::copyPayload with zeroCopy) through
+// the gathering BufferedFileWriterMT::writeEvent, and the same dgrams
+// after PayloadRefs::resolve through the contiguous writeEvent, and checks
+// that both files hold the bytes of dgrams built with memcpy.
+
+#include "drp.hh"
+#include "FileWriter.hh"
+#include "psdaq/service/EbDgram.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace Drp;
+
+static std::vector<uint8_t> readFile(const std::string& fileName)
+{
+    std::ifstream f(fileName, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+int main(int argc, char* argv[])
+{
+    const unsigned nEvents = 100;
+    const size_t pebbleSize = 16384;
+    const std::string dir = argc > 1 ? argv[1] : "/tmp";
+    const std::string gathered = dir + "/tstPayloadRefs-gathered-" + std::to_string(getpid()) + ".xtc2";
+    const std::string resolved = dir + "/tstPayloadRefs-resolved-" + std::to_string(getpid()) + ".xtc2";
+
+    std::vector<uint8_t> dma(PGP_MAX_LANES*4096);
+    std::vector<uint8_t> pebble(pebbleSize);
+    std::vector<uint8_t> expected;
+    BufferedFileWriterMT gatherWriter(1 << 20);
+    BufferedFileWriterMT resolveWriter(1 << 20);
+    if (gatherWriter.open(gathered) || resolveWriter.open(resolved)) {
+        printf("can not create %s\n", gathered.c_str());
+        return EXIT_FAILURE;
+    }
+
+    srand(1);
+    for (unsigned evt = 0; evt < nEvents; evt++) {
+        // An L1Accept in a pebble buffer: the EbDgram header, some payload
+        // bytes written in place and up to PGP_MAX_LANES regions of the DMA buffers
+        for (auto& b : pebble)  b = rand();
+        for (auto& b : dma)     b = rand();
+        Pds::EbDgram* ebDgram = reinterpret_cast<Pds::EbDgram*>(pebble.data());
+        XtcData::Dgram* dgram = ebDgram;  // what EbReceiver writes from
+        XtcData::TimeStamp ts(evt + 1, 0);
+        dgram->time = ts;
+        const size_t payloadSize = 1024 + rand() % 8192;
+        dgram->xtc.extent = sizeof(XtcData::Xtc) + payloadSize;
+        const size_t size = sizeof(XtcData::Dgram) + payloadSize;
+
+        std::vector<uint8_t> reference(reinterpret_cast<uint8_t*>(dgram), reinterpret_cast<uint8_t*>(dgram) + size);
+        PayloadRefs refs;
+        uint8_t* payload = reinterpret_cast<uint8_t*>(dgram->xtc.payload());
+        size_t pos = evt % 3;             // the first region may start right at the payload
+        for (unsigned i = 0; i < PGP_MAX_LANES; i++) {
+            const size_t regionSize = 1 + rand() % 512;
+            if (pos + regionSize > payloadSize)  break;
+            const uint8_t* src = &dma[i*4096 + rand() % 256];
+            // MemPool::copyPayload records the region relative to the Dgram of the pebble
+            if (!refs.add(reinterpret_cast<uint8_t*>(dgram), payload + pos, src, regionSize)) {
+                printf("region %u of event %u not recorded\n", i, evt);
+                return EXIT_FAILURE;
+            }
+            memcpy(&reference[sizeof(XtcData::Dgram) + pos], src, regionSize);
+            pos += regionSize + rand() % 64;
+        }
+        expected.insert(expected.end(), reference.begin(), reference.end());
+
+        struct iovec iov[2*PGP_MAX_LANES+1];
+        int n = refs.gather(reinterpret_cast<const uint8_t*>(dgram), size, iov);
+        gatherWriter.writeEvent(iov, n, size, ts);
+
+        refs.resolve(reinterpret_cast<uint8_t*>(dgram));
+        resolveWriter.writeEvent(dgram, size, ts);
+    }
+    gatherWriter.close();
+    resolveWriter.close();
+
+    std::vector<uint8_t> g = readFile(gathered);
+    std::vector<uint8_t> r = readFile(resolved);
+    remove(gathered.c_str());
+    remove(resolved.c_str());
+    printf("gathered %zu bytes, resolved %zu bytes, expected %zu bytes\n", g.size(), r.size(), expected.size());
+    if (g != expected || r != expected) {
+        printf("%s\n", g != expected ? "gathered dgrams differ" : "resolved dgrams differ");
+        return EXIT_FAILURE;
+    }
+    printf("dgrams of %u events match\n", nEvents);
+    return EXIT_SUCCESS;
+}
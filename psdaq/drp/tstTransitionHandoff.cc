@@ -0,0 +1,151 @@
+// Microbenchmark of how long PGPDetector's reader thread is kept from
+// draining DMA buffers by a transition.  Before the transition thread was
+// added, the reader itself built the transition dgram by copying the xtc
+// made in phase 1 of the transition into the transition buffer.  Now it
+// only queues the pebble index to the transition thread, and the worker
+// that gets the transition waits (spin, then block) until it is ready.
+//
+// For each transition payload size, the reader time of both schemes is
+// printed together with the number of L1Accepts that arrive during it at
+// the given trigger rate, and the time the worker waits for the handoff.
+
+#include "spscqueue.hh"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+using ns_t = std::chrono::nanoseconds;
+
+class Transitioner
+{
+public:
+    Transitioner(unsigned nbuffers, size_t size) :
+        m_queue(nbuffers), m_ready(nbuffers), m_xtc(size, 0x5a),
+        m_trBuffers(nbuffers * size), m_size(size), m_terminate(false)
+    {
+        m_queue.startup();
+        m_thread = std::thread(&Transitioner::run, this);
+    }
+    ~Transitioner()
+    {
+        m_terminate.store(true, std::memory_order_release);
+        m_queue.shutdown();
+        m_thread.join();
+    }
+
+    // What the reader did before: copy the phase 1 xtc into the transition buffer
+    void build(unsigned index)
+    {
+        memcpy(&m_trBuffers[index * m_size], m_xtc.data(), m_size);
+    }
+
+    // What the reader does now
+    void post(unsigned index)
+    {
+        m_ready[index].store(false, std::memory_order_relaxed);
+        m_queue.push(index);
+    }
+
+    // What the worker does, as in PGPDetector::transitionReady()
+    bool ready(unsigned index)
+    {
+        for (unsigned i = 0; i < 1000; ++i) {
+            if (m_ready[index].load(std::memory_order_acquire))  return true;
+            asm volatile("pause" ::: "memory");
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [&] {
+            return m_ready[index].load(std::memory_order_acquire) ||
+                   m_terminate.load(std::memory_order_acquire);
+        });
+        return m_ready[index].load(std::memory_order_acquire);
+    }
+
+private:
+    void run()
+    {
+        unsigned index;
+        while (m_queue.popW(index)) {
+            build(index);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_ready[index].store(true, std::memory_order_release);
+            }
+            m_condition.notify_all();
+        }
+    }
+
+private:
+    SPSCQueue<unsigned> m_queue;
+    std::vector<std::atomic<bool> > m_ready;
+    std::vector<uint8_t> m_xtc;
+    std::vector<uint8_t> m_trBuffers;
+    size_t m_size;
+    std::atomic<bool> m_terminate;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_thread;
+};
+
+static void usage(const char* name)
+{
+    printf("Usage: %s [-b <nbuffers>] [-n <ntransitions>] [-r <L1 rate (Hz)>] [-s <max payload size>]\n", name);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned nbuffers     = 64;
+    unsigned ntransitions = 200;
+    double   rate         = 1e6;
+    size_t   maxSize      = 16 << 20;
+    int c;
+    while ((c = getopt(argc, argv, "b:n:r:s:h")) != EOF) {
+        switch (c) {
+            case 'b':  nbuffers     = std::strtoul(optarg, nullptr, 0);  break;
+            case 'n':  ntransitions = std::strtoul(optarg, nullptr, 0);  break;
+            case 'r':  rate         = std::strtod (optarg, nullptr);     break;
+            case 's':  maxSize      = std::strtoul(optarg, nullptr, 0);  break;
+            default:   usage(argv[0]);  return 1;
+        }
+    }
+    if (nbuffers & (nbuffers - 1)) {
+        fprintf(stderr, "nbuffers must be a power of 2\n");
+        return 1;
+    }
+
+    printf("nbuffers %u, ntransitions %u, L1 rate %.0f Hz\n", nbuffers, ntransitions, rate);
+    printf("%12s %14s %10s %14s %10s %14s\n",
+           "payload (B)", "inline (us)", "L1s", "handoff (us)", "L1s", "worker (us)");
+    for (size_t size = 4096; size <= maxSize; size *= 4) {
+        Transitioner tr(nbuffers, size);
+        double tInline = 0.0, tPost = 0.0, tWait = 0.0;
+        for (unsigned i = 0; i < ntransitions; ++i) {
+            unsigned index = i & (nbuffers - 1);
+            auto t0 = std::chrono::steady_clock::now();
+            tr.build(index);
+            auto t1 = std::chrono::steady_clock::now();
+            tr.post(index);
+            auto t2 = std::chrono::steady_clock::now();
+            if (!tr.ready(index))  return 1;
+            auto t3 = std::chrono::steady_clock::now();
+            tInline += std::chrono::duration_cast<ns_t>(t1 - t0).count();
+            tPost   += std::chrono::duration_cast<ns_t>(t2 - t1).count();
+            tWait   += std::chrono::duration_cast<ns_t>(t3 - t2).count();
+        }
+        tInline /= 1000.0 * ntransitions;
+        tPost   /= 1000.0 * ntransitions;
+        tWait   /= 1000.0 * ntransitions;
+        printf("%12zu %14.2f %10.1f %14.2f %10.1f %14.2f\n", size,
+               tInline, tInline * rate * 1e-6, tPost, tPost * rate * 1e-6, tWait);
+    }
+
+    return 0;
+}
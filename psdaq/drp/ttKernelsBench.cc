@@ -0,0 +1,178 @@
+// Benchmark of the timetool kernels (TTKernels) against the per-element
+// implementations OpalTTFex and Piranha4TTFex used before.  For each kernel
+// the time per call and the largest difference from the reference result
+// are printed.  Set TTKERNELS_ISA=scalar or avx2 to restrict the kernels.
+
+#include "TTKernels.hh"
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace Drp;
+
+//
+//  The previous implementations
+//
+static std::vector<int> ref_project_x(const uint16_t* f, unsigned stride,
+                                      unsigned x0, unsigned x1, unsigned y0, unsigned y1, unsigned ped)
+{
+  std::vector<int> result(x1-x0+1);
+  for(unsigned i=0; i<result.size(); i++) result[i]=-ped*(y1-y0+1);
+  for(unsigned i=y0; i<=y1; i++) {
+    for(unsigned j=x0, k=0; j<=x1; j++,k++)
+      result[k] += f[i*stride+j];
+  }
+  return result;
+}
+
+static std::vector<int> ref_project_y(const uint16_t* f, unsigned stride,
+                                      unsigned x0, unsigned x1, unsigned y0, unsigned y1, unsigned ped)
+{
+  std::vector<int> result(y1-y0+1);
+  for(unsigned i=y0,k=0; i<=y1; i++,k++) {
+    int sum=0;
+    for(unsigned j=x0; j<=x1; j++)
+      sum += f[i*stride+j];
+    result[k] = sum - ped*(x1-x0+1);
+  }
+  return result;
+}
+
+static void ref_rolling_average(std::vector<double>& a, std::vector<double>& avg, double fraction)
+{
+  double g = (1-fraction);
+  double f = fraction;
+  for(unsigned i=0; i<a.size(); i++)
+    avg[i] = avg[i]*g + a[i]*f;
+}
+
+static std::vector<double> ref_finite_impulse_response(std::vector<double>& filter,
+                                                       std::vector<double>& sample)
+{
+  unsigned nf = filter.size();
+  unsigned len = sample.size()-nf;
+  std::vector<double> result = std::vector<double>(len);
+  for(unsigned i=0; i<len; i++) {
+    double v = 0;
+    for(unsigned j=0; j<nf; j++)
+      v += sample[i+j]*filter[j];
+    result[i] = v;
+  }
+  return result;
+}
+
+template <class F>
+static double timeit(unsigned iterations, F f)
+{
+  auto t0 = std::chrono::steady_clock::now();
+  for(unsigned i=0; i<iterations; i++)
+    f();
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(t1-t0).count() / 1000. / iterations;
+}
+
+template <class T>
+static double maxdiff(const T* a, const T* b, size_t n)
+{
+  double d = 0;
+  for(size_t i=0; i<n; i++)
+    d = std::max(d, std::fabs(double(a[i]) - double(b[i])));
+  return d;
+}
+
+static void report(const char* name, double tref, double tnew, double diff)
+{
+  printf("%-24s %10.2f %10.2f %8.1fx %12.3g\n", name, tref, tnew, tref/tnew, diff);
+}
+
+static void usage(const char* name)
+{
+  printf("Usage: %s [-c <columns>] [-r <rows>] [-f <filter len,...>] [-n <iterations>]\n", name);
+}
+
+int main(int argc, char** argv)
+{
+  unsigned columns    = 1024;
+  unsigned rows       = 1024;
+  unsigned iterations = 200;
+  std::vector<unsigned> filters = {16, 32, 64, 128, 256};
+  int c;
+  while ((c = getopt(argc, argv, "c:r:f:n:h")) != EOF) {
+    switch (c) {
+      case 'c':  columns    = strtoul(optarg, nullptr, 0);  break;
+      case 'r':  rows       = strtoul(optarg, nullptr, 0);  break;
+      case 'n':  iterations = strtoul(optarg, nullptr, 0);  break;
+      case 'f': {
+        filters.clear();
+        char* p = optarg;
+        while (*p) {
+          filters.push_back(strtoul(p, &p, 0));
+          if (*p == ',')  p++;
+        }
+        break;
+      }
+      default:   usage(argv[0]);  return 1;
+    }
+  }
+
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<unsigned> pix(0, 4095);
+  std::vector<uint16_t> frame(columns*rows);
+  for(auto& p : frame)  p = pix(gen);
+
+  printf("TTKernels using %s, frame %ux%u\n", TTKernels::isaName(TTKernels::isa()), columns, rows);
+  printf("%-24s %10s %10s %9s %12s\n", "kernel", "prev (us)", "new (us)", "speedup", "max diff");
+
+  //  ROI of most of the frame, not aligned to the vector width
+  unsigned x0 = 3, x1 = columns-6, y0 = rows/4+1, y1 = 3*rows/4;
+  unsigned ped = 32;
+  {
+    std::vector<int> ref = ref_project_x(frame.data(), columns, x0, x1, y0, y1, ped);
+    std::vector<int> res(ref.size());
+    double tref = timeit(iterations, [&]() { ref = ref_project_x(frame.data(), columns, x0, x1, y0, y1, ped); });
+    double tnew = timeit(iterations, [&]() { TTKernels::project_x(frame.data(), columns, x0, x1, y0, y1, ped, res.data()); });
+    report("project_x", tref, tnew, maxdiff(ref.data(), res.data(), ref.size()));
+  }
+  {
+    std::vector<int> ref = ref_project_y(frame.data(), columns, x0, x1, y0, y1, ped);
+    std::vector<int> res(ref.size());
+    double tref = timeit(iterations, [&]() { ref = ref_project_y(frame.data(), columns, x0, x1, y0, y1, ped); });
+    double tnew = timeit(iterations, [&]() { TTKernels::project_y(frame.data(), columns, x0, x1, y0, y1, ped, res.data()); });
+    report("project_y", tref, tnew, maxdiff(ref.data(), res.data(), ref.size()));
+  }
+
+  std::uniform_real_distribution<double> uni(-1., 1.);
+  std::vector<double> sample(x1-x0+1);
+  for(auto& s : sample)  s = uni(gen);
+  {
+    std::vector<double> ref(sample.size(), 1.), res(sample.size(), 1.);
+    double tref = timeit(iterations, [&]() { ref_rolling_average(sample, ref, 0.05); });
+    double tnew = timeit(iterations, [&]() { TTKernels::rolling_average(sample.data(), res.data(), res.size(), 0.05); });
+    report("rolling_average", tref, tnew, maxdiff(ref.data(), res.data(), ref.size()));
+  }
+
+  for(unsigned nf : filters) {
+    if (nf >= sample.size())  continue;
+    std::vector<double> filter(nf);
+    for(auto& w : filter)  w = uni(gen);
+    std::vector<double> ref = ref_finite_impulse_response(filter, sample);
+    std::vector<double> direct(ref.size()), res(ref.size());
+    TTKernels::FirFilter fir;
+    fir.configure(filter, sample.size());
+    double tref = timeit(iterations, [&]() { ref = ref_finite_impulse_response(filter, sample); });
+    double tdir = timeit(iterations, [&]() { TTKernels::correlate(filter.data(), nf, sample.data(), sample.size(), direct.data()); });
+    double tfir = timeit(iterations, [&]() { fir.apply(sample.data(), sample.size(), res.data()); });
+    char name[64];
+    snprintf(name, sizeof(name), "fir %u direct", nf);
+    report(name, tref, tdir, maxdiff(ref.data(), direct.data(), ref.size()));
+    snprintf(name, sizeof(name), "fir %u filter (%s)", nf, fir.usesFft(sample.size()) ? "fft" : "direct");
+    report(name, tref, tfir, maxdiff(ref.data(), res.data(), ref.size()));
+  }
+
+  return 0;
+}
@@ -0,0 +1,250 @@
+// Check that OpalTTFex::analyze() does not allocate memory per event.
+//
+// A configuration equivalent to the one the DRP receives from the
+// configuration database is built in memory, then synthetic frames are
+// analyzed: a flat reference ("no beam") and a signal with an edge.  After
+// a few warm up events, which size the per-thread scratch space and the
+// rolling averages, every call to malloc/calloc/realloc is counted.
+// Set TTKERNELS_ISA=scalar to exercise the FFT filter path with -f.
+
+#include "OpalTTFex.hh"
+#include "drp.hh"
+
+#include "xtcdata/xtc/ConfigIter.hh"
+#include "xtcdata/xtc/DescData.hh"
+#include "xtcdata/xtc/NamesLookup.hh"
+#include "xtcdata/xtc/VarDef.hh"
+
+#include <atomic>
+#include <random>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace XtcData;
+
+//
+//  Allocation counter
+//
+extern "C" void* __libc_malloc (size_t);
+extern "C" void* __libc_calloc (size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+
+static std::atomic<bool>     counting(false);
+static std::atomic<unsigned> allocations(0);
+
+extern "C" void* malloc(size_t size)
+{
+  if (counting.load(std::memory_order_relaxed)) allocations++;
+  return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t n, size_t size)
+{
+  if (counting.load(std::memory_order_relaxed)) allocations++;
+  return __libc_calloc(n, size);
+}
+
+extern "C" void* realloc(void* p, size_t size)
+{
+  if (counting.load(std::memory_order_relaxed)) allocations++;
+  return __libc_realloc(p, size);
+}
+
+static const unsigned BeamCode = 140;
+
+class ConfigDef : public VarDef
+{
+public:
+  enum index { axis, minvalue, prescale_image, prescale_projections,
+               sig_convergence, ref_convergence, sb_convergence,
+               black_level, ref_enable, sb_enable,
+               sig_x0, sig_y0, sig_x1, sig_y1,
+               ref_x0, ref_y0, ref_x1, ref_y1,
+               sb_x0 , sb_y0 , sb_x1 , sb_y1 ,
+               ref_record,
+               beam_incl, beam_excl, laser_incl, laser_excl,
+               fir_weights, calib_poly };
+  ConfigDef()
+  {
+    NameVec.push_back({"fex.project.axis:axisEnum"  , Name::INT32 });
+    NameVec.push_back({"fex.project.minvalue"       , Name::UINT32});
+    NameVec.push_back({"fex.prescale.image"         , Name::UINT32});
+    NameVec.push_back({"fex.prescale.projections"   , Name::UINT32});
+    NameVec.push_back({"fex.sig.convergence"        , Name::DOUBLE});
+    NameVec.push_back({"fex.ref.convergence"        , Name::DOUBLE});
+    NameVec.push_back({"fex.sb.convergence"         , Name::DOUBLE});
+    NameVec.push_back({"user.black_level"           , Name::UINT32});
+    NameVec.push_back({"fex.ref.enable"             , Name::UINT8 });
+    NameVec.push_back({"fex.sb.enable"              , Name::UINT8 });
+    const char* rois[] = {"fex.sig.roi", "fex.ref.roi", "fex.sb.roi"};
+    for(unsigned i=0; i<3; i++) {
+      for(const char* c : {".x0",".y0",".x1",".y1"})
+        NameVec.push_back({(std::string(rois[i])+c).c_str(), Name::UINT32});
+    }
+    NameVec.push_back({"fex.ref.record:recordEnum"  , Name::INT32 });
+    NameVec.push_back({"fex.eventcodes.beam.incl"   , Name::UINT8 , 1});
+    NameVec.push_back({"fex.eventcodes.beam.excl"   , Name::UINT8 , 1});
+    NameVec.push_back({"fex.eventcodes.laser.incl"  , Name::UINT8 , 1});
+    NameVec.push_back({"fex.eventcodes.laser.excl"  , Name::UINT8 , 1});
+    NameVec.push_back({"fex.fir_weights"            , Name::DOUBLE, 1});
+    NameVec.push_back({"fex.calib_poly"             , Name::DOUBLE, 1});
+  }
+};
+
+static void build_config(Xtc& xtc, const void* bufEnd, NamesLookup& namesLookup,
+                          unsigned columns, unsigned rows, unsigned nfir)
+{
+  NamesId namesId(0, 0);
+  Alg alg("ttfex", 2, 1, 0);
+  Names& names = *new(xtc, bufEnd) Names(bufEnd, "tt", alg, "opal", "test", namesId);
+  ConfigDef def;
+  names.add(xtc, bufEnd, def);
+  namesLookup[namesId] = NameIndex(names);
+
+  CreateData cd(xtc, bufEnd, namesLookup, namesId);
+  cd.set_value(ConfigDef::axis                , int32_t(0));
+  cd.set_value(ConfigDef::minvalue            , uint32_t(10));
+  cd.set_value(ConfigDef::prescale_image      , uint32_t(0));
+  cd.set_value(ConfigDef::prescale_projections, uint32_t(0));
+  cd.set_value(ConfigDef::sig_convergence     , 1.0);
+  cd.set_value(ConfigDef::ref_convergence     , 0.05);
+  cd.set_value(ConfigDef::sb_convergence      , 0.05);
+  cd.set_value(ConfigDef::black_level         , uint32_t(32));
+  cd.set_value(ConfigDef::ref_enable          , uint8_t(1));
+  cd.set_value(ConfigDef::sb_enable           , uint8_t(0));
+  uint32_t roi[] = { 0, rows/4, columns-1, rows/2-1,        // signal
+                     0, rows/2, columns-1, 3*rows/4-1,      // reference
+                     0, 3*rows/4, columns-1, rows-1 };      // sideband
+  for(unsigned i=0; i<12; i++)
+    cd.set_value(ConfigDef::sig_x0+i, roi[i]);
+  cd.set_value(ConfigDef::ref_record          , int32_t(0));
+
+  unsigned shape[MaxRank];
+  shape[0] = 1;
+  cd.allocate<uint8_t>(ConfigDef::beam_incl, shape)(0) = BeamCode;
+  shape[0] = 0;
+  cd.allocate<uint8_t>(ConfigDef::beam_excl , shape);
+  cd.allocate<uint8_t>(ConfigDef::laser_incl, shape);
+  cd.allocate<uint8_t>(ConfigDef::laser_excl, shape);
+  //  An edge finder: negative then positive lobe
+  shape[0] = nfir;
+  Array<double> fir = cd.allocate<double>(ConfigDef::fir_weights, shape);
+  for(unsigned i=0; i<nfir; i++)
+    fir(i) = i < nfir/2 ? -1./nfir : 1./nfir;
+  shape[0] = 2;
+  Array<double> poly = cd.allocate<double>(ConfigDef::calib_poly, shape);
+  poly(0) = 0;
+  poly(1) = 0.001;
+}
+
+//  Flat frame with noise; with beam, the signal rows step up at 'edge'
+static void make_frame(std::vector<uint16_t>& frame, unsigned columns, unsigned rows,
+                       bool beam, unsigned edge, std::mt19937& gen)
+{
+  std::uniform_int_distribution<unsigned> noise(0, 8);
+  for(unsigned i=0; i<rows; i++)
+    for(unsigned j=0; j<columns; j++) {
+      unsigned v = 232 + noise(gen);
+      if (beam && i>=rows/4 && i<rows/2 && j>=edge)
+        v += 60;
+      frame[i*columns+j] = v;
+    }
+}
+
+static void usage(const char* p)
+{
+  printf("Usage: %s [-s <frame size>] [-f <fir taps>] [-n <events>]\n",p);
+}
+
+int main(int argc, char* argv[])
+{
+  unsigned size    = 1024;  // square frames, like the Opal 1000
+  unsigned nfir    = 32;
+  unsigned nevents = 1000;
+  int c;
+  while( (c = getopt(argc, argv, "s:f:n:h")) != EOF) {
+    switch(c) {
+    case 's':  size    = strtoul(optarg,NULL,0);  break;
+    case 'f':  nfir    = strtoul(optarg,NULL,0);  break;
+    case 'n':  nevents = strtoul(optarg,NULL,0);  break;
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  unsigned columns = size;
+  unsigned rows    = size;
+
+  std::vector<uint8_t> cfgbuf(1<<20);
+  const void* bufEnd = cfgbuf.data() + cfgbuf.size();
+  Xtc& xtc = *new(reinterpret_cast<char*>(cfgbuf.data()), bufEnd) Xtc(TypeId(TypeId::Parent, 0));
+  NamesLookup namesLookup;
+  build_config(xtc, bufEnd, namesLookup, columns, rows, nfir);
+  ConfigIter configo(&xtc, bufEnd);
+
+  Drp::Parameters para;
+  para.detName = "tt";
+  para.kwargs["ttreffile"] = "/dev/null";
+  Drp::OpalTTFex fex(&para);
+  fex.configure(configo, columns, rows);
+
+  std::mt19937 gen(1);
+  std::vector<uint16_t> frame(columns*rows);
+  Drp::EventInfo info;
+  memset(&info, 0, sizeof(info));
+
+  std::vector< Array<uint8_t> > subframes(4);
+  unsigned fshape[MaxRank];
+  fshape[0] = frame.size()*sizeof(uint16_t);
+  subframes[2] = Array<uint8_t>(reinterpret_cast<uint8_t*>(frame.data()), fshape, 1);
+  unsigned ishape[MaxRank];
+  ishape[0] = sizeof(info);
+  subframes[3] = Array<uint8_t>(reinterpret_cast<uint8_t*>(&info), ishape, 1);
+
+  //  Pre-generate the frames so that only the analysis is measured
+  const unsigned nframes = 16;
+  std::vector< std::vector<uint16_t> > frames(nframes, std::vector<uint16_t>(frame.size()));
+  for(unsigned i=0; i<nframes; i++)
+    make_frame(frames[i], columns, rows, i&1, columns/3 + i, gen);
+
+  std::vector<double> sig, ref;
+  const unsigned warmup = 2*nframes;
+  unsigned results[4] = {0,0,0,0};
+  unsigned counted = 0;
+  double position = 0;
+  for(unsigned ev=0; ev<warmup+nevents; ev++) {
+    bool beam = ev&1;
+    memcpy(frame.data(), frames[ev%nframes].data(), frame.size()*sizeof(uint16_t));
+    memset(info._seqInfo, 0, sizeof(info._seqInfo));
+    if (beam)
+      info._seqInfo[BeamCode>>4] |= 1<<(BeamCode&0xf);
+
+    if (ev==warmup) {
+      allocations = 0;
+      counting = true;
+    }
+    fex.reset();
+    Drp::OpalTTFex::TTResult result = fex.analyze(subframes, sig, ref);
+    if (ev>=warmup) {
+      results[result]++;
+      counted++;
+      if (result==Drp::OpalTTFex::VALID)
+        position = fex.filtered_position();
+    }
+  }
+  counting = false;
+
+  printf("%u events: %u valid, %u nobeam, %u nolaser, %u invalid; last edge at %.1f\n",
+         counted, results[0], results[1], results[2], results[3], position);
+  printf("%u allocations (%.3f per event)\n", allocations.load(), double(allocations)/counted);
+
+  if (allocations || !results[Drp::OpalTTFex::VALID]) {
+    printf("FAILED\n");
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
@@ -717,6 +717,8 @@ int main(int argc, char* argv[])
             if (kwargs.first == "pebbleBufCount")    continue;  // DrpBase
             if (kwargs.first == "batching")          continue;  // DrpBase
             if (kwargs.first == "directIO")          continue;  // DrpBase
+            if (kwargs.first == "traceInterval")     continue;  // DrpBase
+            if (kwargs.first == "traceFile")         continue;  // DrpBase
             logging::critical("Unrecognized kwarg '%s=%s'\n",
                               kwargs.first.c_str(), kwargs.second.c_str());
             return 1;
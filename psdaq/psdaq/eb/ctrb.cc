@@ -913,7 +913,7 @@ int main(int argc, char **argv)
     }
   }
 
-  logging::init(tebPrms.instrument.c_str(), tebPrms.verbose ? LOG_DEBUG : LOG_INFO);
+  logging::init(tebPrms.instrument.c_str(), tebPrms.verbose ? LOG_DEBUG : LOG_INFO, true);
   logging::info("logging configured");
 
   if ( (mebPrms.partition = tebPrms.partition) == NO_PARTITION)
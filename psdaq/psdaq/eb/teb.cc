@@ -1335,7 +1335,7 @@ int main(int argc, char **argv)
     }
   }
 
-  logging::init(prms.instrument.c_str(), prms.verbose ? LOG_DEBUG : LOG_INFO);
+  logging::init(prms.instrument.c_str(), prms.verbose ? LOG_DEBUG : LOG_INFO, true);
   logging::info("logging configured");
 
   if (optind < argc)
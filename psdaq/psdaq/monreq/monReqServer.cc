@@ -10,7 +10,6 @@
 
 #include "psdaq/service/kwargs.hh"
 #include "psdaq/service/Fifo.hh"
-#include "psdaq/service/GenericPool.hh"
 #include "psdaq/service/Collection.hh"
 #include "psdaq/service/MetricExporter.hh"
 #include "psdaq/service/fast_monotonic_clock.hh"
@@ -84,6 +83,8 @@ namespace Pds {
       std::string tag;
       unsigned    nevqueues;
       bool        ldist;
+      bool        rings;                // Pass events to clients through shmem rings
+      bool        broadcast;            // Queue each event to all clients at once
       unsigned    maxBufferSize;        // Maximum built event size
       unsigned    numEvBuffers;         // Number of event buffers
     };
@@ -161,7 +162,8 @@ namespace Pds {
       XtcMonitorServer(prms.tag.c_str(),
                        prms.maxBufferSize,
                        prms.numEvBuffers,
-                       prms.nevqueues),
+                       prms.nevqueues,
+                       prms.rings),
       _mrqLinks    (links),
       _requestCount(requestCount),
       _bufFreeList (prms.numEvBuffers),
@@ -194,22 +196,23 @@ namespace Pds {
     {
       return _bufFreeList.count();
     }
-  private:
-    virtual void _copyDatagram(Dgram* dg, char* buf, size_t bSz)
+    // Assemble the event datagram from its contributions, which is the only
+    // copy made of them, directly in shared memory buffer ibuffer
+    Dgram* build(int ibuffer, const EbEvent* event)
     {
+      char*       buf    = buffer(ibuffer);
+      size_t      bSz    = sizeOfBuffers();
+      const void* bufEnd = buf + bSz;
+
       if (UNLIKELY(_prms.verbose >= VL_EVENT))
-        printf("_copyDatagram:   dg %p, ts %u.%09u to %p\n",
-               dg, dg->time.seconds(), dg->time.nanoseconds(), buf);
-
-      // The dg payload is a directory of contributions to the built event.
-      // Iterate over the directory and construct, in shared memory, the event
-      // datagram (odg) from the contribution XTCs
-      const EbDgram** const  last = (const EbDgram**)dg->xtc.next();
-      const EbDgram*  const* ctrb = (const EbDgram**)dg->xtc.payload();
-      Dgram*                 odg  = new((void*)buf) Dgram(**ctrb); // Not an EbDgram!
+        printf("build:           ts %u.%09u to %p\n",
+               event->creator()->time.seconds(), event->creator()->time.nanoseconds(), buf);
+
+      const EbDgram* const* ctrb = event->begin();
+      const EbDgram** const last = event->end();
+      Dgram*                odg  = new((void*)buf) Dgram(**ctrb); // Not an EbDgram!
       odg->xtc.src      = XtcData::Src(_prms.id, XtcData::Level::Event);
       odg->xtc.contains = XtcData::TypeId(XtcData::TypeId::Parent, 0);
-      const void* bufEnd = buf + bSz;
       do
       {
         const EbDgram* idg = *ctrb;
@@ -229,19 +232,20 @@ namespace Pds {
         memcpy(buf, &idg->xtc, iExt);
       }
       while (++ctrb != last);
+
+      return odg;
     }
 
-    virtual void _deleteDatagram(Dgram* dg) // Not called for transitions
+    // Make the MEB buffer idx, whose contributions have been consumed,
+    // available for requesting another event
+    void release(unsigned idx)          // Not called for transitions
     {
-      unsigned idx = dg->xtc.src.value();
-
       if (UNLIKELY(_prms.verbose >= VL_EVENT))
-        printf("_deleteDatagram: dg %p, ts %u.%09u, idx %u\n",
-               dg, dg->time.seconds(), dg->time.nanoseconds(), idx);
+        printf("release:         idx %u\n", idx);
 
       if (idx >= _bufFreeList.size())
       {
-        logging::warning("deleteDatagram: Out of bounds index %08x, max %08x",
+        logging::warning("release: Out of bounds index %08x, max %08x",
                          idx, _bufFreeList.size() - 1);
       }
 
@@ -249,9 +253,7 @@ namespace Pds {
       {
         if (idx == _bufFreeList.peek(i))
         {
-          logging::error("Index is already on list at %u: idx %u, dg %p, ts %u.%09u, svc %s",
-                         i, idx, dg, dg->time.seconds(), dg->time.nanoseconds(), TransitionId::name(dg->service()));
-          //Pool::free((void*)dg);
+          logging::error("Index is already on list at %u: idx %u", i, idx);
           return;
         }
       }
@@ -268,11 +270,9 @@ namespace Pds {
           printf("Free list entry %u: %u\n", i, _bufFreeList.peek(i));
         }
       }
-      //printf("_deleteDatagram: push idx %u, cnt = %zu\n", idx, _bufFreeList.count());
-
-      Pool::free((void*)dg);
+      //printf("release: push idx %u, cnt = %zu\n", idx, _bufFreeList.count());
     }
-
+  private:
     virtual void _requestDatagram()
     {
       //printf("_requestDatagram\n");
@@ -348,7 +348,6 @@ namespace Pds {
   private:
     std::unique_ptr<MyXtcMonitorServer> _apps;
     std::vector<EbLfCltLink*>           _mrqLinks;
-    std::unique_ptr<GenericPool>        _pool;
     uint64_t                            _pidPrv;
     int64_t                             _latency;
     uint64_t                            _eventCount;
@@ -462,13 +461,6 @@ void Meb::disconnect()
 
 void Meb::unconfigure()
 {
-  if (_pool)
-  {
-    printf("Directory datagram pool:\n");
-    _pool->dump();
-  }
-  _pool.reset();
-
   _apps.reset();
 
   EbAppBase::unconfigure();
@@ -491,11 +483,6 @@ int Meb::connect()
 
 int Meb::configure()
 {
-  // Create pool for transferring events to MyXtcMonitorServer
-  unsigned entries = std::bitset<64>(_prms.contributors).count();
-  size_t   size    = sizeof(Dgram) + entries * sizeof(Dgram*);
-  _pool = std::make_unique<GenericPool>(size, 1 + _prms.numEvBuffers); // +1 for Transitions
-
   // MRQ links need no configuration
 
   int rc = EbAppBase::configure();
@@ -508,7 +495,10 @@ int Meb::configure()
                                                _bufPrcMetric, _monTrgMetric, _appPrcMetric,
                                                _prms);
 
-  _apps->distribute(_prms.ldist);
+  if (_prms.broadcast)
+    _apps->broadcast();
+  else
+    _apps->distribute(_prms.ldist);
 
   return 0;
 }
@@ -594,53 +584,42 @@ void Meb::process(EbEvent* event)
   if (dgram->isEvent())  ++_eventCount;
   else                   ++_trCount;
 
-  // Create a Dgram with a payload that is a directory of contribution
-  // Dgrams to the built event in order to avoid first assembling the
-  // datagram from its contributions in a temporary buffer, only to then
-  // copy it into shmem in _copyDatagram() above.  Since the contributions,
-  // and thus the full datagram, can be quite large, this would amount to
-  // a lot of copying
-  size_t      sz     = (event->end() - event->begin()) * sizeof(*(event->begin()));
-  unsigned    idx    = ImmData::idx(event->immData());
-  Dgram*      dg     = new(_pool->alloc(sizeof(Dgram) + sz)) Dgram(*(event->creator()));
-  const void* bufEnd = ((char*)dg) + _pool->sizeofObject();
-  if (!dg)
+  // Build the event directly in a shared memory buffer from the contributions
+  // received from the DRPs, rather than first describing it with a directory
+  // datagram for XtcMonitorServer to copy from later.  The contributions are
+  // thus copied only once, and the buffer they arrived in is available to be
+  // requested again as soon as the event has been built
+  unsigned idx = ImmData::idx(event->immData());
+  auto     svc = dgram->service();
+  if (svc == TransitionId::L1Accept)
   {
-    logging::critical("%s:\n  Dgram pool allocation of size %zd failed:",
-                      __PRETTY_FUNCTION__, sizeof(Dgram) + sz);
-    printf("Directory datagram pool\n");
-    _pool->dump();
-    printf("Meb::process event dump:\n");
-    event->dump(-1);
-    abort();
+    ++_prcBufCount;    // Number of buffers being processed by the MEB; decremented in release()
+    _bufPrcMetric.start(idx);
+    _monTrgMetric.accumulate(idx);
   }
 
-  dg->xtc.src = {idx, Level::Event}; // Pass buffer's index to _deleteDatagram()
-
-  void*  buf = dg->xtc.alloc(sz, bufEnd);
-  memcpy(buf, event->begin(), sz);
+  int    ibuffer = _apps->reserve(svc);
+  Dgram* dg      = ibuffer < 0 ? nullptr : _apps->build(ibuffer, event);
 
   if (_prms.verbose >= VL_EVENT)
   {
-    unsigned    ctl = dg->control();
-    unsigned    env = dg->env;
-    size_t      sz  = sizeof(*dg) + dg->xtc.sizeofPayload();
-    unsigned    src = dg->xtc.src.value();
-    const char* svc = TransitionId::name(dg->service());
-    auto        cnt = dg->isEvent() ? _eventCount : _trCount;
+    unsigned    ctl = dgram->control();
+    unsigned    env = dgram->env;
+    size_t      sz  = dg ? sizeof(*dg) + dg->xtc.sizeofPayload() : 0;
+    const char* svn = TransitionId::name(svc);
+    auto        cnt = dgram->isEvent() ? _eventCount : _trCount;
     printf("MEB processed %5lu %15s  [%8u] @ "
-           "%16p, ctl %02x, pid %014lx, env %08x, sz %6zd, src %2u, ts %u.%09u\n",
-           cnt, svc, idx, dg, ctl, pid, env, sz, src, dg->time.seconds(), dg->time.nanoseconds());
+           "%16p, ctl %02x, pid %014lx, env %08x, sz %6zd, shm %2d, ts %u.%09u\n",
+           cnt, svn, idx, dg, ctl, pid, env, sz, ibuffer, dgram->time.seconds(), dgram->time.nanoseconds());
   }
   else
   {
-    auto svc = dg->service();
     if ((svc != TransitionId::L1Accept) && (svc != TransitionId::SlowUpdate))
     {
-      logging::info("MEB built      %15s @ %u.%09u (%014lx) from buffer %2u @ %16p",
+      logging::info("MEB built      %15s @ %u.%09u (%014lx) from buffer %2u in shm buffer %2d",
                     TransitionId::name(svc),
-                    dg->time.seconds(), dg->time.nanoseconds(),
-                    pid, dg->xtc.src.value(), dg);
+                    dgram->time.seconds(), dgram->time.nanoseconds(),
+                    pid, idx, ibuffer);
     }
   }
 
@@ -650,35 +629,35 @@ void Meb::process(EbEvent* event)
   tp_t tp   {std::chrono::duration_cast<std::chrono::system_clock::duration>(dgt)};
   _latency = std::chrono::duration_cast<ms_t>(now - tp).count();
 
-  if (dg->service() == TransitionId::L1Accept)
+  if (svc == TransitionId::L1Accept)
   {
-    ++_prcBufCount;    // Number of buffers being processed by the MEB; decremented in _deleteDatagram
-    _bufPrcMetric.start(idx);
-    _monTrgMetric.accumulate(idx);
-
-    int env = dg->env & _prms.rogs;
+    int env = dgram->env & _prms.rogs;
     while (env)
     {
       auto rog = __builtin_ffs(env) - 1;
       env &= ~(1 << rog);
       ++_rogCount[rog];
     }
-  }
 
-  // Transitions, including SlowUpdates, return Handled, L1Accepts return Deferred
-  if (_apps->events(dg) == XtcMonitorServer::Handled)
+    // The contributions have been consumed, so the buffer can be requested
+    // again while the event is distributed to the clients.  When no shared
+    // memory buffer was available, the event is dropped
+    _apps->release(idx);
+    if (dg)  _apps->commit(ibuffer);
+  }
+  else
   {
+    if (dg)  _apps->commit(ibuffer);
+
     // Make the transition buffer available to the contributors again
     post(event->begin(), event->end());
 
-    if (dg->service() != TransitionId::SlowUpdate)
+    if (svc != TransitionId::SlowUpdate)
     {
       // send pulseId to inproc so it gets forwarded to the collection
       json msg = createPulseIdMsg(pid);
       _inprocSend.send(msg.dump());
     }
-
-    Pool::free((void*)dg);          // Handled means _deleteDatagram() won't be called
   }
 }
 
@@ -1015,7 +994,8 @@ void MebApp::_printParams(const MebParams& prms) const
   printf("  # of transition buffers:    0x%08x = %u\n",        MEB_TR_BUFFERS, MEB_TR_BUFFERS);
   printf("  Max buffer size:            0x%08x = %u\n",        prms.maxBufferSize, prms.maxBufferSize);
   printf("  # of event message queues:  0x%08x = %u\n",        prms.nevqueues, prms.nevqueues);
-  printf("  Distribute:                 %s\n",                 prms.ldist ? "yes" : "no");
+  printf("  Distribute:                 %s\n",                 prms.broadcast ? "broadcast" : prms.ldist ? "yes" : "no");
+  printf("  Event queues:               %s\n",                 prms.rings ? "shmem rings" : "message queues");
   printf("  Tag:                        %s\n",                 prms.tag.c_str());
   printf("\n");
 }
@@ -1061,6 +1041,8 @@ int main(int argc, char** argv)
   prms.numEvBuffers  = NUMBEROF_XFERBUFFERS;
   prms.nevqueues     = 1;
   prms.ldist         = false;
+  prms.rings         = false;
+  prms.broadcast     = false;
 
   int c;
   while ((c = getopt(argc, argv, "p:P:n:t:q:dA:C:1:2:u:M:k:vh")) != -1)
@@ -1165,10 +1147,18 @@ int main(int argc, char** argv)
     if (kwargs.first == "ep_fabric")    continue;
     if (kwargs.first == "ep_domain")    continue;
     if (kwargs.first == "ep_provider")  continue;
+    if (kwargs.first == "shmemRings")   continue;
+    if (kwargs.first == "shmemBroadcast") continue;
     logging::critical("Unrecognized kwarg '%s=%s'",
                       kwargs.first.c_str(), kwargs.second.c_str());
     return 1;
   }
+  prms.rings = prms.kwargs.find("shmemRings") != prms.kwargs.end() && prms.kwargs["shmemRings"] == "1";
+  prms.broadcast = prms.kwargs.find("shmemBroadcast") != prms.kwargs.end() && prms.kwargs["shmemBroadcast"] == "1";
+  if (prms.broadcast && !prms.rings) {
+    logging::warning("shmemBroadcast requires shmemRings=1; enabling it");
+    prms.rings = true;
+  }
 
   struct sigaction sigAction;
 